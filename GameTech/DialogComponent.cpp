@@ -65,11 +65,8 @@ DialogComponent::~DialogComponent ()
   };
 
 //-----------------------------------------------------------------------------
-Attr *  DialogComponent::SetAttr (const char *  szNameIn,
-                                  const char *  szValueIn)
+VOID  DialogComponent::OnAttrChanged (Attr *  pattrChanged)
   {
-  Attr * pattrChanged = Component::SetAttr (szNameIn, szValueIn);
-
   // handle any changes that result from setting new values in attrs
   if (pattrChanged != NULL)
     {
@@ -78,7 +75,6 @@ Attr *  DialogComponent::SetAttr (const char *  szNameIn,
       DisconnectFromRegistry ();
       };
     }
-  return pattrChanged;
   };
 
 //-----------------------------------------------------------------------------
@@ -74,8 +74,9 @@ class DialogComponent : public WindowBaseComponent
 
     virtual Component *   Instantiate            (VOID) const                   {return new DialogComponent;};
 
-    virtual Attr *        SetAttr                (const char *  szNameIn,
-                                                  const char *  szValueIn);
+    virtual UINT32        CallbackMask           (VOID) const                   {return (WindowBaseComponent::CallbackMask () | ComponentCallback::kUpdate);};
+
+    virtual VOID          OnAttrChanged          (Attr *  pattrChanged);
 
     virtual VOID          OnEvent                (HASH_T  hEventIn);
 
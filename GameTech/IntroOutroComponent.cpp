@@ -74,6 +74,11 @@ IntroOutroComponent::IntroOutroComponent ()
 
   pattrIntroOutroKey = (AttrString*) AddAttr ("introOutroKey", AttrString::Identifier());
 
+  SubscribeEvent (HASH("OnIntro"));
+  SubscribeEvent (HASH("OnIdle"));
+  SubscribeEvent (HASH("OnOutro"));
+  SubscribeEvent (HASH("OnHidden"));
+
   pelemIntroOutro = NULL;
   };
 
@@ -84,11 +89,8 @@ IntroOutroComponent::~IntroOutroComponent ()
   };
 
 //-----------------------------------------------------------------------------
-Attr *  IntroOutroComponent::SetAttr (const char *  szNameIn,
-                                      const char *  szValueIn)
+VOID  IntroOutroComponent::OnAttrChanged (Attr *  pattrChanged)
   {
-  Attr * pattrChanged = Component::SetAttr (szNameIn, szValueIn);
-
   // handle any changes that result from setting new values in attrs
   if (pattrChanged != NULL)
     {
@@ -97,7 +99,6 @@ Attr *  IntroOutroComponent::SetAttr (const char *  szNameIn,
       DisconnectFromRegistry ();
       };
     }
-  return pattrChanged;
   };
 
 //-----------------------------------------------------------------------------
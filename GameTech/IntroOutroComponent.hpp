@@ -81,8 +81,9 @@ class IntroOutroComponent : public Component
 
     virtual Component *   Instantiate            (VOID) const                   {return new IntroOutroComponent;};
 
-    virtual Attr *        SetAttr                (const char *  szNameIn,
-                                                  const char *  szValueIn);
+    virtual UINT32        CallbackMask           (VOID) const                   {return (ComponentCallback::kRecache | ComponentCallback::kRenderStart | ComponentCallback::kEvent);};
+
+    virtual VOID          OnAttrChanged          (Attr *  pattrChanged);
 
     virtual VOID          OnAwake                (VOID);
 
@@ -71,11 +71,8 @@ ScreenComponent::~ScreenComponent ()
   };
 
 //-----------------------------------------------------------------------------
-Attr *  ScreenComponent::SetAttr (const char *  szNameIn,
-                                  const char *  szValueIn)
+VOID  ScreenComponent::OnAttrChanged (Attr *  pattrChanged)
   {
-  Attr * pattrChanged = Component::SetAttr (szNameIn, szValueIn);
-
   // handle any changes that result from setting new values in attrs
   if (pattrChanged != NULL)
     {
@@ -84,7 +81,6 @@ Attr *  ScreenComponent::SetAttr (const char *  szNameIn,
       DisconnectFromRegistry ();
       };
     }
-  return pattrChanged;
   };
 
 //-----------------------------------------------------------------------------
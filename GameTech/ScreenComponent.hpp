@@ -76,8 +76,9 @@ class ScreenComponent : public WindowBaseComponent
 
     virtual Component *   Instantiate            (VOID) const                   {return new ScreenComponent;};
 
-    virtual Attr *        SetAttr                (const char *  szNameIn,
-                                                  const char *  szValueIn);
+    virtual UINT32        CallbackMask           (VOID) const                   {return (WindowBaseComponent::CallbackMask () | ComponentCallback::kUpdate);};
+
+    virtual VOID          OnAttrChanged          (Attr *  pattrChanged);
 
     virtual VOID          OnUpdate               (VOID);
 
@@ -161,10 +161,9 @@ TweenSetComponent::~TweenSetComponent ()
   };
 
 //-----------------------------------------------------------------------------
-Attr *  TweenSetComponent::SetAttr (const char *  szNameIn,
-                                    const char *  szValueIn)
+VOID  TweenSetComponent::OnAttrChanged (Attr *  pattrChanged)
   {
-  Attr * pattrChanged = IntroOutroComponent::SetAttr (szNameIn, szValueIn);
+  IntroOutroComponent::OnAttrChanged (pattrChanged);
 
   // handle any changes that result from setting new values in attrs
   if (pattrChanged != NULL)
@@ -378,7 +377,6 @@ Attr *  TweenSetComponent::SetAttr (const char *  szNameIn,
       fFadeOutTo = pattrFadeOutTo->Value ();
       };
     }
-  return pattrChanged;
   };
 
 //-----------------------------------------------------------------------------
@@ -180,8 +180,7 @@ class TweenSetComponent : public IntroOutroComponent
 
     virtual Component *   Instantiate            (VOID) const                   {return new TweenSetComponent;};
 
-    virtual Attr *        SetAttr                (const char *  szNameIn,
-                                                  const char *  szValueIn);
+    virtual VOID          OnAttrChanged          (Attr *  pattrChanged);
 
     VOID                  AttrToVec              (AttrFloatArray &  attrIn,
                                                   RVec3 &           vecOut);
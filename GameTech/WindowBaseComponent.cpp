@@ -66,6 +66,11 @@ WindowBaseComponent::WindowBaseComponent ()
   pattrOnOutroExpression    = (AttrString*) AddAttr ("onOutroExpr",    AttrString::Identifier());
   pattrOnHiddenExpression    = (AttrString*) AddAttr ("onHiddenExpr",    AttrString::Identifier());
 
+  SubscribeEvent (HASH("OnIntro"));
+  SubscribeEvent (HASH("OnIdle"));
+  SubscribeEvent (HASH("OnOutro"));
+  SubscribeEvent (HASH("OnHidden"));
+
   pelemIntroOutro = NULL;
   };
 
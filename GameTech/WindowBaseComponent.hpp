@@ -80,8 +80,7 @@ class WindowBaseComponent : public Component
 
     virtual Component *   Instantiate            (VOID) const = 0;
 
-    virtual Attr *        SetAttr                (const char *  szNameIn,
-                                                  const char *  szValueIn) = 0;
+    virtual UINT32        CallbackMask           (VOID) const                   {return (ComponentCallback::kRecache | ComponentCallback::kEvent);};
 
     virtual VOID          OnAwake                (VOID);
 
@@ -39,8 +39,10 @@ ASSERTFILE (__FILE__);
 
 #include "Composite/Attr.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/TArray.hpp"
 
-static TList<Attr *>  listAttrTemplates;
+static TList<Attr *>   listAttrTemplates;
+static TArray<Attr *>  apAttrTemplatesByID;  ///< Templates indexed by their ID in Attr::Types (), or NULL.
 
 // TODO:  Method to delete all templates.
 
@@ -58,6 +60,7 @@ Attr::Attr (const char *  szNameIn) : strName (szNameIn)
   bDirty      = TRUE;
   iVersion    = 0;
   iArrayIndex = 0;
+  iPendingChange = ChangeBatch::kNotPending;
 
   pCachedRegistry = NULL;
   strRegistryKey.Empty ();
@@ -67,6 +70,7 @@ Attr::Attr (const char *  szNameIn) : strName (szNameIn)
 //-----------------------------------------------------------------------------
 Attr::~Attr ()
   {
+  ChangeBatch::Cancel (this, iPendingChange);
   OnDelete ();
   };
 
@@ -101,22 +105,29 @@ VOID  Attr::DebugPrint   (const char *  szIndentIn,
   strOut.AppendFormat ("%sAttr (%s): %s [%s]\n", szIndentIn, Type (), Name (), strValue.AsChar ());
   };
 
+//-----------------------------------------------------------------------------
+TypeRegistry &  Attr::Types  (VOID)
+  {
+  static TypeRegistry  registryTypes;
+  return (registryTypes);
+  };
+
 //-----------------------------------------------------------------------------
 Attr *  Attr::New (const char *  szNameIn,
                    const char *  szTypeIn)
   {
-  for (TListItr<Attr*> itrCurr = listAttrTemplates.First ();
-       itrCurr.IsValid();
-       ++itrCurr)
+  return (New (szNameIn, Types ().Find (szTypeIn)));
+  }
+
+//-----------------------------------------------------------------------------
+Attr *  Attr::New (const char *  szNameIn,
+                   INT           iTypeIDIn)
+  {
+  if ((iTypeIDIn < 0) || (iTypeIDIn >= apAttrTemplatesByID.Length ()) || (apAttrTemplatesByID [iTypeIDIn] == NULL))
     {
-    if (streq ((*itrCurr)->Type (), szTypeIn))
-      {
-      // found the type template
-      Attr *  pNew = (*itrCurr)->Instantiate (szNameIn);
-      return (pNew);
-      };
+    return NULL;
     };
-  return NULL;
+  return (apAttrTemplatesByID [iTypeIDIn]->Instantiate (szNameIn));
   }
 
 //-----------------------------------------------------------------------------
@@ -125,17 +136,18 @@ VOID  Attr::AddTemplate (Attr *  pAttrIn)
   // NOTE: The object passed to AddTemplate via pointer will be owned by Attr
   //   from here on out, and will be deallocated by Attr as needed.
 
-  for (TListItr<Attr*> itrCurr = listAttrTemplates.First ();
-       itrCurr.IsValid();
-       ++itrCurr)
+  INT  iTypeID = Types ().Register (pAttrIn->Type ());
+  while (apAttrTemplatesByID.Length () <= iTypeID)
     {
-    if ((*itrCurr)->IsType (pAttrIn->Type ()))
-      {
-      // we already have this type in the templates
-      delete pAttrIn;
-      return;
-      };
+    apAttrTemplatesByID.Append (NULL);
+    };
+  if (apAttrTemplatesByID [iTypeID] != NULL)
+    {
+    // we already have this type in the templates
+    delete pAttrIn;
+    return;
     };
+  apAttrTemplatesByID [iTypeID] = pAttrIn;
   listAttrTemplates.PushBack (pAttrIn);
   }
 
@@ -149,6 +161,7 @@ VOID  Attr::DeleteAllTemplates (VOID)
     delete (*itrCurr);
     };
   listAttrTemplates.Empty ();
+  apAttrTemplatesByID.Clear ();
   }
 
 //-----------------------------------------------------------------------------
@@ -41,6 +41,9 @@
 #include "Util/RStr.hpp"
 #include "Util/RStrParser.hpp"
 #include "Util/Signal.h"
+#include "Containers/SlabPool.hpp"
+#include "Composite/TypeRegistry.hpp"
+#include "Util/ChangeBatch.hpp"
 #include "ValueRegistry/ValueRegistry.hpp"
 
 /**
@@ -89,6 +92,8 @@ class Attr
 
     INT           iArrayIndex;  ///< If the attr represents one element in an array, this is its index into the array.
 
+    INT           iPendingChange; ///< Slot in ChangeBatch's pending list while a batched sigOnChanged is waiting.
+
   public:
     RStr          strName;     ///< String by which this attr is identified.  Encapsulation broken (public) to allow for efficient serialization.
 
@@ -107,6 +112,12 @@ class Attr
                           Attr         (const char *  szNameIn);
     virtual               ~Attr        ();
 
+                          /// @brief  Attrs are allocated from the SlabAllocator's kAttr pools.
+    static  VOID *        operator new (size_t  uSizeIn)   {return SlabAllocator::Allocate (SlabAllocator::kAttr, uSizeIn);};
+
+    static  VOID          operator delete (VOID *  pIn,
+                                           size_t  uSizeIn) {SlabAllocator::Free (pIn, uSizeIn);};
+
                           /// @brief  Get the string identifier for this Attr type.
                           /// @return Pointer to a null terminated string that identifies the type of this attr.
             const char *  Type         (VOID) const   {return szType;};
@@ -157,14 +168,26 @@ class Attr
 
                           /// @brief OnChanged must be called by the derived classes whenever they change or clear their value.
                           ///           Attach with pAttr->sigOnChanged.Connect( &l, &Label::OnChangedListener );
+                          ///           If ChangeBatch is batching kAttr, sigOnChanged fires at the next flush instead.
                           /// @return None.
-            VOID          OnChanged    (VOID)  {sigOnChanged(this);};
+            VOID          OnChanged    (VOID)  {ChangeBatch::Raise (ChangeBatch::kAttr, this, iPendingChange, &Attr::DeliverChanged, FALSE);};
+
+                          /// @brief Fires sigOnChanged for OnChanged, directly or from ChangeBatch::Flush.
+    static  VOID          DeliverChanged (VOID *  pAttrIn,
+                                          BOOL    bUpdatingIn)  {Attr *  pAttr = static_cast<Attr *>(pAttrIn); pAttr->sigOnChanged (pAttr);};
 
             VOID          OnDelete     (VOID)  {sigOnDelete(this);};
 
     static Attr *         New          (const char *  szNameIn,
                                         const char *  szTypeIn);
 
+                          /// @brief  Create an attr from the template with the given ID in Types ().
+    static Attr *         New          (const char *  szNameIn,
+                                        INT           iTypeIDIn);
+
+                          /// @brief  The registry that hands out IDs for attr types.  Templates are registered by AddTemplate.
+    static TypeRegistry & Types        (VOID);
+
     static VOID           AddTemplate  (Attr *  pAttrIn);
 
     static VOID           DeleteAllTemplates     (VOID);
@@ -198,3 +198,46 @@ TEST (Attr, AttrString)
 
 
 
+
+//------------------------------------------------------------------------------
+class AttrChangeCounter
+  {
+  public:
+    INT    iNumCalls;
+
+           AttrChangeCounter ()  {iNumCalls = 0;};
+
+    VOID   OnChanged     (Attr *  pattrIn)  {++iNumCalls;};
+  };
+
+//------------------------------------------------------------------------------
+TEST (Attr, BatchedChanges)
+  {
+  AttrTemplatesInitialize ();
+
+  AttrInt *          pattrInt = dynamic_cast<AttrInt *>(Attr::New ("MyInt", "int"));
+  AttrChangeCounter  counter;
+  pattrInt->sigOnChanged.Connect (&counter, &AttrChangeCounter::OnChanged);
+
+  // only the batched categories are deferred
+  ChangeBatch::SetBatching (ChangeBatch::kValueElem);
+  pattrInt->SetByInt (1);
+  ASSERT_EQ (1, counter.iNumCalls);
+
+  ChangeBatch::SetBatching (ChangeBatch::kAttr);
+  pattrInt->SetByInt (2);
+  pattrInt->SetByString ("3");
+  ASSERT_EQ (1, counter.iNumCalls);
+  ASSERT_EQ (3, pattrInt->Value ());
+  ASSERT_EQ (1, ChangeBatch::Flush ());
+  ASSERT_EQ (2, counter.iNumCalls);
+
+  // attrs deleted while pending are dropped
+  pattrInt->SetByInt (4);
+  pattrInt->sigOnChanged.Disconnect (&counter, &AttrChangeCounter::OnChanged);
+  delete pattrInt;
+  ASSERT_EQ (0, ChangeBatch::Flush ());
+
+  ChangeBatch::SetBatching (ChangeBatch::kNone);
+  AttrTemplatesUninitialize ();
+  };
@@ -46,6 +46,7 @@ ASSERTFILE (__FILE__);
 #include "Composite/AttrStringArray.hpp"
 #include "Composite/AttrFloatArray.hpp"
 #include "Composite/AttrIntArray.hpp"
+#include "Composite/Node.hpp"
 
 static BOOL    bAttrTemplatesInitialized = FALSE;
 Signal0<>      Component::sigOnUpdate;
@@ -91,6 +92,9 @@ Component::Component (VOID)
   pNext = NULL;
   pParentNode = NULL;
   pParentID   = NULL;
+  uDispatchPass = 0;
+  iTypeID = TypeRegistry::kInvalidID;
+  listAttr.SetPooledEntries (TRUE);
   };
 
 //-----------------------------------------------------------------------------
@@ -101,6 +105,32 @@ Component::~Component ()
     delete (*itrCurr);
     };
   listAttr.Empty();
+  indexAttr.Clear ();
+  };
+
+//-----------------------------------------------------------------------------
+TypeRegistry &  Component::Types  (VOID)
+  {
+  static TypeRegistry  registryTypes;
+  return (registryTypes);
+  };
+
+//-----------------------------------------------------------------------------
+Component *  Component::GetInterfaceByID  (INT  iInterfaceIDIn)
+  {
+  // cache of GetInterface answers, keyed by (component type, interface).  1 if implemented, 0 if not.
+  static THashIndex<INT>  indexInterfaces;
+
+  HASH_T  uKey  = (HASH_T (TypeID ()) << 16) ^ HASH_T (iInterfaceIDIn);
+  INT     iSlot = indexInterfaces.FindFirst (uKey);
+  if (iSlot != -1)
+    {
+    return ((indexInterfaces.GetAt (iSlot) != 0) ? this : NULL);
+    };
+
+  Component *  pcmpInterface = GetInterface (Types ().Name (iInterfaceIDIn));
+  indexInterfaces.Insert (uKey, (pcmpInterface != NULL) ? 1 : 0);
+  return (pcmpInterface);
   };
 
 //-----------------------------------------------------------------------------
@@ -128,6 +158,44 @@ VOID  Component::CloneAttrs  (Component *  pcmpSourceIn)
  bIsLoading = FALSE;
  };
 
+//-----------------------------------------------------------------------------
+VOID  Component::SubscribeEvent (HASH_T  uEventIn)
+  {
+  if ((auEventSubscriptions.Length () > 0) && HandlesEvent (uEventIn)) return;
+
+  auEventSubscriptions.Append (uEventIn);
+  Node::MarkStructureChanged ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  Component::UnsubscribeEvent (HASH_T  uEventIn)
+  {
+  HASH_T *  puEvents = auEventSubscriptions.GetRawBuffer ();
+  for (INT  iIndex = 0; iIndex < auEventSubscriptions.Length (); ++iIndex)
+    {
+    if (puEvents [iIndex] == uEventIn)
+      {
+      auEventSubscriptions.Remove (iIndex);
+      Node::MarkStructureChanged ();
+      return;
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  Component::HandlesEvent (HASH_T  uEventIn)
+  {
+  INT  iNumEvents = auEventSubscriptions.Length ();
+  if (iNumEvents == 0) return (TRUE);
+
+  HASH_T *  puEvents = auEventSubscriptions.GetRawBuffer ();
+  for (INT  iIndex = 0; iIndex < iNumEvents; ++iIndex)
+    {
+    if (puEvents [iIndex] == uEventIn) return (TRUE);
+    };
+  return (FALSE);
+  };
+
 //-----------------------------------------------------------------------------
 VOID  Component::OnEvent (HASH_T  hEventIn)
   {
@@ -313,11 +381,14 @@ VOID  Component::SetParentNode (PVOID         pParentIn,
 //-----------------------------------------------------------------------------
 Attr *  Component::GetAttr (const char *  szNameIn)
   {
-  for (TListItr<Attr*> itrCurr = listAttr.First (); itrCurr.IsValid (); ++itrCurr)
+  HASH_T  uHash = CalcHashValue (szNameIn);
+
+  for (INT  iSlot = indexAttr.FindFirst (uHash); iSlot != -1; iSlot = indexAttr.FindNext (uHash, iSlot))
     {
-    if (streq ((*itrCurr)->Name(), szNameIn))
+    Attr *  pAttr = indexAttr.GetAt (iSlot);
+    if (streq (pAttr->Name (), szNameIn))
       {
-      return (*itrCurr);
+      return (pAttr);
       };
     };
   return (NULL);
@@ -333,10 +404,30 @@ Attr *  Component::SetAttr (const char *  szNameIn,
     //DBG_INFO ("SetAttr calling SetByString %s = \"%s\"", szNameIn, szValueIn == NULL ? "Null" : szValueIn);
     pAttr->Clear ();
     pAttr->SetByString (szValueIn);
+    OnAttrChanged (pAttr);
     };
   return pAttr;
   };
 
+//-----------------------------------------------------------------------------
+Attr *  Component::SetAttrValue (Attr *  pattrValueIn)
+  {
+  Attr *  pAttr = GetAttr (pattrValueIn->Name ());
+  if (pAttr == NULL) return (NULL);
+
+  if (!pAttr->IsCCType (pattrValueIn->CCType ()))
+    {
+    DBG_ERROR ("Component::SetAttrValue () - attr \"%s\" is type %s, not %s", pAttr->Name (), pAttr->Type (), pattrValueIn->Type ());
+    return (NULL);
+    };
+  // mirror SetByString, which bumps the version and fires sigOnChanged.
+  pAttr->Set (pattrValueIn);
+  pAttr->MarkAsDirty ();
+  pAttr->OnChanged ();
+  OnAttrChanged (pAttr);
+  return (pAttr);
+  };
+
 //-----------------------------------------------------------------------------
 Attr *  Component::SetArrayAttr (const char *  szNameIn,
                                  INT           iIndex,
@@ -366,6 +457,7 @@ Attr *  Component::AddAttr (const char *  szNameIn,
       };
 
     listAttr.PushBack (pNew);
+    indexAttr.Insert (CalcHashValue (szNameIn), pNew);
     return (pNew);
     };
 
@@ -436,8 +528,9 @@ VOID  Component::DeleteAttr (const char *  szNameIn)
   Attr *  pAttr = GetAttr (szNameIn);
   if (pAttr != NULL)
     {
-    delete (pAttr);
+    indexAttr.Remove (CalcHashValue (szNameIn), pAttr);
     listAttr.Delete (pAttr);
+    delete (pAttr);
     };
   };
 
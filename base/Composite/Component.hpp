@@ -47,8 +47,12 @@
 #include "Composite/AttrIntArray.hpp"
 #include "Composite/AttrFloatArray.hpp"
 #include "Composite/AttrStringArray.hpp"
+#include "Composite/TypeRegistry.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/SlabPool.hpp"
 #include "Containers/PtrArray.hpp"
+#include "Containers/TArray.hpp"
+#include "Containers/THashIndex.hpp"
 #include "Util/Signal.h"
 
 /**
@@ -68,6 +72,24 @@
 extern VOID AttrTemplatesInitialize   (VOID);
 extern VOID AttrTemplatesUninitialize (VOID);
 
+// NOTE: Flags returned by Component::CallbackMask().  The bit positions follow
+//  the order of ComponentDefaultLooper::Callback, so a callback's flag is
+//  (1 << callback).
+namespace ComponentCallback
+  {
+  enum Mask {kNone           = 0x0000,
+             kPreUpdate      = 0x0001,
+             kUpdate         = 0x0002,
+             kPostUpdate     = 0x0004,
+             kClick          = 0x0008,
+             kRenderStart    = 0x0010,
+             kDisplay        = 0x0020,
+             kTriggerCollide = 0x0040,
+             kRecache        = 0x0080,
+             kEvent          = 0x0100,
+             kAll            = 0x01ff};
+  };
+
 
 //-----------------------------------------------------------------------------
 class Component
@@ -75,7 +97,9 @@ class Component
   protected:
 
     RStr                  strType;
+    INT                   iTypeID;  ///< ID of strType in Types ().  Assigned on first use, since derived constructors set strType.
     TList<Attr*>          listAttr;
+    THashIndex<Attr*>     indexAttr; ///< Attrs in listAttr, keyed by name hash.  Maintained by AddAttr and DeleteAttr.
     INT                   iVersion; ///< used to detect when this component was changed/dirtied.
     BOOL                  bIsActive; ///< Active status is set/cleared when parent is active/inactive.
     BOOL                  bIsLoading; ///< Set to true if component is being loaded, and thus lots of attrs are changing.
@@ -85,19 +109,80 @@ class Component
     Component *           pNext;
     PVOID                 pParentNode;
     const char *          pParentID;
+    UINT32                uDispatchPass; ///< Last World dispatch pass that called this component.
+    TArray<HASH_T>        auEventSubscriptions; ///< Events passed to OnEvent.  Empty means every event.
 
   public:
                           Component    ();
     virtual               ~Component   ();
 
+                          /// @brief  Components are allocated from the SlabAllocator's kComponent pools.
+    static  VOID *        operator new (size_t  uSizeIn)         {return SlabAllocator::Allocate (SlabAllocator::kComponent, uSizeIn);};
+
+    static  VOID          operator delete (VOID *  pIn,
+                                           size_t  uSizeIn)      {SlabAllocator::Free (pIn, uSizeIn);};
+
             const char *  Type         (VOID) const              {return strType.AsChar ();};
 
     virtual Component *   GetInterface (const char *  szTypeIn)  {return NULL;};
 
+                                       /** @brief  Get the ID of this component's type in Types ().
+                                           @return The type ID.
+                                       */
+            INT           TypeID       (VOID)                    {if (iTypeID == TypeRegistry::kInvalidID) {iTypeID = Types ().Register (strType.AsChar ());};
+                                                                  return iTypeID;};
+
+                                       /** @brief  Look up an interface by its ID in Types ().  The GetInterface answer is cached
+                                                   per component type and interface, so every component of a type must answer
+                                                   GetInterface the same way.
+                                           @param  iInterfaceIDIn ID of the interface's identifier string.
+                                           @return The interface, or NULL if this component doesn't implement it.
+                                       */
+            Component *   GetInterfaceByID (INT  iInterfaceIDIn);
+
+                                       /** @brief  The registry that hands out IDs for component types and interface identifiers.
+                                           @return The component type registry.
+                                       */
+    static  TypeRegistry & Types       (VOID);
+
     virtual Component *   Instantiate  (VOID) const;
 
     virtual VOID          CloneAttrs   (Component *  pcmpSourceIn);
 
+                                       /** @brief  Returns the ComponentCallback flags for the callbacks this component
+                                                   overrides, so the World's dispatch lists can skip it for the rest.
+                                                   Subclasses that override any of them should return their own mask.
+                                           @return Bitmask of ComponentCallback::Mask values.  Defaults to all callbacks.
+                                       */
+    virtual UINT32        CallbackMask (VOID) const              {return ComponentCallback::kAll;};
+
+            UINT32        DispatchPass    (VOID) const           {return uDispatchPass;};
+            VOID          SetDispatchPass (UINT32  uPassIn)      {uDispatchPass = uPassIn;};
+
+                                       /** @brief  Limit OnEvent to the given event.  A component that never subscribes
+                                                   receives every event, so subclasses that override OnEvent should
+                                                   subscribe to each event they handle, usually from their constructor.
+                                           @param  uEventIn Hash of the event name.
+                                           @return None
+                                       */
+            VOID          SubscribeEvent   (HASH_T  uEventIn);
+
+                                       /** @brief  Remove an event added with SubscribeEvent.
+                                           @param  uEventIn Hash of the event name.
+                                           @return None
+                                       */
+            VOID          UnsubscribeEvent (HASH_T  uEventIn);
+
+                                       /** @brief  Test whether OnEvent should be called for the given event.
+                                           @param  uEventIn Hash of the event name.
+                                           @return True if the component subscribed to the event, or has no subscriptions.
+                                       */
+            BOOL          HandlesEvent     (HASH_T  uEventIn);
+
+            INT           NumEventSubscriptions (VOID) const     {return auEventSubscriptions.Length ();};
+
+            HASH_T        EventSubscription     (INT  iIndexIn)  {return auEventSubscriptions [iIndexIn];};
+
     static Signal0<>      sigOnUpdate;     ///< Event fired before OnUpdate for node tree.  Best used for one-time setup.
     static Signal0<>      sigOnPreUpdate;  ///< Event fired before OnPreUpdate for node tree.  Best used for one-time setup.
 
@@ -166,9 +251,32 @@ class Component
 
             Attr *        GetAttr      (const char *  szNameIn);
 
+                                       /** @brief  Find an attr by the hash of its name, without comparing strings.  If two
+                                                   attr names on this component share a hash, the first one added that is
+                                                   still present is returned, since THashIndex keeps same-key values in
+                                                   insert order.
+                                           @param  uNameHashIn CalcHashValue of the attr name.
+                                           @return The attr, or NULL if none has that name hash.
+                                       */
+            Attr *        GetAttr      (HASH_T  uNameHashIn)   {return (indexAttr.Find (uNameHashIn, NULL));};
+
     virtual Attr *        SetAttr      (const char *  szNameIn,
                                         const char *  szValueIn);
 
+                                       /** @brief  Copy the value of an attr onto this component's attr of the same name
+                                                   and type, without converting it to a string.
+                                           @param  pattrValueIn The attr holding the name and value to set.
+                                           @return The attr that was changed, or NULL if there isn't a matching attr.
+                                       */
+            Attr *        SetAttrValue (Attr *  pattrValueIn);
+
+                                       /** @brief  Called after SetAttr or SetAttrValue changes one of this component's attrs.
+                                                   Subclasses override this to react to their own attrs.
+                                           @param  pattrChangedIn The attr that changed.
+                                           @return None
+                                       */
+    virtual VOID          OnAttrChanged (Attr *  pattrChangedIn)  {};
+
     virtual Attr *        SetArrayAttr (const char *  szNameIn,
                                         INT           iIndex,
                                         const char *  szValueIn);
@@ -38,3 +38,35 @@
 #include "Debug.hpp"
 ASSERTFILE (__FILE__);
 #include "Composite/ComponentDefaultLooper.hpp"
+#include "Composite/World.hpp"
+
+//-----------------------------------------------------------------------------
+//  ComponentDefaultLooper
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+VOID  ComponentDefaultLooper::IterateNodes  (Callback  modeIn,
+                                             Node *    pnodeRootIn,
+                                             VOID *    pParamIn,
+                                             HASH_T    uEventHashIn,
+                                             INT       iMaxDepthIn,
+                                             BOOL      bVisitInactiveBaseIn)
+  {
+  // The per-frame passes over the whole scene are served from the World's
+  //  flat dispatch lists.  Partial traversals still walk the tree.
+  World *  pWorld = World::ExistingInstance ();
+  if ((pWorld != NULL) &&
+      (pnodeRootIn == pWorld->RootNode ()) &&
+      (iMaxDepthIn == INT32_MAX) &&
+      (! bVisitInactiveBaseIn))
+    {
+    pWorld->IterateComponents (modeIn, pParamIn, uEventHashIn);
+    return;
+    };
+
+  pVoidParameter = pParamIn;
+  uEventHash     = uEventHashIn;
+  bVisitInactiveBase = bVisitInactiveBaseIn;
+  SetCallbackMode (modeIn);
+  RecurseNodeTree (pnodeRootIn, TRUE, iMaxDepthIn);
+  };
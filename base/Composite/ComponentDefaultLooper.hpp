@@ -58,7 +58,8 @@ class ComponentDefaultLooper : public NodeDelegate
                    kDisplay,         // drawing to the screen / eye
                    kTriggerCollide,
                    kRecache,
-                   kEvent};
+                   kEvent,
+                   kNumCallbacks};
 
   private:
     Callback  callbackMode;
@@ -94,7 +95,24 @@ class ComponentDefaultLooper : public NodeDelegate
     virtual BOOL  VisitComponent        (Node *       pnodeIn,
                                          Component *  pcomponentIn)  override
                                            {
-                                           switch (callbackMode)
+                                           Dispatch (callbackMode, pcomponentIn, pVoidParameter, uEventHash);
+                                           return (TRUE);
+                                           };
+
+                                        /** @brief  Call the component method for the given callback.
+                                            @param  modeIn The callback to make.  kUpdate is handled per node, so it does nothing here.
+                                            @param  pcomponentIn The component to call.
+                                            @param  pParamIn Parameter passed to OnTriggerCollide.
+                                            @param  uEventHashIn Event passed to OnEvent.  Components that did not
+                                                    subscribe to it are skipped.
+                                            @return None
+                                        */
+    static VOID   Dispatch              (Callback     modeIn,
+                                         Component *  pcomponentIn,
+                                         VOID *       pParamIn,
+                                         HASH_T       uEventHashIn)
+                                           {
+                                           switch (modeIn)
                                              {
                                              case kPreUpdate:       pcomponentIn->OnPreUpdate (); break;
                                              case kPostUpdate:      pcomponentIn->OnPostUpdate (); break;
@@ -103,27 +121,30 @@ class ComponentDefaultLooper : public NodeDelegate
                                              //case kDisable:         pcomponentIn->OnDisable (); break;
                                              case kRenderStart:     pcomponentIn->OnRenderStart (); break;
                                              case kDisplay:         pcomponentIn->OnDisplay (); break;
-                                             case kTriggerCollide:  pcomponentIn->OnTriggerCollide (pVoidParameter); break;
+                                             case kTriggerCollide:  pcomponentIn->OnTriggerCollide (pParamIn); break;
                                              case kRecache:         pcomponentIn->OnRecache (); break;
-                                             case kEvent:           pcomponentIn->OnEvent (uEventHash); break;
+                                             case kEvent:           if (pcomponentIn->HandlesEvent (uEventHashIn)) {pcomponentIn->OnEvent (uEventHashIn);}; break;
                                              default: break;
                                              }
-                                           return (TRUE);
                                            };
 
+                                        /** @brief  Make the given callback on the tree under pnodeRootIn.  A full traversal
+                                                    of the World's root node uses the World's cached dispatch lists instead
+                                                    of walking the tree.
+                                            @param  modeIn The callback to make.
+                                            @param  pnodeRootIn The root of the tree to visit.
+                                            @param  pParamIn Parameter passed to OnTriggerCollide.
+                                            @param  uEventHashIn Event passed to OnEvent.
+                                            @param  iMaxDepthIn Maximum depth of the traversal.
+                                            @param  bVisitInactiveBaseIn If true, components on inactive nodes are visited too.
+                                            @return None
+                                        */
     VOID          IterateNodes          (Callback  modeIn,
                                          Node *    pnodeRootIn,
                                          VOID *    pParamIn     = NULL,
                                          HASH_T    uEventHashIn = 0,
                                          INT       iMaxDepthIn  = INT32_MAX,
-                                         BOOL      bVisitInactiveBaseIn = FALSE)
-                                           {
-                                           pVoidParameter = pParamIn;
-                                           uEventHash     = uEventHashIn;
-                                           bVisitInactiveBase = bVisitInactiveBaseIn;
-                                           SetCallbackMode (modeIn);
-                                           RecurseNodeTree (pnodeRootIn, TRUE, iMaxDepthIn);
-                                           };
+                                         BOOL      bVisitInactiveBaseIn = FALSE);
   private:
 
     VOID          SetCallbackMode       (Callback  modeIn)  {callbackMode = modeIn;};
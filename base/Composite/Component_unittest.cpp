@@ -12,6 +12,8 @@ ASSERTFILE (__FILE__)
 #include "Composite/Attr.hpp"
 #include "Composite/SceneLoader.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 
@@ -302,3 +304,113 @@ TEST (Component, SceneLoader)
 
 
 
+
+//------------------------------------------------------------------------------
+TEST (Component, HashedAttrLookup)
+  {
+  AttrTemplatesInitialize ();
+
+  TestComponent  cmpTest;
+
+  // string and hash lookups find the same attrs
+  Attr *  pattrFloat = cmpTest.GetAttr ("MyFloat");
+  ASSERT_TRUE (pattrFloat != NULL);
+  ASSERT_STREQ ("MyFloat", pattrFloat->Name ());
+  ASSERT_TRUE (cmpTest.GetAttr (CalcHashValue ("MyFloat")) == pattrFloat);
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("MyIntArray")) == cmpTest.GetAttr ("MyIntArray"));
+  ASSERT_TRUE (cmpTest.GetAttr ("NoSuchAttr") == NULL);
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("NoSuchAttr")) == NULL);
+
+  // deleted attrs leave the index, and the rest stay findable
+  cmpTest.DeleteAttr ("MyFloat");
+  ASSERT_TRUE (cmpTest.GetAttr ("MyFloat") == NULL);
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("MyFloat")) == NULL);
+  ASSERT_TRUE (cmpTest.GetAttr ("MyInt") != NULL);
+  ASSERT_TRUE (cmpTest.GetAttr ("MyString") != NULL);
+
+  // and re-adding one under the same name finds the new attr
+  Attr *  pattrNew = cmpTest.AddAttr ("MyFloat", "float");
+  ASSERT_TRUE (cmpTest.GetAttr ("MyFloat") == pattrNew);
+  ASSERT_TRUE (cmpTest.SetAttr ("MyFloat", "7.5") == pattrNew);
+  RStr  strValue;
+  ASSERT_STREQ ("7.500000", pattrNew->GetAsString (&strValue));
+
+  // "Ab" and "BB" share a name hash.  The hash lookup returns the one added
+  //  first, even after enough attrs are added to grow the index.
+  ASSERT_EQ (HASH ("Ab"), HASH ("BB"));
+  Attr *  pattrFirst  = cmpTest.AddAttr ("Ab", "int");
+  Attr *  pattrSecond = cmpTest.AddAttr ("BB", "int");
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("BB")) == pattrFirst);
+  for (INT  iExtra = 0; iExtra < 40; ++iExtra)
+    {
+    RStr  strName;
+    strName.Format ("Extra%d", iExtra);
+    cmpTest.AddAttr (strName.AsChar (), "int");
+    };
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("BB")) == pattrFirst);
+  ASSERT_TRUE (cmpTest.GetAttr ("BB")        == pattrSecond);
+  ASSERT_TRUE (cmpTest.GetAttr ("Ab")        == pattrFirst);
+  cmpTest.DeleteAttr ("Ab");
+  ASSERT_TRUE (cmpTest.GetAttr (HASH ("Ab")) == pattrSecond);
+  for (INT  iExtra = 0; iExtra < 40; ++iExtra)
+    {
+    RStr  strName;
+    strName.Format ("Extra%d", iExtra);
+    cmpTest.DeleteAttr (strName.AsChar ());
+    };
+  cmpTest.DeleteAttr ("BB");
+
+  AttrTemplatesUninitialize ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (Component, HashedAttrLookupBenchmark)
+  {
+  // a linear name walk against the hashed lookup, on the last attr added
+  if (! UnitTestBenchmarks ()) {return;};
+
+  AttrTemplatesInitialize ();
+
+  TestComponent  cmpTest;
+  cmpTest.DeleteAttr ("MyFloat");
+  cmpTest.AddAttr ("MyFloat", "float");
+
+  const INT  iNumLookups = 200000;
+  INT        iFound      = 0;
+  INT64      iStartUs    = StopWatch::GetTimeUs ();
+  for (INT  iLookup = 0; iLookup < iNumLookups; ++iLookup)
+    {
+    for (TListItr<Attr*>  itrAttr = cmpTest.FirstAttr (); itrAttr.IsValid (); ++itrAttr)
+      {
+      if (streq ((*itrAttr)->Name (), "MyFloat")) {++iFound; break;};
+      };
+    };
+  INT64  iWalkUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumLookups, iFound);
+
+  iFound   = 0;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iLookup = 0; iLookup < iNumLookups; ++iLookup)
+    {
+    if (cmpTest.GetAttr ("MyFloat") != NULL) {++iFound;};
+    };
+  INT64  iNameUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumLookups, iFound);
+
+  HASH_T  uHash = HASH ("MyFloat");
+  iFound   = 0;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iLookup = 0; iLookup < iNumLookups; ++iLookup)
+    {
+    if (cmpTest.GetAttr (uHash) != NULL) {++iFound;};
+    };
+  INT64  iHashUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumLookups, iFound);
+
+  BenchmarkPrintf ("GetAttr, 6 attrs:  list walk %7.1f ns  by name %7.1f ns  by hash %7.1f ns\n",
+                   DOUBLE (iWalkUs) * 1000.0 / DOUBLE (iNumLookups),
+                   DOUBLE (iNameUs) * 1000.0 / DOUBLE (iNumLookups),
+                   DOUBLE (iHashUs) * 1000.0 / DOUBLE (iNumLookups));
+
+  AttrTemplatesUninitialize ();
+  };
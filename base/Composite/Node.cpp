@@ -42,6 +42,12 @@ ASSERTFILE (__FILE__);
 
 static BOOL                bComponentTemplatesInitialized = FALSE;
 static TList<Component *>  listComponentTemplates;
+static TArray<Component *> apComponentTemplatesByID; ///< First template registered for each type ID, or NULL.
+
+UINT32  Node::uStructureVersion = 1;
+
+Signal1<Node*>  Node::sigOnPathChanging;
+Signal1<Node*>  Node::sigOnPathChanged;
 
 //-----------------------------------------------------------------------------
 class MarkTransformComponentsDirty : public NodeDelegate
@@ -104,6 +110,16 @@ VOID  Node::AddComponentTemplate (Component *  componentIn)
   {
   ASSERT (componentIn != NULL);
   listComponentTemplates.PushBack (componentIn);
+
+  INT  iTypeID = componentIn->TypeID ();
+  while (apComponentTemplatesByID.Length () <= iTypeID)
+    {
+    apComponentTemplatesByID.Append (NULL);
+    };
+  if (apComponentTemplatesByID [iTypeID] == NULL)
+    {
+    apComponentTemplatesByID [iTypeID] = componentIn;
+    };
   };
 
 //-----------------------------------------------------------------------------
@@ -116,6 +132,7 @@ VOID  Node::DeleteAllComponentTemplates (VOID)
     delete (*itrCurr);
     };
   listComponentTemplates.Empty ();
+  apComponentTemplatesByID.Clear ();
   };
 
 //-----------------------------------------------------------------------------
@@ -164,7 +181,10 @@ Node::Node ()
   pnodeParent = NULL;
   pcmpTransform = NULL;
   pCollider     = NULL;
+  uDispatchPass = 0;
+  uComponentTypeMask = 0;
   listComponents.MakeListSentinel ();
+  listChildren.SetPooledEntries (TRUE);
   };
 
 //-----------------------------------------------------------------------------
@@ -174,6 +194,7 @@ Node::~Node ()
   //  of the Node at the time of deletion.  This will allow unparenting during the
   //  OnDelete callback, or sending messages to its relatives in the heirarchy,
   //  or marking children for deletion as well.
+  MarkStructureChanged ();
   OnDelete ();
 
   Component *  pcmpNext;
@@ -186,6 +207,7 @@ Node::~Node ()
     pcmpCurr = pcmpNext;
     };
   listComponents.MakeListSentinel ();
+  uComponentTypeMask = 0;
 
   DeleteChildren ();
   ParentTo (NULL);
@@ -201,7 +223,7 @@ VOID  Node::DeleteChildren (VOID)
   //  our iterator's position.
   for (TListItr<Node*>  itrNode = listChildren.First ();
        itrNode.IsValid ();
-       ++itrNode)
+       )
     {
     Node *  pnodeToDelete = (*itrNode);
     ++itrNode;
@@ -235,6 +257,28 @@ Node *  Node::Clone (VOID) const
   return (pnodeNew);
   };
 
+//-----------------------------------------------------------------------------
+VOID  Node::SetName  (const char *  szNameIn)
+  {
+  SetName (szNameIn, CalcHashValue (szNameIn));
+  };
+
+//-----------------------------------------------------------------------------
+VOID  Node::SetName  (const char *  szNameIn,
+                     HASH_T        uHashIn)
+  {
+  if (pnodeParent != NULL)
+    {
+    sigOnPathChanging (this);
+    };
+  strName.Set (szNameIn);
+  strName.SetHashValue (uHashIn);
+  if (pnodeParent != NULL)
+    {
+    sigOnPathChanged (this);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 BOOL  Node::Equals  (Node *  pNodeIn)
   {
@@ -456,9 +500,12 @@ Node *  Node::FindByPath  (UINT  uFullNameHashIn,
 //-----------------------------------------------------------------------------
 VOID  Node::ParentTo  (Node *  pnodeNewParentIn)
   {
+  MarkStructureChanged ();
+
   // unparent
   if (pnodeParent != NULL)
     {
+    sigOnPathChanging (this);
     pnodeParent->listChildren.Delete (this);
 
     if (pcmpTransform != NULL)
@@ -479,46 +526,97 @@ VOID  Node::ParentTo  (Node *  pnodeNewParentIn)
       {
       pcmpTransform->SetParent (pnodeNewParentIn->pcmpTransform);
       };
+    sigOnPathChanged (this);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+Component *  Node::FindComponentTemplate  (const char *  szTypeIn)
+  {
+  return (FindComponentTemplate (Component::Types ().Find (szTypeIn)));
+  };
+
+//-----------------------------------------------------------------------------
+Component *  Node::FindComponentTemplate  (INT  iTypeIDIn)
+  {
+  if ((iTypeIDIn < 0) || (iTypeIDIn >= apComponentTemplatesByID.Length ()))
+    {
+    return (NULL);
     };
+  return (apComponentTemplatesByID [iTypeIDIn]);
   };
 
 //-----------------------------------------------------------------------------
 Component *  Node::AddComponent  (const char *  szTypeIn)
   {
-  for (TListItr<Component*> itrCurr = listComponentTemplates.First ();
-       itrCurr.IsValid ();
-       ++itrCurr)
+  Component *  pcmpTemplate = FindComponentTemplate (szTypeIn);
+  if (pcmpTemplate == NULL)
     {
-    if (streq ((*itrCurr)->Type (), szTypeIn))
-      {
-      Component *  pcmpNew = (*itrCurr)->Instantiate ();
-      listComponents.InsertBefore (pcmpNew);
-      pcmpNew->SetParentNode ((PVOID) this, Name());
+    // unable to find component type in template list.
+    DBG_ERROR ("Unable to find component type \"%s\" in component template list.", szTypeIn);
+    return (NULL);
+    };
+  return (AddComponent (pcmpTemplate));
+  };
 
-      Component *  pcmpInterface = pcmpNew->GetInterface (TransformComponent::Identifier ());
-      if (pcmpInterface != NULL)
-        {
-        pcmpTransform = dynamic_cast<TransformComponent *>(pcmpInterface);
+//-----------------------------------------------------------------------------
+Component *  Node::AddComponent  (INT  iTypeIDIn)
+  {
+  Component *  pcmpTemplate = FindComponentTemplate (iTypeIDIn);
+  if (pcmpTemplate == NULL)
+    {
+    DBG_ERROR ("Unable to find component type \"%s\" (ID %d) in component template list.", Component::Types ().Name (iTypeIDIn), iTypeIDIn);
+    return (NULL);
+    };
+  return (AddComponent (pcmpTemplate));
+  };
 
-        // Set up parenting at the transform component level
-        if ((pcmpTransform != NULL) && (pnodeParent != NULL) && (pnodeParent->pcmpTransform != NULL))
-          {
-          pcmpTransform->SetParent (pnodeParent->pcmpTransform);
-          }
-        }
+//-----------------------------------------------------------------------------
+Component *  Node::AddComponent  (const Component *  pcmpTemplateIn)
+  {
+  Component *  pcmpNew = pcmpTemplateIn->Instantiate ();
+  listComponents.InsertBefore (pcmpNew);
+  MarkStructureChanged ();
+  pcmpNew->SetParentNode ((PVOID) this, Name());
+  uComponentTypeMask |= TypeRegistry::MaskBit (pcmpNew->TypeID ());
+
+  Component *  pcmpInterface = pcmpNew->GetInterfaceByID (TransformComponent::IdentifierID ());
+  if (pcmpInterface != NULL)
+    {
+    pcmpTransform = dynamic_cast<TransformComponent *>(pcmpInterface);
 
-      return (pcmpNew);
+    // Set up parenting at the transform component level
+    if ((pcmpTransform != NULL) && (pnodeParent != NULL) && (pnodeParent->pcmpTransform != NULL))
+      {
+      pcmpTransform->SetParent (pnodeParent->pcmpTransform);
       }
     }
-  // unable to find component type in template list.
-  DBG_ERROR ("Unable to find component type \"%s\" in component template list.", szTypeIn);
-  return (NULL);
+
+  return (pcmpNew);
   };
 
 //-----------------------------------------------------------------------------
 Component *  Node::FindComponent (const char *  szTypeIn,
                                   Component *   pSearchStartIn)
   {
+  // every attached component registered its type in AddComponent, so an unknown name can't match.
+  INT  iTypeID = Component::Types ().Find (szTypeIn);
+  if (iTypeID == TypeRegistry::kInvalidID)
+    {
+    return (NULL);
+    };
+  return (FindComponent (iTypeID, pSearchStartIn));
+  };
+
+//-----------------------------------------------------------------------------
+Component *  Node::FindComponent (INT          iTypeIDIn,
+                                  Component *  pSearchStartIn)
+  {
+  if ((uComponentTypeMask & TypeRegistry::MaskBit (iTypeIDIn)) == 0)
+    {
+    return (NULL);
+    };
+
   Component *  pSearch = pSearchStartIn;
 
   if (pSearch == NULL)
@@ -528,7 +626,7 @@ Component *  Node::FindComponent (const char *  szTypeIn,
   pSearch = pSearch->Next ();
   for (; pSearch->IsValid (); pSearch = pSearch->Next ())
     {
-    if (streq (szTypeIn, pSearch->Type ()))
+    if (pSearch->TypeID () == iTypeIDIn)
       {
       // found the first component of this type, following pSearchStartIn
       return (pSearch);
@@ -541,6 +639,18 @@ Component *  Node::FindComponent (const char *  szTypeIn,
 Component *  Node::FindComponentInParents  (const char *  szTypeIn,
                                             Component *   pSearchStartIn)
   {
+  INT  iTypeID = Component::Types ().Find (szTypeIn);
+  if (iTypeID == TypeRegistry::kInvalidID)
+    {
+    return (NULL);
+    };
+  return (FindComponentInParents (iTypeID, pSearchStartIn));
+  };
+
+//-----------------------------------------------------------------------------
+Component *  Node::FindComponentInParents  (INT          iTypeIDIn,
+                                            Component *  pSearchStartIn)
+  {
   Node *  pNode = this;
   if (pSearchStartIn != NULL)
     {
@@ -551,10 +661,10 @@ Component *  Node::FindComponentInParents  (const char *  szTypeIn,
       pSearchStartIn = NULL;
       };
     };
-  Component *  pSearch = pNode->FindComponent (szTypeIn, pSearchStartIn);
+  Component *  pSearch = pNode->FindComponent (iTypeIDIn, pSearchStartIn);
   if (pSearch != NULL) {return pSearch;};
   if (pNode->pnodeParent == NULL) {return NULL;};
-  return (pNode->pnodeParent->FindComponentInParents (szTypeIn));
+  return (pNode->pnodeParent->FindComponentInParents (iTypeIDIn));
   };
 
 //-----------------------------------------------------------------------------
@@ -584,6 +694,10 @@ VOID  Node::SetActive  (BOOL  bIn)
   //  is meant to be persistent and stateful, while the components reflect a
   //  temporary state.
 
+  if (bActive != bIn)
+    {
+    MarkStructureChanged ();
+    };
   bActive = bIn;
 
   BOOL  bParentsActive = AreParentsActive ();
@@ -688,6 +802,7 @@ VOID  Node::OnDelete (VOID)
   {
 
   sigOnDelete(this);
+  MarkStructureChanged ();
 
   for (Component*  pcmpCurr = FirstComponent ();
        pcmpCurr->IsValid ();
@@ -696,7 +811,7 @@ VOID  Node::OnDelete (VOID)
     pcmpCurr->SetActive (FALSE);
     pcmpCurr->OnDelete();
     };
-  listComponents.MakeListSentinel ();
+  // the component list is left intact so the destructor can delete the components.
   };
 
 
@@ -41,6 +41,7 @@
 #include "Composite/Component.hpp"
 #include "Gfx/TransformComponent.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/SlabPool.hpp"
 
 /**
 
@@ -83,22 +84,39 @@ class Node
     Node *                pnodeParent;    ///< The parent node in the scene graph heirarchy.
     TList<Node*>          listChildren;   ///< List of children of this node in the scene graph heirarchy.
     VOID *                pCollider;      ///< Pointer to a BVolume collider used for faster lookup.  Not used directly by Node since it is in another module.
+    UINT32                uDispatchPass;  ///< Last World dispatch pass that updated this node.
+    UINT64                uComponentTypeMask; ///< TypeRegistry::MaskBit of every attached component's type, for fast FindComponent misses.
+
+    static UINT32         uStructureVersion; ///< Bumped whenever hierarchy, active state, awake state, or components change.
 
   public:
 
     Signal1<Node*>        sigOnDelete;
 
+    static Signal1<Node*> sigOnPathChanging; ///< Fired before a parented node is renamed, unparented, or reparented.
+    static Signal1<Node*> sigOnPathChanged;  ///< Fired after a node is renamed while parented, or parented to a new node.
+
 
   public:
                           Node              ();
 
                           ~Node             ();
 
+                          /// @brief  Nodes are allocated from the SlabAllocator's kNode pools.
+    static VOID *         operator new      (size_t  uSizeIn)         {return SlabAllocator::Allocate (SlabAllocator::kNode, uSizeIn);};
+
+    static VOID           operator delete   (VOID *  pIn,
+                                             size_t  uSizeIn)         {SlabAllocator::Free (pIn, uSizeIn);};
+
     Node *                Clone             (VOID) const;
 
     VOID                  DeleteChildren    (VOID);
 
-    VOID                  SetName           (const char *  szNameIn)  {strName.Set (szNameIn, TRUE);};
+    VOID                  SetName           (const char *  szNameIn);
+
+                          /// @brief  Set the name with a hash calculated earlier, such as one stored in a baked scene.
+    VOID                  SetName           (const char *  szNameIn,
+                                             HASH_T        uHashIn);
 
     const char *          Name              (VOID)                    {return strName.AsChar ();};
 
@@ -143,12 +161,28 @@ class Node
 
     Component *           AddComponent      (const char *  szTypeIn);
 
+                          /// @brief  Add a component from a template already found with FindComponentTemplate.
+    Component *           AddComponent      (const Component *  pcmpTemplateIn);
+
+                          /// @brief  Add a component by its ID in Component::Types ().
+    Component *           AddComponent      (INT  iTypeIDIn);
+
     Component *           FindComponent     (const char *  szTypeIn,
                                              Component *   pSearchStartIn = NULL);
 
+                          /// @brief  Find a component by its ID in Component::Types ().  The string version wraps this one.
+    Component *           FindComponent     (INT          iTypeIDIn,
+                                             Component *  pSearchStartIn = NULL);
+
     Component *           FindComponentInParents  (const char *  szTypeIn,
                                                    Component *   pSearchStartIn = NULL);
 
+    Component *           FindComponentInParents  (INT          iTypeIDIn,
+                                                   Component *  pSearchStartIn = NULL);
+
+                          /// @brief  TypeRegistry::MaskBit of each attached component's type.  A clear bit means no component of that type.
+    UINT64                ComponentTypeMask (VOID) const            {return uComponentTypeMask;};
+
     EStatus               Load              (RStrParser &  parserIn);
 
     EStatus               Save              (RStrParser &  parserIn,
@@ -162,6 +196,10 @@ class Node
 
     static VOID           AddComponentTemplate (Component *  componentIn);
 
+    static Component *    FindComponentTemplate (const char *  szTypeIn);
+
+    static Component *    FindComponentTemplate (INT  iTypeIDIn);
+
     static VOID           DeleteAllComponentTemplates (VOID);
 
     static const char *   GetParentName        (Component *  componentIn);
@@ -171,7 +209,7 @@ class Node
 
     BOOL                  IsAwake              (VOID) const   {return bAwake;};
 
-    VOID                  SetAwake             (BOOL  bIn)    {bAwake = bIn;};
+    VOID                  SetAwake             (BOOL  bIn)    {if (bAwake && !bIn) {MarkStructureChanged ();}; bAwake = bIn;};
 
     BOOL                  IsActive             (VOID) const   {return bActive;};
 
@@ -201,6 +239,18 @@ class Node
 
     VOID                  MarkComponentsDirty  (VOID);
 
+    UINT32                DispatchPass         (VOID) const            {return uDispatchPass;};
+
+    VOID                  SetDispatchPass      (UINT32  uPassIn)       {uDispatchPass = uPassIn;};
+
+                                               /** @brief  Note that some node's parent, active state, awake state, or component list
+                                                           changed, so cached views of the node tree must be rebuilt.
+                                                   @return None
+                                               */
+    static VOID           MarkStructureChanged (VOID)                  {++uStructureVersion;};
+
+    static UINT32         StructureVersion     (VOID)                  {return uStructureVersion;};
+
 
   private:
     VOID                  CalcFullPathInternal (RStr &   strPathOut,
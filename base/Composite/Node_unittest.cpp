@@ -8,6 +8,13 @@ ASSERTFILE (__FILE__)
 #include "Composite/Component.hpp"
 #include "Composite/Attr.hpp"
 #include "Composite/Node.hpp"
+#include "Composite/World.hpp"
+#include "Composite/ComponentDefaultLooper.hpp"
+#include "Composite/SceneLoader.hpp"
+#include "Containers/SlabPool.hpp"
+#include "Gfx/TransformComponent.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
@@ -78,6 +85,795 @@ TEST (Node, Basic)
   AttrTemplatesUninitialize ();
   };
 
+//------------------------------------------------------------------------------
+static RStr    strDispatchLog;
+static Node *  pnodeDeactivateOnCall = NULL;
+
+//------------------------------------------------------------------------------
+class DispatchLogComponent : public Component
+  {
+  public:
+                          DispatchLogComponent () {strType = "DispatchLog";};
+
+    virtual Component *   Instantiate  (VOID) const  override {return new DispatchLogComponent;};
+
+    virtual UINT32        CallbackMask (VOID) const  override {return (ComponentCallback::kPreUpdate | ComponentCallback::kRenderStart);};
+
+    virtual VOID          OnPreUpdate  (VOID)        override
+                                          {
+                                          strDispatchLog.AppendFormat ("%s,", Node::GetParentName (this));
+                                          if (pnodeDeactivateOnCall != NULL)
+                                            {
+                                            pnodeDeactivateOnCall->SetActive (FALSE);
+                                            pnodeDeactivateOnCall = NULL;
+                                            };
+                                          };
+
+    virtual VOID          OnRenderStart (VOID)       override {strDispatchLog.AppendFormat ("r%s,", Node::GetParentName (this));};
+  };
+
+//------------------------------------------------------------------------------
+class DispatchQuietComponent : public Component
+  {
+  public:
+                          DispatchQuietComponent () {strType = "DispatchQuiet";};
+
+    virtual Component *   Instantiate  (VOID) const  override {return new DispatchQuietComponent;};
+
+    virtual UINT32        CallbackMask (VOID) const  override {return ComponentCallback::kNone;};
+  };
+
+//------------------------------------------------------------------------------
+class DispatchEventComponent : public Component
+  {
+  public:
+                          DispatchEventComponent () {strType = "DispatchEvent";};
+
+    virtual Component *   Instantiate  (VOID) const  override {return new DispatchEventComponent;};
+
+    virtual UINT32        CallbackMask (VOID) const  override {return ComponentCallback::kEvent;};
+
+    virtual VOID          OnEvent      (HASH_T  hEventIn) override {strDispatchLog.AppendFormat ("%s,", Node::GetParentName (this));};
+  };
+
+//------------------------------------------------------------------------------
+static VOID  CompareDispatch  (ComponentDefaultLooper::Callback  eCallbackIn,
+                               const char *                      szExpectedIn)
+  {
+  ComponentDefaultLooper  looper;
+
+  // a depth limit forces the tree walk
+  strDispatchLog.Empty ();
+  looper.IterateNodes (eCallbackIn, World::Instance ()->RootNode (), NULL, 0, INT32_MAX - 1);
+  ASSERT_STREQ (szExpectedIn, strDispatchLog.AsChar ());
+
+  strDispatchLog.Empty ();
+  looper.IterateNodes (eCallbackIn, World::Instance ()->RootNode ());
+  ASSERT_STREQ (szExpectedIn, strDispatchLog.AsChar ());
+  };
+
+//------------------------------------------------------------------------------
+static VOID  CompareEvent  (HASH_T        uEventIn,
+                            const char *  szExpectedIn)
+  {
+  ComponentDefaultLooper  looper;
+
+  strDispatchLog.Empty ();
+  looper.IterateNodes (ComponentDefaultLooper::kEvent, World::Instance ()->RootNode (), NULL, uEventIn, INT32_MAX - 1);
+  ASSERT_STREQ (szExpectedIn, strDispatchLog.AsChar ());
+
+  strDispatchLog.Empty ();
+  looper.IterateNodes (ComponentDefaultLooper::kEvent, World::Instance ()->RootNode (), NULL, uEventIn);
+  ASSERT_STREQ (szExpectedIn, strDispatchLog.AsChar ());
+  };
+
+//------------------------------------------------------------------------------
+static Node *  CreateDispatchNode  (const char *  szPathIn,
+                                    BOOL          bActiveIn,
+                                    BOOL          bQuietIn = FALSE)
+  {
+  Node *  pNode = World::Instance ()->CreateNode (szPathIn);
+  pNode->AddComponent ("DispatchLog");
+  if (bQuietIn)
+    {
+    pNode->AddComponent ("DispatchQuiet");
+    };
+  World::Instance ()->CreateNodeFinish (pNode, bActiveIn);
+  return (pNode);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, DispatchLists)
+  {
+  Node::AddComponentTemplate (new DispatchLogComponent);
+  Node::AddComponentTemplate (new DispatchQuietComponent);
+  Node::AddComponentTemplate (new DispatchEventComponent);
+  World *  pWorld = World::Instance ();
+
+  Node *  pnodeA   = CreateDispatchNode ("|A",       TRUE);
+  Node *  pnodeA1  = CreateDispatchNode ("|A|A1",    TRUE, TRUE);
+  Node *  pnodeA2  = CreateDispatchNode ("|A|A2",    FALSE);
+  Node *  pnodeA2a = CreateDispatchNode ("|A|A2|A2a", TRUE);
+  Node *  pnodeB   = CreateDispatchNode ("|B",       TRUE);
+  Node *  pnodeB1  = CreateDispatchNode ("|B|B1",    TRUE);
+
+  // inactive subtrees are skipped, and quiet components never make it into a list
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate,   "A,A1,B,B1,");
+  CompareDispatch (ComponentDefaultLooper::kRenderStart, "rA,rA1,rB,rB1,");
+  ASSERT_EQ (4, pWorld->NumDispatched (ComponentDefaultLooper::kPreUpdate));
+  ASSERT_EQ (0, pWorld->NumDispatched (ComponentDefaultLooper::kDisplay));
+  ASSERT_EQ (5, pWorld->NumDispatched (ComponentDefaultLooper::kUpdate)); // includes the root
+
+  // the inactive node is still woken, since its parent is active
+  ASSERT_TRUE  (pnodeA2->IsAwake ());
+  ASSERT_FALSE (pnodeA2a->IsAwake ());
+
+  // the lists are only rebuilt after a change
+  UINT32  uRebuilds = pWorld->NumDispatchRebuilds ();
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate, "A,A1,B,B1,");
+  ASSERT_EQ (uRebuilds, pWorld->NumDispatchRebuilds ());
+
+  // hierarchy, active state, and component changes
+  pnodeB1->ParentTo (pnodeA1);
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate, "A,A1,B1,B,");
+  ASSERT_GT (pWorld->NumDispatchRebuilds (), uRebuilds);
+
+  pnodeA2->SetActive (TRUE);
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate, "A,A1,B1,A2,A2a,B,");
+  ASSERT_TRUE (pnodeA2a->IsAwake ());
+
+  pnodeB->AddComponent ("DispatchLog");
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate, "A,A1,B1,A2,A2a,B,B,");
+
+  // a callback that deactivates part of the tree mid-pass
+  pnodeDeactivateOnCall = pnodeA2;
+  strDispatchLog.Empty ();
+  ComponentDefaultLooper  looper;
+  looper.IterateNodes (ComponentDefaultLooper::kPreUpdate, pWorld->RootNode (), NULL, 0, INT32_MAX - 1);
+  ASSERT_STREQ ("A,A1,B1,B,B,", strDispatchLog.AsChar ());
+
+  pnodeA2->SetActive (TRUE);
+  pnodeDeactivateOnCall = pnodeA2;
+  strDispatchLog.Empty ();
+  pWorld->IterateComponents (ComponentDefaultLooper::kPreUpdate);
+  ASSERT_STREQ ("A,A1,B1,B,B,", strDispatchLog.AsChar ());
+
+  // deleting nodes
+  pWorld->DeleteNode (pnodeA);
+  CompareDispatch (ComponentDefaultLooper::kPreUpdate, "B,B,");
+
+  // events only reach subscribers and components without subscriptions, in tree order
+  pnodeB->AddComponent ("DispatchEvent")->SubscribeEvent (HASH ("Ping"));
+  Node *  pnodeC  = CreateDispatchNode ("|C",    TRUE);
+  pnodeC->AddComponent ("DispatchEvent");
+  Node *  pnodeC1 = CreateDispatchNode ("|C|C1", TRUE);
+  Component *  pcmpC1Event = pnodeC1->AddComponent ("DispatchEvent");
+  pcmpC1Event->SubscribeEvent (HASH ("Pong"));
+  pcmpC1Event->SubscribeEvent (HASH ("Ping"));
+  pcmpC1Event->SubscribeEvent (HASH ("Ping"));
+
+  ASSERT_EQ (2, pcmpC1Event->NumEventSubscriptions ());
+  ASSERT_EQ (3, pWorld->NumEventSubscribers (HASH ("Ping")));
+  ASSERT_EQ (2, pWorld->NumEventSubscribers (HASH ("Pong")));
+  ASSERT_EQ (1, pWorld->NumEventSubscribers (HASH ("Other")));
+
+  CompareEvent (HASH ("Ping"),  "B,C,C1,");
+  CompareEvent (HASH ("Pong"),  "C,C1,");
+  CompareEvent (HASH ("Other"), "C,");
+
+  pcmpC1Event->UnsubscribeEvent (HASH ("Ping"));
+  CompareEvent (HASH ("Ping"),  "B,C,");
+
+  // enough subscribers to one event to spread them over several index rebuilds
+  RStr  strExpected ("C,");
+  for (INT  iNode = 0; iNode < 80; ++iNode)
+    {
+    RStr  strPath;
+    strPath.Format ("|C|D%d", iNode);
+    Node *  pnodeD = CreateDispatchNode (strPath.AsChar (), TRUE);
+    pnodeD->AddComponent ("DispatchEvent")->SubscribeEvent (HASH ("Many"));
+    strExpected.AppendFormat ("D%d,", iNode);
+    };
+  ASSERT_EQ (81, pWorld->NumEventSubscribers (HASH ("Many")));
+  CompareEvent (HASH ("Many"), strExpected.AsChar ());
+
+  World::DestroyInstance ();
+  Node::DeleteAllComponentTemplates ();
+  };
+
+//------------------------------------------------------------------------------
+static VOID  CompareLookup  (const char *  szNameIn,
+                             const char *  szPathIn)
+  {
+  // the World's tables must find the same node as a walk of the tree
+  World *  pWorld = World::Instance ();
+  Node *   pRoot  = pWorld->RootNode ();
+
+  ASSERT_TRUE (pWorld->FindNode (szNameIn)                          == pRoot->FindByName (szNameIn));
+  ASSERT_TRUE (pWorld->FindNode (CalcHashValue (szNameIn))          == pRoot->FindByName (CalcHashValue (szNameIn)));
+  ASSERT_TRUE (pWorld->FindNode (szPathIn)                          == pRoot->FindByPath (&szPathIn [1]));
+  ASSERT_TRUE (pWorld->FindNodeByPath (szPathIn)                    == pRoot->FindByPath (&szPathIn [1]));
+  ASSERT_TRUE (pWorld->FindNodeByPath (CalcHashValue (szPathIn))    == pRoot->FindByPath (CalcHashValue (szPathIn), CalcHashValue ("|", 1)));
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, WorldLookup)
+  {
+  World *  pWorld = World::Instance ();
+
+  Node *  pnodeShire   = pWorld->CreateNode ("|Shire");
+  Node *  pnodeBaggins = pWorld->CreateNode ("|Shire|Baggins");
+  Node *  pnodeBilbo   = pWorld->CreateNode ("|Shire|Baggins|Bilbo");
+  Node *  pnodeMordor  = pWorld->CreateNode ("|Mordor");
+  Node *  pnodeTower   = pWorld->CreateNode ("|Mordor|Baggins");
+  ASSERT_EQ (5, pWorld->NumIndexedNodes ());
+
+  ASSERT_TRUE (pWorld->FindNode ("Bilbo")                 == pnodeBilbo);
+  ASSERT_TRUE (pWorld->FindNode ("|Shire|Baggins|Bilbo")  == pnodeBilbo);
+  ASSERT_TRUE (pWorld->FindNode ("Baggins")               == pnodeBaggins);
+  ASSERT_TRUE (pWorld->FindNode ("|Mordor|Baggins")       == pnodeTower);
+  ASSERT_TRUE (pWorld->FindNode ("Frodo")                 == NULL);
+  ASSERT_TRUE (pWorld->FindNode ("|Shire|Bilbo")          == NULL);
+  ASSERT_TRUE (pWorld->FindNode ("|Shire|Baggins|Bilb")   == NULL);
+  CompareLookup ("Bilbo",   "|Shire|Baggins|Bilbo");
+  CompareLookup ("Baggins", "|Mordor|Baggins");
+
+  // renaming updates the node and the paths of its children
+  pnodeShire->SetName ("Hobbiton");
+  ASSERT_TRUE (pWorld->FindNode ("Shire")                    == NULL);
+  ASSERT_TRUE (pWorld->FindNode ("|Shire|Baggins|Bilbo")     == NULL);
+  ASSERT_TRUE (pWorld->FindNode ("|Hobbiton|Baggins|Bilbo")  == pnodeBilbo);
+  CompareLookup ("Hobbiton", "|Hobbiton|Baggins|Bilbo");
+
+  // reparenting moves the subtree, and duplicate names resolve in tree order
+  pnodeMordor->ParentTo (pnodeShire);
+  pnodeBaggins->ParentTo (pnodeMordor);
+  ASSERT_TRUE (pWorld->FindNode ("|Hobbiton|Mordor|Baggins|Bilbo")  == pnodeBilbo);
+  ASSERT_TRUE (pWorld->FindNode ("Baggins")                         == pnodeTower);
+  CompareLookup ("Baggins", "|Hobbiton|Mordor|Baggins");
+
+  // Unlike the string walk, which only follows the first "Baggins", the
+  //  tables find the path through the second sibling with the same name.
+  ASSERT_TRUE (pWorld->RootNode ()->FindByPath ("Hobbiton|Mordor|Baggins|Bilbo") == NULL);
+  ASSERT_TRUE (pWorld->FindNodeByPath (CalcHashValue ("|Hobbiton|Mordor|Baggins|Bilbo")) == pnodeBilbo);
+
+  // nodes outside the world are not found
+  pnodeMordor->ParentTo (NULL);
+  ASSERT_EQ (1, pWorld->NumIndexedNodes ());
+  ASSERT_TRUE (pWorld->FindNode ("Bilbo") == NULL);
+  CompareLookup ("Bilbo", "|Mordor|Baggins|Bilbo");
+
+  pnodeMordor->ParentTo (pWorld->RootNode ());
+  ASSERT_EQ (5, pWorld->NumIndexedNodes ());
+  ASSERT_TRUE (pWorld->FindNode ("|Mordor|Baggins|Bilbo") == pnodeBilbo);
+
+  // deleting nodes
+  pWorld->DeleteNode (pnodeBaggins);
+  ASSERT_EQ (3, pWorld->NumIndexedNodes ());
+  ASSERT_TRUE (pWorld->FindNode ("Bilbo") == NULL);
+  ASSERT_TRUE (pWorld->FindNode ("|Mordor|Baggins") == pnodeTower);
+  CompareLookup ("Baggins", "|Mordor|Baggins");
+
+  pWorld->DeleteNode ("|Mordor|Baggins");
+  ASSERT_EQ (2, pWorld->NumIndexedNodes ());
+  ASSERT_TRUE (pWorld->FindNode ("Baggins") == NULL);
+
+  World::DestroyInstance ();
+  };
+
+//------------------------------------------------------------------------------
+class TestNodeFinder : public NodeFinder
+  {
+  public:
+    Node * *  ppFound;
+    BOOL      bAccept;
+
+    TestNodeFinder (const char *  szNameIn,
+                    const char *  szPathIn,
+                    Node * *      ppFoundIn,
+                    BOOL          bAcceptIn = TRUE) : NodeFinder ((szNameIn == NULL) ? 0 : CalcHashValue (szNameIn),
+                                                                  (szPathIn == NULL) ? 0 : CalcHashValue (szPathIn))
+      {
+      ppFound = ppFoundIn;
+      bAccept = bAcceptIn;
+      };
+
+    BOOL  OnFound (Node *  pNode) override
+      {
+      if (bAccept)
+        {
+        *ppFound = pNode;
+        };
+      return (bAccept);
+      };
+  };
+
+//------------------------------------------------------------------------------
+static Node *  CreateFinishedNode  (const char *  szPathIn)
+  {
+  Node *  pNode = World::Instance ()->CreateNode (szPathIn);
+  World::Instance ()->CreateNodeFinish (pNode, TRUE);
+  return (pNode);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, WorldFinders)
+  {
+  World *  pWorld = World::Instance ();
+  Node *   pnodeA = CreateFinishedNode ("|A");
+
+  // existing nodes are found right away
+  Node *  pFoundA = NULL;
+  pWorld->FindNode (new TestNodeFinder ("A", NULL, &pFoundA));
+  ASSERT_TRUE (pFoundA == pnodeA);
+  ASSERT_EQ (0, pWorld->NumPendingFinders ());
+
+  // others wait for the node to be created
+  Node *  pFoundByName  = NULL;
+  Node *  pFoundByPath  = NULL;
+  Node *  pFoundOlder   = NULL;
+  Node *  pFoundNewer   = NULL;
+  Node *  pFoundIgnored = NULL;
+  pWorld->FindNode (new TestNodeFinder ("Later", NULL,          &pFoundByName));
+  pWorld->FindNode (new TestNodeFinder (NULL,    "|A|Elsewhere", &pFoundByPath));
+  pWorld->FindNode (new TestNodeFinder ("Twice", NULL,          &pFoundOlder));
+  pWorld->FindNode (new TestNodeFinder ("Twice", "|A|Twice",    &pFoundNewer));
+  pWorld->FindNode (new TestNodeFinder ("Twice", NULL,          &pFoundIgnored, FALSE));
+  ASSERT_EQ (5, pWorld->NumPendingFinders ());
+
+  CreateFinishedNode ("|B");
+  CreateFinishedNode ("|B|Elsewhere");
+  ASSERT_EQ (5, pWorld->NumPendingFinders ());
+  ASSERT_EQ (0u, pWorld->NumResolvedFinders ());
+
+  Node *  pnodeLater = CreateFinishedNode ("|B|Later");
+  ASSERT_TRUE (pFoundByName == pnodeLater);
+  ASSERT_EQ (4, pWorld->NumPendingFinders ());
+
+  Node *  pnodeElsewhere = CreateFinishedNode ("|A|Elsewhere");
+  ASSERT_TRUE (pFoundByPath == pnodeElsewhere);
+
+  // The newest finder that accepts the node is resolved, one per node.  The
+  //  finder that declines stays pending.
+  Node *  pnodeTwice = CreateFinishedNode ("|A|Twice");
+  ASSERT_TRUE (pFoundNewer == pnodeTwice);
+  ASSERT_TRUE (pFoundOlder == NULL);
+  ASSERT_EQ (2, pWorld->NumPendingFinders ());
+
+  Node *  pnodeTwiceAgain = CreateFinishedNode ("|B|Twice");
+  ASSERT_TRUE (pFoundOlder == pnodeTwiceAgain);
+  ASSERT_TRUE (pFoundIgnored == NULL);
+  ASSERT_EQ (1, pWorld->NumPendingFinders ());
+  ASSERT_EQ (4u, pWorld->NumResolvedFinders ());
+  ASSERT_GE (pWorld->FinderResolveUs (), 0);
+
+  World::DestroyInstance ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, WorldLookupBenchmark)
+  {
+  // 50 groups of 10 panels of 100 leaves, about 50k nodes.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumGroups    = 50;
+  const INT  iNumPanels    = 10;
+  const INT  iNumLeaves    = 100;
+  const INT  iNumTreeRuns  = 200;
+  const INT  iNumIndexRuns = 200000;
+
+  World *  pWorld = World::Instance ();
+  RStr     strName;
+  for (INT  iGroup = 0; iGroup < iNumGroups; ++iGroup)
+    {
+    Node *  pnodeGroup = new Node;
+    strName.Format ("G%d", iGroup);
+    pnodeGroup->SetName (strName.AsChar ());
+    pnodeGroup->ParentTo (pWorld->RootNode ());
+    for (INT  iPanel = 0; iPanel < iNumPanels; ++iPanel)
+      {
+      Node *  pnodePanel = new Node;
+      strName.Format ("G%dP%d", iGroup, iPanel);
+      pnodePanel->SetName (strName.AsChar ());
+      pnodePanel->ParentTo (pnodeGroup);
+      for (INT  iLeaf = 0; iLeaf < iNumLeaves; ++iLeaf)
+        {
+        Node *  pnodeLeaf = new Node;
+        strName.Format ("G%dP%dL%d", iGroup, iPanel, iLeaf);
+        pnodeLeaf->SetName (strName.AsChar ());
+        pnodeLeaf->ParentTo (pnodePanel);
+        };
+      };
+    };
+  ASSERT_EQ (iNumGroups * iNumPanels * (iNumLeaves + 1) + iNumGroups, pWorld->NumIndexedNodes ());
+
+  // look up leaves spread through the scene, by name and by path hash.  Names
+  //  are looked up as strings, since this many short names share some hashes.
+  const INT  iNumProbes = 16;
+  RStr       astrNames [iNumProbes];
+  HASH_T     auPaths   [iNumProbes];
+  for (INT  iProbe = 0; iProbe < iNumProbes; ++iProbe)
+    {
+    INT  iGroup = (iProbe * 7) % iNumGroups;
+    INT  iPanel = (iProbe * 3) % iNumPanels;
+    INT  iLeaf  = (iProbe * 37) % iNumLeaves;
+    astrNames [iProbe].Format ("G%dP%dL%d", iGroup, iPanel, iLeaf);
+    strName.Format ("|G%d|G%dP%d|G%dP%dL%d", iGroup, iGroup, iPanel, iGroup, iPanel, iLeaf);
+    auPaths [iProbe] = CalcHashValue (strName.AsChar ());
+    Node *  pnodeLeaf = pWorld->FindNode (astrNames [iProbe].AsChar ());
+    ASSERT_TRUE (pnodeLeaf != NULL);
+    ASSERT_STREQ (astrNames [iProbe].AsChar (), pnodeLeaf->Name ());
+    ASSERT_TRUE (pnodeLeaf == pWorld->FindNodeByPath (auPaths [iProbe]));
+    ASSERT_TRUE (pnodeLeaf == pWorld->RootNode ()->FindByName (astrNames [iProbe].AsChar ()));
+    };
+
+  StopWatch  watch;
+  INT        iNumFound = 0;
+
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumTreeRuns; ++iRun)
+    {
+    iNumFound += (pWorld->RootNode ()->FindByName (astrNames [iRun % iNumProbes].AsChar ()) != NULL);
+    iNumFound += (pWorld->RootNode ()->FindByPath (auPaths [iRun % iNumProbes], CalcHashValue ("|", 1)) != NULL);
+    };
+  watch.Stop ();
+  INT64  iTreeUs = watch.GetElapsedUs ();
+
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumIndexRuns; ++iRun)
+    {
+    iNumFound += (pWorld->FindNode (astrNames [iRun % iNumProbes].AsChar ()) != NULL);
+    iNumFound += (pWorld->FindNodeByPath (auPaths [iRun % iNumProbes]) != NULL);
+    };
+  watch.Stop ();
+  INT64  iIndexUs = watch.GetElapsedUs ();
+  ASSERT_EQ (2 * (iNumTreeRuns + iNumIndexRuns), iNumFound);
+
+  DOUBLE  dTreeUs  = DOUBLE (iTreeUs)  / DOUBLE (2 * iNumTreeRuns);
+  DOUBLE  dIndexUs = DOUBLE (iIndexUs) / DOUBLE (2 * iNumIndexRuns);
+  BenchmarkPrintf ("World lookup, %d nodes:  tree walk %9.3f us/find  index %7.3f us/find  speedup %.1fx\n",
+                   pWorld->NumIndexedNodes (), dTreeUs, dIndexUs, dTreeUs / dIndexUs);
+
+  World::DestroyInstance ();
+  };
+
+//------------------------------------------------------------------------------
+static INT64  LoadSceneUs  (RStrParser &  parserSceneIn,
+                            INT           iExpectedNodesIn)
+  {
+  SceneLoader  loader;
+  World *      pWorld = World::Instance ();
+
+  parserSceneIn.ResetCursor ();
+  INT64  iStartUs = StopWatch::GetTimeUs ();
+  EXPECT_TRUE (loader.ReadBuffer (parserSceneIn, "|", pWorld, FALSE) == EStatus::kSuccess);
+  INT64  iElapsedUs = StopWatch::GetTimeUs () - iStartUs;
+
+  EXPECT_EQ (iExpectedNodesIn, pWorld->NumIndexedNodes ());
+  pWorld->ClearScene ();
+  EXPECT_EQ (0, pWorld->NumIndexedNodes ());
+  return (iElapsedUs);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, SceneLoadBenchmark)
+  {
+  // 40 groups of 250 nodes, each with a transform.  Without --benchmarks
+  //  a small scene is loaded once, to check the slab scopes.
+  const BOOL bTimed     = UnitTestBenchmarks ();
+  const INT  iNumGroups = bTimed ? 40 : 4;
+  const INT  iNumLeaves = bTimed ? 250 : 25;
+  const INT  iNumNodes  = iNumGroups * (iNumLeaves + 1);
+  const INT  iNumRuns   = bTimed ? 3 : 1;
+  const INT  iScope     = 0x5CE;
+
+  Node::AddComponentTemplate (new TransformComponent);
+
+  RStrParser  parserScene;
+  for (INT  iGroup = 0; iGroup < iNumGroups; ++iGroup)
+    {
+    parserScene.AppendFormat ("node: \"G%d\"\n  component: \"Transform\"\n    tx [%d.0]\n", iGroup, iGroup);
+    for (INT  iLeaf = 0; iLeaf < iNumLeaves; ++iLeaf)
+      {
+      parserScene.AppendFormat ("node: \"G%d|L%d\"\n  component: \"Transform\"\n    tx [%d.0]\n    ry [45.0]\n    sz [2.0]\n",
+                                iGroup, iLeaf, iLeaf);
+      };
+    };
+
+  SlabAllocator::Stats  statsNode;
+  SlabAllocator::Stats  statsComponent;
+  SlabAllocator::Stats  statsAttr;
+  SlabAllocator::Stats  statsEntry;
+
+  INT64  iHeapUs = 0;
+  INT64  iPoolUs = 0;
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    SlabAllocator::SetEnabled (FALSE);
+    iHeapUs += LoadSceneUs (parserScene, iNumNodes);
+    SlabAllocator::SetEnabled (TRUE);
+
+    SlabScope  scope (iScope);
+    iPoolUs += LoadSceneUs (parserScene, iNumNodes);
+    };
+
+  // every object the scene created came from its scope, and has been returned.
+  SlabAllocator::GetStats (SlabAllocator::kNode,      statsNode,      iScope);
+  SlabAllocator::GetStats (SlabAllocator::kComponent, statsComponent, iScope);
+  SlabAllocator::GetStats (SlabAllocator::kAttr,      statsAttr,      iScope);
+  SlabAllocator::GetStats (SlabAllocator::kListEntry, statsEntry,     iScope);
+  ASSERT_EQ (iNumNodes, statsNode.iPeakLive);
+  ASSERT_TRUE (statsComponent.iPeakLive >= iNumNodes);
+  ASSERT_TRUE (statsAttr.iPeakLive >= iNumNodes * 10);
+  ASSERT_TRUE (statsEntry.iPeakLive >= iNumNodes * 11);
+  ASSERT_EQ (0, statsNode.iNumLive);
+  ASSERT_EQ (0, statsComponent.iNumLive);
+  ASSERT_EQ (0, statsAttr.iNumLive);
+  ASSERT_EQ (0, statsEntry.iNumLive);
+
+  INT64  iReservedBytes = statsNode.iBytesReserved + statsComponent.iBytesReserved +
+                          statsAttr.iBytesReserved + statsEntry.iBytesReserved;
+  ASSERT_TRUE (SlabAllocator::ReleaseScope (iScope));
+  SlabAllocator::GetStats (SlabAllocator::kAttr, statsAttr, iScope);
+  ASSERT_EQ (0, statsAttr.iNumSlabs);
+
+  BenchmarkPrintf ("Scene load, %d nodes:  heap %9.3f ms  slab pools %9.3f ms  speedup %.2fx  (%lld KB of slabs released)\n",
+                   iNumNodes,
+                   DOUBLE (iHeapUs) / DOUBLE (1000 * iNumRuns),
+                   DOUBLE (iPoolUs) / DOUBLE (1000 * iNumRuns),
+                   DOUBLE (iHeapUs) / DOUBLE (iPoolUs),
+                   (long long) (iReservedBytes / 1024));
+
+  World::DestroyInstance ();
+  Node::DeleteAllComponentTemplates ();
+  };
+
+//------------------------------------------------------------------------------
+static VOID  PlainWorldMatrix  (Transform *  pTransformIn,
+                                RMatrix &    matOut)
+  {
+  // world matrix solved up the parent links, without the batch.
+  RMatrix  matLocal;
+  pTransformIn->GetLocalMatrix (matLocal);
+  if (pTransformIn->pParent == NULL)
+    {
+    matOut = matLocal;
+    return;
+    };
+  RMatrix  matParent;
+  PlainWorldMatrix (pTransformIn->pParent, matParent);
+  matOut = matParent * matLocal;
+  };
+
+//------------------------------------------------------------------------------
+static FLOAT  SceneTransformError  (Node *  pnodeIn,
+                                    INT &   iNumCheckedOut)
+  {
+  FLOAT  fMaxError = 0.0f;
+  if (pnodeIn->Transform () != NULL)
+    {
+    Transform &  trans = pnodeIn->Transform ()->transform;
+    RMatrix      matPlain;
+
+    EXPECT_TRUE (trans.GetBatch () == &World::Instance ()->Transforms ()) << pnodeIn->Name ();
+    EXPECT_FALSE (trans.bWorldDirty) << pnodeIn->Name ();
+    PlainWorldMatrix (&trans, matPlain);
+    for (INT  iElem = 0; iElem < 16; ++iElem)
+      {
+      fMaxError = RMax (fMaxError, FLOAT (fabs (trans.matWorld.fArray [iElem] - matPlain.fArray [iElem])));
+      };
+    ++iNumCheckedOut;
+    };
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild (); itrChild.IsValid (); ++itrChild)
+    {
+    FLOAT  fChildError = SceneTransformError (*itrChild, iNumCheckedOut);
+    fMaxError = RMax (fMaxError, fChildError);
+    };
+  return (fMaxError);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, SceneTransformBatch)
+  {
+  // Transforms in a loaded scene are solved by the World's batch, and match
+  //  the matrices solved one node at a time.
+  Node::AddComponentTemplate (new TransformComponent);
+
+  RStrParser  parserScene;
+  for (INT  iGroup = 0; iGroup < 4; ++iGroup)
+    {
+    parserScene.AppendFormat ("node: \"G%d\"\n  component: \"Transform\"\n    tx [%d.0]\n    ry [30.0]\n", iGroup, iGroup * 3);
+    for (INT  iLeaf = 0; iLeaf < 5; ++iLeaf)
+      {
+      parserScene.AppendFormat ("node: \"G%d|L%d\"\n  component: \"Transform\"\n    ty [%d.5]\n    rz [%d.0]\n    sx [1.5]\n",
+                                iGroup, iLeaf, iLeaf, iLeaf * 20);
+      parserScene.AppendFormat ("node: \"G%d|L%d|Tip\"\n  component: \"Transform\"\n    tz [-2.0]\n    rx [45.0]\n", iGroup, iLeaf);
+      };
+    };
+
+  World *      pWorld = World::Instance ();
+  SceneLoader  loader;
+  ASSERT_TRUE (loader.ReadBuffer (parserScene, "|", pWorld, FALSE) == EStatus::kSuccess);
+  ASSERT_EQ (44, pWorld->NumIndexedNodes ());
+
+  // the root's transform plus one per scene node.
+  ASSERT_EQ (45, pWorld->Transforms ().NumNodes ());
+  pWorld->UpdateTransforms ();
+  ASSERT_FALSE (pWorld->Transforms ().NeedsUpdate ());
+
+  INT  iNumChecked = 0;
+  ASSERT_LT (SceneTransformError (pWorld->RootNode (), iNumChecked), 0.0001f);
+  ASSERT_EQ (45, iNumChecked);
+
+  // attr changes part way down reach the descendants on the next update.
+  TransformComponent *  pcmpGroup = pWorld->FindNodeByPath ("|G2")->Transform ();
+  pcmpGroup->SetTx (-7.0f);
+  pcmpGroup->SetRy (-60.0f);
+  pcmpGroup->ApplyChanges ();
+  ASSERT_TRUE (pWorld->Transforms ().NeedsUpdate ());
+  pWorld->UpdateTransforms ();
+  iNumChecked = 0;
+  ASSERT_LT (SceneTransformError (pWorld->RootNode (), iNumChecked), 0.0001f);
+
+  // deleted nodes leave the batch, and reparented ones move with their new parent.
+  pWorld->DeleteNode ("|G1");
+  pWorld->FindNodeByPath ("|G3|L0")->ParentTo (pWorld->FindNodeByPath ("|G2|L4"));
+  pWorld->UpdateTransforms ();
+  ASSERT_EQ (34, pWorld->Transforms ().NumNodes ());
+  iNumChecked = 0;
+  ASSERT_LT (SceneTransformError (pWorld->RootNode (), iNumChecked), 0.0001f);
+  ASSERT_EQ (34, iNumChecked);
+
+  pWorld->ClearScene ();
+  ASSERT_EQ (1, pWorld->Transforms ().NumNodes ());
+
+  World::DestroyInstance ();
+  Node::DeleteAllComponentTemplates ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, ComponentTypeIDs)
+  {
+  AttrTemplatesInitialize ();
+
+  // the registry itself
+  TypeRegistry  registry;
+  ASSERT_EQ (0, registry.Register ("alpha"));
+  ASSERT_EQ (1, registry.Register ("beta"));
+  ASSERT_EQ (0, registry.Register ("alpha"));
+  ASSERT_EQ (1, registry.Find ("beta"));
+  ASSERT_EQ (TypeRegistry::kInvalidID, registry.Find ("gamma"));
+  ASSERT_STREQ ("beta", registry.Name (1));
+  ASSERT_STREQ ("", registry.Name (2));
+  ASSERT_EQ (2, registry.Size ());
+
+  // component templates are registered and can be found by ID
+  Node::AddComponentTemplate (new TransformComponent);
+  Node::AddComponentTemplate (new DispatchLogComponent);
+  Node::AddComponentTemplate (new DispatchQuietComponent);
+
+  INT  iLogID   = Component::Types ().Find ("DispatchLog");
+  INT  iQuietID = Component::Types ().Find ("DispatchQuiet");
+  ASSERT_NE (TypeRegistry::kInvalidID, iLogID);
+  ASSERT_NE (TypeRegistry::kInvalidID, iQuietID);
+  ASSERT_STREQ ("DispatchLog", Node::FindComponentTemplate (iLogID)->Type ());
+  ASSERT_TRUE (Node::FindComponentTemplate (iLogID) == Node::FindComponentTemplate ("DispatchLog"));
+
+  Node *  pnodeParent = new Node;
+  Node *  pnodeChild  = new Node;
+  pnodeParent->SetName ("Parent");
+  pnodeChild->SetName ("Child");
+  pnodeChild->ParentTo (pnodeParent);
+
+  Component *  pcmpLog = pnodeParent->AddComponent (iLogID);
+  ASSERT_TRUE (pcmpLog != NULL);
+  ASSERT_EQ (iLogID, pcmpLog->TypeID ());
+  pnodeParent->AddComponent ("Transform");
+  ASSERT_TRUE (pnodeParent->Transform () != NULL);
+
+  // ID and string lookups agree, and the mask rejects types that aren't attached
+  ASSERT_TRUE (pnodeParent->FindComponent (iLogID) == pcmpLog);
+  ASSERT_TRUE (pnodeParent->FindComponent ("DispatchLog") == pcmpLog);
+  ASSERT_TRUE (pnodeParent->FindComponent (iQuietID) == NULL);
+  ASSERT_TRUE ((pnodeParent->ComponentTypeMask () & TypeRegistry::MaskBit (iLogID)) != 0);
+  ASSERT_TRUE ((pnodeParent->ComponentTypeMask () & TypeRegistry::MaskBit (iQuietID)) == 0);
+  ASSERT_EQ (0, pnodeChild->ComponentTypeMask ());
+
+  // string lookups of unknown types don't register them
+  ASSERT_TRUE (pnodeParent->FindComponent ("NoSuchComponent") == NULL);
+  ASSERT_EQ (TypeRegistry::kInvalidID, Component::Types ().Find ("NoSuchComponent"));
+  ASSERT_TRUE (pnodeParent->AddComponent ("NoSuchComponent") == NULL);
+
+  ASSERT_TRUE (pnodeChild->FindComponent (iLogID) == NULL);
+  ASSERT_TRUE (pnodeChild->FindComponentInParents (iLogID) == pcmpLog);
+  ASSERT_TRUE (pnodeChild->FindComponentInParents ("DispatchLog") == pcmpLog);
+
+  // interfaces by ID, asked twice so the cached answer is used the second time
+  Component *  pcmpTransform = pnodeParent->Transform ();
+  for (INT  iPass = 0; iPass < 2; ++iPass)
+    {
+    ASSERT_TRUE (pcmpTransform->GetInterfaceByID (TransformComponent::IdentifierID ()) == pcmpTransform);
+    ASSERT_TRUE (pcmpLog->GetInterfaceByID (TransformComponent::IdentifierID ()) == NULL);
+    };
+
+  delete pnodeParent;
+
+  // attr types
+  INT  iFloatID = Attr::Types ().Find ("float");
+  ASSERT_NE (TypeRegistry::kInvalidID, iFloatID);
+  Attr *  pattrFloat = Attr::New ("speed", iFloatID);
+  ASSERT_TRUE (pattrFloat != NULL);
+  ASSERT_STREQ ("float", pattrFloat->Type ());
+  ASSERT_STREQ ("speed", pattrFloat->Name ());
+  delete pattrFloat;
+  ASSERT_TRUE (Attr::New ("speed", "nosuchtype") == NULL);
+  ASSERT_TRUE (Attr::New ("speed", TypeRegistry::kInvalidID) == NULL);
+
+  Node::DeleteAllComponentTemplates ();
+  ASSERT_TRUE (Node::FindComponentTemplate (iLogID) == NULL);
+  AttrTemplatesUninitialize ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (Node, FindComponentBenchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumFinds = 200000;
+
+  Node::AddComponentTemplate (new TransformComponent);
+  Node::AddComponentTemplate (new DispatchLogComponent);
+  Node::AddComponentTemplate (new DispatchQuietComponent);
+  Node::AddComponentTemplate (new DispatchEventComponent);
+
+  Node  node;
+  node.AddComponent ("Transform");
+  node.AddComponent ("DispatchQuiet");
+  node.AddComponent ("DispatchEvent");
+
+  INT  iHitID  = Component::Types ().Find ("DispatchEvent");
+  INT  iMissID = Component::Types ().Find ("DispatchLog");
+  INT  iFound  = 0;
+
+  // the string compare walk FindComponent used before type IDs
+  INT64  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFind = 0; iFind < iNumFinds; ++iFind)
+    {
+    const char *  szType = (iFind & 1) ? "DispatchEvent" : "DispatchLog";
+    for (Component *  pSearch = node.FirstComponent (); pSearch->IsValid (); pSearch = pSearch->Next ())
+      {
+      if (streq (szType, pSearch->Type ())) {++iFound; break;};
+      };
+    };
+  INT64  iStreqUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumFinds / 2, iFound);
+
+  iFound = 0;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFind = 0; iFind < iNumFinds; ++iFind)
+    {
+    if (node.FindComponent ((iFind & 1) ? "DispatchEvent" : "DispatchLog") != NULL) {++iFound;};
+    };
+  INT64  iStringUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumFinds / 2, iFound);
+
+  iFound = 0;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFind = 0; iFind < iNumFinds; ++iFind)
+    {
+    if (node.FindComponent ((iFind & 1) ? iHitID : iMissID) != NULL) {++iFound;};
+    };
+  INT64  iIDUs = StopWatch::GetTimeUs () - iStartUs;
+  ASSERT_EQ (iNumFinds / 2, iFound);
+
+  BenchmarkPrintf ("FindComponent, 3 components:  streq walk %7.1f ns/find  by name %7.1f ns/find  by ID %7.1f ns/find\n",
+                   DOUBLE (iStreqUs)  * 1000.0 / DOUBLE (iNumFinds),
+                   DOUBLE (iStringUs) * 1000.0 / DOUBLE (iNumFinds),
+                   DOUBLE (iIDUs)     * 1000.0 / DOUBLE (iNumFinds));
+
+  Node::DeleteAllComponentTemplates ();
+  };
+
 
   // TODO:  AttrFloatArray, AttrIntArray, AttrStringArray
   // TODO:  Node, SceneLoader,
@@ -0,0 +1,362 @@
+/* -----------------------------------------------------------------
+                            Scene Baker
+
+     This module converts text scene files into a binary form that
+   can be loaded without any text parsing, and loads that binary
+   form back into a World.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Composite/SceneBaker.hpp"
+#include "Composite/SceneLoader.hpp"
+#include "Composite/AttrBinarySerializer.hpp"
+#include "Sys/FilePath.hpp"
+#include "Containers/TArray.hpp"
+
+//-----------------------------------------------------------------------------
+//  SceneBaker
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+SceneBaker::SceneBaker  ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+SceneBaker::~SceneBaker ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+UINT32  SceneBaker::InternString  (const char *  szIn)
+  {
+  HASH_T  uHash = CalcHashValue (szIn);
+
+  for (INT  iSlot = indexStrings.FindFirst (uHash); iSlot != -1; iSlot = indexStrings.FindNext (uHash, iSlot))
+    {
+    INT  iIndex = indexStrings.GetAt (iSlot);
+    if (astrStrings [iIndex] == szIn)
+      {
+      return (UINT32 (iIndex));
+      };
+    };
+
+  INT  iIndex = astrStrings.Length ();
+  astrStrings.Append (RStr (szIn, TRUE));
+  indexStrings.Insert (uHash, iIndex);
+  return (UINT32 (iIndex));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  SceneBaker::BakeBuffer  (RStrParser &  parserTextIn,
+                                  RStrParser &  parserBakedOut)
+  {
+  // load the text into a private world, so the baked tree only holds the scene's nodes.
+  World        worldBake;
+  SceneLoader  loader;
+
+  EStatus  status = loader.ReadBuffer (parserTextIn, "|", &worldBake, FALSE);
+  if (status != EStatus::kSuccess)
+    {
+    return (status);
+    };
+  return (BakeTree (worldBake.RootNode (), parserBakedOut));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  SceneBaker::BakeTree  (Node *        pnodeRootIn,
+                                RStrParser &  parserBakedOut)
+  {
+  astrStrings.Clear ();
+  indexStrings.Clear ();
+
+  // nodes are written first, since that is where the strings are interned.
+  RStrParser  parserNodes;
+  UINT32      uNumNodes = 0;
+
+  // the node block is built a few bytes at a time, so grow it in large steps rather than the default 128 bytes.
+  parserNodes.SetGrowIncrement (kBakeGrowIncrement);
+  parserBakedOut.SetGrowIncrement (kBakeGrowIncrement);
+
+  for (TListItr<Node*>  itrChild = pnodeRootIn->FirstChild (); itrChild.IsValid (); ++itrChild)
+    {
+    EStatus  status = BakeNode (*itrChild, kNoParent, uNumNodes, parserNodes);
+    if (status != EStatus::kSuccess)
+      {
+      return (status);
+      };
+    };
+
+  parserBakedOut.SetU4_LEnd (MAKE_FOUR_CODE("SCNB"));
+  INT  iSizeLocation = parserBakedOut.GetCursorStart ();
+  parserBakedOut.SetU4_LEnd (0);  // reserve a location for the total size
+  parserBakedOut.SetU4_LEnd (kVersion);
+
+  parserBakedOut.SetU4_LEnd (MAKE_FOUR_CODE("STRT"));
+  INT  iStringsLocation = parserBakedOut.GetCursorStart ();
+  parserBakedOut.SetU4_LEnd (0);
+  parserBakedOut.SetU4_LEnd (astrStrings.Length ());
+  for (INT  iIndex = 0; iIndex < astrStrings.Length (); ++iIndex)
+    {
+    RStr &  strCurr = astrStrings [iIndex];
+    parserBakedOut.SetU4_LEnd (strCurr.GetHash ());
+    parserBakedOut.SetU4_LEnd (strCurr.Length ());
+    parserBakedOut.SetData    ((const unsigned char *) strCurr.AsChar (), strCurr.Length ());
+    };
+  INT  iStringsEnd = parserBakedOut.GetCursorStart ();
+  parserBakedOut.SetCursorStart (iStringsLocation);
+  parserBakedOut.SetU4_LEnd (iStringsEnd - iStringsLocation - sizeof (INT32));
+  parserBakedOut.SetCursorStart (iStringsEnd);
+
+  parserBakedOut.SetU4_LEnd (MAKE_FOUR_CODE("NODS"));
+  parserBakedOut.SetU4_LEnd (sizeof (UINT32) + parserNodes.Length ());
+  parserBakedOut.SetU4_LEnd (uNumNodes);
+  parserBakedOut.SetData    ((const unsigned char *) parserNodes.AsChar (), parserNodes.Length ());
+
+  // now that we know how much data we saved, we can store it in the block header
+  INT  iEndPos = parserBakedOut.GetCursorStart ();
+  parserBakedOut.SetCursorStart (iSizeLocation);
+  parserBakedOut.SetU4_LEnd (iEndPos - iSizeLocation - sizeof (INT32));
+  parserBakedOut.SetCursorStart (iEndPos);
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  SceneBaker::BakeNode  (Node *        pnodeIn,
+                                UINT32        uParentIndexIn,
+                                UINT32 &      uNumNodesInOut,
+                                RStrParser &  parserNodesOut)
+  {
+  UINT32  uNodeIndex = uNumNodesInOut++;
+
+  parserNodesOut.SetU4_LEnd (uParentIndexIn);
+  parserNodesOut.SetU4_LEnd (InternString (pnodeIn->Name ()));
+  parserNodesOut.SetU1_LEnd (pnodeIn->IsActive () ? 1 : 0);
+
+  INT  iCountLocation = parserNodesOut.GetCursorStart ();
+  parserNodesOut.SetU4_LEnd (0);
+
+  AttrBinarySerializer  serializer;
+  RStr                  strValue;
+  RStr                  strDefault;
+  UINT32                uNumComponents = 0;
+
+  for (Component *  pcmpCurr = pnodeIn->FirstComponent (); pcmpCurr->IsValid (); pcmpCurr = pcmpCurr->Next ())
+    {
+    Component *  pcmpTemplate = Node::FindComponentTemplate (pcmpCurr->Type ());
+    if (pcmpTemplate == NULL)
+      {
+      return (EStatus::Failure ("SceneBaker: No template for component type \"%s\"", pcmpCurr->Type ()));
+      };
+
+    // only the attrs that loading changed from their defaults need to be stored.
+    TList<Attr*>  listChanged;
+    for (TListItr<Attr*>  itrAttr = pcmpCurr->FirstAttr (); itrAttr.IsValid (); ++itrAttr)
+      {
+      Attr *  pattrDefault = pcmpTemplate->GetAttr ((*itrAttr)->Name ());
+
+      strValue.Empty ();
+      (*itrAttr)->GetAsString (&strValue);
+      if (pattrDefault != NULL)
+        {
+        strDefault.Empty ();
+        pattrDefault->GetAsString (&strDefault);
+        if (strValue == strDefault) continue;
+        };
+      listChanged.PushBack (*itrAttr);
+      };
+
+    parserNodesOut.SetU4_LEnd (InternString (pcmpCurr->Type ()));
+    serializer.SaveList (parserNodesOut, &listChanged);
+    ++uNumComponents;
+    };
+
+  INT  iEndPos = parserNodesOut.GetCursorStart ();
+  parserNodesOut.SetCursorStart (iCountLocation);
+  parserNodesOut.SetU4_LEnd (uNumComponents);
+  parserNodesOut.SetCursorStart (iEndPos);
+
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild (); itrChild.IsValid (); ++itrChild)
+    {
+    EStatus  status = BakeNode (*itrChild, uNodeIndex, uNumNodesInOut, parserNodesOut);
+    if (status != EStatus::kSuccess)
+      {
+      return (status);
+      };
+    };
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  SceneBaker::ReadFile  (const char *  szFilenameIn,
+                                const char *  szHeirarchyPrefixIn,
+                                World *       pwldWorldIn)
+  {
+  if (! FilePath::FileExists (szFilenameIn))
+    {
+    return (EStatus::Failure (RStr("File does not exist: ") + szFilenameIn));
+    };
+
+  RStrParser  parserBuffer;
+  EStatus     status = parserBuffer.ReadFromFile (szFilenameIn);
+  if (status != EStatus::kSuccess)
+    {
+    return (status);
+    };
+  return (ReadBuffer (parserBuffer, szHeirarchyPrefixIn, pwldWorldIn));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  SceneBaker::ReadBuffer  (RStrParser &  parserBakedIn,
+                                  const char *  szHeirarchyPrefixIn,
+                                  World *       pwldWorldIn)
+  {
+  if ((parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("SCNB")) ||
+      (parserBakedIn.GetU4_LEnd () == 0))
+    {
+    return (EStatus::Failure ("SceneBaker: Buffer is not a baked scene."));
+    };
+  UINT32  uVersion = parserBakedIn.GetU4_LEnd ();
+  if (uVersion != kVersion)
+    {
+    return (EStatus::Failure ("SceneBaker: Baked scene is version %d.  Expected version %d.", uVersion, kVersion));
+    };
+
+  // string table.  Names keep the hashes calculated at bake time, and component
+  //  types are resolved to their templates once per string.
+  if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("STRT"))
+    {
+    return (EStatus::Failure ("SceneBaker: Missing string table."));
+    };
+  parserBakedIn.GetU4_LEnd ();
+  UINT32  uNumStrings = parserBakedIn.GetU4_LEnd ();
+
+  RStrArray             astrTable;
+  TArray<Component *>   apTemplates;
+  astrTable.SetMinLength (uNumStrings);
+  apTemplates.SetMinLength (uNumStrings);
+  for (UINT32  uIndex = 0; uIndex < uNumStrings; ++uIndex)
+    {
+    HASH_T  uHash   = parserBakedIn.GetU4_LEnd ();
+    UINT32  uLength = parserBakedIn.GetU4_LEnd ();
+    parserBakedIn.GetData (&astrTable [uIndex], uLength);
+    astrTable [uIndex].SetHashValue (uHash);
+    apTemplates [uIndex] = NULL;
+    };
+
+  if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("NODS"))
+    {
+    return (EStatus::Failure ("SceneBaker: Missing node block."));
+    };
+  parserBakedIn.GetU4_LEnd ();
+  UINT32  uNumNodes = parserBakedIn.GetU4_LEnd ();
+
+  // find the node the scene is attached under.
+  Node *  pnodePrefix = pwldWorldIn->RootNode ();
+  RStr    strPrefix (szHeirarchyPrefixIn);
+  if (strPrefix.EndsWith ("|"))
+    {
+    strPrefix.TruncateRight (strPrefix.Length () - 2);
+    };
+  if (!strPrefix.IsEmpty ())
+    {
+    pnodePrefix = pwldWorldIn->FindNodeByPath (strPrefix.AsChar ());
+    if (pnodePrefix == NULL)
+      {
+      DBG_ERROR ("SceneBaker::ReadBuffer () - Unable to find parent path \"%s\"", strPrefix.AsChar ());
+      pnodePrefix = pwldWorldIn->RootNode ();
+      };
+    };
+
+  AttrBinarySerializer  serializer;
+  TArray<Node *>        apNodes;
+  apNodes.SetMinLength (uNumNodes);
+
+  for (UINT32  uNode = 0; uNode < uNumNodes; ++uNode)
+    {
+    UINT32  uParent = parserBakedIn.GetU4_LEnd ();
+    UINT32  uName   = parserBakedIn.GetU4_LEnd ();
+    BOOL    bActive = (parserBakedIn.GetU1_LEnd () != 0);
+
+    if ((uName >= uNumStrings) || ((uParent != kNoParent) && (uParent >= uNode)))
+      {
+      return (EStatus::Failure ("SceneBaker: Node %d has a bad name or parent index.", uNode));
+      };
+
+    Node *  pnodeNew = new Node;
+    pnodeNew->SetName (astrTable [uName].AsChar (), astrTable [uName].GetHash ());
+    pnodeNew->ParentTo ((uParent == kNoParent) ? pnodePrefix : apNodes [uParent]);
+    apNodes [uNode] = pnodeNew;
+
+    UINT32  uNumComponents = parserBakedIn.GetU4_LEnd ();
+    for (UINT32  uComponent = 0; uComponent < uNumComponents; ++uComponent)
+      {
+      UINT32  uType = parserBakedIn.GetU4_LEnd ();
+      if (uType >= uNumStrings)
+        {
+        return (EStatus::Failure ("SceneBaker: Node %s has a bad component type index.", pnodeNew->Name ()));
+        };
+      if (apTemplates [uType] == NULL)
+        {
+        apTemplates [uType] = Node::FindComponentTemplate (astrTable [uType].AsChar ());
+        if (apTemplates [uType] == NULL)
+          {
+          return (EStatus::Failure ("SceneBaker: Unable to find component type \"%s\"", astrTable [uType].AsChar ()));
+          };
+        };
+
+      Component *   pcmpNew = pnodeNew->AddComponent (apTemplates [uType]);
+      TList<Attr*>  listValues;
+
+      pcmpNew->SetLoading (TRUE);
+      EStatus  status = serializer.LoadList (parserBakedIn, &listValues);
+      for (TListItr<Attr*>  itrAttr = listValues.First (); itrAttr.IsValid (); ++itrAttr)
+        {
+        pcmpNew->SetAttrValue (*itrAttr);
+        delete (*itrAttr);
+        };
+      pcmpNew->SetLoading (FALSE);
+
+      if (status != EStatus::kSuccess)
+        {
+        return (status);
+        };
+      };
+
+    pwldWorldIn->CreateNodeFinish (pnodeNew, bActive);
+    };
+  return (EStatus::kSuccess);
+  };
@@ -0,0 +1,139 @@
+/* -----------------------------------------------------------------
+                            Scene Baker
+
+     This module converts text scene files into a binary form that
+   can be loaded without any text parsing, and loads that binary
+   form back into a World.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SCENEBAKER_HPP
+#define SCENEBAKER_HPP
+
+#include "Sys/Types.hpp"
+#include "Util/RStr.hpp"
+#include "Util/RStrParser.hpp"
+#include "Containers/RStrArray.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Composite/Node.hpp"
+#include "Composite/World.hpp"
+
+/**
+  Baked scene layout.  All values are little endian, and blocks follow the
+  IFF style used by AttrBinarySerializer (four code, then byte size).
+
+    SCNB  size
+      version
+      STRT  size
+        count
+        (hash, length, chars) per string
+      NODS  size
+        count
+        per node, in pre-order:
+          parent index  (kNoParent for nodes attached to the load prefix)
+          name string index
+          active flag (1 byte)
+          component count
+          per component:
+            type string index
+            AATR block from AttrBinarySerializer::SaveList
+
+  Only attrs that differ from the component template are stored.  Value
+  registry entries and anim clips in the text file are not baked.
+  */
+
+//-----------------------------------------------------------------------------
+class SceneBaker
+  {
+  public:
+    static const UINT32  kVersion           = 3;
+    static const UINT32  kNoParent          = 0xffffffff;
+    static const UINT32  kBakeGrowIncrement = 64 * 1024;  ///< buffer growth step while baking
+
+  private:
+    RStrArray          astrStrings;   ///< Interned strings, with their hashes calculated.
+    THashIndex<INT>    indexStrings;  ///< Hash of each interned string to its index in astrStrings.
+
+  private:
+
+    UINT32   InternString           (const char *    szIn);
+
+    EStatus  BakeNode               (Node *          pnodeIn,
+                                     UINT32          uParentIndexIn,
+                                     UINT32 &        uNumNodesInOut,
+                                     RStrParser &    parserNodesOut);
+
+  public:
+
+             SceneBaker             ();
+
+             ~SceneBaker            ();
+
+                                    /** @brief  Load a text scene and bake it.
+                                        @param  parserTextIn The text scene, as read by SceneLoader.
+                                        @param  parserBakedOut Receives the baked scene.
+                                        @return Success, or the text loader's failure.
+                                    */
+    EStatus  BakeBuffer             (RStrParser &    parserTextIn,
+                                     RStrParser &    parserBakedOut);
+
+                                    /** @brief  Bake the children of a node, and everything below them.
+                                        @param  pnodeRootIn The node whose children are baked.  The node itself is not.
+                                        @param  parserBakedOut Receives the baked scene.
+                                        @return Success or failure.
+                                    */
+    EStatus  BakeTree               (Node *          pnodeRootIn,
+                                     RStrParser &    parserBakedOut);
+
+                                    /** @brief  Load a baked scene file.
+                                        @param  szFilenameIn The file written from a BakeBuffer or BakeTree result.
+                                        @param  szHeirarchyPrefixIn Path of the node the scene is attached under, such as "|".
+                                        @param  pwldWorldIn The world to create the nodes in.
+                                        @return Success or failure.
+                                    */
+    EStatus  ReadFile               (const char *    szFilenameIn,
+                                     const char *    szHeirarchyPrefixIn,
+                                     World *         pwldWorldIn);
+
+                                    /** @brief  Load a baked scene from memory.
+                                        @param  parserBakedIn The baked scene.  Reading starts at the cursor.
+                                        @param  szHeirarchyPrefixIn Path of the node the scene is attached under, such as "|".
+                                        @param  pwldWorldIn The world to create the nodes in.
+                                        @return Success or failure.
+                                    */
+    EStatus  ReadBuffer             (RStrParser &    parserBakedIn,
+                                     const char *    szHeirarchyPrefixIn,
+                                     World *         pwldWorldIn);
+  };
+
+#endif // SCENEBAKER_HPP
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Composite/Component.hpp"
+#include "Composite/Node.hpp"
+#include "Composite/World.hpp"
+#include "Composite/SceneLoader.hpp"
+#include "Composite/SceneBaker.hpp"
+#include "Gfx/TransformComponent.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
+
+
+// NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
+
+//------------------------------------------------------------------------------
+class BakeTestComponent : public Component
+  {
+  public:
+    AttrFloat *           pattrSpeed;
+    FLOAT                 fCachedSpeed;  ///< Updated from OnAttrChanged, to show the hook runs for baked loads.
+
+  public:
+                          BakeTestComponent ()                                {
+                                                                              strType = "baketest";
+                                                                              pattrSpeed = AddAttrFloat ("speed");
+                                                                              pattrSpeed->Set (1.0f);
+                                                                              fCachedSpeed = 1.0f;
+                                                                              AddAttr ("count",  "int")->SetByString ("3");
+                                                                              AddAttr ("label",  "string")->SetByString ("none");
+                                                                              AddAttr ("tags",   "stringarray");
+                                                                              AddAttr ("weights","floatarray");
+                                                                              AddAttr ("ids",    "intarray");
+                                                                              };
+
+    virtual               ~BakeTestComponent ()                               {};
+
+    virtual Component *   Instantiate       (VOID) const              override {return new BakeTestComponent;};
+
+    virtual VOID          OnAttrChanged     (Attr *  pattrChangedIn)  override {if (pattrChangedIn == pattrSpeed) {fCachedSpeed = pattrSpeed->Value ();};};
+  };
+
+//------------------------------------------------------------------------------
+static VOID  DescribeTree  (Node *  pnodeIn,
+                            RStr &  strOut)
+  {
+  // a canonical dump of everything the loaders set: paths, active flags, components and attr values.
+  RStr  strPath;
+  RStr  strValue;
+
+  pnodeIn->CalcFullPath (strPath);
+  strOut.AppendFormat ("%s active=%d\n", strPath.AsChar (), pnodeIn->IsActive () ? 1 : 0);
+  for (Component *  pcmpCurr = pnodeIn->FirstComponent (); pcmpCurr->IsValid (); pcmpCurr = pcmpCurr->Next ())
+    {
+    strOut.AppendFormat ("  %s\n", pcmpCurr->Type ());
+    for (TListItr<Attr*>  itrAttr = pcmpCurr->FirstAttr (); itrAttr.IsValid (); ++itrAttr)
+      {
+      strValue.Empty ();
+      strOut.AppendFormat ("    %s = %s\n", (*itrAttr)->Name (), (*itrAttr)->GetAsString (&strValue));
+      };
+    BakeTestComponent *  pcmpTest = dynamic_cast<BakeTestComponent *>(pcmpCurr);
+    if (pcmpTest != NULL)
+      {
+      strOut.AppendFormat ("    cached speed %f\n", pcmpTest->fCachedSpeed);
+      };
+    };
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild (); itrChild.IsValid (); ++itrChild)
+    {
+    DescribeTree (*itrChild, strOut);
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (SceneBaker, RoundTrip)
+  {
+  Node::AddComponentTemplate (new TransformComponent);
+  Node::AddComponentTemplate (new BakeTestComponent);
+
+  RStrParser  parserText (
+    "// Comment line \n" \
+    "\n" \
+    "node: \"Level\"\n" \
+    "  component: \"Transform\"\n" \
+    "    tx [1.5]\n" \
+    "    ry [90.0]\n" \
+    "\n" \
+    "node: \"Level|Player\"\n" \
+    "  component: \"Transform\"\n" \
+    "    tz [-4.0]\n" \
+    "  component: \"baketest\"\n" \
+    "    speed [2.5]\n" \
+    "    count [7]\n" \
+    "    label [\"hero\"]\n" \
+    "    tags [\"a\", \"b\", \"c\"]\n" \
+    "    weights [\"0.5, 0.25\"]\n" \
+    "    ids [\"4, 5, 6\"]\n" \
+    "\n" \
+    "node: \"Level|Player|Hat\"\n" \
+    "  active: false\n" \
+    "  component: \"baketest\"\n" \
+    "\n" \
+    "node: \"Level|Enemy\"\n" \
+    "  component: \"baketest\"\n" \
+    "    label [\"hero\"]\n" \
+    "\n" \
+    "node: \"Sky\"\n" \
+    "\n");
+
+  // bake
+  SceneBaker  baker;
+  RStrParser  parserBaked;
+  ASSERT_TRUE (baker.BakeBuffer (parserText, parserBaked) == EStatus::kSuccess);
+  ASSERT_TRUE (parserBaked.Length () > 0);
+
+  // load the text and baked versions under the same prefix, and compare them.
+  World *  pWorld = World::Instance ();
+  pWorld->CreateNode ("|Text");
+  pWorld->CreateNode ("|Baked");
+
+  SceneLoader  loader;
+  parserText.ResetCursor ();
+  ASSERT_TRUE (loader.ReadBuffer (parserText, "|Text|", pWorld, FALSE) == EStatus::kSuccess);
+  parserBaked.ResetCursor ();
+  ASSERT_TRUE (baker.ReadBuffer (parserBaked, "|Baked|", pWorld) == EStatus::kSuccess);
+
+  RStr  strText;
+  RStr  strBaked;
+  DescribeTree (pWorld->FindNodeByPath ("|Text"),  strText);
+  DescribeTree (pWorld->FindNodeByPath ("|Baked"), strBaked);
+  strText.ReplaceChar ('|', '/');
+  strBaked.ReplaceChar ('|', '/');
+
+  RStr  strTextRelative  (strText);
+  RStr  strBakedRelative (strBaked);
+  strTextRelative.Replace  ("/Text",  "", TRUE);
+  strBakedRelative.Replace ("/Baked", "", TRUE);
+  ASSERT_STREQ (strTextRelative.AsChar (), strBakedRelative.AsChar ());
+
+  // spot check the loaded values, and that the baked nodes are indexed by the world.
+  Node *  pnodePlayer = pWorld->FindNodeByPath ("|Baked|Level|Player");
+  ASSERT_TRUE (pnodePlayer != NULL);
+  BakeTestComponent *  pcmpPlayer = dynamic_cast<BakeTestComponent *>(pnodePlayer->FindComponent ("baketest"));
+  ASSERT_TRUE (pcmpPlayer != NULL);
+  ASSERT_FLOAT_EQ (2.5f, pcmpPlayer->fCachedSpeed);
+  RStr  strValue;
+  ASSERT_STREQ ("\"a\", \"b\", \"c\"", pcmpPlayer->GetAttr ("tags")->GetAsString (&strValue));
+  ASSERT_TRUE (pnodePlayer->Transform () != NULL);
+  ASSERT_TRUE (pWorld->FindNodeByPath ("|Baked|Level|Player|Hat") != NULL);
+  ASSERT_FALSE (pWorld->FindNodeByPath ("|Baked|Level|Player|Hat")->IsActive ());
+
+  // names take the hash stored at bake time rather than hashing again.
+  ASSERT_EQ (RStr::CalcHash ("Player"), pnodePlayer->NameHash ());
+  ASSERT_EQ (RStr::CalcHash ("Hat"),    pWorld->FindNodeByPath ("|Baked|Level|Player|Hat")->NameHash ());
+  Node  nodeStored;
+  nodeStored.SetName ("Stored", 1234);
+  ASSERT_EQ (1234u, nodeStored.NameHash ());
+  ASSERT_STREQ ("Stored", nodeStored.Name ());
+
+  // a missing component type fails cleanly.
+  Node::DeleteAllComponentTemplates ();
+  Node::AddComponentTemplate (new TransformComponent);
+  parserBaked.ResetCursor ();
+  ASSERT_FALSE (baker.ReadBuffer (parserBaked, "|", pWorld) == EStatus::kSuccess);
+
+  // and so does a buffer that isn't a baked scene.
+  parserText.ResetCursor ();
+  ASSERT_FALSE (baker.ReadBuffer (parserText, "|", pWorld) == EStatus::kSuccess);
+
+  World::DestroyInstance ();
+  Node::DeleteAllComponentTemplates ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (SceneBaker, LoadBenchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumGroups = 20;
+  const INT  iNumLeaves = 250;
+  const INT  iNumNodes  = iNumGroups * (iNumLeaves + 1);
+  const INT  iNumRuns   = 3;
+
+  Node::AddComponentTemplate (new TransformComponent);
+  Node::AddComponentTemplate (new BakeTestComponent);
+
+  RStrParser  parserText;
+  for (INT  iGroup = 0; iGroup < iNumGroups; ++iGroup)
+    {
+    parserText.AppendFormat ("node: \"G%d\"\n  component: \"Transform\"\n    tx [%d.0]\n", iGroup, iGroup);
+    for (INT  iLeaf = 0; iLeaf < iNumLeaves; ++iLeaf)
+      {
+      parserText.AppendFormat ("node: \"G%d|L%d\"\n  component: \"Transform\"\n    tx [%d.0]\n    ry [45.0]\n" \
+                               "  component: \"baketest\"\n    speed [%d.5]\n    label [\"leaf\"]\n",
+                               iGroup, iLeaf, iLeaf, iLeaf % 7);
+      };
+    };
+
+  SceneBaker   baker;
+  SceneLoader  loader;
+  RStrParser   parserBaked;
+  ASSERT_TRUE (baker.BakeBuffer (parserText, parserBaked) == EStatus::kSuccess);
+
+  World *  pWorld = World::Instance ();
+  INT64    iTextUs  = 0;
+  INT64    iBakedUs = 0;
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    parserText.ResetCursor ();
+    INT64  iStartUs = StopWatch::GetTimeUs ();
+    ASSERT_TRUE (loader.ReadBuffer (parserText, "|", pWorld, FALSE) == EStatus::kSuccess);
+    iTextUs += StopWatch::GetTimeUs () - iStartUs;
+    ASSERT_EQ (iNumNodes, pWorld->NumIndexedNodes ());
+    pWorld->ClearScene ();
+
+    parserBaked.ResetCursor ();
+    iStartUs = StopWatch::GetTimeUs ();
+    ASSERT_TRUE (baker.ReadBuffer (parserBaked, "|", pWorld) == EStatus::kSuccess);
+    iBakedUs += StopWatch::GetTimeUs () - iStartUs;
+    ASSERT_EQ (iNumNodes, pWorld->NumIndexedNodes ());
+    pWorld->ClearScene ();
+    };
+
+  BenchmarkPrintf ("Scene load, %d nodes:  text %9.3f ms (%d bytes)  baked %9.3f ms (%d bytes)  speedup %.1fx\n",
+                   iNumNodes,
+                   DOUBLE (iTextUs)  / DOUBLE (1000 * iNumRuns), parserText.Length (),
+                   DOUBLE (iBakedUs) / DOUBLE (1000 * iNumRuns), parserBaked.Length (),
+                   DOUBLE (iTextUs) / DOUBLE (iBakedUs));
+
+  World::DestroyInstance ();
+  Node::DeleteAllComponentTemplates ();
+  };
@@ -803,6 +803,9 @@ EStatus SceneLoaderB::ReadAnimClip (RStrParser &  parserBufferIn,
       break;
       };
     };
+
+  // all the curves are in, so the clip can be baked if it or the manager asks for it.
+  AnimManager::FinishLibraryClip (pclipBase);
   return (EStatus::kSuccess);
   };
 
@@ -857,6 +860,22 @@ EStatus  SceneLoaderB::ReadAnimClipParams (RStr &          strKeyIn,
     {
     pclipCurr->SetSpeed (parserValueIn.GetFloat ());
     }
+  else if ((strKeyIn == "bakeRate") || (strKeyIn == "bakeError"))
+    {
+    // samples per second for the clip's lookup tables, or 0 to always solve the curves.
+    AnimClipCurve *  pclipCurve = dynamic_cast<AnimClipCurve *>(pclipCurr);
+    if (pclipCurve != NULL)
+      {
+      if (strKeyIn == "bakeRate")
+        {
+        pclipCurve->SetBakeRate (parserValueIn.GetFloat (), pclipCurve->GetBakeMaxError ());
+        }
+      else
+        {
+        pclipCurve->SetBakeRate (pclipCurve->GetBakeRate (), parserValueIn.GetFloat ());
+        };
+      };
+    }
   return (EStatus::kSuccess);
   };
 
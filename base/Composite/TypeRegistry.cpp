@@ -0,0 +1,102 @@
+/* -----------------------------------------------------------------
+                            Type Registry
+
+     This module hands out compact integer IDs for type names, so
+   component and attr types can be compared and indexed without
+   string compares.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Composite/TypeRegistry.hpp"
+#include "Util/CalcHash.hpp"
+
+const INT  TypeRegistry::kInvalidID;
+
+//-----------------------------------------------------------------------------
+//  TypeRegistry
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+TypeRegistry::TypeRegistry  ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+TypeRegistry::~TypeRegistry ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+INT  TypeRegistry::Register  (const char *  szNameIn)
+  {
+  INT  iID = Find (szNameIn);
+  if (iID != kInvalidID)
+    {
+    return (iID);
+    };
+
+  iID = astrNames.Length ();
+  astrNames.Append (RStr (szNameIn, TRUE));
+  indexNames.Insert (astrNames [iID].GetHash (), iID);
+  return (iID);
+  };
+
+//-----------------------------------------------------------------------------
+INT  TypeRegistry::Find  (const char *  szNameIn)
+  {
+  HASH_T  uHash = CalcHashValue (szNameIn);
+
+  for (INT  iSlot = indexNames.FindFirst (uHash); iSlot != -1; iSlot = indexNames.FindNext (uHash, iSlot))
+    {
+    INT  iID = indexNames.GetAt (iSlot);
+    if (streq (astrNames [iID].AsChar (), szNameIn))
+      {
+      return (iID);
+      };
+    };
+  return (kInvalidID);
+  };
+
+//-----------------------------------------------------------------------------
+const char *  TypeRegistry::Name  (INT  iIDIn)
+  {
+  if ((iIDIn < 0) || (iIDIn >= astrNames.Length ()))
+    {
+    return ("");
+    };
+  return (astrNames [iIDIn].AsChar ());
+  };
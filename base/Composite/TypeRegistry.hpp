@@ -0,0 +1,101 @@
+/* -----------------------------------------------------------------
+                            Type Registry
+
+     This module hands out compact integer IDs for type names, so
+   component and attr types can be compared and indexed without
+   string compares.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef TYPEREGISTRY_HPP
+#define TYPEREGISTRY_HPP
+
+#include "Sys/Types.hpp"
+#include "Util/RStr.hpp"
+#include "Containers/RStrArray.hpp"
+#include "Containers/THashIndex.hpp"
+
+/**
+  IDs are handed out in registration order starting at zero, and are never
+  reused or released, so they stay valid for as long as the registry exists.
+  This lets callers cache them and use them as array indices.
+  */
+
+//-----------------------------------------------------------------------------
+class TypeRegistry
+  {
+  public:
+    static const INT   kInvalidID = -1;
+
+  private:
+    RStrArray          astrNames;     ///< Type names, indexed by ID.
+    THashIndex<INT>    indexNames;    ///< Name hash to ID.
+
+  public:
+                       TypeRegistry   ();
+
+                       ~TypeRegistry  ();
+
+                       /** @brief  Get the ID for a type name, assigning the next free ID if the name is new.
+                           @param  szNameIn The type name.
+                           @return The type's ID.
+                       */
+    INT                Register       (const char *  szNameIn);
+
+                       /** @brief  Get the ID for a type name without registering it.
+                           @param  szNameIn The type name.
+                           @return The type's ID, or kInvalidID if the name was never registered.
+                       */
+    INT                Find           (const char *  szNameIn);
+
+                       /** @brief  Get the name a type ID was registered with.
+                           @param  iIDIn A type ID returned by Register.
+                           @return The type name, or an empty string for an unknown ID.
+                       */
+    const char *       Name           (INT  iIDIn);
+
+                       /** @brief  Query the number of registered types.
+                           @return One more than the highest ID handed out.
+                       */
+    INT                Size           (VOID) const          {return (astrNames.Length ());};
+
+                       /** @brief  Get the bit that represents a type ID in a 64 bit type mask.  IDs past 63
+                                   share bits, so a set bit only means the type may be present.
+                           @param  iIDIn A type ID returned by Register.
+                           @return The mask bit for the type.
+                       */
+    static UINT64      MaskBit        (INT  iIDIn)          {return (UINT64 (1) << (iIDIn & 63));};
+  };
+
+#endif // TYPEREGISTRY_HPP
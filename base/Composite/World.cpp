@@ -39,6 +39,7 @@
 ASSERTFILE (__FILE__);
 #include "Composite/World.hpp"
 #include "Util/CalcHash.hpp"
+#include "Sys/Timer.hpp"
 
 
 
@@ -53,22 +54,185 @@ World *  World::pInstance = NULL;
 //-----------------------------------------------------------------------------
 World::World  ()
   {
+  uDispatchVersion  = 0;
+  uDispatchPass     = 0;
+  uDispatchRebuilds = 0;
+  uNextWatchOrder   = 0;
+  uFindersResolved  = 0;
+  iFinderResolveUs  = 0;
+  apAwakeNodes.SetSizeIncrement  (256);
+  apUpdateNodes.SetSizeIncrement (256);
+  for (INT  iCallback = 0; iCallback < ComponentDefaultLooper::kNumCallbacks; ++iCallback)
+    {
+    apDispatch [iCallback].SetSizeIncrement (256);
+    };
   nodeRoot.SetActive (TRUE);
+
+  // The root carries a transform, so every node transform in the scene is
+  //  parented under it and solved by the batch.
+  TransformComponent  cmpTransformTemplate;
+  nodeRoot.AddComponent (&cmpTransformTemplate);
+  batchTransforms.AddRoot (&nodeRoot.Transform ()->transform);
+
+  Node::sigOnPathChanging.Connect (this, &World::OnNodePathChanging);
+  Node::sigOnPathChanged.Connect  (this, &World::OnNodePathChanged);
   };
 
 //-----------------------------------------------------------------------------
 World::~World  ()
   {
   ClearScene ();
+
+  Node::sigOnPathChanging.Disconnect (this, &World::OnNodePathChanging);
+  Node::sigOnPathChanged.Disconnect  (this, &World::OnNodePathChanged);
+  };
+
+//-----------------------------------------------------------------------------
+static HASH_T  PathPrefixHash  (Node *  pnodeIn,
+                                Node *  pnodeRootIn)
+  {
+  // Hash of the node's full path followed by a separator, built the same way
+  //  as Node::FindByPath(UINT) builds it while walking down the tree.
+  if ((pnodeIn == NULL) || (pnodeIn == pnodeRootIn))
+    {
+    return (CalcHashValue ("|", 1));
+    };
+  HASH_T  uHash = CalcHashValue (pnodeIn->Name (), 0, PathPrefixHash (pnodeIn->GetParent (), pnodeRootIn));
+  return (CalcHashValue ("|", 1, uHash));
+  };
+
+//-----------------------------------------------------------------------------
+static BOOL  PathMatches  (Node *        pnodeIn,
+                           Node *        pnodeRootIn,
+                           const char *  szFullPathIn,
+                           INT           iPathLengthIn)
+  {
+  // Compare the node's path against the string from the end, one name at a
+  //  time, so that hash collisions can be rejected without building the path.
+  INT  iEnd = iPathLengthIn;
+  for (Node *  pnodeCurr = pnodeIn; pnodeCurr != pnodeRootIn; pnodeCurr = pnodeCurr->GetParent ())
+    {
+    if (pnodeCurr == NULL) return (FALSE);
+
+    INT  iNameLength = (INT) strlen (pnodeCurr->Name ());
+    INT  iStart      = iEnd - iNameLength;
+    if ((iStart < 1) ||
+        (szFullPathIn [iStart - 1] != '|') ||
+        (strncmp (&szFullPathIn [iStart], pnodeCurr->Name (), iNameLength) != 0))
+      {
+      return (FALSE);
+      };
+    iEnd = iStart - 1;
+    };
+  return (iEnd == 0);
+  };
+
+//-----------------------------------------------------------------------------
+static BOOL  PrecedesInTree  (Node *  pnodeA,
+                              Node *  pnodeB)
+  {
+  // Returns TRUE if A is visited before B in a depth-first, pre-order walk
+  //  of the tree that holds them both.  Used to pick the same node as the
+  //  tree walk when several nodes share a name or path.
+  INT  iDepthA = 0;
+  INT  iDepthB = 0;
+  for (Node *  pnodeCurr = pnodeA; pnodeCurr->GetParent () != NULL; pnodeCurr = pnodeCurr->GetParent ()) {++iDepthA;};
+  for (Node *  pnodeCurr = pnodeB; pnodeCurr->GetParent () != NULL; pnodeCurr = pnodeCurr->GetParent ()) {++iDepthB;};
+
+  Node *  pnodeAncestorA = pnodeA;
+  Node *  pnodeAncestorB = pnodeB;
+  for (; iDepthA > iDepthB; --iDepthA) {pnodeAncestorA = pnodeAncestorA->GetParent ();};
+  for (; iDepthB > iDepthA; --iDepthB) {pnodeAncestorB = pnodeAncestorB->GetParent ();};
+
+  if (pnodeAncestorA == pnodeAncestorB)
+    {
+    // one is an ancestor of the other, and ancestors come first.
+    return (pnodeAncestorA == pnodeA);
+    };
+  while (pnodeAncestorA->GetParent () != pnodeAncestorB->GetParent ())
+    {
+    pnodeAncestorA = pnodeAncestorA->GetParent ();
+    pnodeAncestorB = pnodeAncestorB->GetParent ();
+    };
+  for (TListItr<Node*>  itrChild = pnodeAncestorA->GetParent ()->FirstChild ();
+       itrChild.IsValid ();
+       ++itrChild)
+    {
+    if (*itrChild == pnodeAncestorA) return (TRUE);
+    if (*itrChild == pnodeAncestorB) return (FALSE);
+    };
+  return (FALSE);
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  World::IsInScene  (Node *  pnodeIn)
+  {
+  return ((pnodeIn != &nodeRoot) && (pnodeIn->RootParent () == &nodeRoot));
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::IndexSubtree  (Node *  pnodeIn,
+                            HASH_T  uParentPathHashIn)
+  {
+  HASH_T  uPathHash = CalcHashValue (pnodeIn->Name (), 0, uParentPathHashIn);
+
+  indexNodePaths.Insert (uPathHash, pnodeIn);
+  indexNodeNames.Insert (pnodeIn->NameHash (), pnodeIn);
+
+  uPathHash = CalcHashValue ("|", 1, uPathHash);
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild ();
+       itrChild.IsValid ();
+       ++itrChild)
+    {
+    IndexSubtree (*itrChild, uPathHash);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::UnindexSubtree  (Node *  pnodeIn,
+                              HASH_T  uParentPathHashIn)
+  {
+  HASH_T  uPathHash = CalcHashValue (pnodeIn->Name (), 0, uParentPathHashIn);
+
+  indexNodePaths.Remove (uPathHash, pnodeIn);
+  indexNodeNames.Remove (pnodeIn->NameHash (), pnodeIn);
+
+  uPathHash = CalcHashValue ("|", 1, uPathHash);
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild ();
+       itrChild.IsValid ();
+       ++itrChild)
+    {
+    UnindexSubtree (*itrChild, uPathHash);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::OnNodePathChanging  (Node *  pnodeIn)
+  {
+  // called while the node still has its old name and parent
+  if (IsInScene (pnodeIn))
+    {
+    UnindexSubtree (pnodeIn, PathPrefixHash (pnodeIn->GetParent (), &nodeRoot));
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::OnNodePathChanged  (Node *  pnodeIn)
+  {
+  if (IsInScene (pnodeIn))
+    {
+    IndexSubtree (pnodeIn, PathPrefixHash (pnodeIn->GetParent (), &nodeRoot));
+    };
   };
 
 //-----------------------------------------------------------------------------
 VOID  World::ClearScene  (VOID)
   {
 
+  // the iterator is advanced before each node is unparented, so every child is visited.
   for (TListItr<Node*>  itrNode = nodeRoot.FirstChild ();
        itrNode.IsValid ();
-       ++itrNode)
+       )
     {
     Node *  pnodeToDelete = (*itrNode);
     ++itrNode;
@@ -119,24 +283,61 @@ VOID World::CreateNodeFinish  (Node *  pnodeIn,
 
   if (pnodeIn == NULL) return;
 
-  RStr  strFullPath;
-  pnodeIn->CalcFullPath (strFullPath);
-  strFullPath.CalcHash ();
-
-  for (TListItr<NodeFinder*>  itrSearch = listCreateWatchers.First ();
-       itrSearch.IsValid ();
-       ++itrSearch)
+  if (NumPendingFinders () > 0)
     {
-    if (((*itrSearch)->uNameHash == pnodeIn->NameHash()) ||
-        ((*itrSearch)->uFullNameHash == strFullPath.GetHash()))
+    INT64  iStartUs = StopWatch::GetTimeUs ();
+
+    RStr  strFullPath;
+    pnodeIn->CalcFullPath (strFullPath);
+    strFullPath.CalcHash ();
+
+    HASH_T  uNameHash = pnodeIn->NameHash ();
+    HASH_T  uPathHash = strFullPath.GetHash ();
+
+    // Gather the finders waiting on this node's name or path.  Callbacks may
+    //  register new finders, so the buckets aren't walked while calling them.
+    TArray<NodeFinder*>  apMatches;
+    for (INT  iSlot = indexWatchersByName.FindFirst (uNameHash); iSlot != -1; iSlot = indexWatchersByName.FindNext (uNameHash, iSlot))
+      {
+      apMatches.Append (indexWatchersByName.GetAt (iSlot));
+      };
+    for (INT  iSlot = indexWatchersByPath.FindFirst (uPathHash); iSlot != -1; iSlot = indexWatchersByPath.FindNext (uPathHash, iSlot))
+      {
+      NodeFinder *  pSearch = indexWatchersByPath.GetAt (iSlot);
+      if (pSearch->uNameHash != uNameHash)
+        {
+        apMatches.Append (pSearch);
+        };
+      };
+
+    // newest first, then the first finder that accepts the node is resolved.
+    NodeFinder * *  ppMatches   = apMatches.GetRawBuffer ();
+    INT             iNumMatches = apMatches.Length ();
+    for (INT  iSorted = 1; iSorted < iNumMatches; ++iSorted)
+      {
+      NodeFinder *  pSearch = ppMatches [iSorted];
+      INT           iIndex  = iSorted;
+      for (; (iIndex > 0) && (ppMatches [iIndex - 1]->uWatchOrder < pSearch->uWatchOrder); --iIndex)
+        {
+        ppMatches [iIndex] = ppMatches [iIndex - 1];
+        };
+      ppMatches [iIndex] = pSearch;
+      };
+
+    for (INT  iIndex = 0; iIndex < iNumMatches; ++iIndex)
       {
-      if ((*itrSearch)->OnFound (pnodeIn))
+      NodeFinder *  pSearch = ppMatches [iIndex];
+      if (pSearch->OnFound (pnodeIn))
         {
-        delete (*itrSearch);
-        listCreateWatchers.Delete (itrSearch);
+        indexWatchersByName.Remove (pSearch->uNameHash,     pSearch);
+        indexWatchersByPath.Remove (pSearch->uFullNameHash, pSearch);
+        delete (pSearch);
+        ++uFindersResolved;
         break;
         };
       };
+
+    iFinderResolveUs += StopWatch::GetTimeUs () - iStartUs;
     };
 
   pnodeIn->SetActive (bIsActive);
@@ -164,12 +365,21 @@ Node *  World::FindNode  (const char *  szNameOrPathIn)
   {
   if (szNameOrPathIn[0] == '|')
     {
-    return (nodeRoot.FindByPath (&szNameOrPathIn[1]));
-    }
-  else
+    return (FindNodeByPath (szNameOrPathIn));
+    };
+
+  Node *  pFound = NULL;
+  HASH_T  uHash  = CalcHashValue (szNameOrPathIn);
+  for (INT  iSlot = indexNodeNames.FindFirst (uHash); iSlot != -1; iSlot = indexNodeNames.FindNext (uHash, iSlot))
     {
-    return (nodeRoot.FindByName (&szNameOrPathIn[0]));
+    Node *  pnodeCurr = indexNodeNames.GetAt (iSlot);
+    if (streq (pnodeCurr->Name (), szNameOrPathIn) &&
+        ((pFound == NULL) || PrecedesInTree (pnodeCurr, pFound)))
+      {
+      pFound = pnodeCurr;
+      };
     };
+  return (pFound);
   };
 
 //-----------------------------------------------------------------------------
@@ -177,20 +387,50 @@ Node *  World::FindNodeByPath  (const char *  szFullPathIn)
   {
   ASSERT (szFullPathIn[0] == '|');
 
-  return (nodeRoot.FindByPath (&szFullPathIn[1]));
+  INT     iLength = (INT) strlen (szFullPathIn);
+  HASH_T  uHash   = CalcHashValue (szFullPathIn, iLength);
+  Node *  pFound  = NULL;
+  for (INT  iSlot = indexNodePaths.FindFirst (uHash); iSlot != -1; iSlot = indexNodePaths.FindNext (uHash, iSlot))
+    {
+    Node *  pnodeCurr = indexNodePaths.GetAt (iSlot);
+    if (PathMatches (pnodeCurr, &nodeRoot, szFullPathIn, iLength) &&
+        ((pFound == NULL) || PrecedesInTree (pnodeCurr, pFound)))
+      {
+      pFound = pnodeCurr;
+      };
+    };
+  return (pFound);
   };
 
 //-----------------------------------------------------------------------------
 Node *  World::FindNode  (UINT  uNameHashIn)
   {
-  return (nodeRoot.FindByName (uNameHashIn));
+  Node *  pFound = NULL;
+  for (INT  iSlot = indexNodeNames.FindFirst (uNameHashIn); iSlot != -1; iSlot = indexNodeNames.FindNext (uNameHashIn, iSlot))
+    {
+    Node *  pnodeCurr = indexNodeNames.GetAt (iSlot);
+    if ((pFound == NULL) || PrecedesInTree (pnodeCurr, pFound))
+      {
+      pFound = pnodeCurr;
+      };
+    };
+  return (pFound);
   };
 
 //-----------------------------------------------------------------------------
 Node *  World::FindNodeByPath  (UINT  uFullPathHashIn)
   {
   // NOTE: World path should start with a pipe separator '|'
-  return (nodeRoot.FindByPath (uFullPathHashIn, CalcHashValue ("|", 1)));
+  Node *  pFound = NULL;
+  for (INT  iSlot = indexNodePaths.FindFirst (uFullPathHashIn); iSlot != -1; iSlot = indexNodePaths.FindNext (uFullPathHashIn, iSlot))
+    {
+    Node *  pnodeCurr = indexNodePaths.GetAt (iSlot);
+    if ((pFound == NULL) || PrecedesInTree (pnodeCurr, pFound))
+      {
+      pFound = pnodeCurr;
+      };
+    };
+  return (pFound);
   };
 
 //-----------------------------------------------------------------------------
@@ -226,7 +466,276 @@ VOID World::FindNode (NodeFinder *  pSearch)
 
   // Node doesn't exist yet.  Watch for it later.
 
-  listCreateWatchers.PushFront (pSearch);
+  pSearch->uWatchOrder = ++uNextWatchOrder;
+  indexWatchersByName.Insert (pSearch->uNameHash,     pSearch);
+  indexWatchersByPath.Insert (pSearch->uFullNameHash, pSearch);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::RebuildDispatchLists  (VOID)
+  {
+  apAwakeNodes.Clear ();
+  apUpdateNodes.Clear ();
+  for (INT  iCallback = 0; iCallback < ComponentDefaultLooper::kNumCallbacks; ++iCallback)
+    {
+    apDispatch [iCallback].Clear ();
+    };
+  indexEventSubscribers.Clear ();
+  aiEventRunStart.Clear ();
+  aiEventSubscribers.Clear ();
+  auEventSubHashes.Clear ();
+  aiEventSubIndices.Clear ();
+  aiEventWildcards.Clear ();
+
+  CollectDispatch (&nodeRoot);
+  BuildEventRuns ();
+
+  uDispatchVersion = Node::StructureVersion ();
+  ++uDispatchRebuilds;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::CollectDispatch  (Node *  pnodeIn)
+  {
+  // Mirrors ComponentDefaultLooper's traversal:  every visited node is woken,
+  //  but only active nodes have their components called and children visited.
+  if (! pnodeIn->IsAwake ())
+    {
+    apAwakeNodes.Append (pnodeIn);
+    };
+  if (! pnodeIn->IsActive ())
+    {
+    return;
+    };
+  apUpdateNodes.Append (pnodeIn);
+
+  for (Component *  pcmpCurr = pnodeIn->FirstComponent ();
+       pcmpCurr->IsValid ();
+       pcmpCurr = pcmpCurr->Next ())
+    {
+    UINT32  uMask = pcmpCurr->CallbackMask ();
+    if (uMask == ComponentCallback::kNone) continue;
+
+    for (INT  iCallback = 0; iCallback < ComponentDefaultLooper::kNumCallbacks; ++iCallback)
+      {
+      if ((iCallback != ComponentDefaultLooper::kUpdate) && (uMask & (1u << iCallback)))
+        {
+        apDispatch [iCallback].Append (pcmpCurr);
+        };
+      };
+
+    if (uMask & ComponentCallback::kEvent)
+      {
+      // indices are appended in list order, and BuildEventRuns keeps that order.
+      INT  iEventIndex = apDispatch [ComponentDefaultLooper::kEvent].Length () - 1;
+      INT  iNumEvents  = pcmpCurr->NumEventSubscriptions ();
+      if (iNumEvents == 0)
+        {
+        aiEventWildcards.Append (iEventIndex);
+        };
+      for (INT  iIndex = 0; iIndex < iNumEvents; ++iIndex)
+        {
+        auEventSubHashes.Append  (pcmpCurr->EventSubscription (iIndex));
+        aiEventSubIndices.Append (iEventIndex);
+        };
+      };
+    };
+
+  for (TListItr<Node*>  itrChild = pnodeIn->FirstChild ();
+       itrChild.IsValid ();
+       ++itrChild)
+    {
+    CollectDispatch (*itrChild);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::IterateComponents  (ComponentDefaultLooper::Callback  eCallbackIn,
+                                 VOID *                            pParamIn,
+                                 HASH_T                            uEventHashIn)
+  {
+  // A callback may reparent, activate, or delete nodes, which invalidates the
+  //  lists part way through.  When that happens the lists are rebuilt and the
+  //  pass starts over, skipping anything already called during this pass.
+  ++uDispatchPass;
+
+  BOOL  bRestart;
+  do
+    {
+    bRestart = FALSE;
+    if (uDispatchVersion != Node::StructureVersion ())
+      {
+      RebuildDispatchLists ();
+      };
+
+    Node * *  ppNodes  = apAwakeNodes.GetRawBuffer ();
+    INT       iCount   = apAwakeNodes.Length ();
+    for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+      {
+      ppNodes [iIndex]->Awake ();
+      if (uDispatchVersion != Node::StructureVersion ()) {bRestart = TRUE; break;};
+      };
+    if (bRestart) continue;
+    apAwakeNodes.Clear ();
+
+    if (eCallbackIn == ComponentDefaultLooper::kUpdate)
+      {
+      ppNodes = apUpdateNodes.GetRawBuffer ();
+      iCount  = apUpdateNodes.Length ();
+      for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+        {
+        Node *  pnodeCurr = ppNodes [iIndex];
+        if (pnodeCurr->DispatchPass () == uDispatchPass) continue;
+        pnodeCurr->SetDispatchPass (uDispatchPass);
+        pnodeCurr->Update ();
+        if (uDispatchVersion != Node::StructureVersion ()) {bRestart = TRUE; break;};
+        };
+      }
+    else if (eCallbackIn == ComponentDefaultLooper::kEvent)
+      {
+      bRestart = DispatchEvent (uEventHashIn);
+      }
+    else
+      {
+      Component * *  ppComponents = apDispatch [eCallbackIn].GetRawBuffer ();
+      iCount = apDispatch [eCallbackIn].Length ();
+      for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+        {
+        if (DispatchComponent (eCallbackIn, ppComponents [iIndex], pParamIn, uEventHashIn)) {bRestart = TRUE; break;};
+        };
+      };
+    } while (bRestart);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  World::BuildEventRuns  (VOID)
+  {
+  // Group the subscriptions by event into contiguous runs.  A counting sort
+  //  is stable, so each run keeps the ascending order of the kEvent list.
+  INT  iNumSubs = aiEventSubIndices.Length ();
+  IntArray  aiRunOfSub;
+  aiRunOfSub.SetLength (iNumSubs);
+  for (INT  iSub = 0; iSub < iNumSubs; ++iSub)
+    {
+    INT  iRun = indexEventSubscribers.Find (auEventSubHashes [iSub], -1);
+    if (iRun == -1)
+      {
+      iRun = aiEventRunStart.Length ();
+      indexEventSubscribers.Insert (auEventSubHashes [iSub], iRun);
+      aiEventRunStart.Append (0);
+      };
+    aiEventRunStart [iRun] = aiEventRunStart [iRun] + 1;
+    aiRunOfSub [iSub] = iRun;
+    };
+
+  // counts to start offsets, with an end entry after the last run
+  INT  iNumRuns = aiEventRunStart.Length ();
+  INT  iOffset  = 0;
+  aiEventRunStart.Append (0);
+  for (INT  iRun = 0; iRun <= iNumRuns; ++iRun)
+    {
+    INT  iCount = aiEventRunStart [iRun];
+    aiEventRunStart [iRun] = iOffset;
+    iOffset += iCount;
+    };
+
+  IntArray  aiCursor;
+  aiCursor.SetLength (iNumRuns);
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    aiCursor [iRun] = aiEventRunStart [iRun];
+    };
+  aiEventSubscribers.SetLength (iNumSubs);
+  for (INT  iSub = 0; iSub < iNumSubs; ++iSub)
+    {
+    INT  iRun = aiRunOfSub [iSub];
+    aiEventSubscribers [aiCursor [iRun]] = aiEventSubIndices [iSub];
+    aiCursor [iRun] = aiCursor [iRun] + 1;
+    };
+
+  auEventSubHashes.Clear ();
+  aiEventSubIndices.Clear ();
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  World::DispatchComponent  (ComponentDefaultLooper::Callback  eCallbackIn,
+                                 Component *                       pcmpIn,
+                                 VOID *                            pParamIn,
+                                 HASH_T                            uEventHashIn)
+  {
+  // returns TRUE if the callback changed the scene structure, and the lists are stale.
+  if (pcmpIn->DispatchPass () == uDispatchPass) return (FALSE);
+  pcmpIn->SetDispatchPass (uDispatchPass);
+  ComponentDefaultLooper::Dispatch (eCallbackIn, pcmpIn, pParamIn, uEventHashIn);
+  return (uDispatchVersion != Node::StructureVersion ());
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  World::DispatchEvent  (HASH_T  uEventHashIn)
+  {
+  // Merge the event's subscribers with the components that take every event.
+  //  Both hold ascending indices into the kEvent list, so the merge keeps the
+  //  tree walk's order.
+  Component * *  ppComponents  = apDispatch [ComponentDefaultLooper::kEvent].GetRawBuffer ();
+  INT32 *        piWildcards   = aiEventWildcards.GetRawArray ();
+  INT            iNumWildcards = aiEventWildcards.Length ();
+  INT            iWildcard     = 0;
+  INT32 *        piSubscribers = aiEventSubscribers.GetRawArray ();
+  INT            iSub          = 0;
+  INT            iSubEnd       = 0;
+  INT            iRun          = indexEventSubscribers.Find (uEventHashIn, -1);
+
+  if (iRun != -1)
+    {
+    iSub    = aiEventRunStart [iRun];
+    iSubEnd = aiEventRunStart [iRun + 1];
+    };
+
+  while ((iSub < iSubEnd) || (iWildcard < iNumWildcards))
+    {
+    INT  iEventIndex;
+    if ((iSub < iSubEnd) &&
+        ((iWildcard >= iNumWildcards) || (piSubscribers [iSub] < piWildcards [iWildcard])))
+      {
+      iEventIndex = piSubscribers [iSub++];
+      }
+    else
+      {
+      iEventIndex = piWildcards [iWildcard++];
+      };
+    if (DispatchComponent (ComponentDefaultLooper::kEvent, ppComponents [iEventIndex], NULL, uEventHashIn)) return (TRUE);
+    };
+  return (FALSE);
+  };
+
+//-----------------------------------------------------------------------------
+INT  World::NumDispatched  (ComponentDefaultLooper::Callback  eCallbackIn)
+  {
+  if (uDispatchVersion != Node::StructureVersion ())
+    {
+    RebuildDispatchLists ();
+    };
+  if (eCallbackIn == ComponentDefaultLooper::kUpdate)
+    {
+    return (apUpdateNodes.Length ());
+    };
+  return (apDispatch [eCallbackIn].Length ());
+  };
+
+//-----------------------------------------------------------------------------
+INT  World::NumEventSubscribers  (HASH_T  uEventHashIn)
+  {
+  if (uDispatchVersion != Node::StructureVersion ())
+    {
+    RebuildDispatchLists ();
+    };
+  INT  iCount = aiEventWildcards.Length ();
+  INT  iRun   = indexEventSubscribers.Find (uEventHashIn, -1);
+  if (iRun != -1)
+    {
+    iCount += aiEventRunStart [iRun + 1] - aiEventRunStart [iRun];
+    };
+  return (iCount);
   };
 
 //-----------------------------------------------------------------------------
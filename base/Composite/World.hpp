@@ -41,7 +41,12 @@
 #include "Sys/Types.hpp"
 #include "Composite/Node.hpp"
 #include "Composite/Resource.hpp"
+#include "Composite/ComponentDefaultLooper.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/TArray.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Containers/IntArray.hpp"
+#include "Gfx/TransformBatch.hpp"
 
 #include "Util/Signal.h"
 
@@ -79,7 +84,7 @@ using namespace Gallant;
   */
 
 
-// NOTE: The purpose of NodeFinder and listCreateWatchers is to assist in hooking up
+// NOTE: The purpose of NodeFinder and the create watchers is to assist in hooking up
 //   one object to another.  A Component can be initialized with the name of another
 //   node.  This node may or may not have been loaded at the time of the component's
 //   creation.  This way on creation, the component can find the node if it exists,
@@ -93,12 +98,14 @@ class NodeFinder
 
     UINT32    uNameHash;
     UINT32    uFullNameHash;
+    UINT32    uWatchOrder;   ///< Set by World when the finder starts waiting.  Newer finders are checked first.
 
     NodeFinder (UINT32   uNameHashIn,
                 UINT32   uFullNameHashIn)
       {
       uNameHash     = uNameHashIn;
       uFullNameHash = uFullNameHashIn;
+      uWatchOrder   = 0;
       };
 
     virtual ~NodeFinder () {}
@@ -113,12 +120,69 @@ class NodeFinder
 class World
   {
   private:
+    TransformBatch  batchTransforms; ///< Solves the world matrices of every transform under the root.  Declared before nodeRoot, so it outlives the root's transform.
+
     Node   nodeRoot; ///< Root of all nodes in the scene graph.
 
-    TList<NodeFinder*>  listCreateWatchers;
+    // NodeFinders waiting for a node to be created, bucketed by both of their
+    //  hashes so CreateNodeFinish only checks the ones that can match.
+    THashIndex<NodeFinder*>  indexWatchersByName;
+    THashIndex<NodeFinder*>  indexWatchersByPath;
+    UINT32                   uNextWatchOrder;
+    UINT32                   uFindersResolved;  ///< Finders resolved by CreateNodeFinish.
+    INT64                    iFinderResolveUs;  ///< Time CreateNodeFinish has spent matching and resolving finders.
+
+    // Flattened, depth-ordered views of the active part of the scene, used by
+    //  IterateComponents instead of walking the tree every frame.  They are
+    //  rebuilt whenever Node::StructureVersion() changes.
+    UINT32                 uDispatchVersion;  ///< Node::StructureVersion() the lists were built from.  Zero if never built.
+    UINT32                 uDispatchPass;     ///< Incremented for each IterateComponents call.
+    UINT32                 uDispatchRebuilds;
+    TArray<Node*>          apAwakeNodes;      ///< Visited nodes that were not yet awake when the lists were built.
+    TArray<Node*>          apUpdateNodes;     ///< Active nodes, for kUpdate.
+    TArray<Component*>     apDispatch [ComponentDefaultLooper::kNumCallbacks]; ///< Components that implement each callback.
+    THashIndex<INT>        indexEventSubscribers; ///< Event hash to its run in aiEventRunStart.
+    IntArray               aiEventRunStart;       ///< Where each event's subscribers start in aiEventSubscribers, plus one end entry.
+    IntArray               aiEventSubscribers;    ///< apDispatch[kEvent] indices of each event's subscribers, ascending within a run.
+    TArray<HASH_T>         auEventSubHashes;      ///< Event hash of each subscription, in list order.  Only used while rebuilding.
+    IntArray               aiEventSubIndices;     ///< apDispatch[kEvent] index of each subscription.  Only used while rebuilding.
+    IntArray               aiEventWildcards;      ///< apDispatch[kEvent] indices of components that take every event.
+
+    // Lookup tables for the nodes under nodeRoot, kept current through
+    //  Node::sigOnPathChanging and Node::sigOnPathChanged.  Keys match the
+    //  hashes used by Node::FindByName(UINT) and Node::FindByPath(UINT).
+    THashIndex<Node*>      indexNodePaths;    ///< Full path hash ("|Parent|Child") to node.
+    THashIndex<Node*>      indexNodeNames;    ///< Name hash to node.
 
     static World *  pInstance;
 
+  private:
+
+    VOID     RebuildDispatchLists  (VOID);
+
+    VOID     CollectDispatch       (Node *  pnodeIn);
+
+    VOID     BuildEventRuns        (VOID);
+
+    BOOL     DispatchComponent     (ComponentDefaultLooper::Callback  eCallbackIn,
+                                    Component *                       pcmpIn,
+                                    VOID *                            pParamIn,
+                                    HASH_T                            uEventHashIn);
+
+    BOOL     DispatchEvent         (HASH_T  uEventHashIn);
+
+    BOOL     IsInScene             (Node *  pnodeIn);
+
+    VOID     IndexSubtree          (Node *  pnodeIn,
+                                    HASH_T  uParentPathHashIn);
+
+    VOID     UnindexSubtree        (Node *  pnodeIn,
+                                    HASH_T  uParentPathHashIn);
+
+    VOID     OnNodePathChanging    (Node *  pnodeIn);
+
+    VOID     OnNodePathChanged     (Node *  pnodeIn);
+
   public:
              World          ();
 
@@ -128,6 +192,8 @@ class World
 
     static VOID     DestroyInstance  (VOID)   {if (pInstance != NULL) {delete pInstance;}; pInstance = NULL;};
 
+    static World *  ExistingInstance (VOID)   {return pInstance;}; ///< Like Instance(), but returns NULL instead of creating the World.
+
     VOID     ClearScene     (VOID); ///< deletes all children of the root node.
 
     Node *   CreateNode     (const char *  szFullPathIn = "|NewNode"); ///< create a node somewhere in the world.  Parent to root if no parent given.
@@ -159,6 +225,49 @@ class World
     VOID     DebugPrint     (const char *  szIndentIn,
                              RStr &        strOut) const;
 
+                            /** @brief  Make a callback on every active component under the root, in the same order
+                                        as ComponentDefaultLooper's tree walk, using the cached dispatch lists.  Nodes
+                                        that the walk would visit are woken first.
+                                @param  eCallbackIn The callback to make.
+                                @param  pParamIn Parameter passed to OnTriggerCollide.
+                                @param  uEventHashIn Event passed to OnEvent.  Only components subscribed to it,
+                                        or with no subscriptions, are visited.
+                                @return None
+                            */
+    VOID     IterateComponents  (ComponentDefaultLooper::Callback  eCallbackIn,
+                                 VOID *                            pParamIn     = NULL,
+                                 HASH_T                            uEventHashIn = 0);
+
+                            /** @brief  Query how many components are in the dispatch list for a callback.
+                                @param  eCallbackIn The callback to query.  kUpdate returns the number of active nodes.
+                                @return The list size, building the lists if needed.
+                            */
+    INT      NumDispatched      (ComponentDefaultLooper::Callback  eCallbackIn);
+
+    UINT32   NumDispatchRebuilds (VOID) const   {return uDispatchRebuilds;};
+
+                            /** @brief  Query how many components a kEvent pass would call for the given event.
+                                @param  uEventHashIn The event to query.
+                                @return Subscribers to the event, plus components that take every event.
+                            */
+    INT      NumEventSubscribers (HASH_T  uEventHashIn);
+
+    INT      NumIndexedNodes    (VOID) const   {return indexNodePaths.Size ();}; ///< Number of nodes under the root, as seen by the lookup tables.
+
+    INT      NumPendingFinders  (VOID) const   {return indexWatchersByName.Size ();}; ///< NodeFinders still waiting for their node to be created.
+
+    UINT32   NumResolvedFinders (VOID) const   {return uFindersResolved;}; ///< NodeFinders resolved by node creation since the World was made.
+
+    INT64    FinderResolveUs    (VOID) const   {return iFinderResolveUs;}; ///< Total microseconds CreateNodeFinish has spent checking pending NodeFinders.
+
+                            /** @brief  Solve the world matrix of every transform in the scene that changed, or whose
+                                        parent changed.  Called once per frame by Shell::StaticGameLoop.
+                                @return None
+                            */
+    VOID     UpdateTransforms   (VOID)         {batchTransforms.Update ();};
+
+    TransformBatch &  Transforms (VOID)        {return batchTransforms;}; ///< The batch holding the root node's transform and everything parented under it.
+
 
 
   };
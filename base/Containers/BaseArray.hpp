@@ -135,6 +135,8 @@ class BaseArray
                                      */
     VOID *          GetRawBuffer     (VOID)           {return pArray;};
 
+    const VOID *    GetRawBuffer     (VOID) const     {return pArray;};
+
   protected:
                                      /** @brief  Test an index against the array boundaries.
                                          @return True if the given index is within the array bounds, and False if not.
@@ -8,6 +8,9 @@ ASSERTFILE (__FILE__);
 
 
 #include "Containers/KVPArray.hpp"
+#include "Containers/SlabPool.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Containers/TList.hpp"
 #include "Util/RStrParser.hpp"
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
@@ -80,6 +83,230 @@ TEST (KVPArray, ExpandMacros)
   ASSERT_STREQ (pszResult, "1 2 3 1$also and $This is a test.");
   }
 
+//------------------------------------------------------------------------------
+static BOOL  HashIndexInOrder  (THashIndex<INT> &  indexIn,
+                                HASH_T              uKeyIn,
+                                INT                 iExpectedCountIn)
+  {
+  // values under a key were inserted in ascending order, and must come back that way.
+  INT  iCount = 0;
+  INT  iPrev  = -1;
+  for (INT  iSlot = indexIn.FindFirst (uKeyIn); iSlot != -1; iSlot = indexIn.FindNext (uKeyIn, iSlot))
+    {
+    if (indexIn.GetAt (iSlot) <= iPrev) return (FALSE);
+    iPrev = indexIn.GetAt (iSlot);
+    ++iCount;
+    };
+  return (iCount == iExpectedCountIn);
+  };
+
+//------------------------------------------------------------------------------
+TEST (THashIndex, OrderSurvivesRebuild)
+  {
+  THashIndex<INT>  index;
+  index.Reserve (48);
+  INT  iCapacity = index.Capacity ();
+
+  // find a key whose home slot is the last slot, so its chain wraps past the end.
+  HASH_T  uWrapKey = 0;
+  for (HASH_T  uKey = 1; uKey < 100000; ++uKey)
+    {
+    index.Insert (uKey, 0);
+    BOOL  bLast = (index.FindFirst (uKey) == iCapacity - 1);
+    index.Remove (uKey, 0);
+    if (bLast) {uWrapKey = uKey; break;};
+    };
+  ASSERT_NE (uWrapKey, HASH_T (0));
+
+  THashIndex<INT>  indexWrap;
+  indexWrap.Reserve (48);
+  ASSERT_EQ (indexWrap.Capacity (), iCapacity);
+
+  for (INT  iValue = 0; iValue < 20; ++iValue)
+    {
+    indexWrap.Insert (uWrapKey, iValue);
+    };
+  ASSERT_EQ (indexWrap.FindFirst (uWrapKey), iCapacity - 1);
+  ASSERT_TRUE (HashIndexInOrder (indexWrap, uWrapKey, 20));
+
+  // tombstone sweeps and growth, with other keys mixed in
+  for (INT  iValue = 0; iValue < 20; iValue += 3)
+    {
+    indexWrap.Remove (uWrapKey, iValue);
+    };
+  for (INT  iValue = 20; iValue < 200; ++iValue)
+    {
+    indexWrap.Insert (uWrapKey, iValue);
+    indexWrap.Insert (HASH_T (iValue * 7919), iValue);
+    };
+  ASSERT_GT (indexWrap.Capacity (), iCapacity);
+  ASSERT_TRUE (HashIndexInOrder (indexWrap, uWrapKey, 200 - 7));
+
+  // many keys, each with several values, through repeated growth
+  THashIndex<INT>  indexMany;
+  for (INT  iValue = 0; iValue < 60; ++iValue)
+    {
+    for (HASH_T  uKey = 1; uKey <= 2000; ++uKey)
+      {
+      if ((iValue == 0) || (uKey % 30 == 0))
+        {
+        indexMany.Insert (uKey, iValue);
+        };
+      };
+    };
+  for (HASH_T  uKey = 1; uKey <= 2000; ++uKey)
+    {
+    ASSERT_TRUE (HashIndexInOrder (indexMany, uKey, (uKey % 30 == 0) ? 60 : 1));
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (SlabPool, Basic)
+  {
+  // block sizes are rounded up so a free block can hold the free list link
+  SlabPool  poolTiny (1);
+  ASSERT_EQ (INT (sizeof (VOID *)), poolTiny.BlockSize ());
+
+  SlabPool  pool (48, 7, 48 * 10);
+  ASSERT_EQ (48, pool.BlockSize ());
+  ASSERT_EQ (7,  pool.Tag ());
+  ASSERT_EQ (0,  pool.NumSlabs ());
+
+  const INT  iNumBlocks = 25;
+  UINT8 *    apBlocks [iNumBlocks];
+  for (INT  iIndex = 0; iIndex < iNumBlocks; ++iIndex)
+    {
+    apBlocks [iIndex] = (UINT8 *) pool.Allocate ();
+    memset (apBlocks [iIndex], iIndex, 48);
+    ASSERT_TRUE (SlabPool::FindOwner (apBlocks [iIndex]) == &pool);
+    ASSERT_TRUE (SlabPool::FindOwner (apBlocks [iIndex] + 47) == &pool);
+    };
+  ASSERT_EQ (3, pool.NumSlabs ());
+  ASSERT_EQ (iNumBlocks, pool.NumLive ());
+  ASSERT_EQ (48 * 30, pool.BytesReserved ());
+
+  // blocks don't overlap
+  for (INT  iIndex = 0; iIndex < iNumBlocks; ++iIndex)
+    {
+    ASSERT_EQ (iIndex, apBlocks [iIndex][0]);
+    ASSERT_EQ (iIndex, apBlocks [iIndex][47]);
+    };
+
+  // heap memory isn't claimed by any pool
+  INT *  piHeap = new INT [4];
+  ASSERT_TRUE (SlabPool::FindOwner (piHeap) == NULL);
+  delete [] piHeap;
+
+  // freed blocks are reused before new slabs are added
+  pool.Free (apBlocks [3]);
+  pool.Free (apBlocks [10]);
+  ASSERT_EQ (iNumBlocks - 2, pool.NumLive ());
+  ASSERT_TRUE (pool.Allocate () == apBlocks [10]);
+  ASSERT_TRUE (pool.Allocate () == apBlocks [3]);
+  ASSERT_EQ (3, pool.NumSlabs ());
+  ASSERT_EQ (iNumBlocks, pool.PeakLive ());
+  ASSERT_EQ (iNumBlocks + 2, pool.NumAllocs ());
+
+  // slabs can only be released once every block is returned
+  ASSERT_FALSE (pool.ReleaseSlabs ());
+  for (INT  iIndex = 0; iIndex < iNumBlocks; ++iIndex)
+    {
+    pool.Free (apBlocks [iIndex]);
+    };
+  ASSERT_TRUE (pool.ReleaseSlabs ());
+  ASSERT_EQ (0, pool.NumSlabs ());
+  ASSERT_TRUE (SlabPool::FindOwner (apBlocks [0]) == NULL);
+  }
+
+//------------------------------------------------------------------------------
+TEST (SlabAllocator, Scopes)
+  {
+  const INT  iTestScope = 0x51AB;
+  SlabAllocator::Stats  stats;
+
+  ASSERT_TRUE (SlabAllocator::IsEnabled ());
+  SlabAllocator::GetStats (SlabAllocator::kAttr, stats, iTestScope);
+  ASSERT_EQ (0, stats.iNumSlabs);
+
+  VOID *  apSmall [100];
+  VOID *  pLarge;
+  {
+  SlabScope  scope (iTestScope);
+  ASSERT_EQ (iTestScope, SlabAllocator::Scope ());
+
+  for (INT  iIndex = 0; iIndex < 100; ++iIndex)
+    {
+    apSmall [iIndex] = SlabAllocator::Allocate (SlabAllocator::kAttr, 40 + (iIndex % 3) * 16);
+    ASSERT_TRUE (SlabPool::FindOwner (apSmall [iIndex]) != NULL);
+    };
+  // requests over the maximum block size go to the heap
+  pLarge = SlabAllocator::Allocate (SlabAllocator::kAttr, SlabAllocator::kMaxBlockSize + 1);
+  ASSERT_TRUE (SlabPool::FindOwner (pLarge) == NULL);
+  }
+  ASSERT_EQ (SlabAllocator::kDefaultScope, SlabAllocator::Scope ());
+
+  SlabAllocator::GetStats (SlabAllocator::kAttr, stats, iTestScope);
+  ASSERT_EQ (100, stats.iNumLive);
+  ASSERT_EQ (100, stats.iNumAllocs);
+  ASSERT_EQ (3,   stats.iNumSlabs);  // one per size class
+  ASSERT_TRUE (stats.iBytesReserved >= 100 * 48);
+
+  // a scope with live objects can't be released
+  ASSERT_FALSE (SlabAllocator::ReleaseScope (iTestScope));
+
+  // objects allocated while pooling was on are freed to their pool after it is turned off
+  SlabAllocator::SetEnabled (FALSE);
+  VOID *  pUnpooled = SlabAllocator::Allocate (SlabAllocator::kAttr, 40);
+  ASSERT_TRUE (SlabPool::FindOwner (pUnpooled) == NULL);
+  SlabAllocator::Free (pUnpooled, 40);
+  for (INT  iIndex = 0; iIndex < 100; ++iIndex)
+    {
+    SlabAllocator::Free (apSmall [iIndex], 40 + (iIndex % 3) * 16);
+    };
+  SlabAllocator::Free (pLarge, SlabAllocator::kMaxBlockSize + 1);
+  SlabAllocator::SetEnabled (TRUE);
+
+  SlabAllocator::GetStats (SlabAllocator::kAttr, stats, iTestScope);
+  ASSERT_EQ (0,   stats.iNumLive);
+  ASSERT_EQ (100, stats.iPeakLive);
+
+  ASSERT_TRUE (SlabAllocator::ReleaseScope (iTestScope));
+  SlabAllocator::GetStats (SlabAllocator::kAttr, stats, iTestScope);
+  ASSERT_EQ (0, stats.iNumSlabs);
+  ASSERT_EQ (0, stats.iBytesReserved);
+
+  // pooled list entries
+  {
+  SlabScope      scope (iTestScope);
+  TList<INT*>    listPooled;
+  INT            aiValues [3] = {1, 2, 3};
+
+  listPooled.SetPooledEntries (TRUE);
+  listPooled.PushBack (&aiValues [1]);
+  listPooled.PushFront (&aiValues [0]);
+  listPooled.PushBack (&aiValues [2]);
+  SlabAllocator::GetStats (SlabAllocator::kListEntry, stats, iTestScope);
+  ASSERT_EQ (3, stats.iNumLive);
+
+  INT  iExpected = 1;
+  for (TListItr<INT*>  itrCurr = listPooled.First (); itrCurr.IsValid (); ++itrCurr)
+    {
+    ASSERT_EQ (iExpected++, *(*itrCurr));
+    };
+  listPooled.Delete (&aiValues [1]);
+  SlabAllocator::GetStats (SlabAllocator::kListEntry, stats, iTestScope);
+  ASSERT_EQ (2, stats.iNumLive);
+  listPooled.Empty ();
+  SlabAllocator::GetStats (SlabAllocator::kListEntry, stats, iTestScope);
+  ASSERT_EQ (0, stats.iNumLive);
+  }
+  ASSERT_TRUE (SlabAllocator::ReleaseScope (iTestScope));
+
+  RStr  strStats;
+  SlabAllocator::DebugPrint (strStats);
+  ASSERT_TRUE (strStats.Find ("ListEntry") != -1);
+  }
+
 
 /*
                  KVPArray      ();
@@ -0,0 +1,421 @@
+/* -----------------------------------------------------------------
+                            Slab Pool
+
+     This module implements fixed-size block pools that carve small
+   objects out of larger slabs, and a size-classed allocator built on
+   them for the scene graph's Node, Component, Attr and list entry
+   objects.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <new>
+#include "Sys/Types.hpp"
+#include "Debug.hpp"
+ASSERTFILE (__FILE__)
+
+#include "Containers/SlabPool.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Containers/TArray.hpp"
+
+// Slabs are registered by the address windows they cover, so FindOwner can
+//  map any pointer back to its pool with one hash lookup.  A window may be
+//  shared with other heap memory, so the slab's range is checked as well.
+static const INT  kWindowShift = 14;
+
+//-----------------------------------------------------------------------------
+static THashIndex<SlabPool::Slab*> &  SlabIndex  (VOID)
+  {
+  // never freed, so that objects deleted during static destruction can still find their pool.
+  static THashIndex<SlabPool::Slab*> *  pIndex = new THashIndex<SlabPool::Slab*>;
+  return (*pIndex);
+  };
+
+//-----------------------------------------------------------------------------
+static HASH_T  WindowKey  (const VOID *  pIn)
+  {
+  return (HASH_T (size_t (pIn) >> kWindowShift));
+  };
+
+// storage for the class constants, so they can be bound to references.
+const INT  SlabPool::kDefaultSlabBytes;
+const INT  SlabAllocator::kGranularity;
+const INT  SlabAllocator::kMaxBlockSize;
+const INT  SlabAllocator::kNumSizeClasses;
+const INT  SlabAllocator::kDefaultScope;
+const INT  SlabAllocator::kAllScopes;
+
+//-----------------------------------------------------------------------------
+//  SlabPool
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+SlabPool::SlabPool  (INT  iBlockSizeIn,
+                     INT  iTagIn,
+                     INT  iSlabBytesIn)
+  {
+  // blocks hold the free list link while they are free
+  INT  iAlign = INT (sizeof (VOID *));
+  iBlockSize     = ((iBlockSizeIn + iAlign - 1) / iAlign) * iAlign;
+  if (iBlockSize < iAlign) iBlockSize = iAlign;
+  iBlocksPerSlab = iSlabBytesIn / iBlockSize;
+  if (iBlocksPerSlab < 1) iBlocksPerSlab = 1;
+
+  iTag       = iTagIn;
+  pFreeList  = NULL;
+  pSlabs     = NULL;
+  iNumSlabs  = 0;
+  iNumLive   = 0;
+  iPeakLive  = 0;
+  iNumAllocs = 0;
+  };
+
+//-----------------------------------------------------------------------------
+SlabPool::~SlabPool  ()
+  {
+  if (iNumLive != 0)
+    {
+    DBG_ERROR ("SlabPool: deleting pool of %d byte blocks with %d blocks still allocated", iBlockSize, iNumLive);
+    };
+  iNumLive = 0;
+  ReleaseSlabs ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  SlabPool::AddSlab  (VOID)
+  {
+  Slab *  pSlab = new Slab;
+  INT     iSlabBytes = iBlockSize * iBlocksPerSlab;
+
+  pSlab->pStart = new UINT8 [iSlabBytes];
+  pSlab->pEnd   = pSlab->pStart + iSlabBytes;
+  pSlab->pOwner = this;
+  pSlab->pNext  = pSlabs;
+  pSlabs        = pSlab;
+  ++iNumSlabs;
+
+  for (HASH_T  uKey = WindowKey (pSlab->pStart); uKey <= WindowKey (pSlab->pEnd - 1); ++uKey)
+    {
+    SlabIndex ().Insert (uKey, pSlab);
+    };
+
+  // thread the new blocks onto the free list, lowest address first.
+  for (INT  iBlock = iBlocksPerSlab - 1; iBlock >= 0; --iBlock)
+    {
+    VOID *  pBlock = pSlab->pStart + (iBlock * iBlockSize);
+    *((VOID **) pBlock) = pFreeList;
+    pFreeList = pBlock;
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  SlabPool::ReleaseSlabs  (VOID)
+  {
+  if (iNumLive != 0) return (FALSE);
+
+  while (pSlabs != NULL)
+    {
+    Slab *  pSlab = pSlabs;
+    pSlabs = pSlab->pNext;
+
+    for (HASH_T  uKey = WindowKey (pSlab->pStart); uKey <= WindowKey (pSlab->pEnd - 1); ++uKey)
+      {
+      SlabIndex ().Remove (uKey, pSlab);
+      };
+    delete [] pSlab->pStart;
+    delete pSlab;
+    };
+  pFreeList = NULL;
+  iNumSlabs = 0;
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+SlabPool *  SlabPool::FindOwner  (const VOID *  pBlockIn)
+  {
+  THashIndex<Slab*> &  index = SlabIndex ();
+  HASH_T               uKey  = WindowKey (pBlockIn);
+
+  for (INT  iSlot = index.FindFirst (uKey); iSlot != -1; iSlot = index.FindNext (uKey, iSlot))
+    {
+    Slab *  pSlab = index.GetAt (iSlot);
+    if ((pBlockIn >= pSlab->pStart) && (pBlockIn < pSlab->pEnd))
+      {
+      return (pSlab->pOwner);
+      };
+    };
+  return (NULL);
+  };
+
+//-----------------------------------------------------------------------------
+//  SlabAllocator
+//-----------------------------------------------------------------------------
+
+struct SlabScopePools
+  {
+  INT         iScope;
+  SlabPool *  apPools [SlabAllocator::kNumCategories][SlabAllocator::kNumSizeClasses];
+  };
+
+struct SlabAllocatorState
+  {
+  BOOL                     bEnabled;
+  INT                      iScope;
+  SlabScopePools *         pCurrent;
+  TArray<SlabScopePools*>  apScopes;
+  INT64                    aiNumUnpooled [SlabAllocator::kNumCategories];
+  };
+
+//-----------------------------------------------------------------------------
+static SlabAllocatorState &  AllocatorState  (VOID)
+  {
+  // never freed, for the same reason as SlabIndex.
+  static SlabAllocatorState *  pState = NULL;
+  if (pState == NULL)
+    {
+    pState = new SlabAllocatorState;
+    pState->bEnabled = TRUE;
+    pState->iScope   = SlabAllocator::kDefaultScope;
+    pState->pCurrent = NULL;
+    for (INT  iCategory = 0; iCategory < SlabAllocator::kNumCategories; ++iCategory)
+      {
+      pState->aiNumUnpooled [iCategory] = 0;
+      };
+    };
+  return (*pState);
+  };
+
+//-----------------------------------------------------------------------------
+static SlabScopePools *  FindScope  (INT   iScopeIn,
+                                     BOOL  bCreateIn)
+  {
+  SlabAllocatorState &  state = AllocatorState ();
+
+  for (INT  iIndex = 0; iIndex < state.apScopes.Length (); ++iIndex)
+    {
+    if (state.apScopes [iIndex]->iScope == iScopeIn)
+      {
+      return (state.apScopes [iIndex]);
+      };
+    };
+  if (!bCreateIn) return (NULL);
+
+  SlabScopePools *  pScope = new SlabScopePools;
+  pScope->iScope = iScopeIn;
+  memset (pScope->apPools, 0, sizeof (pScope->apPools));
+  state.apScopes.Append (pScope);
+  return (pScope);
+  };
+
+//-----------------------------------------------------------------------------
+VOID *  SlabAllocator::Allocate  (ECategory  eCategoryIn,
+                                  size_t     uSizeIn)
+  {
+  SlabAllocatorState &  state = AllocatorState ();
+
+  if ((!state.bEnabled) || (uSizeIn > size_t (kMaxBlockSize)) || (uSizeIn == 0))
+    {
+    ++state.aiNumUnpooled [eCategoryIn];
+    return (::operator new (uSizeIn));
+    };
+
+  if (state.pCurrent == NULL)
+    {
+    state.pCurrent = FindScope (state.iScope, TRUE);
+    };
+  INT          iSizeClass = INT ((uSizeIn - 1) / kGranularity);
+  SlabPool * & pPool      = state.pCurrent->apPools [eCategoryIn][iSizeClass];
+  if (pPool == NULL)
+    {
+    pPool = new SlabPool ((iSizeClass + 1) * kGranularity, eCategoryIn);
+    };
+  return (pPool->Allocate ());
+  };
+
+//-----------------------------------------------------------------------------
+VOID  SlabAllocator::Free  (VOID *  pIn,
+                            size_t  uSizeIn)
+  {
+  if (pIn == NULL) return;
+
+  if (uSizeIn <= size_t (kMaxBlockSize))
+    {
+    SlabPool *  pOwner = SlabPool::FindOwner (pIn);
+    if (pOwner != NULL)
+      {
+      pOwner->Free (pIn);
+      return;
+      };
+    };
+  ::operator delete (pIn);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  SlabAllocator::SetEnabled  (BOOL  bEnabledIn)
+  {
+  AllocatorState ().bEnabled = bEnabledIn;
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  SlabAllocator::IsEnabled  (VOID)
+  {
+  return (AllocatorState ().bEnabled);
+  };
+
+//-----------------------------------------------------------------------------
+INT  SlabAllocator::SetScope  (INT  iScopeIn)
+  {
+  SlabAllocatorState &  state = AllocatorState ();
+  INT  iPrevScope = state.iScope;
+
+  if (iScopeIn != iPrevScope)
+    {
+    state.iScope   = iScopeIn;
+    state.pCurrent = NULL;
+    };
+  return (iPrevScope);
+  };
+
+//-----------------------------------------------------------------------------
+INT  SlabAllocator::Scope  (VOID)
+  {
+  return (AllocatorState ().iScope);
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  SlabAllocator::ReleaseScope  (INT  iScopeIn)
+  {
+  SlabAllocatorState &  state  = AllocatorState ();
+  SlabScopePools *      pScope = FindScope (iScopeIn, FALSE);
+  if (pScope == NULL) return (TRUE);
+
+  for (INT  iCategory = 0; iCategory < kNumCategories; ++iCategory)
+    {
+    for (INT  iSizeClass = 0; iSizeClass < kNumSizeClasses; ++iSizeClass)
+      {
+      SlabPool *  pPool = pScope->apPools [iCategory][iSizeClass];
+      if ((pPool != NULL) && (pPool->NumLive () != 0))
+        {
+        DBG_ERROR ("SlabAllocator::ReleaseScope (%d): %d %s objects are still allocated",
+                   iScopeIn, pPool->NumLive (), CategoryName (ECategory (iCategory)));
+        return (FALSE);
+        };
+      };
+    };
+
+  for (INT  iCategory = 0; iCategory < kNumCategories; ++iCategory)
+    {
+    for (INT  iSizeClass = 0; iSizeClass < kNumSizeClasses; ++iSizeClass)
+      {
+      delete pScope->apPools [iCategory][iSizeClass];
+      };
+    };
+  for (INT  iIndex = 0; iIndex < state.apScopes.Length (); ++iIndex)
+    {
+    if (state.apScopes [iIndex] == pScope)
+      {
+      state.apScopes.Remove (iIndex);
+      break;
+      };
+    };
+  if (state.pCurrent == pScope)
+    {
+    state.pCurrent = NULL;
+    };
+  delete pScope;
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  SlabAllocator::GetStats  (ECategory  eCategoryIn,
+                                Stats &    statsOut,
+                                INT        iScopeIn)
+  {
+  SlabAllocatorState &  state = AllocatorState ();
+
+  statsOut.iNumSlabs      = 0;
+  statsOut.iNumLive       = 0;
+  statsOut.iPeakLive      = 0;
+  statsOut.iNumAllocs     = 0;
+  statsOut.iNumUnpooled   = state.aiNumUnpooled [eCategoryIn];
+  statsOut.iBytesReserved = 0;
+
+  for (INT  iIndex = 0; iIndex < state.apScopes.Length (); ++iIndex)
+    {
+    SlabScopePools *  pScope = state.apScopes [iIndex];
+    if ((iScopeIn != kAllScopes) && (pScope->iScope != iScopeIn)) continue;
+
+    for (INT  iSizeClass = 0; iSizeClass < kNumSizeClasses; ++iSizeClass)
+      {
+      SlabPool *  pPool = pScope->apPools [eCategoryIn][iSizeClass];
+      if (pPool == NULL) continue;
+
+      statsOut.iNumSlabs      += pPool->NumSlabs ();
+      statsOut.iNumLive       += pPool->NumLive ();
+      statsOut.iPeakLive      += pPool->PeakLive ();
+      statsOut.iNumAllocs     += pPool->NumAllocs ();
+      statsOut.iBytesReserved += pPool->BytesReserved ();
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+const char *  SlabAllocator::CategoryName  (ECategory  eCategoryIn)
+  {
+  switch (eCategoryIn)
+    {
+    case kNode:       return ("Node");
+    case kComponent:  return ("Component");
+    case kAttr:       return ("Attr");
+    case kListEntry:  return ("ListEntry");
+    default:          break;
+    };
+  return ("Unknown");
+  };
+
+//-----------------------------------------------------------------------------
+VOID  SlabAllocator::DebugPrint  (RStr &  strOut)
+  {
+  strOut.AppendFormat ("SlabAllocator (%s, scope %d)\n", IsEnabled () ? "enabled" : "disabled", Scope ());
+  for (INT  iCategory = 0; iCategory < kNumCategories; ++iCategory)
+    {
+    Stats  stats;
+    GetStats (ECategory (iCategory), stats);
+    strOut.AppendFormat ("  %-10s live %7d  peak %7d  allocs %9lld  unpooled %7lld  slabs %5d  reserved %9lld bytes\n",
+                         CategoryName (ECategory (iCategory)),
+                         stats.iNumLive,
+                         stats.iPeakLive,
+                         (long long) stats.iNumAllocs,
+                         (long long) stats.iNumUnpooled,
+                         stats.iNumSlabs,
+                         (long long) stats.iBytesReserved);
+    };
+  };
@@ -0,0 +1,238 @@
+/* -----------------------------------------------------------------
+                            Slab Pool
+
+     This module implements fixed-size block pools that carve small
+   objects out of larger slabs, and a size-classed allocator built on
+   them for the scene graph's Node, Component, Attr and list entry
+   objects.  Pools may be grouped into scopes (usually a resource ID)
+   so that all the slabs used by one resource can be released at once.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SLABPOOL_HPP
+#define SLABPOOL_HPP
+
+#include <stddef.h>
+#include "Sys/Types.hpp"
+#include "Util/RStr.hpp"
+
+// NOTE:  The pools are not thread safe.  They are meant for scene graph
+//  objects, which are created and destroyed on the main thread.
+
+//-----------------------------------------------------------------------------
+class SlabPool
+  {
+  public:
+    struct Slab
+      {
+      UINT8 *     pStart;    ///< First block in the slab
+      UINT8 *     pEnd;      ///< One past the last block in the slab
+      SlabPool *  pOwner;
+      Slab *      pNext;
+      };
+
+    static const INT  kDefaultSlabBytes = 16384;
+
+  private:
+    INT       iBlockSize;     ///< Bytes per block.  Always a multiple of the pointer size.
+    INT       iBlocksPerSlab;
+    INT       iTag;           ///< Caller defined value, used to group statistics.
+    VOID *    pFreeList;      ///< Free blocks, linked through their first bytes.
+    Slab *    pSlabs;
+    INT       iNumSlabs;
+    INT       iNumLive;
+    INT       iPeakLive;
+    INT64     iNumAllocs;
+
+  private:
+    // Not copyable.
+                  SlabPool        (const SlabPool &  poolIn);
+    SlabPool &    operator=       (const SlabPool &  poolIn);
+
+    VOID          AddSlab         (VOID);
+
+  public:
+                                  /** @brief  Constructor
+                                      @param  iBlockSizeIn Size of each block in bytes.
+                                      @param  iTagIn Caller defined value returned by Tag().
+                                      @param  iSlabBytesIn Approximate size of each slab in bytes.
+                                      @return None
+                                  */
+                  SlabPool        (INT  iBlockSizeIn,
+                                   INT  iTagIn       = 0,
+                                   INT  iSlabBytesIn = kDefaultSlabBytes);
+
+                  ~SlabPool       ();
+
+                                  /** @brief  Take a block from the free list, adding a slab if there are none.
+                                      @return Pointer to an uninitialized block of BlockSize() bytes.
+                                  */
+    VOID *        Allocate        (VOID)                {
+                                                        if (pFreeList == NULL) {AddSlab ();};
+                                                        VOID *  pBlock = pFreeList;
+                                                        pFreeList = *((VOID **) pBlock);
+                                                        ++iNumAllocs;
+                                                        if (++iNumLive > iPeakLive) {iPeakLive = iNumLive;};
+                                                        return (pBlock);
+                                                        };
+
+                                  /** @brief  Return a block to the free list.
+                                      @param  pBlockIn A block returned by this pool's Allocate().
+                                      @return None
+                                  */
+    VOID          Free            (VOID *  pBlockIn)    {
+                                                        *((VOID **) pBlockIn) = pFreeList;
+                                                        pFreeList = pBlockIn;
+                                                        --iNumLive;
+                                                        };
+
+                                  /** @brief  Give all slabs back to the system at once.  Only allowed when no blocks are live.
+                                      @return True if the slabs were released, False if blocks are still in use.
+                                  */
+    BOOL          ReleaseSlabs    (VOID);
+
+                                  /** @brief  Find the pool that owns a block.
+                                      @param  pBlockIn Any pointer.
+                                      @return The owning pool, or NULL if the pointer isn't in any pool's slab.
+                                  */
+    static SlabPool *  FindOwner  (const VOID *  pBlockIn);
+
+    INT           BlockSize       (VOID) const          {return iBlockSize;};
+    INT           Tag             (VOID) const          {return iTag;};
+    INT           NumSlabs        (VOID) const          {return iNumSlabs;};
+    INT           NumLive         (VOID) const          {return iNumLive;};   ///< Blocks currently allocated
+    INT           PeakLive        (VOID) const          {return iPeakLive;};  ///< Most blocks allocated at one time
+    INT64         NumAllocs       (VOID) const          {return iNumAllocs;}; ///< Blocks allocated over the pool's life
+    INT64         BytesReserved   (VOID) const          {return (INT64 (iNumSlabs) * iBlocksPerSlab * iBlockSize);};
+  };
+
+
+//-----------------------------------------------------------------------------
+class SlabAllocator
+  {
+  public:
+    enum ECategory {kNode       = 0,
+                    kComponent  = 1,
+                    kAttr       = 2,
+                    kListEntry  = 3,
+                    kNumCategories};
+
+    static const INT  kGranularity    = 16;   ///< Requests are rounded up to a multiple of this.
+    static const INT  kMaxBlockSize   = 1024; ///< Larger requests go to the system allocator.
+    static const INT  kNumSizeClasses = kMaxBlockSize / kGranularity;
+    static const INT  kDefaultScope   = 0;
+    static const INT  kAllScopes      = -1;
+
+    struct Stats
+      {
+      INT     iNumSlabs;
+      INT     iNumLive;        ///< Pooled objects currently allocated
+      INT     iPeakLive;       ///< Sum of each pool's peak
+      INT64   iNumAllocs;      ///< Pooled allocations made
+      INT64   iNumUnpooled;    ///< Allocations passed to the system allocator because they were too large or pooling was off
+      INT64   iBytesReserved;  ///< Slab memory held by the pools
+      };
+
+  public:
+                                  /** @brief  Allocate memory for an object of the given category.
+                                      @param  eCategoryIn Which pools to allocate from.
+                                      @param  uSizeIn Size of the object in bytes.
+                                      @return Pointer to the memory.
+                                  */
+    static VOID *   Allocate      (ECategory  eCategoryIn,
+                                   size_t     uSizeIn);
+
+                                  /** @brief  Free memory returned by Allocate.  Memory that came from the system allocator
+                                              is returned to it, so this is safe to call after pooling is turned off.
+                                      @param  pIn Pointer returned by Allocate.
+                                      @param  uSizeIn The size passed to Allocate.
+                                      @return None
+                                  */
+    static VOID     Free          (VOID *  pIn,
+                                   size_t  uSizeIn);
+
+                                  /** @brief  Turn pooling on or off.  When off, Allocate uses the system allocator.
+                                      @param  bEnabledIn True to pool allocations.
+                                      @return None
+                                  */
+    static VOID     SetEnabled    (BOOL  bEnabledIn);
+
+    static BOOL     IsEnabled     (VOID);
+
+                                  /** @brief  Choose the scope that later allocations come from.  Scopes are usually
+                                              resource IDs, so a resource's slabs can be released together.
+                                      @param  iScopeIn The scope ID.  kDefaultScope is used when none is set.
+                                      @return The previous scope, so it can be restored.
+                                  */
+    static INT      SetScope      (INT  iScopeIn);
+
+    static INT      Scope         (VOID);
+
+                                  /** @brief  Give every slab in a scope back to the system at once.  The objects
+                                              in the scope must already have been deleted.
+                                      @param  iScopeIn The scope ID.
+                                      @return True if the scope was released, False if it still had live objects.
+                                  */
+    static BOOL     ReleaseScope  (INT  iScopeIn);
+
+                                  /** @brief  Collect statistics for one category.
+                                      @param  eCategoryIn The category to report on.
+                                      @param  statsOut Receives the totals.
+                                      @param  iScopeIn The scope to report on, or kAllScopes.
+                                      @return None
+                                  */
+    static VOID     GetStats      (ECategory  eCategoryIn,
+                                   Stats &    statsOut,
+                                   INT        iScopeIn = kAllScopes);
+
+    static const char *  CategoryName  (ECategory  eCategoryIn);
+
+    static VOID     DebugPrint    (RStr &  strOut);
+  };
+
+
+//-----------------------------------------------------------------------------
+class SlabScope
+  {
+  private:
+    INT   iPrevScope;
+
+  public:
+                                  /** @brief  Make allocations come from the given scope until this object goes away.
+                                      @param  iScopeIn The scope ID.
+                                      @return None
+                                  */
+    explicit      SlabScope       (INT  iScopeIn)       {iPrevScope = SlabAllocator::SetScope (iScopeIn);};
+                  ~SlabScope      ()                    {SlabAllocator::SetScope (iPrevScope);};
+  };
+
+#endif // SLABPOOL_HPP
@@ -0,0 +1,291 @@
+/* -----------------------------------------------------------------
+                        Templated Hash Index
+
+     This module implements an open-addressing hash index that maps
+     HASH_T keys to values (usually pointers).  Multiple values may be
+     stored under the same key, so callers should verify each match
+     (e.g. by comparing names) when hash collisions are possible.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2016, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef THASHINDEX_HPP
+#define THASHINDEX_HPP
+
+#include "Sys/Types.hpp"
+#include "Util/CalcHash.hpp"
+
+// NOTE:  Deleted slots are left as tombstones so that probe chains stay
+//  intact.  Tombstones are never reused by Insert; they are reclaimed
+//  when the table is rebuilt.  This keeps entries that share a key in
+//  insertion order along their probe chain.  Rebuild re-inserts each
+//  cluster of slots in probe order, starting after an empty slot, so
+//  the order survives growth and tombstone sweeps, including chains
+//  that wrap past the end of the table.
+
+//------------------------------------------------------------------------
+template <class T>
+class THashIndex
+  {
+  private:
+
+    enum ESlotState  {kEmpty   = 0,
+                      kUsed    = 1,
+                      kDeleted = 2};
+
+    static const INT  kMinCapacity = 16;
+
+    HASH_T *       puKeys;      ///< Key stored in each slot
+    T *            ptValues;    ///< Value stored in each slot
+    UINT8 *        puState;     ///< ESlotState of each slot
+    INT            iCapacity;   ///< Number of slots.  Always zero or a power of two.
+    INT            iNumUsed;    ///< Number of live entries
+    INT            iNumDeleted; ///< Number of tombstones
+
+  private:
+
+    // Not copyable.  Owners rebuild their index when they copy their contents.
+                   THashIndex     (const THashIndex<T> &  indexIn);
+    THashIndex<T> &  operator=    (const THashIndex<T> &  indexIn);
+
+                                  /** @brief  Spread the key bits so sequential hashes don't cluster.
+                                      @param  uKeyIn The key to find the home slot for.
+                                      @return Index of the first slot to probe.
+                                  */
+    INT            HomeSlot       (HASH_T  uKeyIn) const      {
+                                                              UINT32  uMixed = UINT32 (uKeyIn) * 0x9e3779b1u;
+                                                              uMixed ^= (uMixed >> 16);
+                                                              return (INT (uMixed & UINT32 (iCapacity - 1)));
+                                                              };
+
+                                  /** @brief  Rebuild the table with the given number of slots, dropping tombstones.
+                                      @param  iNewCapacityIn Number of slots.  Must be a power of two.
+                                      @return None
+                                  */
+    VOID           Rebuild        (INT  iNewCapacityIn)       {
+                                                              HASH_T *  puOldKeys     = puKeys;
+                                                              T *       ptOldValues   = ptValues;
+                                                              UINT8 *   puOldState    = puState;
+                                                              INT       iOldCapacity  = iCapacity;
+
+                                                              iCapacity   = iNewCapacityIn;
+                                                              puKeys      = new HASH_T [iCapacity];
+                                                              ptValues    = new T      [iCapacity];
+                                                              puState     = new UINT8  [iCapacity];
+                                                              memset (puState, kEmpty, iCapacity);
+                                                              iNumUsed    = 0;
+                                                              iNumDeleted = 0;
+
+                                                              // start just past an empty slot, so no cluster is entered part way
+                                                              //  through its probe chain.  The load limit keeps one empty slot.
+                                                              INT  iStart = 0;
+                                                              for (INT  iSlot = 0; iSlot < iOldCapacity; ++iSlot)
+                                                                {
+                                                                if (puOldState [iSlot] == kEmpty) {iStart = iSlot + 1; break;};
+                                                                };
+                                                              for (INT  iStep = 0; iStep < iOldCapacity; ++iStep)
+                                                                {
+                                                                INT  iSlot = (iStart + iStep) & (iOldCapacity - 1);
+                                                                if (puOldState [iSlot] == kUsed)
+                                                                  {
+                                                                  Insert (puOldKeys [iSlot], ptOldValues [iSlot]);
+                                                                  };
+                                                                };
+                                                              delete [] puOldKeys;
+                                                              delete [] ptOldValues;
+                                                              delete [] puOldState;
+                                                              };
+
+  public:
+
+                                  /** @brief  Constructor
+                                      @return None
+                                  */
+                   THashIndex     ()                          {puKeys = NULL; ptValues = NULL; puState = NULL;
+                                                               iCapacity = iNumUsed = iNumDeleted = 0;};
+
+                                  /** @brief  Destructor
+                                      @return None
+                                  */
+                   ~THashIndex    ()                          {Clear ();};
+
+                                  /** @brief  Remove all entries and release the table.
+                                      @return None
+                                  */
+    VOID           Clear          (VOID)                      {
+                                                              delete [] puKeys;   puKeys   = NULL;
+                                                              delete [] ptValues; ptValues = NULL;
+                                                              delete [] puState;  puState  = NULL;
+                                                              iCapacity = iNumUsed = iNumDeleted = 0;
+                                                              };
+
+                                  /** @brief  Query the number of live entries.
+                                      @return The number of entries in the index.
+                                  */
+    INT            Size           (VOID) const                {return (iNumUsed);};
+
+                                  /** @brief  Query the number of slots currently allocated.
+                                      @return The table capacity.
+                                  */
+    INT            Capacity       (VOID) const                {return (iCapacity);};
+
+                                  /** @brief  Make sure the table can hold the given number of entries without growing.
+                                      @param  iCountIn Number of entries to make room for.
+                                      @return None
+                                  */
+    VOID           Reserve        (INT  iCountIn)             {
+                                                              INT  iNewCapacity = (iCapacity > 0) ? iCapacity : kMinCapacity;
+                                                              while ((iCountIn + iNumDeleted) * 4 >= iNewCapacity * 3) {iNewCapacity <<= 1;};
+                                                              if (iNewCapacity != iCapacity) {Rebuild (iNewCapacity);};
+                                                              };
+
+                                  /** @brief  Add a value under the given key.  Existing entries with the same key are kept.
+                                      @param  uKeyIn The hash key.
+                                      @param  tValueIn The value to store.
+                                      @return None
+                                  */
+    VOID           Insert         (HASH_T  uKeyIn,
+                                   T       tValueIn)          {
+                                                              if ((iCapacity == 0) || ((iNumUsed + iNumDeleted + 1) * 4 >= iCapacity * 3))
+                                                                {
+                                                                // grow if live entries fill the table, otherwise just sweep the tombstones.
+                                                                INT  iNewCapacity = (iCapacity > 0) ? iCapacity : kMinCapacity;
+                                                                while ((iNumUsed + 1) * 2 >= iNewCapacity) {iNewCapacity <<= 1;};
+                                                                Rebuild (iNewCapacity);
+                                                                };
+                                                              INT  iMask = iCapacity - 1;
+                                                              INT  iSlot = HomeSlot (uKeyIn);
+                                                              while (puState [iSlot] != kEmpty)
+                                                                {
+                                                                iSlot = (iSlot + 1) & iMask;
+                                                                };
+                                                              puKeys   [iSlot] = uKeyIn;
+                                                              ptValues [iSlot] = tValueIn;
+                                                              puState  [iSlot] = kUsed;
+                                                              ++iNumUsed;
+                                                              };
+
+                                  /** @brief  Remove the entry with the given key and value.
+                                      @param  uKeyIn The hash key the value was inserted under.
+                                      @param  tValueIn The value to remove.
+                                      @return True if an entry was removed, False if it was not found.
+                                  */
+    BOOL           Remove         (HASH_T  uKeyIn,
+                                   T       tValueIn)          {
+                                                              for (INT  iSlot = FindFirst (uKeyIn); iSlot != -1; iSlot = FindNext (uKeyIn, iSlot))
+                                                                {
+                                                                if (ptValues [iSlot] == tValueIn)
+                                                                  {
+                                                                  puState [iSlot] = kDeleted;
+                                                                  --iNumUsed;
+                                                                  ++iNumDeleted;
+                                                                  return (TRUE);
+                                                                  };
+                                                                };
+                                                              return (FALSE);
+                                                              };
+
+                                  /** @brief  Remove every entry holding the given value, regardless of key.  This is a full
+                                              table scan, meant for entries whose key may have changed since insertion.
+                                      @param  tValueIn The value to remove.
+                                      @return The number of entries removed.
+                                  */
+    INT            RemoveValue    (T  tValueIn)               {
+                                                              INT  iNumRemoved = 0;
+                                                              for (INT  iSlot = 0; iSlot < iCapacity; ++iSlot)
+                                                                {
+                                                                if ((puState [iSlot] == kUsed) && (ptValues [iSlot] == tValueIn))
+                                                                  {
+                                                                  puState [iSlot] = kDeleted;
+                                                                  --iNumUsed;
+                                                                  ++iNumDeleted;
+                                                                  ++iNumRemoved;
+                                                                  };
+                                                                };
+                                                              return (iNumRemoved);
+                                                              };
+
+                                  /** @brief  Find the first slot holding the given key.
+                                      @param  uKeyIn The hash key to search for.
+                                      @return Slot index for use with GetAt and FindNext, or -1 if not found.
+                                  */
+    INT            FindFirst      (HASH_T  uKeyIn) const      {
+                                                              if (iNumUsed == 0) return (-1);
+                                                              return (Probe (uKeyIn, HomeSlot (uKeyIn)));
+                                                              };
+
+                                  /** @brief  Find the next slot after iSlotIn holding the given key.
+                                      @param  uKeyIn The hash key to search for.
+                                      @param  iSlotIn A slot previously returned by FindFirst or FindNext.
+                                      @return Slot index, or -1 if there are no more matches.
+                                  */
+    INT            FindNext       (HASH_T  uKeyIn,
+                                   INT     iSlotIn) const     {return (Probe (uKeyIn, (iSlotIn + 1) & (iCapacity - 1)));};
+
+                                  /** @brief  Walk the probe chain from iSlotIn until the key or an empty slot is found.
+                                      @param  uKeyIn The hash key to search for.
+                                      @param  iSlotIn The slot to start probing from.
+                                      @return Slot index, or -1 if not found.
+                                  */
+    INT            Probe          (HASH_T  uKeyIn,
+                                   INT     iSlotIn) const     {
+                                                              INT  iMask = iCapacity - 1;
+                                                              INT  iSlot = iSlotIn;
+                                                              while (puState [iSlot] != kEmpty)
+                                                                {
+                                                                if ((puState [iSlot] == kUsed) && (puKeys [iSlot] == uKeyIn))
+                                                                  {
+                                                                  return (iSlot);
+                                                                  };
+                                                                iSlot = (iSlot + 1) & iMask;
+                                                                };
+                                                              return (-1);
+                                                              };
+
+                                  /** @brief  Return the value stored in a slot.
+                                      @param  iSlotIn A slot returned by FindFirst or FindNext.
+                                      @return The stored value.
+                                  */
+    T              GetAt          (INT  iSlotIn) const        {return (ptValues [iSlotIn]);};
+
+                                  /** @brief  Return the first value stored under the given key.
+                                      @param  uKeyIn The hash key to search for.
+                                      @param  tDefaultIn The value to return if the key is not present.
+                                      @return The stored value, or tDefaultIn.
+                                  */
+    T              Find           (HASH_T  uKeyIn,
+                                   T       tDefaultIn) const  {
+                                                              INT  iSlot = FindFirst (uKeyIn);
+                                                              return ((iSlot == -1) ? tDefaultIn : ptValues [iSlot]);
+                                                              };
+  };
+
+#endif // THASHINDEX_HPP
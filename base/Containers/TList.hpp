@@ -38,13 +38,13 @@
 #ifndef TLIST_HPP
 #define TLIST_HPP
 
+#include <new>
 #include "Sys/Types.hpp"
+#include "Containers/SlabPool.hpp"
 
-// REFACTOR : This module could be sped up by using a pool to control the TListEntry
-//   allocations.  Since the use case for TList is almost always to store a list
-//   of pointers, this should be relatively straightforward with few problems in
-//   clearing/initializing memory.  Perhaps pool storage could be an optional flag
-//   that is set.
+// NOTE : Lists that are created and destroyed in bulk (such as the scene graph's
+//   child and attribute lists) can take their TListEntry storage from the
+//   SlabAllocator by calling SetPooledEntries.  Other lists use the heap.
 
 //------------------------------------------------------------------------
 template <class T>
@@ -214,6 +214,7 @@ class TList
     TListEntry<T>       entBeginRoot; ///< Sentinel entry for the start of the list.  pPrev will always be NULL.
     TListEntry<T>       entEndRoot;   ///< Sentinel entry for the end of the list.  pNext will always be NULL.
     UINT32              uiSize;       ///< The number of elements in the list.
+    BOOL                bPooledEntries; ///< True if entries come from the SlabAllocator instead of the heap.
 
 
   protected:
@@ -235,14 +236,34 @@ class TList
                                             @param  tDataIn The data value the new entry will be initialized with.
                                             @return None
                                         */
-    TListEntry<T> *     NewEntry        (T    tDataIn)              {return new TListEntry<T> (tDataIn);};
+    TListEntry<T> *     NewEntry        (T    tDataIn)              {return AllocEntry (tDataIn);};
+
+                                        /** @brief  Allocates a new entry from the pool or the heap, depending on how the list is set up.
+                                            @param  tDataIn The data value the new entry will be initialized with.
+                                            @return The new entry.
+                                        */
+    TListEntry<T> *     AllocEntry      (T    tDataIn)              {
+                                                                    if (!bPooledEntries) {return new TListEntry<T> (tDataIn);};
+                                                                    return new (SlabAllocator::Allocate (SlabAllocator::kListEntry, sizeof (TListEntry<T>))) TListEntry<T> (tDataIn);
+                                                                    };
+
+                                        /** @brief  Destroys an entry allocated with AllocEntry.  The entry must already be out of the chain.
+                                            @param  pentIn The entry to free.
+                                            @return None
+                                        */
+    VOID                FreeEntry       (TListEntry<T> *  pentIn)   {
+                                                                    if (pentIn == NULL) return;
+                                                                    if (!bPooledEntries) {delete (pentIn); return;};
+                                                                    pentIn->~TListEntry<T> ();
+                                                                    SlabAllocator::Free (pentIn, sizeof (TListEntry<T>));
+                                                                    };
 
                                         /** @brief  Removes the given entry from the list, and deletes it.
                                             @param  pentIn  The entry to delete.
                                         */
     VOID                DeleteEntry     (TListEntry<T> *  pentIn)   {//ASSERT (uiSize != 0);
                                                                      pentIn->Remove ();
-                                                                     delete (pentIn);
+                                                                     FreeEntry (pentIn);
                                                                      if (uiSize > 0) --uiSize;};
 
                                         /** @brief  Inserts the passed entry into the beginning of the list.
@@ -272,13 +293,14 @@ class TList
                                         /** @brief  Constructor
                                             @return None
                                         */
-                        TList           ()                           {InitializeVars ();};
+                        TList           ()                           {bPooledEntries = FALSE; InitializeVars ();};
 
                                         /** @brief  Copy Constructor.  A complete copy of the given list will be made.
                                             @param  listIn The list which is to be copied.
                                             @return None
                                         */
-                        TList           (const TList<T> &  listIn)   {InitializeVars ();
+                        TList           (const TList<T> &  listIn)   {bPooledEntries = listIn.bPooledEntries;
+                                                                      InitializeVars ();
 
                                                                       for (TListItr<T> itrCurr = listIn.First ();
                                                                            itrCurr.IsValid ();
@@ -296,11 +318,18 @@ class TList
                                                                      Empty ();
                                                                      };
 
+                                        /** @brief  Choose whether entries come from the SlabAllocator or the heap.
+                                                    Only change this while the list is empty.
+                                            @param  bPooledIn True to allocate entries from the SlabAllocator.
+                                            @return None
+                                        */
+    VOID                SetPooledEntries (BOOL  bPooledIn)          {ASSERT (uiSize == 0); bPooledEntries = bPooledIn;};
+
                                         /** @brief  Creates a new entry at the beginning of the list, initialized with the passed data.
                                             @param  tDataIn The data to add to the list.
                                             @return Returns The passed data that was inserted.
                                         */
-    T                   PushFront       (T    tDataIn)              {PushEntryFront (new TListEntry<T> (tDataIn)); return (tDataIn);};
+    T                   PushFront       (T    tDataIn)              {PushEntryFront (AllocEntry (tDataIn)); return (tDataIn);};
 
                                         /** @brief  Creates a new entry at the end of the list, initialized with the passed data.
                                             @param  tDataIn The data to add to the list
@@ -309,7 +338,7 @@ class TList
                                         */
     T                   PushBack        (T    tDataIn)              {
                                                                     //DBG_INFO ("PushBack before end(%x):prev(%x)", &entEndRoot, entEndRoot.pPrev);
-                                                                    PushEntryBack (new TListEntry<T> (tDataIn));
+                                                                    PushEntryBack (AllocEntry (tDataIn));
                                                                     //DBG_INFO ("PushBack after end(%x):prev(%x)", &entEndRoot, entEndRoot.pPrev);
                                                                     return (tDataIn);
                                                                     };
@@ -323,7 +352,7 @@ class TList
                                         TListItr<T> &    itrIn)   {
                                                                   if (itrIn.IsValid ())
                                                                     {
-                                                                    itrIn.GetEntryPtr()->InsertBefore (new TListEntry<T> (tDataIn));
+                                                                    itrIn.GetEntryPtr()->InsertBefore (AllocEntry (tDataIn));
                                                                     }
                                                                   else
                                                                     {
@@ -342,7 +371,7 @@ class TList
                                         TListItr<T> &    itrIn)   {
                                                                   if (itrIn.IsValid ())
                                                                     {
-                                                                    itrIn.GetEntryPtr()->InsertAfter (new TListEntry<T> (tDataIn));
+                                                                    itrIn.GetEntryPtr()->InsertAfter (AllocEntry (tDataIn));
                                                                     }
                                                                   else
                                                                     {
@@ -401,7 +430,7 @@ class TList
                                         */
     VOID                Delete          (TListItr<T> &  itrIn)      {TListEntry<T> *  pEntry = itrIn.GetEntryPtr();
                                                                      if (pEntry != NULL) {pEntry->Remove ();};
-                                                                     delete (pEntry);
+                                                                     FreeEntry (pEntry);
                                                                      if (uiSize > 0) --uiSize;};
 
                                         /** @brief  Deletes all entries out of the list.  Note that the items pointed to by the entries are not affected.
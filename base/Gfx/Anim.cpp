@@ -14,6 +14,8 @@ ASSERTFILE (__FILE__);
 
 AnimManager *         AnimManager::pInstance = NULL;
 TList<AnimClipBase*>  AnimManager::listClipLibrary;
+FLOAT                 AnimManager::fLibraryBakeRate     = 0.0f;
+FLOAT                 AnimManager::fLibraryBakeMaxError = 0.0f;
 
 //=============================================================================
 // Animation Clip Base
@@ -222,8 +224,9 @@ VOID AnimClipBase::OnClipDone (ValueRegistry *  pRegIn)
 MappedCurve::MappedCurve  (const char *  szMapIn)
   {
   strBaseMapping.Set (szMapIn, TRUE);
-  pelemTarget = NULL;
-  pRef        = NULL;
+  pelemTarget    = NULL;
+  pRef           = NULL;
+  iSegmentCursor = -1;
   };
 
 //-----------------------------------------------------------------------------
@@ -236,6 +239,7 @@ MappedCurve::~MappedCurve  ()
 VOID MappedCurve::SetRef  (MappedCurve *  pcurveIn)
   {
   pRef           = pcurveIn;
+  iSegmentCursor = -1;
   };
 
 //-----------------------------------------------------------------------------
@@ -263,13 +267,20 @@ VOID MappedCurve::DetachFromTarget (ValueElem *  pelemIn)
   };
 
 //-----------------------------------------------------------------------------
-VOID  MappedCurve::SetTime  (FLOAT        fTimeIn)
+VOID  MappedCurve::SetTime  (FLOAT        fTimeIn,
+                             BOOL         bBakedIn)
   {
   // NOTE:  Time is not stored, but used immediately to push values out to
   //         mapped targets.
   if (pelemTarget != NULL)
     {
-    RVec3  vecSolve = Ref()->GetPointOnCurve_X (fTimeIn);
+    if (bBakedIn && Ref()->IsBaked ())
+      {
+      pelemTarget->SetFloat (Ref()->GetBakedValue_X (fTimeIn), TRUE);
+      return;
+      };
+
+    RVec3  vecSolve = Ref()->GetPointOnCurve_X (fTimeIn, &iSegmentCursor);
 
     //DBG_INFO ("Setting curve %s to %f", pelemTarget->GetName (), vecSolve.fY);
     pelemTarget->SetFloat (vecSolve.fY, TRUE);
@@ -285,11 +296,17 @@ VOID  MappedCurve::SetTime  (FLOAT        fTimeIn)
 AnimClipCurve::AnimClipCurve (const char *  szAnimNameIn) : AnimClipBase (szAnimNameIn)
   {
   uType = MAKE_FOUR_CODE("CURV");
+  fBakeRate     = -1.0f;
+  fBakeMaxError = 0.0f;
+  bUseBaked     = FALSE;
   };
 
 //-----------------------------------------------------------------------------
 AnimClipCurve::AnimClipCurve (AnimClipBase *  pLibClipIn) : AnimClipBase (pLibClipIn)
   {
+  fBakeRate     = -1.0f;
+  fBakeMaxError = 0.0f;
+  bUseBaked     = FALSE;
   };
 
 //-----------------------------------------------------------------------------
@@ -427,19 +444,37 @@ VOID  AnimClipCurve::IncTime  (FLOAT            fTimeDeltaIn,
   // tell each curve in the clip what time it is.
   if (IsTimeInClip ())
     {
-    FLOAT  fTime = GetClippedTime ();
+    FLOAT  fTime   = GetClippedTime ();
+    BOOL   bBaked  = CurveRef ()->UseBaked ();
 
     for (TListItr<MappedCurve*> itrCurve = listCurves.First ();
         itrCurve.IsValid ();
         ++itrCurve)
       {
       //DBG_INFO ("SetCurveTime %f", fTime);
-      (*itrCurve)->SetTime (fTime);
+      (*itrCurve)->SetTime (fTime, bBaked);
       };
     };
   };
 
 
+//-----------------------------------------------------------------------------
+FLOAT  AnimClipCurve::Bake  (FLOAT  fSamplesPerSecIn,
+                             FLOAT  fMaxErrorIn)
+  {
+  ASSERT (pLibraryClip == NULL); // instances share the library clip's curves
+
+  FLOAT  fMaxError = 0.0f;
+  for (TListItr<MappedCurve*> itrCurve = listCurves.First ();
+       itrCurve.IsValid ();
+       ++itrCurve)
+    {
+    fMaxError = RMax (fMaxError, (*itrCurve)->Bake (fSamplesPerSecIn, fMaxErrorIn));
+    };
+  bUseBaked = (fSamplesPerSecIn > 0.0f);
+  return (fMaxError);
+  };
+
 //-----------------------------------------------------------------------------
 FLOAT  AnimClipCurve::GetLength  (VOID)
   {
@@ -1161,6 +1196,28 @@ AnimClipBase *  AnimManager::NewLibraryClip (const char *  szTypeIn,
   };
 
 
+//-----------------------------------------------------------------------------
+VOID  AnimManager::FinishLibraryClip (AnimClipBase *  pclipIn)
+  {
+  AnimClipCurve *  pclipCurve = dynamic_cast<AnimClipCurve *>(pclipIn);
+  if (pclipCurve == NULL)
+    {
+    return;
+    };
+
+  FLOAT  fRate     = pclipCurve->GetBakeRate ();
+  FLOAT  fMaxError = pclipCurve->GetBakeMaxError ();
+  if (fRate < 0.0f)
+    {
+    fRate     = fLibraryBakeRate;
+    fMaxError = fLibraryBakeMaxError;
+    };
+  if (fRate > 0.0f)
+    {
+    pclipCurve->Bake (fRate, fMaxError);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 VOID  AnimManager::BuildLibraryList  (RStrArray &  arrayLibsOut)
   {
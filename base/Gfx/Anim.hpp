@@ -203,6 +203,7 @@ class MappedCurve : public Curve
     RStr                 strBaseMapping;
     ValueElem *          pelemTarget;
     MappedCurve *        pRef; // use the mapping from this object, but the keyframes from the ref, if present
+    INT32                iSegmentCursor; // segment of the ref curve used by the last SetTime, so playback doesn't search from the start
 
   public:
     explicit             MappedCurve       (const char *  szMapIn);
@@ -226,7 +227,13 @@ class MappedCurve : public Curve
 
     VOID                 DetachFromTarget  (ValueElem *  pelemIn);
 
-    VOID                 SetTime           (FLOAT        fTimeIn);
+                         /** @brief  Push the curve's value at the given time out to the mapped target.
+                             @param  fTimeIn Time in seconds.
+                             @param  bBakedIn Read the ref curve's baked table instead of solving it, if it has one.
+                             @return None
+                         */
+    VOID                 SetTime           (FLOAT        fTimeIn,
+                                            BOOL         bBakedIn = FALSE);
 
 
   };
@@ -241,6 +248,10 @@ class AnimClipCurve : public AnimClipBase
 
     TList<MappedCurve*>    listCurves;
 
+    FLOAT                  fBakeRate;      // requested at load.  Below zero uses the AnimManager default, zero is always exact.
+    FLOAT                  fBakeMaxError;
+    BOOL                   bUseBaked;      // sample the baked tables instead of solving the curves
+
     // multiple curves and multiple mappings over a single time period.
     //  all clips start at 0, and clip goes until last keyframe of longest curve.
 
@@ -258,6 +269,25 @@ class AnimClipCurve : public AnimClipBase
 
     MappedCurve *   FindCurve      (const char *  szMapIn);
 
+    VOID            SetBakeRate    (FLOAT  fSamplesPerSecIn,
+                                    FLOAT  fMaxErrorIn = 0.0f)  {fBakeRate = fSamplesPerSecIn; fBakeMaxError = fMaxErrorIn;};
+
+    FLOAT           GetBakeRate    (VOID)                    {return (fBakeRate);};
+
+    FLOAT           GetBakeMaxError (VOID)                   {return (fBakeMaxError);};
+
+                    /** @brief  Bake every curve in this library clip to a lookup table, and play the clip from the tables.
+                        @param  fSamplesPerSecIn Table entries per second.
+                        @param  fMaxErrorIn If greater than zero, curves are sampled more finely until they are within this error.
+                        @return The largest error between a table and its curve.
+                    */
+    FLOAT           Bake           (FLOAT  fSamplesPerSecIn,
+                                    FLOAT  fMaxErrorIn = 0.0f);
+
+    VOID            SetUseBaked    (BOOL  bBakedIn)          {bUseBaked = bBakedIn;};
+
+    BOOL            UseBaked       (VOID)                    {return (bUseBaked);};
+
     AnimClipBase *  LinkedInstance (VOID) override;
 
     FLOAT           GetLength      (VOID) override;
@@ -351,6 +381,9 @@ class AnimManager
 
     static TList<AnimClipBase*>  listClipLibrary; // clips that are loaded from disk and can be instantiated.
 
+    static FLOAT                 fLibraryBakeRate;
+    static FLOAT                 fLibraryBakeMaxError;
+
     ValueRegistry *              pReg;
 
   public:
@@ -448,6 +481,20 @@ class AnimManager
 
     static VOID            UnloadAllClipLibraries (VOID);
 
+                           /** @brief  Set the rate that loaded curve clips are baked at, unless the clip sets its own.
+                               @param  fSamplesPerSecIn Table entries per second.  Zero leaves the clips exact.
+                               @param  fMaxErrorIn Error bound passed on to AnimClipCurve::Bake.
+                               @return None
+                           */
+    static VOID            SetLibraryBakeRate   (FLOAT  fSamplesPerSecIn,
+                                                 FLOAT  fMaxErrorIn = 0.0f)    {fLibraryBakeRate = fSamplesPerSecIn; fLibraryBakeMaxError = fMaxErrorIn;};
+
+                           /** @brief  Called by the loaders once a library clip has all its curves.  Bakes the clip if asked to.
+                               @param  pclipIn The library clip.
+                               @return None
+                           */
+    static VOID            FinishLibraryClip    (AnimClipBase *  pclipIn);
+
     static AnimClipBase *  NewLibraryClip       (const char *  szTypeIn,
                                                  const char *  szNameIn,
                                                  const char *  szLibNameIn);
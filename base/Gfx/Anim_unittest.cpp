@@ -4,8 +4,10 @@
 ASSERTFILE (__FILE__);
 
 #include "Gfx/Anim.hpp"
+#include "Sys/Timer.hpp"
 #include "Util/CalcHash.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 
@@ -256,6 +258,312 @@ TEST (AnimManager, AnimManager)
   delete (pReg);
   };
 
+//------------------------------------------------------------------------------
+static VOID  BuildLongCurve  (Curve &  curveIn,
+                              INT      iNumKeysIn,
+                              INT      iSeedIn)
+  {
+  RVec3  vecPnt;
+
+  // uneven key spacing, so the key index can't be calculated from the time.
+  FLOAT  fTime = 0.0f;
+  for (INT  iKey = 0; iKey < iNumKeysIn; ++iKey)
+    {
+    curveIn.AddPoint (vecPnt.Set (fTime, sinf (fTime * 0.5f + FLOAT (iSeedIn)) * 10.0f), NULL, NULL, Curve::kEnd);
+    fTime += 0.05f + FLOAT ((iKey * 7 + iSeedIn) % 5) * 0.02f;
+    };
+  curveIn.SetDefaultTangentType (Curve::kCatmullRom);
+  };
+
+//------------------------------------------------------------------------------
+static INT32  LinearFindSegment  (Curve &  curveIn,
+                                  FLOAT    fXIn)
+  {
+  // the search GetPointOnCurve_X used before FindSegment_X
+  INT32  iNextIndex = 0;
+  for (iNextIndex = 0; iNextIndex < curveIn.GetNumKeys (); ++iNextIndex)
+    {
+    if (curveIn.GetPointTime (iNextIndex) > fXIn)
+      {
+      break;
+      };
+    };
+  return (iNextIndex - 1);
+  };
+
+//------------------------------------------------------------------------------
+TEST (AnimManager, CurveSegmentSearch)
+  {
+  Curve  curve;
+  BuildLongCurve (curve, 200, 3);
+
+  FLOAT  fLength = curve.GetPointTime (curve.GetNumKeys () - 1);
+
+  // every hint, good or bad, gives the same segment as a linear search.
+  INT32  iCursor = -1;
+  for (FLOAT  fTime = -1.0f; fTime < fLength + 1.0f; fTime += 0.013f)
+    {
+    INT32  iExpected = LinearFindSegment (curve, fTime);
+
+    ASSERT_EQ (curve.FindSegment_X (fTime),                             iExpected);
+    ASSERT_EQ (curve.FindSegment_X (fTime, iCursor),                    iExpected);
+    ASSERT_EQ (curve.FindSegment_X (fTime, curve.GetNumKeys () - 1),    iExpected);
+    ASSERT_EQ (curve.FindSegment_X (fTime, curve.GetNumKeys () + 10),   iExpected);
+    ASSERT_EQ (curve.FindSegment_X (fTime, (iExpected * 31) % 200),     iExpected);
+
+    RVec3  vecPlain  = curve.GetPointOnCurve_X (fTime);
+    RVec3  vecCursor = curve.GetPointOnCurve_X (fTime, &iCursor);
+    ASSERT_EQ (iCursor, iExpected);
+    ASSERT_TRUE (vecPlain == vecCursor);
+    };
+
+  // keys are hit exactly, and jumping backwards still finds the right segment.
+  for (INT  iKey = curve.GetNumKeys () - 1; iKey >= 0; iKey -= 3)
+    {
+    FLOAT  fKeyTime = curve.GetPointTime (iKey);
+
+    ASSERT_EQ (curve.FindSegment_X (fKeyTime, iCursor), iKey);
+    ASSERT_TRUE (FLT_APPROX_EQUAL (curve.GetPointOnCurve_X (fKeyTime, &iCursor).fX, fKeyTime));
+    ASSERT_EQ (iCursor, iKey);
+    };
+
+  Curve  curveEmpty;
+  ASSERT_EQ (curveEmpty.FindSegment_X (1.0f, 0), -1);
+  };
+
+//------------------------------------------------------------------------------
+TEST (AnimManager, CurveSegmentBenchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT    iNumCurves = 16;
+  const INT    iNumKeys   = 2000;
+  const FLOAT  fFrameSec  = 1.0f / 60.0f;
+  RStr         strAttr;
+
+  ValueRegistry *  pReg = new ValueRegistrySimple;
+  AnimManager::Instance()->SetValueRegistry (pReg);
+
+  AnimClipCurve *  pclipCurve = dynamic_cast<AnimClipCurve*>(AnimManager::NewLibraryClip ("curve",
+                                                                                          "LongClip",
+                                                                                          "res://gfx/clips/long.anim"));
+  ASSERT_TRUE (pclipCurve != NULL);
+
+  for (INT  iCurve = 0; iCurve < iNumCurves; ++iCurve)
+    {
+    strAttr.Format ("Attr%d", iCurve);
+    BuildLongCurve (*pclipCurve->NewCurve (strAttr.AsChar ()), iNumKeys, iCurve);
+
+    strAttr.Format ("Bench.Attr%d", iCurve);
+    pReg->SetFloat (strAttr.AsChar (), 0.0f);
+    };
+
+  AnimManager::Instance()->NewChan ("Bench");
+  AnimManager::Instance()->PlayClip ("LongClip", "Bench");
+
+  FLOAT  fLength  = pclipCurve->GetLength ();
+  INT    iFrames  = INT (fLength / fFrameSec) - 1;
+  FLOAT  fTime    = 0.0f;
+
+  // play the whole clip through the manager, the way a game would
+  INT64  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFrame = 0; iFrame < iFrames; ++iFrame)
+    {
+    AnimManager::Instance()->IncTime (fFrameSec);
+    fTime += fFrameSec;
+    };
+  INT64  iPlayUs = StopWatch::GetTimeUs () - iStartUs;
+
+  MappedCurve *  pCurve = pclipCurve->FindCurve ("Attr5");
+  ASSERT_TRUE (pCurve != NULL);
+  ASSERT_NEAR (pReg->GetFloat ("Bench.Attr5"), pCurve->GetPointOnCurve_X (fTime).fY, 0.001f);
+
+  // the same samples with only the search changed, to show what the cursor saves.
+  FLOAT  fChecksum = 0.0f;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFrame = 0; iFrame < iFrames; ++iFrame)
+    {
+    fChecksum += FLOAT (LinearFindSegment (*pCurve, FLOAT (iFrame) * fFrameSec));
+    };
+  INT64  iLinearUs = StopWatch::GetTimeUs () - iStartUs;
+
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFrame = 0; iFrame < iFrames; ++iFrame)
+    {
+    fChecksum -= FLOAT (pCurve->FindSegment_X (FLOAT (iFrame) * fFrameSec));
+    };
+  INT64  iBinaryUs = StopWatch::GetTimeUs () - iStartUs;
+
+  INT32  iCursor = -1;
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iFrame = 0; iFrame < iFrames; ++iFrame)
+    {
+    iCursor = pCurve->FindSegment_X (FLOAT (iFrame) * fFrameSec, iCursor);
+    fChecksum += FLOAT (iCursor);
+    };
+  INT64  iCursorUs = StopWatch::GetTimeUs () - iStartUs;
+
+  BenchmarkPrintf ("Curve playback, %d curves x %d keys, %d frames:  IncTime %.3f us/frame.  Segment search per sample:  linear %.3f us  binary %.3f us  cursor %.3f us  (checksum %.1f)\n",
+                   iNumCurves, iNumKeys, iFrames,
+                   DOUBLE (iPlayUs)   / DOUBLE (iFrames),
+                   DOUBLE (iLinearUs) / DOUBLE (iFrames),
+                   DOUBLE (iBinaryUs) / DOUBLE (iFrames),
+                   DOUBLE (iCursorUs) / DOUBLE (iFrames),
+                   fChecksum);
+
+  AnimManager::DestroyInstance();
+  delete (pReg);
+  };
+
+//------------------------------------------------------------------------------
+TEST (AnimManager, CurveBake)
+  {
+  Curve  curve;
+  BuildLongCurve (curve, 100, 1);
+  ASSERT_FALSE (curve.IsBaked ());
+
+  FLOAT  fLength = curve.GetPointTime (curve.GetNumKeys () - 1);
+
+  // without a bound the rate is used as given
+  FLOAT  fError = curve.Bake (2.0f);
+  ASSERT_TRUE (curve.IsBaked ());
+  ASSERT_EQ (curve.GetNumBakedSamples (), INT32 (ceilf (fLength * 2.0f)) + 1);
+  ASSERT_GT (fError, 0.01f);
+  ASSERT_TRUE (FLT_APPROX_EQUAL (curve.GetBakedError (), fError));
+
+  // with a bound the table is refined until it is close enough
+  fError = curve.Bake (2.0f, 0.01f);
+  ASSERT_LE (fError, 0.01f);
+  ASSERT_GT (curve.GetNumBakedSamples (), INT32 (ceilf (fLength * 2.0f)) + 1);
+
+  FLOAT  fMeasured = 0.0f;
+  for (FLOAT  fTime = 0.0f; fTime < fLength; fTime += 0.0037f)
+    {
+    fMeasured = RMax (fMeasured, FLOAT (fabs (curve.GetBakedValue_X (fTime) - curve.GetPointOnCurve_X (fTime).fY)));
+    };
+  ASSERT_LE (fMeasured, 0.02f);
+
+  // keys and the ends of the table match the curve, and lookups clamp outside it.
+  ASSERT_NEAR (curve.GetBakedValue_X (0.0f),           curve.GetPointValue (0), 0.0001f);
+  ASSERT_NEAR (curve.GetBakedValue_X (fLength),        curve.GetPointValue (curve.GetNumKeys () - 1), 0.0001f);
+  ASSERT_NEAR (curve.GetBakedValue_X (-5.0f),          curve.GetPointValue (0), 0.0001f);
+  ASSERT_NEAR (curve.GetBakedValue_X (fLength + 5.0f), curve.GetPointValue (curve.GetNumKeys () - 1), 0.0001f);
+
+  // copies keep the table, edits throw it away
+  Curve  curveCopy;
+  curveCopy = curve;
+  ASSERT_TRUE (curveCopy.IsBaked ());
+  ASSERT_EQ (curveCopy.GetNumBakedSamples (), curve.GetNumBakedSamples ());
+
+  RVec3  vecPnt;
+  curve.AddPoint (vecPnt.Set (fLength + 1.0f, 0.0f));
+  ASSERT_FALSE (curve.IsBaked ());
+  curveCopy.RemovePoint (3);
+  ASSERT_FALSE (curveCopy.IsBaked ());
+
+  // huge rates and unreachable bounds stop at the sample cap
+  ASSERT_LT (curveCopy.Bake (1.0e9f), 1.0f);
+  ASSERT_EQ (curveCopy.GetNumBakedSamples (), Curve::kMaxBakedSamples);
+  fError = curveCopy.Bake (4000.0f, 1.0e-9f);
+  ASSERT_EQ (curveCopy.GetNumBakedSamples (), Curve::kMaxBakedSamples);
+  ASSERT_GT (fError, 1.0e-9f);
+
+  // nothing to bake
+  Curve  curveSingle;
+  curveSingle.AddPoint (vecPnt.Set (1.0f, 1.0f));
+  ASSERT_EQ (curveSingle.Bake (30.0f), 0.0f);
+  ASSERT_FALSE (curveSingle.IsBaked ());
+  };
+
+//------------------------------------------------------------------------------
+TEST (AnimManager, CurveBakeClip)
+  {
+  // short clips unless timing the playback with --benchmarks.
+  const INT    iNumCurves = 16;
+  const INT    iNumKeys   = UnitTestBenchmarks () ? 500 : 50;
+  const FLOAT  fFrameSec  = 1.0f / 60.0f;
+  RStr         strAttr;
+
+  ValueRegistry *  pReg = new ValueRegistrySimple;
+  AnimManager::Instance()->SetValueRegistry (pReg);
+
+  // one clip left exact, one that asks for its own rate, and one baked by the manager default.
+  AnimClipCurve *  aclips [3];
+  const char *     aszNames [3] = {"ExactClip", "OwnRateClip", "DefaultRateClip"};
+  const char *     aszChans [3] = {"Exact", "OwnRate", "DefaultRate"};
+
+  AnimManager::SetLibraryBakeRate (30.0f, 0.01f);
+  for (INT  iClip = 0; iClip < 3; ++iClip)
+    {
+    aclips [iClip] = dynamic_cast<AnimClipCurve*>(AnimManager::NewLibraryClip ("curve",
+                                                                               aszNames [iClip],
+                                                                               "res://gfx/clips/baked.anim"));
+    ASSERT_TRUE (aclips [iClip] != NULL);
+    for (INT  iCurve = 0; iCurve < iNumCurves; ++iCurve)
+      {
+      strAttr.Format ("Attr%d", iCurve);
+      BuildLongCurve (*aclips [iClip]->NewCurve (strAttr.AsChar ()), iNumKeys, iCurve);
+
+      strAttr.Format ("%s.Attr%d", aszChans [iClip], iCurve);
+      pReg->SetFloat (strAttr.AsChar (), 0.0f);
+      };
+    };
+  aclips [0]->SetBakeRate (0.0f);
+  aclips [1]->SetBakeRate (60.0f);
+
+  // what the loader does once a clip is read
+  for (INT  iClip = 0; iClip < 3; ++iClip)
+    {
+    AnimManager::FinishLibraryClip (aclips [iClip]);
+    };
+  AnimManager::SetLibraryBakeRate (0.0f);
+
+  ASSERT_FALSE (aclips [0]->UseBaked ());
+  ASSERT_FALSE (aclips [0]->FindCurve ("Attr0")->IsBaked ());
+  ASSERT_TRUE  (aclips [1]->UseBaked ());
+  ASSERT_TRUE  (aclips [2]->UseBaked ());
+  ASSERT_LE    (aclips [2]->FindCurve ("Attr0")->GetBakedError (), 0.01f);
+
+  FLOAT  fLength = aclips [1]->FindCurve ("Attr0")->GetPointTime (iNumKeys - 1);
+  ASSERT_NEAR (FLOAT (aclips [1]->FindCurve ("Attr0")->GetNumBakedSamples ()), ceilf (fLength * 60.0f) + 1.0f, 1.0f);
+
+  // play each clip on its own channel, timing them one at a time
+  INT    iFrames = INT (aclips [0]->GetLength () / fFrameSec) - 1;
+  INT64  aiUs [3];
+  FLOAT  fTime = 0.0f;
+  for (INT  iClip = 0; iClip < 3; ++iClip)
+    {
+    AnimManager::Instance()->NewChan (aszChans [iClip]);
+    AnimManager::Instance()->PlayClip (aszNames [iClip], aszChans [iClip]);
+
+    fTime = 0.0f;
+    INT64  iStartUs = StopWatch::GetTimeUs ();
+    for (INT  iFrame = 0; iFrame < iFrames; ++iFrame)
+      {
+      AnimManager::Instance()->IncTime (fFrameSec);
+      fTime += fFrameSec;
+      };
+    aiUs [iClip] = StopWatch::GetTimeUs () - iStartUs;
+    AnimManager::Instance()->StopChan (aszChans [iClip]);
+    };
+
+  // the baked clips land on their tables, and stay close to the exact clip.
+  MappedCurve *  pCurve = aclips [2]->FindCurve ("Attr7");
+  ASSERT_NEAR (pReg->GetFloat ("Exact.Attr7"),       pCurve->GetPointOnCurve_X (fTime).fY, 0.0001f);
+  ASSERT_NEAR (pReg->GetFloat ("DefaultRate.Attr7"), pCurve->GetBakedValue_X (fTime),      0.0001f);
+  ASSERT_NEAR (pReg->GetFloat ("DefaultRate.Attr7"), pReg->GetFloat ("Exact.Attr7"),       0.02f);
+  ASSERT_NEAR (pReg->GetFloat ("OwnRate.Attr7"),     pReg->GetFloat ("Exact.Attr7"),       0.05f);
+
+  BenchmarkPrintf ("Curve clip playback, %d curves x %d keys, %d frames:  exact %.3f us/frame  baked %.3f us/frame (%.1fx)\n",
+                   iNumCurves, iNumKeys, iFrames,
+                   DOUBLE (aiUs [0]) / DOUBLE (iFrames),
+                   DOUBLE (aiUs [2]) / DOUBLE (iFrames),
+                   DOUBLE (aiUs [0]) / DOUBLE (RMax (INT64 (1), aiUs [2])));
+
+  AnimManager::DestroyInstance();
+  delete (pReg);
+  };
+
   /*
     // AnimManager
     // XFade : (can scale chans separeately, and sum all results)
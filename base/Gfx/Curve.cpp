@@ -39,11 +39,14 @@
 #include <math.h>
 
 #include "Sys/Types.hpp"
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
 #include "Gfx/Curve.hpp"
 #include "Containers/DoubleArray.hpp"
 
 INT32  Curve::iApproximationRecursionLevel = 10;
 FLOAT  Curve::fKeyTimeEpsilon              = 0.001f;  // one one-thousandth of a second
+const INT32  Curve::kMaxBakedSamples;
 
 //-----------------------------------------------------------------------------
 Curve::Curve  ()
@@ -64,6 +67,9 @@ VOID Curve::Init (VOID)
   avecOutTangents.Clear ();
   afTwistWeights.Clear ();
   afBaseSegmentLengths.Clear ();
+  ClearBaked ();
+  fBakedStartX  = 0.0f;
+  fBakedInvStep = 0.0f;
 
   eDefaultInterp = kCatmullRom;
 
@@ -81,27 +87,23 @@ RVec3  Curve::GetPointOnCurve  (FLOAT  fT) const
   };
 
 //-----------------------------------------------------------------------------
-RVec3  Curve::GetPointOnCurve_X (FLOAT  fXIn)
+RVec3  Curve::GetPointOnCurve_X (FLOAT    fXIn,
+                                 INT32 *  piCursorInOut)
   {
   // Given the passed X value, find the first instance where the curve crosses that point.
   //  Assume that Time is laid out on the X axis.
 
   // Use piecewise approximation to find the intersection.
 
-  INT32  iFirstIndex = 0;
-  INT32  iNextIndex  = 0;
-  INT32  iNumKeys = avecControlVerts.Length ();
-  for (iNextIndex = 0; iNextIndex < iNumKeys; ++iNextIndex)
+  INT32  iNumKeys    = avecControlVerts.Length ();
+  INT32  iFirstIndex = FindSegment_X (fXIn, (piCursorInOut == NULL) ? -1 : *piCursorInOut);
+  INT32  iNextIndex  = iFirstIndex + 1;
+
+  if (piCursorInOut != NULL)
     {
-    if (avecControlVerts [iNextIndex].fX > fXIn)
-      {
-      // found one larger than the given value, so this is the first key to the right of the sample X.
-      break;
-      };
+    *piCursorInOut = iFirstIndex;
     };
 
-  iFirstIndex = iNextIndex - 1;
-
   if (iFirstIndex < 0)
     {
     // sample point is to the left of all the keys.  Handle out-of-bounds calculations.
@@ -162,6 +164,139 @@ RVec3  Curve::GetPointOnCurve_X (FLOAT  fXIn)
   return (LERP (vecLeft, vecRight, fT));
   };
 
+//-----------------------------------------------------------------------------
+INT32  Curve::FindSegment_X  (FLOAT  fXIn,
+                              INT32  iHintIn) const
+  {
+  INT32  iNumKeys = avecControlVerts.Length ();
+
+  // Playback usually moves forward a little at a time, so the hinted segment
+  //  or the one right after it is the answer most of the time.
+  if ((iHintIn >= 0) && (iHintIn < iNumKeys) && (avecControlVerts [iHintIn].fX <= fXIn))
+    {
+    if ((iHintIn + 1 >= iNumKeys) || (avecControlVerts [iHintIn + 1].fX > fXIn))
+      {
+      return (iHintIn);
+      };
+    if ((iHintIn + 2 >= iNumKeys) || (avecControlVerts [iHintIn + 2].fX > fXIn))
+      {
+      return (iHintIn + 1);
+      };
+    };
+
+  // binary search for the first key to the right of the sample X.  Keys are sorted by X.
+  INT32  iLow  = 0;
+  INT32  iHigh = iNumKeys;
+  while (iLow < iHigh)
+    {
+    INT32  iMid = (iLow + iHigh) / 2;
+    if (avecControlVerts [iMid].fX > fXIn)
+      {
+      iHigh = iMid;
+      }
+    else
+      {
+      iLow = iMid + 1;
+      };
+    };
+  return (iLow - 1);
+  };
+
+//-----------------------------------------------------------------------------
+FLOAT  Curve::Bake  (FLOAT  fSamplesPerSecIn,
+                     FLOAT  fMaxErrorIn)
+  {
+  ClearBaked ();
+
+  INT32  iNumKeys = avecControlVerts.Length ();
+  if ((iNumKeys < 2) || (fSamplesPerSecIn <= 0.0f))
+    {
+    return (0.0f);
+    };
+
+  FLOAT  fStartX  = avecControlVerts [0].fX;
+  FLOAT  fRangeX  = avecControlVerts [iNumKeys - 1].fX - fStartX;
+  if (fRangeX <= 0.0f)
+    {
+    return (0.0f);
+    };
+
+  FLOAT  fRate       = fSamplesPerSecIn;
+  FLOAT  fMaxError   = 0.0f;
+  INT32  iNumSamples = 0;
+  BOOL   bCapped     = FALSE;
+  for (INT  iPass = 0; iPass <= 8; ++iPass)
+    {
+    // count in double, since a long curve at a high rate overflows an INT32.
+    DOUBLE  dNumSamples = ceil (DOUBLE (fRangeX) * DOUBLE (fRate)) + 1.0;
+    bCapped     = (dNumSamples >= DOUBLE (kMaxBakedSamples));
+    iNumSamples = bCapped ? kMaxBakedSamples : RMax (INT32 (2), INT32 (dNumSamples));
+
+    FLOAT  fStep       = fRangeX / FLOAT (iNumSamples - 1);
+    INT32  iCursor     = -1;
+
+    afBakedValues.SetLength (iNumSamples);
+    FLOAT *  afValues = (FLOAT *) afBakedValues.GetRawBuffer ();
+    for (INT32  iSample = 0; iSample < iNumSamples; ++iSample)
+      {
+      afValues [iSample] = GetPointOnCurve_X (fStartX + FLOAT (iSample) * fStep, &iCursor).fY;
+      };
+
+    // measure the error between the entries, where the lerp is furthest from the samples.
+    fMaxError = 0.0f;
+    iCursor   = -1;
+    for (INT32  iSample = 0; iSample < iNumSamples - 1; ++iSample)
+      {
+      for (INT  iQuarter = 1; iQuarter < 4; ++iQuarter)
+        {
+        FLOAT  fFraction = FLOAT (iQuarter) * 0.25f;
+        FLOAT  fExact    = GetPointOnCurve_X (fStartX + (FLOAT (iSample) + fFraction) * fStep, &iCursor).fY;
+        FLOAT  fLerp     = afValues [iSample] + (afValues [iSample + 1] - afValues [iSample]) * fFraction;
+
+        fMaxError = RMax (fMaxError, FLOAT (fabs (fExact - fLerp)));
+        };
+      };
+
+    fBakedStartX  = fStartX;
+    fBakedInvStep = 1.0f / fStep;
+
+    if ((fMaxErrorIn <= 0.0f) || (fMaxError <= fMaxErrorIn) || bCapped)
+      {
+      break;
+      };
+    fRate *= 2.0f;
+    };
+
+  if ((fMaxErrorIn > 0.0f) && (fMaxError > fMaxErrorIn))
+    {
+    DBG_WARNING ("Curve::Bake () - error %f is above the bound %f with %d samples%s", fMaxError, fMaxErrorIn, iNumSamples, bCapped ? " (capped)" : "");
+    };
+  fBakedMaxError = fMaxError;
+  return (fMaxError);
+  };
+
+//-----------------------------------------------------------------------------
+FLOAT  Curve::GetBakedValue_X  (FLOAT  fXIn) const
+  {
+  INT32          iNumSamples = afBakedValues.Length ();
+  const FLOAT *  afValues    = (const FLOAT *) afBakedValues.GetRawBuffer ();
+
+  FLOAT  fPos = (fXIn - fBakedStartX) * fBakedInvStep;
+  if (fPos <= 0.0f)
+    {
+    return (afValues [0]);
+    };
+
+  INT32  iIndex = INT32 (fPos);
+  if (iIndex >= iNumSamples - 1)
+    {
+    return (afValues [iNumSamples - 1]);
+    };
+
+  FLOAT  fFraction = fPos - FLOAT (iIndex);
+  return (afValues [iIndex] + (afValues [iIndex + 1] - afValues [iIndex]) * fFraction);
+  };
+
 //-----------------------------------------------------------------------------
 EStatus  Curve::SampleCurveSegment  (INT32         iStartIndex,
                                      INT32         iArrayStartIndex,
@@ -223,6 +358,8 @@ INT32  Curve::AddPoint  (const RVec3 & vecPointIn,
   INT32    iInsertPoint = 0;
   BOOL     bOverwrite   = false;
 
+  ClearBaked ();
+
   // calculate the insertion point
 
   switch (eInsertIn)
@@ -343,6 +480,7 @@ RVec3  Curve::SolveForPoint  (INT32        iFirstIndex,
 EStatus  Curve::CalcTangents (INT32        iStartIndex,
                               INT32        iEndIndex)
   {
+  ClearBaked ();
 
   switch (eDefaultInterp)
     {
@@ -467,6 +605,11 @@ Curve &  Curve::operator=  (const Curve &  curveIn)
   afBaseSegmentLengths = curveIn.afBaseSegmentLengths;
   eTwistMode           = curveIn.eTwistMode;
 
+  afBakedValues        = curveIn.afBakedValues;
+  fBakedStartX         = curveIn.fBakedStartX;
+  fBakedInvStep        = curveIn.fBakedInvStep;
+  fBakedMaxError       = curveIn.fBakedMaxError;
+
   return (*this);
   };
 
@@ -512,6 +655,7 @@ VOID  Curve::ClearPoints  (VOID)
   avecOutTangents .Clear ();
   afTwistWeights  .Clear ();
   afBaseSegmentLengths.Clear ();
+  ClearBaked ();
   };
 
 
@@ -530,6 +674,7 @@ VOID  Curve::RemovePoint  (INT32  iIndexIn)
   avecOutTangents .Remove (iIndexIn, 1);
   afTwistWeights  .Remove (iIndexIn, 1);
   afBaseSegmentLengths.Remove (iIndexIn, 1);
+  ClearBaked ();
 
   CalcTangents (iIndexIn - 1, RMin (iIndexIn, avecControlVerts.Length () - 1));
   };
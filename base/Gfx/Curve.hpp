@@ -87,6 +87,8 @@ class Curve
 
     static FLOAT      fKeyTimeEpsilon;
 
+    static const INT32  kMaxBakedSamples = 64 * 1024;  ///< Largest table Bake will build, whatever the rate.
+
   private:
 
     RVec3Array     avecControlVerts;
@@ -95,6 +97,11 @@ class Curve
     FloatArray     afTwistWeights;
     FloatArray     afBaseSegmentLengths;
 
+    FloatArray     afBakedValues;     ///< Y values resampled at even X steps.  Empty if not baked.
+    FLOAT          fBakedStartX;
+    FLOAT          fBakedInvStep;     ///< samples per unit of X
+    FLOAT          fBakedMaxError;
+
   public:
 
               Curve                  ();
@@ -102,9 +109,9 @@ class Curve
 
     VOID      Init                   (VOID);
 
-    VOID      SetPoints              (const RVec3Array &  avecControlVertsIn)  {avecControlVerts  = avecControlVertsIn;};
-    VOID      SetInTangents          (const RVec3Array &  avecInTangentsIn)    {avecInTangents    = avecInTangentsIn;};
-    VOID      SetOutTangents         (const RVec3Array &  avecOutTangentsIn)   {avecOutTangents   = avecOutTangentsIn;};
+    VOID      SetPoints              (const RVec3Array &  avecControlVertsIn)  {avecControlVerts  = avecControlVertsIn; ClearBaked ();};
+    VOID      SetInTangents          (const RVec3Array &  avecInTangentsIn)    {avecInTangents    = avecInTangentsIn;   ClearBaked ();};
+    VOID      SetOutTangents         (const RVec3Array &  avecOutTangentsIn)   {avecOutTangents   = avecOutTangentsIn;  ClearBaked ();};
     VOID      SetTwistWeights        (const FloatArray &  afTwistWeightsIn)    {afTwistWeights    = afTwistWeightsIn;};
 
     VOID        SetTwistMode         (ETwistMode  eModeIn)    {eTwistMode = eModeIn;};
@@ -115,7 +122,51 @@ class Curve
 
     RVec3     GetPointOnCurve        (FLOAT  fT) const;
 
-    RVec3     GetPointOnCurve_X      (FLOAT  fXIn);
+                                     /** @brief  Solve for the point where the curve crosses the given X (time) value.
+                                         @param  fXIn The X value to solve for.
+                                         @param  piCursorInOut Optional segment cursor kept by the caller between
+                                                   calls.  It is checked before searching, and updated with
+                                                   the segment that was used.  Start it at -1.
+                                         @return The point on the curve
+                                     */
+    RVec3     GetPointOnCurve_X      (FLOAT    fXIn,
+                                      INT32 *  piCursorInOut = NULL);
+
+                                     /** @brief  Find the last key at or before the given X value.
+                                         @param  fXIn The X value to search for.
+                                         @param  iHintIn Segment to check first, along with the one after it.
+                                                   Pass -1 to go straight to a binary search.
+                                         @return Index of the key, or -1 if fXIn is before the first key.
+                                     */
+    INT32     FindSegment_X          (FLOAT  fXIn,
+                                      INT32  iHintIn = -1) const;
+
+                                     /** @brief  Resample the Y values of the curve at even X steps into a table,
+                                                   so they can be looked up with a lerp instead of solved.
+                                                   Editing the keys throws the table away.
+                                         @param  fSamplesPerSecIn Table entries per unit of X (seconds).
+                                         @param  fMaxErrorIn If greater than zero, the rate is doubled (up to 8 times)
+                                                   until the table is within this distance of the curve.
+                                                   The table never grows past kMaxBakedSamples; if the bound
+                                                   still isn't met a warning is logged.
+                                         @return The largest difference found between the table and GetPointOnCurve_X.
+                                     */
+    FLOAT     Bake                   (FLOAT  fSamplesPerSecIn,
+                                      FLOAT  fMaxErrorIn = 0.0f);
+
+    VOID      ClearBaked             (VOID)                {afBakedValues.Clear (); fBakedMaxError = 0.0f;};
+
+    BOOL      IsBaked                (VOID) const          {return (afBakedValues.Length () > 0);};
+
+    INT32     GetNumBakedSamples     (VOID) const          {return (afBakedValues.Length ());};
+
+    FLOAT     GetBakedError          (VOID) const          {return (fBakedMaxError);};
+
+                                     /** @brief  Look up the Y value at the given X in the baked table.  Clamps outside the keys.
+                                         @param  fXIn The X value to look up.
+                                         @return The interpolated Y value.  Only valid if IsBaked ().
+                                     */
+    FLOAT     GetBakedValue_X        (FLOAT  fXIn) const;
 
     EStatus   SampleCurveSegment     (INT32         iStartIndex,
                                       INT32         iArrayStartIndex,
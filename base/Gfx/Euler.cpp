@@ -251,6 +251,34 @@ VOID  Euler::ToMatrix (RMatrix &  matOut)
     };
   };
 
+//-----------------------------------------------------------------------------
+VOID  Euler::ToMatrixF (RMatrixF &  matOut)
+  {
+  RMatrixF  matRotX;
+  RMatrixF  matRotY;
+  RMatrixF  matRotZ;
+
+  matRotX.SetRotateX (this->fX * R_DEG_TO_RAD);
+  matRotY.SetRotateY (this->fY * R_DEG_TO_RAD);
+  matRotZ.SetRotateZ (this->fZ * R_DEG_TO_RAD);
+
+  switch (eOrder)
+    {
+    case XYZ:
+          matOut = matRotZ * matRotY * matRotX; break;
+    case XZY:
+          matOut = matRotY * matRotZ * matRotX; break;
+    case YZX:
+          matOut = matRotX * matRotZ * matRotY; break;
+    case YXZ:
+          matOut = matRotZ * matRotX * matRotY; break;
+    case ZXY:
+          matOut = matRotY * matRotX * matRotZ; break;
+    case ZYX:
+          matOut = matRotX * matRotY * matRotZ; break;
+    };
+  };
+
 // This approach to converting Matrix to Euler is derived from the blog post at:
 // http://khayyam.kaplinski.com/2011/06/more-about-matrix-to-euler-angles.html
 
@@ -40,6 +40,7 @@
 #include "Sys/Types.hpp"
 #include "Math/RVec.hpp"
 #include "Math/RMatrix.hpp"
+#include "Math/RMatrixF.hpp"
 
 /**
   Euler angles are stored in degrees, and internally converted to radians as needed.
@@ -78,6 +79,8 @@ class Euler : public RVec3
 
     VOID  ToMatrix     (RMatrix &  matOut);
 
+    VOID  ToMatrixF    (RMatrixF &  matOut);  ///< Single precision version of ToMatrix.
+
     VOID  FromMatrix   (const RMatrix &  matIn,
                         Euler            eulBase);
 
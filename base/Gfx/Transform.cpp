@@ -41,6 +41,7 @@ ASSERTFILE (__FILE__);
 #include "Math/RVec.hpp"
 #include "Math/RMatrix.hpp"
 #include "Gfx/Transform.hpp"
+#include "Gfx/TransformBatch.hpp"
 
 #define OPT_DBG_INFO(...)      ((void)0)
 //#define OPT_DBG_INFO  DBG_INFO
@@ -70,12 +71,30 @@ Transform::Transform  ()
   pRectSolver = NULL;
 
   pszID = NULL;
+
+  pBatch      = NULL;
+  iBatchIndex = -1;
   };
 
 
 //-----------------------------------------------------------------------------
 Transform::~Transform ()
   {
+  // leave the hierarchy and the batch, so neither the parent nor the batch
+  //  keeps a pointer to this transform.  Children are left without a parent.
+  UnParent ();
+  if (pBatch != NULL)
+    {
+    SetBatch (NULL);
+    };
+  for (Transform *  pCurr = pChildren; pCurr != NULL; )
+    {
+    Transform *  pNext = pCurr->pSibling;
+    pCurr->pParent  = NULL;
+    pCurr->pSibling = NULL;
+    pCurr = pNext;
+    };
+  pChildren = NULL;
 
   if (pRectSolver != NULL)
     {
@@ -142,9 +161,43 @@ Transform &  Transform::CalcLocalMatrix ()
   };
 
 
+//-----------------------------------------------------------------------------
+VOID  Transform::CalcLocalMatrixF (RMatrixF &  matOut)
+  {
+  if (bLocalDirty && bCalcFromComponents)
+    {
+    if (bEulerRotate)
+      {
+      eulRotate.ToMatrixF (matOut);
+      }
+    else
+      {
+      matOut.FromQuat (RVec4F (quatRotate));
+      };
+
+    // same as multiplying the scale matrix on the left, as CalcLocalMatrix does.
+    matOut.PreScale (vecScale.fX, vecScale.fY, vecScale.fZ);
+    matOut.SetTrans (vecTranslate.fX, vecTranslate.fY, vecTranslate.fZ);
+
+    matLocal.SetF (matOut.fArray);
+    bLocalDirty = FALSE;
+    }
+  else
+    {
+    CalcLocalMatrix ();
+    matOut.Set (matLocal);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 Transform &  Transform::CalcWorldMatrix ()
   {
+  if ((pBatch != NULL) && pBatch->NeedsUpdate ())
+    {
+    // solves this transform along with everything else that changed in the batch.
+    pBatch->Update ();
+    };
+
   if (bWorldDirty)
     {
     CalcLocalMatrix ();
@@ -193,6 +246,14 @@ VOID Transform::SetParent (Transform *  pParentIn)
     {
     pSibling = pParent->pChildren;
     pParent->pChildren = this;
+    if (pParent->pBatch != pBatch)
+      {
+      SetBatch (pParent->pBatch);
+      }
+    else if (pBatch != NULL)
+      {
+      pBatch->MarkOrderDirty ();
+      };
     pParent->MarkHierarchyDirty ();
     };
   }
@@ -222,6 +283,10 @@ VOID Transform::UnParent (VOID)
           }
         pParent = NULL;
         pSibling = NULL;
+        if (pBatch != NULL)
+          {
+          SetBatch (NULL);
+          };
         return;
         }
       pPrev = pCurr;
@@ -248,6 +313,20 @@ VOID Transform::MarkHierarchyDirty (VOID)
   // mark self
   bWorldDirty = TRUE;
 
+  if (pBatch != NULL)
+    {
+    // the batch pushes the flag down to the children when it updates.
+    if (iBatchIndex >= 0)
+      {
+      pBatch->MarkDirty (iBatchIndex);
+      }
+    else
+      {
+      pBatch->MarkOrderDirty ();
+      };
+    return;
+    };
+
   // mark children
   Transform *  pCurr = pChildren;
   while (pCurr != NULL)
@@ -257,6 +336,28 @@ VOID Transform::MarkHierarchyDirty (VOID)
     };
   }
 
+//-----------------------------------------------------------------------------
+VOID Transform::SetBatch (TransformBatch *  pBatchIn)
+  {
+  if (pBatch != NULL)
+    {
+    pBatch->RemoveNode (this);
+    };
+  pBatch      = pBatchIn;
+  iBatchIndex = -1;
+  bWorldDirty = TRUE;
+  if (pBatch != NULL)
+    {
+    // placed in the batch's arrays on its next update.
+    pBatch->MarkOrderDirty ();
+    };
+
+  for (Transform *  pCurr = pChildren; pCurr != NULL; pCurr = pCurr->pSibling)
+    {
+    pCurr->SetBatch (pBatchIn);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 BOOL  Transform::AncestorsAreDirty (VOID)
   {
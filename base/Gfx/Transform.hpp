@@ -46,6 +46,8 @@
 #include "Math/RectSolver.hpp"
 #include "Gfx/Euler.hpp"
 
+class TransformBatch;
+
 
 /**
 
@@ -86,6 +88,9 @@ class Transform
 
     const char *  pszID;
 
+    TransformBatch *  pBatch;       ///< Batch that solves this transform's world matrix, or NULL.
+    INT               iBatchIndex;  ///< Index in pBatch, or -1 if it hasn't been placed yet.
+
   public:
 
                Transform       ();
@@ -116,6 +121,8 @@ class Transform
 
     Transform &  CalcWorldMatrix ();
 
+    VOID         CalcLocalMatrixF (RMatrixF &  matOut);  ///< Single precision CalcLocalMatrix.  Also updates matLocal.
+
 
     Transform &  operator=   (const Transform &  trans)  {vecTranslate = trans.vecTranslate;
                                                           eulRotate = trans.eulRotate;
@@ -149,9 +156,9 @@ class Transform
 
     RMatrix *  WorldMatrixPtr  (VOID)                   {CalcWorldMatrix (); return &matWorld;};
 
-    VOID       SetLocalMatrix  (const FLOAT *  afArrayIn)   {bCalcFromComponents = FALSE; matLocal.SetF (afArrayIn); MarkHierarchyDirty ();};
+    VOID       SetLocalMatrix  (const FLOAT *  afArrayIn)   {bCalcFromComponents = FALSE; matLocal.SetF (afArrayIn); bLocalDirty = TRUE; MarkHierarchyDirty ();};
 
-    VOID       SetLocalMatrix  (const RMatrix &  matIn)     {bCalcFromComponents = FALSE; matLocal.Set (matIn); MarkHierarchyDirty ();};
+    VOID       SetLocalMatrix  (const RMatrix &  matIn)     {bCalcFromComponents = FALSE; matLocal.Set (matIn); bLocalDirty = TRUE; MarkHierarchyDirty ();};
 
     VOID       SetParent       (Transform *  pParentIn);
 
@@ -163,6 +170,10 @@ class Transform
 
     VOID         MarkHierarchyDirty     (VOID);
 
+    VOID         SetBatch               (TransformBatch *  pBatchIn);  ///< Move this transform and its descendants into a batch, or out of one with NULL.
+
+    TransformBatch *  GetBatch          (VOID)     {return (pBatch);};
+
     BOOL         AncestorsAreDirty      (VOID);
 
     VOID         MarkRectDirty          (VOID)                       {bRectDirty = TRUE;};
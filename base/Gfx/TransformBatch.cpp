@@ -0,0 +1,279 @@
+/* -----------------------------------------------------------------
+                           Transform Batch
+
+     This module keeps the transforms of one or more hierarchies in
+     flat, depth sorted arrays so their world matrices can be solved
+     in a single pass with float SIMD kernels, instead of recursing
+     up the parent links of each node.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+#include "Gfx/TransformBatch.hpp"
+#include "Gfx/Transform.hpp"
+#include "Math/RMatrixF.hpp"
+
+//-----------------------------------------------------------------------------
+//  TransformBatch
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+TransformBatch::TransformBatch  ()
+  {
+  pafBuffer   = NULL;
+  pafLocal    = NULL;
+  pafWorld    = NULL;
+  iBufferSize = 0;
+  bOrderDirty = FALSE;
+  bAnyDirty   = FALSE;
+  bFloatLocals = FALSE;
+
+  // large hierarchies are rebuilt by appending one node at a time.
+  apNodes.SetSizeIncrement   (4096);
+  aiParents.SetSizeIncrement (4096);
+  aDirty.SetSizeIncrement    (4096);
+  };
+
+//-----------------------------------------------------------------------------
+TransformBatch::~TransformBatch  ()
+  {
+  Clear ();
+  delete [] pafBuffer;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::AddRoot  (Transform *  pRootIn)
+  {
+  if (pRootIn->pParent != NULL)
+    {
+    DBG_ERROR ("TransformBatch::AddRoot () : Root transform has a parent.");
+    return;
+    };
+  pRootIn->SetBatch (this);
+  apRoots.Append (pRootIn);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::RemoveRoot  (Transform *  pRootIn)
+  {
+  if (pRootIn->pBatch == this)
+    {
+    pRootIn->SetBatch (NULL);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::Clear  (VOID)
+  {
+  // SetBatch removes each root from apRoots, along with the nodes under it.
+  while (apRoots.Length () > 0)
+    {
+    apRoots [apRoots.Length () - 1]->SetBatch (NULL);
+    };
+
+  apNodes.Clear ();
+  aiParents.Clear ();
+  aDirty.Clear ();
+  bOrderDirty = FALSE;
+  bAnyDirty   = FALSE;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::RemoveNode  (Transform *  pTransformIn)
+  {
+  INT  iIndex = pTransformIn->iBatchIndex;
+  if ((iIndex >= 0) && (iIndex < apNodes.Length ()) && (apNodes [iIndex] == pTransformIn))
+    {
+    apNodes [iIndex] = NULL;
+    };
+  for (INT  iRoot = 0; iRoot < apRoots.Length (); ++iRoot)
+    {
+    if (apRoots [iRoot] == pTransformIn)
+      {
+      apRoots.Remove (iRoot);
+      break;
+      };
+    };
+  pTransformIn->iBatchIndex = -1;
+  bOrderDirty = TRUE;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::AllocMatrices  (INT  iNumNodesIn)
+  {
+  if (iNumNodesIn <= iBufferSize)
+    {
+    return;
+    };
+  delete [] pafBuffer;
+
+  // room for both arrays, plus slack to start them on a 16 byte boundary.
+  pafBuffer   = new FLOAT [iNumNodesIn * 32 + 4];
+  pafLocal    = (FLOAT *) ((((uintptr_t) pafBuffer) + 15) & ~((uintptr_t) 15));
+  pafWorld    = pafLocal + (iNumNodesIn * 16);
+  iBufferSize = iNumNodesIn;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::Rebuild  (VOID)
+  {
+  // forget the old placement.  Nodes still in the batch are placed again below.
+  for (INT  iIndex = 0; iIndex < apNodes.Length (); ++iIndex)
+    {
+    Transform *  pNode = apNodes [iIndex];
+    if ((pNode != NULL) && (pNode->pBatch == this))
+      {
+      pNode->iBatchIndex = -1;
+      };
+    };
+  apNodes.Clear ();
+  aiParents.Clear ();
+
+  for (INT  iRoot = 0; iRoot < apRoots.Length (); ++iRoot)
+    {
+    // a root that was parented since it was added is reached from its new parent.
+    if (apRoots [iRoot]->pParent == NULL)
+      {
+      apNodes.Append   (apRoots [iRoot]);
+      aiParents.Append (-1);
+      };
+    };
+
+  // breadth first, so every parent is placed before its children.
+  for (INT  iHead = 0; iHead < apNodes.Length (); ++iHead)
+    {
+    for (Transform *  pChild = apNodes [iHead]->pChildren; pChild != NULL; pChild = pChild->pSibling)
+      {
+      apNodes.Append   (pChild);
+      aiParents.Append (iHead);
+      };
+    };
+
+  INT  iNumNodes = apNodes.Length ();
+  AllocMatrices (iNumNodes);
+  aDirty.SetLength (iNumNodes);
+
+  for (INT  iIndex = 0; iIndex < iNumNodes; ++iIndex)
+    {
+    Transform *  pNode = apNodes [iIndex];
+    pNode->pBatch      = this;
+    pNode->iBatchIndex = iIndex;
+    CalcLocal (pNode, &pafLocal [iIndex * 16]);
+    aDirty [iIndex] = 1;
+    };
+
+  bOrderDirty = FALSE;
+  bAnyDirty   = TRUE;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::Update  (VOID)
+  {
+  if (bOrderDirty)
+    {
+    Rebuild ();
+    };
+  if (! bAnyDirty)
+    {
+    return;
+    };
+
+  INT           iNumNodes  = apNodes.Length ();
+  Transform **  apNodeBuf  = apNodes.GetRawBuffer ();
+  INT *         aiParent   = aiParents.GetRawBuffer ();
+  UINT8 *       aDirtyBuf  = aDirty.GetRawBuffer ();
+
+  // parents come first, so one forward pass pushes the dirty flags all the
+  //  way down, and every parent's world matrix is ready before its children need it.
+  for (INT  iIndex = 0; iIndex < iNumNodes; ++iIndex)
+    {
+    INT  iParent = aiParent [iIndex];
+    if ((iParent >= 0) && aDirtyBuf [iParent])
+      {
+      aDirtyBuf [iIndex] = 1;
+      };
+    if (! aDirtyBuf [iIndex])
+      {
+      continue;
+      };
+
+    Transform *  pNode      = apNodeBuf [iIndex];
+    FLOAT *      pafNodeLoc = &pafLocal [iIndex * 16];
+    FLOAT *      pafNodeWld = &pafWorld [iIndex * 16];
+
+    if (pNode->bLocalDirty)
+      {
+      CalcLocal (pNode, pafNodeLoc);
+      };
+
+    if (iParent >= 0)
+      {
+      RMatrixF::Multiply (&pafWorld [iParent * 16], pafNodeLoc, pafNodeWld);
+      }
+    else
+      {
+      for (INT  iElem = 0; iElem < 16; ++iElem)
+        {
+        pafNodeWld [iElem] = pafNodeLoc [iElem];
+        };
+      };
+    };
+
+  // copy the results back for the nodes that changed, and reset the flags.
+  for (INT  iIndex = 0; iIndex < iNumNodes; ++iIndex)
+    {
+    if (aDirtyBuf [iIndex])
+      {
+      apNodeBuf [iIndex]->matWorld.SetF (&pafWorld [iIndex * 16]);
+      apNodeBuf [iIndex]->bWorldDirty = FALSE;
+      aDirtyBuf [iIndex] = 0;
+      };
+    };
+  bAnyDirty = FALSE;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  TransformBatch::CalcLocal  (Transform *  pNodeIn,
+                                  FLOAT *      afLocalOut)
+  {
+  if (bFloatLocals)
+    {
+    // the local arrays are 16 byte aligned, the same as RMatrixF.
+    pNodeIn->CalcLocalMatrixF (*((RMatrixF *) afLocalOut));
+    }
+  else
+    {
+    pNodeIn->CalcLocalMatrix ();
+    pNodeIn->matLocal.GetFloatArray (afLocalOut);
+    };
+  };
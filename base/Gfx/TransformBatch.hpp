@@ -0,0 +1,159 @@
+/* -----------------------------------------------------------------
+                           Transform Batch
+
+     This module keeps the transforms of one or more hierarchies in
+     flat, depth sorted arrays so their world matrices can be solved
+     in a single pass with float SIMD kernels, instead of recursing
+     up the parent links of each node.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef TRANSFORMBATCH_HPP
+#define TRANSFORMBATCH_HPP
+
+#include "Sys/Types.hpp"
+#include "Containers/TArray.hpp"
+
+class Transform;
+
+// NOTE:  The batch doesn't own its transforms.  Nodes are stored breadth
+//  first from the roots, so every parent comes before its children and a
+//  single forward pass can both push dirty flags down the hierarchy and
+//  solve the world matrices.  Local and world matrices are kept as column
+//  major float arrays, 16 byte aligned, and the world result is copied back
+//  into Transform::matWorld for the nodes that changed, so callers keep
+//  using Transform and TransformComponent as before.
+//
+//  The local TRS is still converted to a matrix by the Transform, since that
+//  is where the euler orders and quaternion support live.  SetFloatLocals
+//  switches this from CalcLocalMatrix to the single precision
+//  CalcLocalMatrixF.
+//
+//  Parenting a transform under a batched one adds it to the batch, and
+//  unparenting it removes it.  These only flag the order for rebuilding,
+//  which happens on the next Update.
+//
+//  World owns a batch rooted at the transform of its root node, so node
+//  transforms join it as scenes are loaded and parented.
+//  Shell::StaticGameLoop updates it once per frame.
+
+//-----------------------------------------------------------------------------
+class TransformBatch
+  {
+  private:
+    TArray<Transform *>  apRoots;
+    TArray<Transform *>  apNodes;       ///< Depth sorted.  NULL for nodes deleted since the last rebuild.
+    TArray<INT>          aiParents;     ///< Index of each node's parent in apNodes, or -1 for roots.
+    TArray<UINT8>        aDirty;        ///< Non-zero if the node's world matrix needs solving.
+
+    FLOAT *              pafBuffer;     ///< Unaligned allocation holding the two matrix arrays.
+    FLOAT *              pafLocal;      ///< 16 floats per node, 16 byte aligned.
+    FLOAT *              pafWorld;      ///< 16 floats per node, 16 byte aligned.
+    INT                  iBufferSize;   ///< Number of nodes the matrix arrays have room for.
+
+    BOOL                 bOrderDirty;
+    BOOL                 bAnyDirty;
+    BOOL                 bFloatLocals;
+
+  private:
+
+    VOID               Rebuild           (VOID);
+
+    VOID               CalcLocal         (Transform *  pNodeIn,
+                                          FLOAT *      afLocalOut);
+
+    VOID               AllocMatrices     (INT          iNumNodesIn);
+
+  public:
+
+                       TransformBatch    ();
+
+                       ~TransformBatch   ();
+
+                       /** @brief  Add a hierarchy to the batch.  All of its descendants are added with it.
+                           @param  pRootIn The top of the hierarchy.  Must not have a parent.
+                           @return None
+                       */
+    VOID               AddRoot           (Transform *  pRootIn);
+
+                       /** @brief  Remove a hierarchy that was added with AddRoot.
+                           @param  pRootIn The top of the hierarchy.
+                           @return None
+                       */
+    VOID               RemoveRoot        (Transform *  pRootIn);
+
+                       /** @brief  Take every transform out of the batch.
+                           @return None
+                       */
+    VOID               Clear             (VOID);
+
+    INT                NumNodes          (VOID)                   {if (bOrderDirty) {Rebuild ();}; return (apNodes.Length ());};
+
+    BOOL               NeedsUpdate       (VOID) const             {return (bAnyDirty || bOrderDirty);};
+
+                       /** @brief  Build local matrices in single precision with Transform::CalcLocalMatrixF.
+                           @param  bFloatIn True for single precision, false (the default) for CalcLocalMatrix.
+                           @return None
+                       */
+    VOID               SetFloatLocals    (BOOL         bFloatIn)  {bFloatLocals = bFloatIn;};
+
+                       /** @brief  Flag a node as changed.  Called by Transform::MarkHierarchyDirty.
+                           @param  iIndexIn Index of the node in the batch.
+                           @return None
+                       */
+    VOID               MarkDirty         (INT          iIndexIn)  {aDirty[iIndexIn] = 1; bAnyDirty = TRUE;};
+
+                       /** @brief  Flag the node order for rebuilding, after a parent changed.
+                           @return None
+                       */
+    VOID               MarkOrderDirty    (VOID)                   {bOrderDirty = TRUE;};
+
+                       /** @brief  Take a single transform out of the batch.  Called by Transform::SetBatch and
+                                   when a batched transform is deleted.  Use RemoveRoot to remove a hierarchy.
+                           @param  pTransformIn The transform.
+                           @return None
+                       */
+    VOID               RemoveNode        (Transform *  pTransformIn);
+
+                       /** @brief  Solve the world matrix of every node that changed, or that has an ancestor that changed.
+                           @return None
+                       */
+    VOID               Update            (VOID);
+
+                       /** @brief  World matrix of a node as column major floats, as of the last Update.
+                           @param  iIndexIn Index of the node in the batch.
+                           @return Pointer to 16 floats.
+                       */
+    const FLOAT *      WorldFloatArray   (INT          iIndexIn) const  {return (&pafWorld[iIndexIn * 16]);};
+  };
+
+#endif // TRANSFORMBATCH_HPP
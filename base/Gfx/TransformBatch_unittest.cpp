@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Gfx/Transform.hpp"
+#include "Gfx/TransformBatch.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
+
+// NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
+
+//------------------------------------------------------------------------------
+static UINT32  TransformBatchTest_Rand  (UINT32 &  uSeedIn)
+  {
+  uSeedIn = uSeedIn * 1664525 + 1013904223;
+  return (uSeedIn >> 8);
+  };
+
+//------------------------------------------------------------------------------
+static FLOAT  TransformBatchTest_RandF  (UINT32 &  uSeedIn,
+                                         FLOAT     fRangeIn)
+  {
+  return ((FLOAT (TransformBatchTest_Rand (uSeedIn) % 2001) / 1000.0f - 1.0f) * fRangeIn);
+  };
+
+//------------------------------------------------------------------------------
+static VOID  TransformBatchTest_Build  (Transform *  aTransIn,
+                                        INT          iNumIn,
+                                        UINT32       uSeedIn)
+  {
+  // each node is parented to a random earlier node, so node 0 is the only root.
+  for (INT  iIndex = 0; iIndex < iNumIn; ++iIndex)
+    {
+    Transform &  trans = aTransIn [iIndex];
+
+    trans.SetPosition (TransformBatchTest_RandF (uSeedIn, 5.0f),
+                       TransformBatchTest_RandF (uSeedIn, 5.0f),
+                       TransformBatchTest_RandF (uSeedIn, 5.0f));
+    if (iIndex % 3 == 0)
+      {
+      trans.SetQuaternion (0.0f, 0.38268343f, 0.0f, 0.92387953f);
+      }
+    else
+      {
+      trans.SetEuler (TransformBatchTest_RandF (uSeedIn, 90.0f),
+                      TransformBatchTest_RandF (uSeedIn, 90.0f),
+                      TransformBatchTest_RandF (uSeedIn, 90.0f),
+                      (iIndex % 2) ? Euler::XYZ : Euler::ZXY);
+      };
+    FLOAT  fScale = 0.9f + TransformBatchTest_RandF (uSeedIn, 0.05f);
+    trans.SetScale (fScale, fScale, fScale);
+
+    if (iIndex > 0)
+      {
+      trans.SetParent (&aTransIn [TransformBatchTest_Rand (uSeedIn) % iIndex]);
+      };
+    };
+  };
+
+//------------------------------------------------------------------------------
+static FLOAT  TransformBatchTest_MaxError  (Transform *  aBatchedIn,
+                                            Transform *  aPlainIn,
+                                            INT          iNumIn)
+  {
+  FLOAT  fMaxError = 0.0f;
+  for (INT  iIndex = 0; iIndex < iNumIn; ++iIndex)
+    {
+    RMatrix &  matBatched = aBatchedIn [iIndex].WorldMatrix ();
+    RMatrix &  matPlain   = aPlainIn   [iIndex].WorldMatrix ();
+
+    for (INT  iElem = 0; iElem < 16; ++iElem)
+      {
+      fMaxError = RMax (fMaxError, FLOAT (fabs (matBatched.fArray [iElem] - matPlain.fArray [iElem])));
+      };
+    };
+  return (fMaxError);
+  };
+
+//------------------------------------------------------------------------------
+TEST (TransformBatch, MatchesRecursive)
+  {
+  const INT  iNumNodes = 500;
+
+  Transform *  aBatched = new Transform [iNumNodes];
+  Transform *  aPlain   = new Transform [iNumNodes];
+
+  TransformBatchTest_Build (aBatched, iNumNodes, 1234);
+  TransformBatchTest_Build (aPlain,   iNumNodes, 1234);
+
+  TransformBatch  batch;
+  batch.AddRoot (&aBatched [0]);
+  ASSERT_EQ (batch.NumNodes (), iNumNodes);
+  ASSERT_TRUE (aBatched [iNumNodes - 1].GetBatch () == &batch);
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+  ASSERT_FALSE (batch.NeedsUpdate ());
+
+  // changes part way down the hierarchy reach the descendants.
+  for (INT  iIndex = 0; iIndex < iNumNodes; iIndex += 37)
+    {
+    aBatched [iIndex].SetPosition (1.0f, FLOAT (iIndex) * 0.01f, -2.0f);
+    aPlain   [iIndex].SetPosition (1.0f, FLOAT (iIndex) * 0.01f, -2.0f);
+    };
+  ASSERT_TRUE (batch.NeedsUpdate ());
+  ASSERT_TRUE (aBatched [iNumNodes - 1].AncestorsAreDirty () == aPlain [iNumNodes - 1].AncestorsAreDirty ());
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+
+  // reparenting within the batch
+  aBatched [200].SetParent (&aBatched [3]);
+  aPlain   [200].SetParent (&aPlain   [3]);
+  aBatched [3].SetScale (1.5f, 1.5f, 1.5f);
+  aPlain   [3].SetScale (1.5f, 1.5f, 1.5f);
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+
+  // unparenting takes the subtree out of the batch
+  aBatched [100].UnParent ();
+  aPlain   [100].UnParent ();
+  aPlain   [100].MarkHierarchyDirty ();
+  ASSERT_TRUE (aBatched [100].GetBatch () == NULL);
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+  ASSERT_LT (batch.NumNodes (), iNumNodes);
+
+  // a set local matrix is picked up too
+  RMatrix  matLocal;
+  matLocal.Identity ();
+  matLocal.SetTrans (3.0f, 4.0f, 5.0f);
+  aBatched [7].SetLocalMatrix (matLocal);
+  aPlain   [7].SetLocalMatrix (matLocal);
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+
+  // single precision locals
+  batch.SetFloatLocals (TRUE);
+  for (INT  iIndex = 1; iIndex < iNumNodes; iIndex += 11)
+    {
+    aBatched [iIndex].SetEuler (10.0f, FLOAT (iIndex % 90), -20.0f, Euler::YZX);
+    aPlain   [iIndex].SetEuler (10.0f, FLOAT (iIndex % 90), -20.0f, Euler::YZX);
+    };
+  aBatched [5].SetQuaternion (0.0f, 0.0f, 0.38268343f, 0.92387953f);
+  aPlain   [5].SetQuaternion (0.0f, 0.0f, 0.38268343f, 0.92387953f);
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.001f);
+
+  // deleting a batched transform and clearing leaves the rest unbatched
+  Transform *  pExtra = new Transform;
+  pExtra->SetParent (&aBatched [1]);
+  ASSERT_TRUE (pExtra->GetBatch () == &batch);
+  pExtra->WorldMatrix ();
+  pExtra->UnParent ();
+  delete (pExtra);
+  batch.Update ();
+
+  batch.Clear ();
+  ASSERT_TRUE (aBatched [0].GetBatch () == NULL);
+  ASSERT_TRUE (aBatched [iNumNodes - 1].GetBatch () == NULL);
+  ASSERT_EQ (batch.NumNodes (), 0);
+
+  delete [] aBatched;
+  delete [] aPlain;
+  };
+
+//------------------------------------------------------------------------------
+TEST (TransformBatch, Benchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumNodes  = 100000;
+  const INT  iNumFrames = 10;
+
+  Transform *  aBatched = new Transform [iNumNodes];
+  Transform *  aPlain   = new Transform [iNumNodes];
+
+  TransformBatchTest_Build (aBatched, iNumNodes, 99);
+  TransformBatchTest_Build (aPlain,   iNumNodes, 99);
+
+  TransformBatch  batch;
+  batch.AddRoot (&aBatched [0]);
+  batch.Update ();
+
+  // every frame moves the root and animates one node in ten, so every world
+  //  matrix is solved again, then reads all the world matrices back the way a
+  //  renderer would.  The batch runs the frame twice, once with each
+  //  precision for the local matrices.
+  INT64  iPlainUs   = 0;
+  INT64  iBatchedUs = 0;
+  INT64  iFloatUs   = 0;
+  DOUBLE dChecksum  = 0.0;
+  for (INT  iFrame = 0; iFrame < iNumFrames; ++iFrame)
+    {
+    INT64  iStartUs = StopWatch::GetTimeUs ();
+    aPlain [0].SetPosition (FLOAT (iFrame), 0.0f, 0.0f);
+    for (INT  iIndex = 1; iIndex < iNumNodes; iIndex += 10)
+      {
+      aPlain [iIndex].SetEuler (FLOAT (iFrame), 0.0f, 45.0f);
+      };
+    for (INT  iIndex = 0; iIndex < iNumNodes; ++iIndex)
+      {
+      dChecksum += aPlain [iIndex].WorldMatrix ().fArray [12];
+      };
+    iPlainUs += StopWatch::GetTimeUs () - iStartUs;
+
+    for (INT  iPass = 0; iPass < 2; ++iPass)
+      {
+      batch.SetFloatLocals (iPass == 1);
+
+      iStartUs = StopWatch::GetTimeUs ();
+      aBatched [0].SetPosition (FLOAT (iFrame), 0.0f, 0.0f);
+      for (INT  iIndex = 1; iIndex < iNumNodes; iIndex += 10)
+        {
+        aBatched [iIndex].SetEuler (FLOAT (iFrame), 0.0f, 45.0f);
+        };
+      for (INT  iIndex = 0; iIndex < iNumNodes; ++iIndex)
+        {
+        dChecksum -= aBatched [iIndex].WorldMatrix ().fArray [12] * 0.5;
+        };
+      ((iPass == 0) ? iBatchedUs : iFloatUs) += StopWatch::GetTimeUs () - iStartUs;
+      };
+    };
+
+  ASSERT_LT (TransformBatchTest_MaxError (aBatched, aPlain, iNumNodes), 0.01f);
+
+  BenchmarkPrintf ("Transform hierarchy, %d nodes:  recursive %9.3f ms  batched %9.3f ms (%.1fx)  batched float locals %9.3f ms (%.1fx)  (checksum %.3f)\n",
+                   iNumNodes,
+                   DOUBLE (iPlainUs)   / DOUBLE (1000 * iNumFrames),
+                   DOUBLE (iBatchedUs) / DOUBLE (1000 * iNumFrames),
+                   DOUBLE (iPlainUs) / DOUBLE (RMax (INT64 (1), iBatchedUs)),
+                   DOUBLE (iFloatUs)   / DOUBLE (1000 * iNumFrames),
+                   DOUBLE (iPlainUs) / DOUBLE (RMax (INT64 (1), iFloatUs)),
+                   dChecksum);
+
+  batch.Clear ();
+  delete [] aBatched;
+  delete [] aPlain;
+  };
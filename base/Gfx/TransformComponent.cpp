@@ -91,16 +91,8 @@ TransformComponent::~TransformComponent ()
   };
 
 //-----------------------------------------------------------------------------
-Attr *  TransformComponent::SetAttr (const char *  szNameIn,
-                                     const char *  szValueIn)
+VOID  TransformComponent::OnAttrChanged (Attr *  pattrChanged)
   {
-  Attr *  pattrChanged = Component::SetAttr (szNameIn, szValueIn);
-
-  if (pattrChanged == NULL)
-    {
-    return NULL;
-    }
-
   // handle any changes that result from setting new values in attrs
   if ((pattrChanged == static_cast<Attr *>(pattrTx)) ||
       (pattrChanged == static_cast<Attr *>(pattrTy)) ||
@@ -133,7 +125,6 @@ Attr *  TransformComponent::SetAttr (const char *  szNameIn,
     {
     pattrTz->SetRegistryKey (pattrTzRegistryKey->GetString ());
     }
-  return pattrChanged;
   }
 
 //-----------------------------------------------------------------------------
@@ -145,6 +136,13 @@ VOID  TransformComponent::SetParent  (TransformComponent *  pcmpParentIn)
   transform.pszID = pParentID;
   };
 
+//-----------------------------------------------------------------------------
+INT  TransformComponent::IdentifierID  (VOID)
+  {
+  static INT  iID = Component::Types ().Register (szTransformComponentID);
+  return (iID);
+  };
+
 //-----------------------------------------------------------------------------
 VOID TransformComponent::CacheTransform (Component *             pcmpSiblingIn,
                                          TransformComponent * *  ppCachedTransformOut)
@@ -157,7 +155,7 @@ VOID TransformComponent::CacheTransform (Component *             pcmpSiblingIn,
 
   while (pSearch->IsValid ())
     {
-    Component *  pcmpInterface = pSearch->GetInterface (TransformComponent::Identifier ());
+    Component *  pcmpInterface = pSearch->GetInterfaceByID (IdentifierID ());
     if (pcmpInterface != NULL)
       {
       *ppCachedTransformOut = dynamic_cast<TransformComponent *>(pcmpInterface);
@@ -78,14 +78,17 @@ class TransformComponent : public Component
 
     static  const char *  Identifier       (VOID)                             {return szTransformComponentID;};
 
+    static  INT           IdentifierID     (VOID);  ///< ID of Identifier () in Component::Types ()
+
     virtual Component *   GetInterface     (const char *  szTypeIn)  override {if streq(szTypeIn, szTransformComponentID) return (dynamic_cast<Component *>(this)); return (NULL);};
 
     virtual Component *   Instantiate      (VOID) const              override {return new TransformComponent;};
 
+    virtual UINT32        CallbackMask     (VOID) const              override {return ComponentCallback::kNone;};
+
     virtual Transform &   GetTransform     (VOID)                             {ApplyTranslation(); ApplyRotation(); ApplyScale(); return transform;};
 
-    virtual Attr *        SetAttr          (const char *  szNameIn,
-                                            const char *  szValueIn) override;
+    virtual VOID          OnAttrChanged    (Attr *  pattrChangedIn)  override;
 
     VOID                  SetParent        (TransformComponent *  pcmpParentIn);
 
@@ -0,0 +1,414 @@
+/* -----------------------------------------------------------------
+                     Single Precision Matrix Library
+
+     This module contains 16 byte aligned float matrix and vector
+     types, with SSE2 and NEON versions of the heavier operations.
+     They sit alongside RMatrix and RVec4, for code that ends up
+     handing floats to the graphics API anyway.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+#include "Math/RMatrixF.hpp"
+#include "Containers/RVecArray.hpp"
+#include "Containers/RMatrixArray.hpp"
+
+//------------------------------------------------------------------------
+// Four wide float operations
+//------------------------------------------------------------------------
+
+// The operations below are written once against these helpers.  Lane 3
+//  of V4Cross3 is always zero, and V4Dot3 ignores lane 3.
+
+#if defined (__SSE2__) || defined (_M_X64)
+
+  #include <emmintrin.h>
+
+  typedef __m128  V4;
+
+  static inline V4     V4Load    (const FLOAT *  afIn)         {return (_mm_load_ps (afIn));};
+  static inline VOID   V4Store   (FLOAT *  afOut, V4  vIn)     {_mm_store_ps (afOut, vIn);};
+  static inline V4     V4Splat   (FLOAT  fIn)                  {return (_mm_set1_ps (fIn));};
+  static inline V4     V4Add     (V4  vA, V4  vB)              {return (_mm_add_ps (vA, vB));};
+  static inline V4     V4Sub     (V4  vA, V4  vB)              {return (_mm_sub_ps (vA, vB));};
+  static inline V4     V4Mul     (V4  vA, V4  vB)              {return (_mm_mul_ps (vA, vB));};
+  static inline V4     V4MulAdd  (V4  vA, V4  vB, V4  vC)      {return (_mm_add_ps (vA, _mm_mul_ps (vB, vC)));};
+  static inline V4     V4YZX     (V4  vIn)                     {return (_mm_shuffle_ps (vIn, vIn, _MM_SHUFFLE (3, 0, 2, 1)));};
+  static inline V4     V4ZXY     (V4  vIn)                     {return (_mm_shuffle_ps (vIn, vIn, _MM_SHUFFLE (3, 1, 0, 2)));};
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+
+  #include <arm_neon.h>
+
+  typedef float32x4_t  V4;
+
+  static inline V4     V4Load    (const FLOAT *  afIn)         {return (vld1q_f32 (afIn));};
+  static inline VOID   V4Store   (FLOAT *  afOut, V4  vIn)     {vst1q_f32 (afOut, vIn);};
+  static inline V4     V4Splat   (FLOAT  fIn)                  {return (vdupq_n_f32 (fIn));};
+  static inline V4     V4Add     (V4  vA, V4  vB)              {return (vaddq_f32 (vA, vB));};
+  static inline V4     V4Sub     (V4  vA, V4  vB)              {return (vsubq_f32 (vA, vB));};
+  static inline V4     V4Mul     (V4  vA, V4  vB)              {return (vmulq_f32 (vA, vB));};
+  static inline V4     V4MulAdd  (V4  vA, V4  vB, V4  vC)      {return (vmlaq_f32 (vA, vB, vC));};
+  static inline V4     V4YZX     (V4  vIn)                     {float32x2_t  vLo = vget_low_f32 (vIn);
+                                                                float32x2_t  vHi = vget_high_f32 (vIn);
+                                                                return (vcombine_f32 (vext_f32 (vLo, vHi, 1),
+                                                                                      vset_lane_f32 (vget_lane_f32 (vHi, 1), vLo, 1)));};
+  static inline V4     V4ZXY     (V4  vIn)                     {float32x2_t  vLo = vget_low_f32 (vIn);
+                                                                float32x2_t  vHi = vget_high_f32 (vIn);
+                                                                return (vcombine_f32 (vset_lane_f32 (vget_lane_f32 (vLo, 0), vHi, 1),
+                                                                                      vset_lane_f32 (vget_lane_f32 (vLo, 1), vHi, 0)));};
+
+#else
+
+  struct V4 {FLOAT  f [4];};
+
+  static inline V4     V4Make    (FLOAT  fX, FLOAT  fY, FLOAT  fZ, FLOAT  fW)  {V4  v; v.f[0] = fX; v.f[1] = fY; v.f[2] = fZ; v.f[3] = fW; return (v);};
+  static inline V4     V4Load    (const FLOAT *  afIn)         {return (V4Make (afIn[0], afIn[1], afIn[2], afIn[3]));};
+  static inline VOID   V4Store   (FLOAT *  afOut, V4  vIn)     {afOut[0] = vIn.f[0]; afOut[1] = vIn.f[1]; afOut[2] = vIn.f[2]; afOut[3] = vIn.f[3];};
+  static inline V4     V4Splat   (FLOAT  fIn)                  {return (V4Make (fIn, fIn, fIn, fIn));};
+  static inline V4     V4Add     (V4  vA, V4  vB)              {return (V4Make (vA.f[0] + vB.f[0], vA.f[1] + vB.f[1], vA.f[2] + vB.f[2], vA.f[3] + vB.f[3]));};
+  static inline V4     V4Sub     (V4  vA, V4  vB)              {return (V4Make (vA.f[0] - vB.f[0], vA.f[1] - vB.f[1], vA.f[2] - vB.f[2], vA.f[3] - vB.f[3]));};
+  static inline V4     V4Mul     (V4  vA, V4  vB)              {return (V4Make (vA.f[0] * vB.f[0], vA.f[1] * vB.f[1], vA.f[2] * vB.f[2], vA.f[3] * vB.f[3]));};
+  static inline V4     V4MulAdd  (V4  vA, V4  vB, V4  vC)      {return (V4Add (vA, V4Mul (vB, vC)));};
+  static inline V4     V4YZX     (V4  vIn)                     {return (V4Make (vIn.f[1], vIn.f[2], vIn.f[0], vIn.f[3]));};
+  static inline V4     V4ZXY     (V4  vIn)                     {return (V4Make (vIn.f[2], vIn.f[0], vIn.f[1], vIn.f[3]));};
+
+#endif
+
+//------------------------------------------------------------------------
+static inline V4  V4Cross3  (V4  vA, V4  vB)
+  {
+  return (V4Sub (V4Mul (V4YZX (vA), V4ZXY (vB)), V4Mul (V4ZXY (vA), V4YZX (vB))));
+  };
+
+//------------------------------------------------------------------------
+static inline FLOAT  V4Dot3  (V4  vA, V4  vB)
+  {
+  alignas(16) FLOAT  af [4];
+  V4Store (af, V4Mul (vA, vB));
+  return (af[0] + af[1] + af[2]);
+  };
+
+//------------------------------------------------------------------------
+static inline V4  V4Transform  (V4  vCol0, V4  vCol1, V4  vCol2, V4  vCol3,
+                                FLOAT  fX, FLOAT  fY, FLOAT  fZ, FLOAT  fW)
+  {
+  return (V4MulAdd (V4MulAdd (V4MulAdd (V4Mul (vCol0, V4Splat (fX)),
+                                        vCol1, V4Splat (fY)),
+                              vCol2, V4Splat (fZ)),
+                    vCol3, V4Splat (fW)));
+  };
+
+//-----------------------------------------------------------------------------
+//  RVec4F
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+RVec4F  RVec4F::QuatMultiply  (const RVec4F &  qIn) const
+  {
+  // xyz = w1 v2 + w2 v1 + v1 x v2,  w = w1 w2 - v1 . v2
+  V4  vA = V4Load (afV);
+  V4  vB = V4Load (qIn.afV);
+
+  RVec4F  qOut;
+  V4Store (qOut.afV, V4Add (V4MulAdd (V4Mul (V4Splat (fW), vB), V4Splat (qIn.fW), vA),
+                            V4Cross3 (vA, vB)));
+  qOut.fW = fW * qIn.fW - V4Dot3 (vA, vB);
+  return (qOut);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RVec4F::QuatNormalize  (VOID)
+  {
+  FLOAT  fLengthSq = Dot (*this);
+
+  ASSERT (fLengthSq != 0.0f);
+
+  V4Store (afV, V4Mul (V4Load (afV), V4Splat (1.0f / sqrtf (fLengthSq))));
+  };
+
+//-----------------------------------------------------------------------------
+RVec4F  RVec4F::QuatSLERP  (const RVec4F &  qTo,
+                            FLOAT           fTime) const
+  {
+  FLOAT  fCosOm = Dot (qTo);
+  FLOAT  fSign  = 1.0f;
+
+  // take the shorter way around
+  if (fCosOm < 0.0f)
+    {
+    fCosOm = -fCosOm;
+    fSign  = -1.0f;
+    };
+
+  FLOAT  fScale0;
+  FLOAT  fScale1;
+  if ((1.0f - fCosOm) > 0.0001f)
+    {
+    FLOAT  fOmega = acosf (fCosOm);
+    FLOAT  fSinOm = sinf (fOmega);
+    fScale0 = sinf ((1.0f - fTime) * fOmega) / fSinOm;
+    fScale1 = sinf (fTime * fOmega) / fSinOm;
+    }
+  else
+    {
+    // nearly the same rotation, so a linear blend is close enough and avoids dividing by ~0.
+    fScale0 = 1.0f - fTime;
+    fScale1 = fTime;
+    };
+
+  RVec4F  qOut;
+  V4Store (qOut.afV, V4MulAdd (V4Mul (V4Load (afV), V4Splat (fScale0)),
+                               V4Load (qTo.afV), V4Splat (fScale1 * fSign)));
+  return (qOut);
+  };
+
+//-----------------------------------------------------------------------------
+//  RMatrixF
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::SetRotateX  (FLOAT  fAngleIn)
+  {
+  FLOAT  fSin = sinf (fAngleIn);
+  FLOAT  fCos = cosf (fAngleIn);
+
+  f00=1.0f; f01=0.0f; f02= 0.0f; f03=0.0f;
+  f10=0.0f; f11=fCos; f12=-fSin; f13=0.0f;
+  f20=0.0f; f21=fSin; f22= fCos; f23=0.0f;
+  f30=0.0f; f31=0.0f; f32= 0.0f; f33=1.0f;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::SetRotateY  (FLOAT  fAngleIn)
+  {
+  FLOAT  fSin = sinf (fAngleIn);
+  FLOAT  fCos = cosf (fAngleIn);
+
+  f00= fCos; f01=0.0f; f02=fSin; f03=0.0f;
+  f10= 0.0f; f11=1.0f; f12=0.0f; f13=0.0f;
+  f20=-fSin; f21=0.0f; f22=fCos; f23=0.0f;
+  f30= 0.0f; f31=0.0f; f32=0.0f; f33=1.0f;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::SetRotateZ  (FLOAT  fAngleIn)
+  {
+  FLOAT  fSin = sinf (fAngleIn);
+  FLOAT  fCos = cosf (fAngleIn);
+
+  f00=fCos; f01=-fSin; f02=0.0f; f03=0.0f;
+  f10=fSin; f11= fCos; f12=0.0f; f13=0.0f;
+  f20=0.0f; f21= 0.0f; f22=1.0f; f23=0.0f;
+  f30=0.0f; f31= 0.0f; f32=0.0f; f33=1.0f;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::FromQuat  (const RVec4F &  qIn)
+  {
+  FLOAT  fX2 = qIn.fX + qIn.fX;
+  FLOAT  fY2 = qIn.fY + qIn.fY;
+  FLOAT  fZ2 = qIn.fZ + qIn.fZ;
+
+  FLOAT  fXX = qIn.fX * fX2;  FLOAT  fXY = qIn.fX * fY2;  FLOAT  fXZ = qIn.fX * fZ2;
+  FLOAT  fYY = qIn.fY * fY2;  FLOAT  fYZ = qIn.fY * fZ2;  FLOAT  fZZ = qIn.fZ * fZ2;
+  FLOAT  fWX = qIn.fW * fX2;  FLOAT  fWY = qIn.fW * fY2;  FLOAT  fWZ = qIn.fW * fZ2;
+
+  f00 = 1.0f - (fYY + fZZ);  f01 = fXY + fWZ;           f02 = fXZ - fWY;           f03 = 0.0f;
+  f10 = fXY - fWZ;           f11 = 1.0f - (fXX + fZZ);  f12 = fYZ + fWX;           f13 = 0.0f;
+  f20 = fXZ + fWY;           f21 = fYZ - fWX;           f22 = 1.0f - (fXX + fYY);  f23 = 0.0f;
+  f30 = 0.0f;                f31 = 0.0f;                f32 = 0.0f;                f33 = 1.0f;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::Multiply  (const FLOAT *  afAIn,
+                           const FLOAT *  afBIn,
+                           FLOAT *        afOut)
+  {
+  // column major, so each column of the result is the columns of A weighted
+  //  by the matching column of B.
+  V4  vCol0 = V4Load (&afAIn [0]);
+  V4  vCol1 = V4Load (&afAIn [4]);
+  V4  vCol2 = V4Load (&afAIn [8]);
+  V4  vCol3 = V4Load (&afAIn [12]);
+
+  for (INT  iCol = 0; iCol < 16; iCol += 4)
+    {
+    V4Store (&afOut [iCol], V4Transform (vCol0, vCol1, vCol2, vCol3,
+                                         afBIn [iCol], afBIn [iCol + 1], afBIn [iCol + 2], afBIn [iCol + 3]));
+    };
+  };
+
+//-----------------------------------------------------------------------------
+RVec4F  RMatrixF::operator*  (const RVec4F &  vecIn) const
+  {
+  RVec4F  vecOut;
+  V4Store (vecOut.afV, V4Transform (V4Load (&fArray [0]), V4Load (&fArray [4]), V4Load (&fArray [8]), V4Load (&fArray [12]),
+                                    vecIn.fX, vecIn.fY, vecIn.fZ, vecIn.fW));
+  return (vecOut);
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  RMatrixF::Invert  (VOID)
+  {
+  // Works on the columns as 3D vectors a, b, c, d, with the bottom row
+  //  x y z w riding along in lane 3.  See Lengyel, "Foundations of Game
+  //  Engine Development, Volume 1", section 1.7.5.
+  V4  vA = V4Load (&fArray [0]);
+  V4  vB = V4Load (&fArray [4]);
+  V4  vC = V4Load (&fArray [8]);
+  V4  vD = V4Load (&fArray [12]);
+
+  V4  vS = V4Cross3 (vA, vB);
+  V4  vT = V4Cross3 (vC, vD);
+  V4  vU = V4Sub (V4Mul (vA, V4Splat (f31)), V4Mul (vB, V4Splat (f30)));
+  V4  vV = V4Sub (V4Mul (vC, V4Splat (f33)), V4Mul (vD, V4Splat (f32)));
+
+  FLOAT  fDet = V4Dot3 (vS, vV) + V4Dot3 (vT, vU);
+  if (fabsf (fDet) < FLT_MIN)
+    {
+    return (FALSE);
+    };
+
+  V4  vInvDet = V4Splat (1.0f / fDet);
+  vS = V4Mul (vS, vInvDet);
+  vT = V4Mul (vT, vInvDet);
+  vU = V4Mul (vU, vInvDet);
+  vV = V4Mul (vV, vInvDet);
+
+  // rows of the inverse.  Lane 3 of the cross products is zero, so lane 3
+  //  of each row is filled in from the dot products below.
+  alignas(16) FLOAT  afRows [16];
+  V4Store (&afRows [0],  V4MulAdd (V4Cross3 (vB, vV), vT, V4Splat (f31)));
+  V4Store (&afRows [4],  V4Sub    (V4Cross3 (vV, vA), V4Mul (vT, V4Splat (f30))));
+  V4Store (&afRows [8],  V4MulAdd (V4Cross3 (vD, vU), vS, V4Splat (f33)));
+  V4Store (&afRows [12], V4Sub    (V4Cross3 (vU, vC), V4Mul (vS, V4Splat (f32))));
+  afRows [3]  = -V4Dot3 (vB, vT);
+  afRows [7]  =  V4Dot3 (vA, vT);
+  afRows [11] = -V4Dot3 (vD, vS);
+  afRows [15] =  V4Dot3 (vC, vS);
+
+  for (INT  iRow = 0; iRow < 4; ++iRow)
+    {
+    for (INT  iCol = 0; iCol < 4; ++iCol)
+      {
+      fArray [iCol * 4 + iRow] = afRows [iRow * 4 + iCol];
+      };
+    };
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::TransformPoints  (const RVec4F *  avecIn,
+                                  RVec4F *        avecOut,
+                                  INT             iCountIn) const
+  {
+  V4  vCol0 = V4Load (&fArray [0]);
+  V4  vCol1 = V4Load (&fArray [4]);
+  V4  vCol2 = V4Load (&fArray [8]);
+  V4  vCol3 = V4Load (&fArray [12]);
+
+  for (INT  iIndex = 0; iIndex < iCountIn; ++iIndex)
+    {
+    const RVec4F &  vecIn = avecIn [iIndex];
+    V4Store (avecOut [iIndex].afV, V4Transform (vCol0, vCol1, vCol2, vCol3, vecIn.fX, vecIn.fY, vecIn.fZ, vecIn.fW));
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::TransformPoints  (RVec3Array &  arrayInOut) const
+  {
+  // RVec3 has a vtable, so the elements aren't packed floats.  Each result
+  //  goes back into its element through a temporary.
+  V4  vCol0 = V4Load (&fArray [0]);
+  V4  vCol1 = V4Load (&fArray [4]);
+  V4  vCol2 = V4Load (&fArray [8]);
+  V4  vCol3 = V4Load (&fArray [12]);
+
+  RVec3 *  avec   = (RVec3 *) arrayInOut.GetRawBuffer ();
+  INT      iCount = arrayInOut.Length ();
+  alignas(16) FLOAT  afResult [4];
+
+  for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+    {
+    RVec3 &  vec = avec [iIndex];
+    V4Store (afResult, V4Transform (vCol0, vCol1, vCol2, vCol3, vec.fX, vec.fY, vec.fZ, 1.0f));
+    vec.fX = afResult [0];
+    vec.fY = afResult [1];
+    vec.fZ = afResult [2];
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::TransformPoints  (RVec4Array &  arrayInOut) const
+  {
+  // as above, RVec4 has a vtable, so each result is written back through its members.
+  V4  vCol0 = V4Load (&fArray [0]);
+  V4  vCol1 = V4Load (&fArray [4]);
+  V4  vCol2 = V4Load (&fArray [8]);
+  V4  vCol3 = V4Load (&fArray [12]);
+
+  RVec4 *  avec   = (RVec4 *) arrayInOut.GetRawBuffer ();
+  INT      iCount = arrayInOut.Length ();
+  alignas(16) FLOAT  afResult [4];
+
+  for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+    {
+    RVec4 &  vec = avec [iIndex];
+    V4Store (afResult, V4Transform (vCol0, vCol1, vCol2, vCol3, vec.fX, vec.fY, vec.fZ, vec.fW));
+    vec.Set (afResult [0], afResult [1], afResult [2], afResult [3]);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::ToMatrixArray  (const RMatrixF *  amatIn,
+                                INT               iCountIn,
+                                RMatrixArray &    arrayOut)
+  {
+  arrayOut.SetLength (iCountIn);
+  for (INT  iIndex = 0; iIndex < iCountIn; ++iIndex)
+    {
+    amatIn [iIndex].Get (arrayOut [iIndex]);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  RMatrixF::FromMatrixArray  (RMatrixArray &    arrayIn,
+                                  RMatrixF *        amatOut)
+  {
+  INT  iCount = arrayIn.Length ();
+  for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+    {
+    amatOut [iIndex].Set (arrayIn [iIndex]);
+    };
+  };
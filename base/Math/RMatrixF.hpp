@@ -0,0 +1,240 @@
+/* -----------------------------------------------------------------
+                     Single Precision Matrix Library
+
+     This module contains 16 byte aligned float matrix and vector
+     types, with SSE2 and NEON versions of the heavier operations.
+     They sit alongside RMatrix and RVec4, for code that ends up
+     handing floats to the graphics API anyway.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef RMATRIXF_HPP
+#define RMATRIXF_HPP
+
+#include "Sys/Types.hpp"
+#include "Math/RVec.hpp"
+#include "Math/RMatrix.hpp"
+
+//------------------------------------------------------------------------
+// Forward Declarations
+//------------------------------------------------------------------------
+
+class RVec3Array;
+class RVec4Array;
+class RMatrixArray;
+
+//------------------------------------------------------------------------
+// Class Definitions
+//------------------------------------------------------------------------
+
+// NOTE:  RMatrixF uses the same column major layout and element names as
+//  RMatrix, so fArray can be handed straight to OpenGL.  Unlike RMatrix,
+//  operations use the full 4x4 matrix, including the bottom row.
+//
+//  Multiply, Invert, TransformPoints, and the quaternion operations use
+//  SSE2 on x86, NEON on ARM, and plain C++ elsewhere.  The simpler
+//  per-component operations are left inline for the compiler.
+//
+//  The RVec3Array and RVec4Array versions of TransformPoints work on the
+//  arrays' own elements in place, without copying them out to RVec4F first.
+//  RMatrix holds RMAT_T (double, by default), so converting to and from
+//  RMatrix and RMatrixArray is a copy.
+
+//------------------------------------------------------------------------
+class alignas(16) RVec4F
+//------------------------------------------------------------------------
+  {
+  public:
+    union
+      {
+      FLOAT    afV [4];
+      struct {FLOAT  fX, fY, fZ, fW;};
+      };
+
+  public:
+                RVec4F        ()                                {};
+
+                RVec4F        (FLOAT  fXIn,
+                               FLOAT  fYIn,
+                               FLOAT  fZIn,
+                               FLOAT  fWIn)                     {fX = fXIn; fY = fYIn; fZ = fZIn; fW = fWIn;};
+
+    explicit    RVec4F        (const RVec4 &  vecIn)            {Set (vecIn);};
+
+    RVec4F &    Set           (FLOAT  fXIn,
+                               FLOAT  fYIn,
+                               FLOAT  fZIn,
+                               FLOAT  fWIn)                     {fX = fXIn; fY = fYIn; fZ = fZIn; fW = fWIn; return (*this);};
+
+    RVec4F &    Set           (const RVec4 &  vecIn)            {fX = vecIn.fX; fY = vecIn.fY; fZ = vecIn.fZ; fW = vecIn.fW; return (*this);};
+
+    VOID        Get           (RVec4 &  vecOut) const           {vecOut.fX = fX; vecOut.fY = fY; vecOut.fZ = fZ; vecOut.fW = fW;};
+
+    RVec4F      operator+     (const RVec4F &  vecIn) const     {return (RVec4F (fX + vecIn.fX, fY + vecIn.fY, fZ + vecIn.fZ, fW + vecIn.fW));};
+
+    RVec4F      operator-     (const RVec4F &  vecIn) const     {return (RVec4F (fX - vecIn.fX, fY - vecIn.fY, fZ - vecIn.fZ, fW - vecIn.fW));};
+
+    RVec4F      operator*     (FLOAT  fIn) const                {return (RVec4F (fX * fIn, fY * fIn, fZ * fIn, fW * fIn));};
+
+    FLOAT       Dot           (const RVec4F &  vecIn) const     {return (fX * vecIn.fX + fY * vecIn.fY + fZ * vecIn.fZ + fW * vecIn.fW);};
+
+    BOOL        operator==    (const RVec4F &  vecIn) const     {return ((fabsf (fX - vecIn.fX) <= R_EPSILON) && (fabsf (fY - vecIn.fY) <= R_EPSILON) &&
+                                                                         (fabsf (fZ - vecIn.fZ) <= R_EPSILON) && (fabsf (fW - vecIn.fW) <= R_EPSILON));};
+
+    // Quaternions are stored as (x, y, z, w), with w as the scalar part, the same as RVec4.
+
+                /** @brief  Hamilton product.  The result applies qIn first, then this rotation.
+                    @param  qIn The right hand quaternion.
+                    @return this * qIn
+                */
+    RVec4F      QuatMultiply  (const RVec4F &  qIn) const;
+
+    RVec4F      QuatConjugate (VOID) const                      {return (RVec4F (-fX, -fY, -fZ, fW));};
+
+    VOID        QuatNormalize (VOID);
+
+                /** @brief  Spherical linear interpolation along the shortest arc.
+                    @param  qTo The quaternion at fTime = 1.
+                    @param  fTime Position between this (0.0) and qTo (1.0).
+                    @return The interpolated quaternion.
+                */
+    RVec4F      QuatSLERP     (const RVec4F &  qTo,
+                               FLOAT           fTime) const;
+  };
+
+
+//------------------------------------------------------------------------
+class alignas(16) RMatrixF
+//------------------------------------------------------------------------
+  {
+  public:
+    union
+      {
+      FLOAT    fArray [16];
+      struct {FLOAT  f00,f10,f20,f30,  f01,f11,f21,f31,  f02,f12,f22,f32,  f03,f13,f23,f33;};
+      };
+
+  public:
+                RMatrixF        ()                               {};
+
+    explicit    RMatrixF        (const RMatrix &  matIn)         {Set (matIn);};
+
+    VOID        Identity        (VOID)                           {f00=1.0f; f01=0.0f; f02=0.0f; f03=0.0f;
+                                                                  f10=0.0f; f11=1.0f; f12=0.0f; f13=0.0f;
+                                                                  f20=0.0f; f21=0.0f; f22=1.0f; f23=0.0f;
+                                                                  f30=0.0f; f31=0.0f; f32=0.0f; f33=1.0f;};
+
+    VOID        Set             (const RMatrix &  matIn)         {for (INT  iIndex = 0; iIndex < 16; ++iIndex) {fArray [iIndex] = FLOAT (matIn.fArray [iIndex]);};};
+
+    VOID        Get             (RMatrix &  matOut) const        {matOut.SetF (fArray);};
+
+    VOID        SetF            (const FLOAT *  afArrayIn)       {for (INT  iIndex = 0; iIndex < 16; ++iIndex) {fArray [iIndex] = afArrayIn [iIndex];};};
+
+    VOID        GetFloatArray   (FLOAT *  afArrayOut) const      {for (INT  iIndex = 0; iIndex < 16; ++iIndex) {afArrayOut [iIndex] = fArray [iIndex];};};
+
+    VOID        SetTrans        (FLOAT  fXIn,
+                                 FLOAT  fYIn,
+                                 FLOAT  fZIn)                    {f03 = fXIn; f13 = fYIn; f23 = fZIn;};
+
+                /** @brief  Scale the rows of the upper 3x3, the same as multiplying a scale matrix on the left.
+                    @return None
+                */
+    VOID        PreScale        (FLOAT  fXIn,
+                                 FLOAT  fYIn,
+                                 FLOAT  fZIn)                    {f00 *= fXIn; f01 *= fXIn; f02 *= fXIn;
+                                                                  f10 *= fYIn; f11 *= fYIn; f12 *= fYIn;
+                                                                  f20 *= fZIn; f21 *= fZIn; f22 *= fZIn;};
+
+    VOID        SetRotateX      (FLOAT  fAngleIn);  ///< radians.  Same convention as RMatrix.
+
+    VOID        SetRotateY      (FLOAT  fAngleIn);  ///< radians.  Same convention as RMatrix.
+
+    VOID        SetRotateZ      (FLOAT  fAngleIn);  ///< radians.  Same convention as RMatrix.
+
+                /** @brief  Set the rotation from a quaternion, with the same result as RMatrix::FromQuat.
+                    @param  qIn The quaternion.
+                    @return None
+                */
+    VOID        FromQuat        (const RVec4F &  qIn);
+
+    RMatrixF    operator*       (const RMatrixF &  matIn) const  {RMatrixF  matOut; Multiply (fArray, matIn.fArray, matOut.fArray); return (matOut);};
+
+    RMatrixF &  operator*=      (const RMatrixF &  matIn)        {RMatrixF  matOut; Multiply (fArray, matIn.fArray, matOut.fArray); *this = matOut; return (*this);};
+
+    RVec4F      operator*       (const RVec4F &  vecIn) const;
+
+                /** @brief  Invert the full 4x4 matrix in place.
+                    @return False, leaving the matrix unchanged, if it is singular.
+                */
+    BOOL        Invert          (VOID);
+
+                /** @brief  Transform an array of vectors by this matrix.
+                    @param  avecIn Source vectors.
+                    @param  avecOut Receives the results.  May be the same array as avecIn.
+                    @param  iCountIn Number of vectors.
+                    @return None
+                */
+    VOID        TransformPoints (const RVec4F *  avecIn,
+                                 RVec4F *        avecOut,
+                                 INT             iCountIn) const;
+
+                /** @brief  Transform points in place, treating each as (x, y, z, 1).
+                    @param  arrayInOut The points.
+                    @return None
+                */
+    VOID        TransformPoints (RVec3Array &  arrayInOut) const;
+
+                /** @brief  Transform vectors in place.
+                    @param  arrayInOut The vectors.
+                    @return None
+                */
+    VOID        TransformPoints (RVec4Array &  arrayInOut) const;
+
+                /** @brief  Multiply two column major float matrices.
+                    @param  afAIn Left hand matrix, 16 byte aligned.
+                    @param  afBIn Right hand matrix, 16 byte aligned.
+                    @param  afOut Receives A * B, 16 byte aligned.  Must not overlap the inputs.
+                    @return None
+                */
+    static VOID Multiply        (const FLOAT *  afAIn,
+                                 const FLOAT *  afBIn,
+                                 FLOAT *        afOut);
+
+    static VOID ToMatrixArray   (const RMatrixF *  amatIn,
+                                 INT               iCountIn,
+                                 RMatrixArray &    arrayOut);
+
+    static VOID FromMatrixArray (RMatrixArray &    arrayIn,
+                                 RMatrixF *        amatOut);
+  };
+
+#endif // RMATRIXF_HPP
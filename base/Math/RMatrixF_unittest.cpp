@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Math/RMatrixF.hpp"
+#include "Containers/RVecArray.hpp"
+#include "Containers/RMatrixArray.hpp"
+#include "Gfx/Euler.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
+
+// NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
+
+//------------------------------------------------------------------------------
+static VOID  RMatrixFTest_Expect  (const RMatrixF &  matIn,
+                                   const RMatrix &   matExpectedIn,
+                                   DOUBLE            dToleranceIn = 0.0001)
+  {
+  for (INT  iElem = 0; iElem < 16; ++iElem)
+    {
+    EXPECT_NEAR (matIn.fArray [iElem], matExpectedIn.fArray [iElem], dToleranceIn) << "element " << iElem;
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, MultiplyAndConvert)
+  {
+  RMatrix  matA (1.0f, 2.0f, 3.0f, 4.0f,
+                 0.5f, 1.5f, 2.5f, 3.5f,
+                 -1.0f, 0.0f, 1.0f, 2.0f,
+                 0.0f, 0.0f, 0.0f, 1.0f);
+  RMatrix  matB (2.0f, 0.0f, 1.0f, -3.0f,
+                 1.0f, 1.0f, 0.0f, 2.0f,
+                 0.0f, -2.0f, 3.0f, 0.5f,
+                 0.0f, 0.0f, 0.0f, 1.0f);
+
+  RMatrixF  matAF (matA);
+  RMatrixF  matBF (matB);
+
+  RMatrixFTest_Expect (matAF * matBF, matA * matB);
+
+  matAF *= matBF;
+  RMatrix  matBack;
+  matAF.Get (matBack);
+  RMatrixFTest_Expect (matAF, matBack, 0.0);
+
+  // matrix arrays
+  RMatrixF  amat [2] = {matBF, matBF};
+  amat [1].SetTrans (1.0f, 2.0f, 3.0f);
+
+  RMatrixArray  arrayMats;
+  RMatrixF::ToMatrixArray (amat, 2, arrayMats);
+  ASSERT_EQ (arrayMats.Length (), 2);
+  ASSERT_NEAR (arrayMats [1].fArray [13], 2.0, 0.00001);
+
+  RMatrixF  amatBack [2];
+  RMatrixF::FromMatrixArray (arrayMats, amatBack);
+  RMatrixFTest_Expect (amatBack [1], arrayMats [1], 0.0);
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, Invert)
+  {
+  RMatrixF  matRot;
+  RMatrixF  matTrans;
+  matRot.SetRotateY (0.7f);
+  matTrans.Identity ();
+  matTrans.SetTrans (3.0f, -2.0f, 5.0f);
+  matTrans.PreScale (2.0f, 0.5f, 1.5f);
+
+  // also has a projective bottom row, which RMatrix::Invert doesn't handle.
+  RMatrixF  matFull = matTrans * matRot;
+  matFull.f30 = 0.25f;
+  matFull.f32 = -0.5f;
+
+  RMatrixF  matInverse = matFull;
+  ASSERT_TRUE (matInverse.Invert ());
+
+  RMatrix  matIdentity;
+  matIdentity.Identity ();
+  RMatrixFTest_Expect (matFull * matInverse, matIdentity);
+  RMatrixFTest_Expect (matInverse * matFull, matIdentity);
+
+  RMatrixF  matSingular;
+  matSingular.Identity ();
+  matSingular.f11 = 0.0f;
+  RMatrixF  matUnchanged = matSingular;
+  ASSERT_FALSE (matSingular.Invert ());
+  ASSERT_EQ (memcmp (matSingular.fArray, matUnchanged.fArray, sizeof (matUnchanged.fArray)), 0);
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, TransformPoints)
+  {
+  RMatrix  mat;
+  mat.SetRotateZ (0.3f);
+  mat.SetTrans (1.0f, 2.0f, 3.0f);
+  RMatrixF  matF (mat);
+
+  RVec3Array  array3;
+  RVec4Array  array4;
+  RVec4F      avec4F [5];
+  for (INT  iIndex = 0; iIndex < 5; ++iIndex)
+    {
+    array3.Append (RVec3 (FLOAT (iIndex), 1.0f, -FLOAT (iIndex)));
+    array4.Append (RVec4 (FLOAT (iIndex), 2.0f, 0.5f, (iIndex % 2) ? 1.0f : 0.0f));
+    avec4F [iIndex].Set (array4 [iIndex]);
+    };
+
+  RVec3Array  array3Source (array3);
+  RVec4Array  array4Source (array4);
+
+  matF.TransformPoints (array3);
+  matF.TransformPoints (array4);
+  matF.TransformPoints (avec4F, avec4F, 5);
+
+  for (INT  iIndex = 0; iIndex < 5; ++iIndex)
+    {
+    RVec4  vec3Expected = mat * array3Source [iIndex];
+    RVec4  vec4Expected = mat * array4Source [iIndex];
+
+    ASSERT_NEAR (array3 [iIndex].fX, vec3Expected.fX, 0.0001);
+    ASSERT_NEAR (array3 [iIndex].fY, vec3Expected.fY, 0.0001);
+    ASSERT_NEAR (array3 [iIndex].fZ, vec3Expected.fZ, 0.0001);
+
+    ASSERT_NEAR (array4 [iIndex].fX, vec4Expected.fX, 0.0001);
+    ASSERT_NEAR (array4 [iIndex].fY, vec4Expected.fY, 0.0001);
+    ASSERT_NEAR (array4 [iIndex].fZ, vec4Expected.fZ, 0.0001);
+    ASSERT_NEAR (array4 [iIndex].fW, vec4Expected.fW, 0.0001);
+
+    ASSERT_TRUE (avec4F [iIndex] == RVec4F (array4 [iIndex]));
+    ASSERT_TRUE ((matF * RVec4F (array4Source [iIndex])) == avec4F [iIndex]);
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, Quaternion)
+  {
+  // 90 degrees about Z, then 90 degrees about X
+  RVec4F  qZ (0.0f, 0.0f, 0.70710678f, 0.70710678f);
+  RVec4F  qX (0.70710678f, 0.0f, 0.0f, 0.70710678f);
+
+  RVec4F  qBoth = qX.QuatMultiply (qZ);
+  ASSERT_NEAR (qBoth.fX,  0.5f, 0.0001f);
+  ASSERT_NEAR (qBoth.fY, -0.5f, 0.0001f);
+  ASSERT_NEAR (qBoth.fZ,  0.5f, 0.0001f);
+  ASSERT_NEAR (qBoth.fW,  0.5f, 0.0001f);
+
+  // a rotation followed by its inverse is the identity
+  RVec4F  qNone = qBoth.QuatMultiply (qBoth.QuatConjugate ());
+  ASSERT_TRUE (qNone == RVec4F (0.0f, 0.0f, 0.0f, 1.0f));
+
+  RVec4F  qScaled = qBoth * 3.0f;
+  qScaled.QuatNormalize ();
+  ASSERT_TRUE (qScaled == qBoth);
+
+  // matches the double precision versions
+  RMatrix  matQuat;
+  RVec4    vecBoth;
+  qBoth.Get (vecBoth);
+  matQuat.FromQuat (vecBoth);
+
+  RMatrixF  matQuatF;
+  matQuatF.FromQuat (qBoth);
+  RMatrixFTest_Expect (matQuatF, matQuat);
+
+  // RVec4::QuatSLERP lerps unless R_QUAT_DELTA is lowered, so check the
+  //  slerp directly:  it stays unit length, the midpoint is the normalized
+  //  sum, and the angle moves at a constant rate.
+  RVec4F  qSlerp = qZ.QuatSLERP (qBoth, 0.3f);
+  ASSERT_NEAR (qSlerp.Dot (qSlerp), 1.0f, 0.0001f);
+
+  RVec4F  qMid = qZ + qBoth;
+  qMid.QuatNormalize ();
+  ASSERT_TRUE (qZ.QuatSLERP (qBoth, 0.5f) == qMid);
+
+  FLOAT  fFullAngle = acosf (qZ.Dot (qBoth));
+  ASSERT_NEAR (acosf (qZ.Dot (qSlerp)), fFullAngle * 0.3f, 0.0001f);
+
+  ASSERT_TRUE (qZ.QuatSLERP (qBoth, 0.0f) == qZ);
+  ASSERT_TRUE (qZ.QuatSLERP (qBoth, 1.0f) == qBoth);
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, EulerToMatrixF)
+  {
+  for (INT  iOrder = Euler::XYZ; iOrder <= Euler::ZYX; ++iOrder)
+    {
+    Euler  eul;
+    eul.Set (30.0f, -45.0f, 100.0f, Euler::EOrder (iOrder));
+
+    RMatrix   mat;
+    RMatrixF  matF;
+    eul.ToMatrix  (mat);
+    eul.ToMatrixF (matF);
+    RMatrixFTest_Expect (matF, mat);
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (RMatrixF, Benchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumMats   = 10000;
+  const INT  iNumPoints = 100000;
+
+  RMatrix *   amat   = new RMatrix  [iNumMats];
+  RMatrixF *  amatF  = new RMatrixF [iNumMats];
+  for (INT  iIndex = 0; iIndex < iNumMats; ++iIndex)
+    {
+    amat [iIndex].SetRotateX (FLOAT (iIndex) * 0.001f);
+    amat [iIndex].SetTrans (FLOAT (iIndex), 1.0f, 2.0f);
+    amatF [iIndex].Set (amat [iIndex]);
+    };
+
+  // chain the products so neither loop can be skipped.
+  RMatrix   matAccum;
+  RMatrixF  matAccumF;
+  matAccum.Identity ();
+  matAccumF.Identity ();
+
+  INT64  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iIndex = 0; iIndex < iNumMats; ++iIndex)
+    {
+    matAccum = amat [iIndex] * matAccum;
+    };
+  INT64  iDoubleMulUs = StopWatch::GetTimeUs () - iStartUs;
+
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iIndex = 0; iIndex < iNumMats; ++iIndex)
+    {
+    matAccumF = amatF [iIndex] * matAccumF;
+    };
+  INT64  iFloatMulUs = StopWatch::GetTimeUs () - iStartUs;
+
+  // points
+  RVec3Array  arrayPoints (iNumPoints);
+  for (INT  iIndex = 0; iIndex < iNumPoints; ++iIndex)
+    {
+    arrayPoints [iIndex].Set (FLOAT (iIndex % 100), 1.0f, FLOAT (iIndex % 7));
+    };
+  RVec3Array  arrayPointsF (arrayPoints);
+
+  iStartUs = StopWatch::GetTimeUs ();
+  for (INT  iIndex = 0; iIndex < iNumPoints; ++iIndex)
+    {
+    RVec4  vecOut = amat [1] * arrayPoints [iIndex];
+    arrayPoints [iIndex].Set (vecOut.fX, vecOut.fY, vecOut.fZ);
+    };
+  INT64  iDoublePointsUs = StopWatch::GetTimeUs () - iStartUs;
+
+  iStartUs = StopWatch::GetTimeUs ();
+  amatF [1].TransformPoints (arrayPointsF);
+  INT64  iFloatPointsUs = StopWatch::GetTimeUs () - iStartUs;
+
+  ASSERT_NEAR (arrayPoints [iNumPoints - 1].fY, arrayPointsF [iNumPoints - 1].fY, 0.001);
+
+  BenchmarkPrintf ("Matrix multiply, %d:  RMatrix %9.3f ms  RMatrixF %9.3f ms (%.1fx)   Transform %d points:  RMatrix %9.3f ms  RMatrixF %9.3f ms (%.1fx)  (%f %f)\n",
+                   iNumMats,
+                   DOUBLE (iDoubleMulUs) / 1000.0,
+                   DOUBLE (iFloatMulUs)  / 1000.0,
+                   DOUBLE (iDoubleMulUs) / DOUBLE (RMax (INT64 (1), iFloatMulUs)),
+                   iNumPoints,
+                   DOUBLE (iDoublePointsUs) / 1000.0,
+                   DOUBLE (iFloatPointsUs)  / 1000.0,
+                   DOUBLE (iDoublePointsUs) / DOUBLE (RMax (INT64 (1), iFloatPointsUs)),
+                   DOUBLE (matAccum.f03), DOUBLE (matAccumF.f03));
+
+  delete [] amat;
+  delete [] amatF;
+  };
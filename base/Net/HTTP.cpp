@@ -43,7 +43,7 @@ ASSERTFILE (__FILE__);
 #include "Net/Base64.hpp"
 
 
-INT  HTTP::iNumCalls = 0;
+std::atomic<INT>  HTTP::iNumCalls (0);
 
 // NOTE:  Some code in here is inspired by:
 //  http://fm4dd.com/openssl/sslconnect.htm
@@ -86,6 +86,7 @@ const char *  HTTP::kMimeTypeWWWForm = "application/x-www-form-urlencoded";
 //------------------------------------------------------------------------------
 HTTP::HTTP ()
   {
+  iResponseCode = 0;
   }
 
 //------------------------------------------------------------------------------
@@ -145,12 +146,13 @@ EStatus  HTTP::Post (const char *  szMimeType,
   };
 
 //------------------------------------------------------------------------------
-EStatus  HTTP::Get (RStr &      strResultOut)
+EStatus  HTTP::Get (RStr &        strResultOut,
+                    const char *  szAdditionalHeaderIn)
   {
   RStrParser    parserSend;
 
   parserSend.Empty ();
-  BuildMessage (parserSend, "GET");
+  BuildMessage (parserSend, "GET", NULL, NULL, szAdditionalHeaderIn);
 
   //DBG_INFO ("HTTP::Get");
   //DBG_INFO (parserSend.AsChar ());
@@ -171,9 +173,9 @@ EStatus  HTTP::Get (RStr &      strResultOut)
 
   BOOL          bSuccess;
   const char *  szCodeName = NULL;
-  KVPArray      kvpAttributes;
 
-  ParseHeader (parserReceive, bSuccess, &szCodeName, kvpAttributes);
+  kvpResponseHeaders.Clear ();
+  ParseHeader (parserReceive, bSuccess, &szCodeName, kvpResponseHeaders);
 
   parserReceive.SubString (parserReceive.GetCursorStart (), parserReceive.Length () - parserReceive.GetCursorStart (), strResultOut);
 
@@ -239,6 +241,7 @@ VOID  HTTP::ParseHeader (RStrParser &    parserIn,
   parserIn.SkipEOL ();
 
   const char *  szCodeName = "Undefined";
+  iResponseCode = iCode;
   bSuccessOut = CheckErrorCode (iCode, &szCodeName);
 
   if (bSuccessOut)
@@ -566,12 +569,43 @@ RStr &  HTTP::HeaderBasicAuth (const char *  szUsername,
   return (strAuthOut);
   };
 
+//------------------------------------------------------------------------------
+const char *  HTTP::GetResponseHeader  (const char *  szKeyIn) const
+  {
+  for (INT  iIndex = 0; iIndex < kvpResponseHeaders.Length (); ++iIndex)
+    {
+    if (streqi (kvpResponseHeaders.KeyAtIndex (iIndex).AsChar (), szKeyIn))
+      {
+      return (kvpResponseHeaders.ValueAtIndex (iIndex).AsChar ());
+      };
+    };
+  return (NULL);
+  };
+
+//------------------------------------------------------------------------------
+VOID  HTTP::HeaderConditional  (const char *  szETagIn,
+                                const char *  szLastModifiedIn,
+                                RStr &        strHeaderOut)
+  {
+  // NOTE: Not built in a static like HeaderBasicAuth, since content fetches
+  //  run on worker threads.
+  strHeaderOut.Empty ();
+  if ((szETagIn != NULL) && (szETagIn [0] != '\0'))
+    {
+    strHeaderOut.AppendFormat ("If-None-Match: %s\r\n", szETagIn);
+    };
+  if ((szLastModifiedIn != NULL) && (szLastModifiedIn [0] != '\0'))
+    {
+    strHeaderOut.AppendFormat ("If-Modified-Since: %s\r\n", szLastModifiedIn);
+    };
+  };
+
 //------------------------------------------------------------------------------
 const char *  HTTP::NumCallsStr  (VOID)
   {
   static RStr  strOut;
 
-  strOut.Format ("%d", iNumCalls);
+  strOut.Format ("%d", INT (iNumCalls));
   return (strOut.AsChar ());
   };
 
@@ -43,6 +43,7 @@
 #include "Net/Socket.hpp"
 #include "Net/URLBuilder.hpp"
 #include "Containers/KVPArray.hpp"
+#include <atomic>
 
 //------------------------------------------------------------------------
 // Defines
@@ -68,7 +69,9 @@ class HTTP
     URLBuilder    url;
     RStrParser    parserSend;
     RStrParser    parserReceive;
-    static INT    iNumCalls;
+    INT           iResponseCode;       ///< Status code of the last response ParseHeader handled
+    KVPArray      kvpResponseHeaders;  ///< Header fields of the last response Get received
+    static std::atomic<INT>  iNumCalls;  ///< Requests sent, by every thread
 
   public:
 
@@ -87,7 +90,16 @@ class HTTP
                                              RStr *        strContent,
                                              const char *  szAdditionalHeader);
 
-    EStatus         Get                     (RStr &        strResultOut);
+    EStatus         Get                     (RStr &        strResultOut,
+                                             const char *  szAdditionalHeaderIn = NULL);
+
+    INT             GetResponseCode         (VOID) const   {return (iResponseCode);};
+
+                    /** @brief  Look up a header field of the last response Get received.
+                        @param  szKeyIn Name of the field.  Case is ignored, as HTTP requires.
+                        @return The value, or NULL if the response didn't have the field.
+                    */
+    const char *    GetResponseHeader       (const char *  szKeyIn) const;
 
     VOID            ParseHeader             (RStrParser &    parserIn,
                                              BOOL &          bSuccessOut,
@@ -116,6 +128,17 @@ class HTTP
     static RStr &   HeaderBasicAuth         (const char *  szUsername,
                                              const char *  szPassword);
 
+                    /** @brief  Build the header lines for a conditional GET, which the server answers with
+                                304 Not Modified if its copy still matches.
+                        @param  szETagIn ETag of the copy we have, or NULL.
+                        @param  szLastModifiedIn Last-Modified of the copy we have, or NULL.
+                        @param  strHeaderOut Receives the header lines, or an empty string if neither was given.
+                        @return None
+                    */
+    static VOID     HeaderConditional       (const char *  szETagIn,
+                                             const char *  szLastModifiedIn,
+                                             RStr &        strHeaderOut);
+
     static const char * NumCallsStr         (VOID);
 
   };
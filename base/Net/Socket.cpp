@@ -57,7 +57,7 @@ ASSERTFILE (__FILE__);
 //}
 
 
-int Socket::iRefCount      = 0;
+std::atomic<int> Socket::iRefCount (0);
 
 //------------------------------------------------------------------------
 Socket::Socket ()
@@ -82,8 +82,7 @@ Socket::~Socket ()
   {
 
 
-  if (iRefCount != 0) --iRefCount;
-  if (iRefCount == 0)
+  if (--iRefCount == 0)
     {
     #ifdef WIN32
     WSACleanup ();
@@ -99,15 +98,13 @@ EStatus  Socket::Init  (VOID)
   {
   iSocketfd  = 0;
   iPort      = 0;
-  server     = NULL;
   bConnected = FALSE;
 
   memset (&serv_addr, 0, sizeof (serv_addr));
 
 
   // perform class-wide initialization when the first instance is created.
-  ++iRefCount;
-  if (iRefCount == 1)
+  if (++iRefCount == 1)
     {
     #ifdef WIN32
 
@@ -183,8 +180,22 @@ EStatus Socket::ClientConnect (const char *   szClientIn,
     }
   else
     {
-    // server is a name.  Look it up
-    if ((server = gethostbyname (szClientIn)) == NULL)
+    // server is a name.  Look it up.  getaddrinfo is reentrant, where
+    //  gethostbyname returns a shared static on Linux, so fetches can resolve
+    //  names from worker threads.
+    #ifdef LINUX_OR_ANDROID
+      struct addrinfo    hints;
+      struct addrinfo *  pResults = NULL;
+
+      memset (&hints, 0, sizeof (hints));
+      hints.ai_family   = AF_INET;
+      hints.ai_socktype = SOCK_STREAM;
+      if ((getaddrinfo (szClientIn, NULL, &hints, &pResults) != 0) || (pResults == NULL))
+    #else
+      // Winsock keeps the gethostbyname result per thread.
+      struct hostent *  server = gethostbyname (szClientIn);
+      if (server == NULL)
+    #endif
       {
       // error: no such host.  This is an early-out failure so we don't create a socket we can't use.
       RStr  strErrorOut ("Socket::ClientConnect Failure - No Host found for ");
@@ -197,9 +208,13 @@ EStatus Socket::ClientConnect (const char *   szClientIn,
       return (errorStatus);
       };
 
-    // the following two lines do the same thing for IPv4.  We likely need to revisit for IPv6 due to a different address size.
-    serv_addr.sin_addr.s_addr = *((unsigned long*) &server->h_addr);
-    //memcpy (server->h_addr, &(serv_addr.sin_addr.s_addr), server->h_length);
+    // NOTE:  IPv4 only.  We likely need to revisit for IPv6 due to a different address size.
+    #ifdef LINUX_OR_ANDROID
+      serv_addr.sin_addr = ((struct sockaddr_in *) pResults->ai_addr)->sin_addr;
+      freeaddrinfo (pResults);
+    #else
+      memcpy (&(serv_addr.sin_addr.s_addr), server->h_addr, server->h_length);
+    #endif
     };
 
   DBG_INFO ("Socket::ClientConnect - Creating socket for client %s:%i", szClientIn, iPortIn);
@@ -395,7 +410,8 @@ VOID Socket::Block (BOOL  bBlockStatusIn)
 //------------------------------------------------------------------------
 const char *  Socket::GetErrorString (VOID)
   {
-  static char  szOut [255];
+  // per thread, since sockets are used from fetch worker threads.
+  static thread_local char  szOut [255];
 
   #ifdef LINUX_OR_ANDROID
     INT32  iError = errno;
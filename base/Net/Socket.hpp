@@ -68,6 +68,7 @@
 
 
 #include <memory.h>
+#include <atomic>
 
 #include "Sys/Types.hpp"
 #include "Util/RStr.hpp"
@@ -81,9 +82,8 @@ class  Socket
     int                 iSocketfd;
     int                 iPort;
     struct sockaddr_in  serv_addr; // Note: This is an IPv4 structure.  We will need to revisit for IPv6 support.
-    struct hostent *    server;
 
-    static int          iRefCount;
+    static std::atomic<int>  iRefCount;
     BOOL                bConnected;
 
   public:
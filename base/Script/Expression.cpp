@@ -43,6 +43,7 @@ ASSERTFILE (__FILE__)
 
 #include "Util/RStrParser.hpp"
 #include "Script/Expression.hpp"
+#include "Script/ExpressionProgram.hpp"
 #include "Util/RegEx.hpp"
 
 // NOTE:  Based off of http://en.wikipedia.org/wiki/Shunting-yard_algorithm
@@ -929,12 +930,16 @@ VOID  ExpressionFn::OnCall (Token *          ptokParamsIn,
 //-----------------------------------------------------------------------------
 
 TList<ExpressionFn*>   Expression::listFn;
+UINT32                 Expression::uFnGeneration = 0;
+thread_local ExpressionCache  Expression::cacheCompiled;
+ExpressionBackend::Type  Expression::eBackend = ExpressionBackend::kInterpreter;
 
 //-----------------------------------------------------------------------------
 VOID  Expression::RegisterFunction (ExpressionFn *  pfnIn)
   {
   //DBG_INFO ("Expression::RegisterFunction - %s", pfnIn->Name ().AsChar ());
   listFn.PushFront (pfnIn);
+  ++uFnGeneration;
   };
 
 //-----------------------------------------------------------------------------
@@ -957,6 +962,7 @@ VOID  Expression::UnregisterFunction (ExpressionFn *  pfnIn)
   //DBG_INFO ("Expression::UnregisterFunction - %s", pfnIn->Name ().AsChar ());
   listFn.Delete (pfnIn);
   delete (pfnIn);
+  ++uFnGeneration;
   };
 
 //-----------------------------------------------------------------------------
@@ -967,39 +973,51 @@ VOID  Expression::UnregisterAllFunctions (VOID)
     delete (*itrCurr);
     };
   listFn.Empty ();
+  ++uFnGeneration;
   };
 
 //-----------------------------------------------------------------------------
-VOID  Expression::CallFunction  (const char *            szNameIn,
-                                 Token *                 ptokParamsIn,
-                                 ValueRegistry *         pRegistryIn,
-                                 TList<ExpressionFn*> *  plistLocalFnIn,
-                                 Token *                 ptokResultOut)
+ExpressionFn *  Expression::FindFunction  (RStr &                  strNameIn,
+                                           TList<ExpressionFn*> *  plistLocalFnIn)
   {
-  RStr   strName (szNameIn);
-  strName.CalcHash ();
-
   TListItr<ExpressionFn*>  itrCurr;
   // NOTE: Local functions override global functions
   if (plistLocalFnIn != NULL)
     {
     for (itrCurr = plistLocalFnIn->First (); itrCurr.IsValid (); ++itrCurr)
       {
-      if ((*itrCurr)->CanHandleFunction (strName))
+      if ((*itrCurr)->CanHandleFunction (strNameIn))
         {
-        (*itrCurr)->OnCall (ptokParamsIn, pRegistryIn, ptokResultOut);
-        return;
+        return (*itrCurr);
         };
       };
     };
   for (itrCurr = listFn.First (); itrCurr.IsValid (); ++itrCurr)
     {
-    if ((*itrCurr)->CanHandleFunction (strName))
+    if ((*itrCurr)->CanHandleFunction (strNameIn))
       {
-      (*itrCurr)->OnCall (ptokParamsIn, pRegistryIn, ptokResultOut);
-      return;
+      return (*itrCurr);
       };
     };
+  return (NULL);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  Expression::CallFunction  (const char *            szNameIn,
+                                 Token *                 ptokParamsIn,
+                                 ValueRegistry *         pRegistryIn,
+                                 TList<ExpressionFn*> *  plistLocalFnIn,
+                                 Token *                 ptokResultOut)
+  {
+  RStr   strName (szNameIn);
+  strName.CalcHash ();
+
+  ExpressionFn *  pfnFound = FindFunction (strName, plistLocalFnIn);
+  if (pfnFound != NULL)
+    {
+    pfnFound->OnCall (ptokParamsIn, pRegistryIn, ptokResultOut);
+    return;
+    };
 
   // Error:  Didn't find the function.
   // TODO: Error Handling
@@ -1070,59 +1088,17 @@ TList<Token*> *  Expression::Tokenize  (const char *  szScriptIn,
   //  us to edit the string, which will require some (costly) allocation to be done.
   //  Therefore we make sure there are macros before doing any substitution.
 
-  KVPArray    arrayMacros;
-
-  INT  iNumMacros = ParseOutMacros (szScriptIn, arrayMacros);
-
-
   // TODO: Implement an Include keyword.  It will be used for macro inclusion, but
   //  could be used for additional parsing as well.
 
+  // Tokens are split with a single pass over the text, driven by the character
+  //  class table.  Tokens are:
+  //    words:      runs of [a-zA-Z0-9_.${}] (numbers, identifiers, and variables)
+  //    strings:    "..." or '...' including the quotes
+  //    operators:  == != <= >= += -= *= /= %= ++ -- || && < > = , - + * / % ( ) ;
+  //  Whitespace separates tokens, and any other character is skipped.
 
-  // This RegEx defines how to split up the script into tokens, ignoring whitespace
-  // NOTE:  I may need to strip whitespace since I lack group matching
-  // TODO: Implement more escaped characters in RegEx, such as \s and \S
-
-  /*
-  [ ]*(
-
-  ==|
-  !=|
-  <=|
-  >=|
-  <|
-  >|
-  =|
-  +=|
-  -=|
-  *=|
-  /=|
-  ,|
-  ++|
-  --|
-  |||
-  &&|
-  -|
-  +|
-  *|
-  /|
-  (|
-  )|
-  [0-9]+(.[0-9]+)?|[a-zA-Z\\$_]?[a-zA-Z0-9\\${}_.]*|
-  ;|
-  "[^"]*"
-
-  )[ ]*
-  */
-
-
-  RegEx  rexTokens ("[ ]*(==|\\!=|<=|>=|<|>|=|\\+=|\\-=|\\*=|/=|%=|,|\\+\\+|\\-\\-|\\-|\\|\\||%|&&|\\+|\\*|/|\\(|\\)|[0-9]+(\\.[0-9]+)?|[a-zA-Z_\\$]?[a-zA-Z0-9\\${}_\\.]*|;|\"[^\"]*\"|'[^']*')[ ]*");
-/*
-[ ]*(==|\!=|<=|>=|<|>|=|\+=|\-=|\*=|/=|,|\+\+|\-\-|\-|\+|\*|/|\(|\)|[0-9]+(\.[0-9]+)?|[a-zA-Z_]?[a-zA-Z0-9_\.]*|;|"[^"]*")[ ]*
-    4  7   1  1  1 1 2 2   2   3   3  3 4    4    5  5  5  5 6  6  6      7        8 8                         1 1       2
-           1  4  7 9 1 3   7   1   5  8 0    5    0  3  6  9 1  4  7      4        3 5                         1 3       1
-*/
-  //RegEx  rexTokens ("[ ]*(\\+|\\-|\\*|\\\\|[0-9]+(\\.[0-9]+)?|;)[ ]*");
+  const UINT8 *  auClass = Token::CharClassTable ();
 
   INT  iScriptLength = (iScriptLengthIn == -1) ? (INT) strlen (pszCurr) : iScriptLengthIn;
 
@@ -1130,44 +1106,61 @@ TList<Token*> *  Expression::Tokenize  (const char *  szScriptIn,
 
   //DBG_INFO ("Calling Expression::Tokenize on len(%d) : \"%s\"", iScriptLength, pszCurr);
 
-  // NOTE:  Pointer arithmetic may not be the best way to solve this problem.  It is
-  //         clear to write, but may not be supported in the future by the compiler.
-
   const char *  pszEnd = pszCurr + iScriptLength;
-  const char *  pszMatchStart = NULL;
-  INT           iMatchLength = 0;
 
   while (pszCurr < pszEnd)
     {
-    rexTokens.Match (pszCurr, pszEnd - pszCurr, 0, &pszMatchStart, iMatchLength);
-
-    //DBG_INFO ("curr %x  end %x  rem %d  match  %x  matchlen  %d", pszCurr, pszEnd, pszEnd - pszCurr, pszMatchStart, iMatchLength);
+    const char *  pszTokenStart = pszCurr;
 
-    RStr  strTest;
-    strTest.AppendChars (pszMatchStart, iMatchLength);
-    //DBG_INFO ("Match returned \"%s\"", strTest.AsChar ());
-
-    // NOTE: Since capture groups are not currently implement we strip off whitespace
-
-    if (iMatchLength != 0)
+    switch (auClass [(UCHAR) *pszCurr])
       {
-      pszCurr += iMatchLength;
+      case CharClass::kWord:
+        {
+        while ((pszCurr < pszEnd) && (auClass [(UCHAR) *pszCurr] == CharClass::kWord))
+          {
+          ++pszCurr;
+          };
+        };
+        break;
 
-      while ((pszMatchStart[0] == ' ') && (iMatchLength > 0)) {++pszMatchStart; --iMatchLength;};
-      while ((pszMatchStart[iMatchLength - 1] == ' ') && (iMatchLength > 0)) {--iMatchLength;};
+      case CharClass::kQuote:
+        {
+        const char *  pszClose = (const char *) memchr (pszCurr + 1, *pszCurr, pszEnd - pszCurr - 1);
+        if (pszClose == NULL)
+          {
+          DBG_INFO ("Unterminated string, skip char \'%c\'", pszCurr[0]);
+          ++pszCurr;
+          continue;
+          };
+        pszCurr = pszClose + 1;
+        };
+        break;
 
-      if (iMatchLength != 0)
+      case CharClass::kOperator:
         {
-        pListOut->PushBack (new Token (pszMatchStart, iMatchLength));
+        INT  iOpLength = Token::OperatorLength (pszCurr, pszEnd);
+        if (iOpLength == 0)
+          {
+          DBG_INFO ("No match, skip char \'%c\'", pszCurr[0]);
+          ++pszCurr;
+          continue;
+          };
+        pszCurr += iOpLength;
         };
-      }
-    else
-      {
-      // no match.  Skip the current character and try again.  This should handle
-      //  weird whitespace and line end characters.
-      DBG_INFO ("No match, skip char \'%c\'", pszCurr[0]);
-      ++pszCurr;
+        break;
+
+      case CharClass::kSpace:
+        ++pszCurr;
+        continue;
+
+      default:
+        // no match.  Skip the current character and try again.
+        DBG_INFO ("No match, skip char \'%c\'", pszCurr[0]);
+        ++pszCurr;
+        continue;
       };
+
+    pListOut->PushBack (new Token (pszTokenStart, INT (pszCurr - pszTokenStart)));
     };
 
   //DBG_INFO ("Tokenize done");
@@ -1347,7 +1340,6 @@ FLOAT  Expression::Execute  (const char *            pszExpressionIn,
                              KVPArray *              pEnvVarsIn,
                              TList<ExpressionFn*> *  plistLocalFnIn)
   {
-  TList<Token*> *  pCompiled  = NULL;
   Token            tokResult;
 
   if (pRegistryIn == NULL)
@@ -1362,9 +1354,26 @@ FLOAT  Expression::Execute  (const char *            pszExpressionIn,
 
   //DBG_INFO ("Expression::Execute running: %s", pszExpressionIn);
 
-  pCompiled = Expression::Compile (pszExpressionIn);
-  FLOAT  fResult = Expression::Execute (pCompiled, pRegistryIn, pTokenOut, NULL, pEnvVarsIn, plistLocalFnIn);
-  Expression::FreeTokenList (&pCompiled);
+  // Compiled programs are cached by their text.  The entry stays pinned while
+  //  it runs, since functions called from it may execute other expressions.
+  ExpressionCacheEntry *  pEntry  = cacheCompiled.Acquire (pszExpressionIn);
+  FLOAT                   fResult = 0.0f;
+
+  ExpressionProgram *     pProgram = (eBackend == ExpressionBackend::kBytecode) ? pEntry->GetProgram () : NULL;
+
+  if ((pProgram != NULL) && pProgram->CanExecute ())
+    {
+    fResult = pProgram->Execute (pRegistryIn, pTokenOut, NULL, pEnvVarsIn, plistLocalFnIn);
+    }
+  else if (pEntry->plistCompiled != NULL)
+    {
+    fResult = Expression::Execute (pEntry->plistCompiled, pRegistryIn, pTokenOut, NULL, pEnvVarsIn, plistLocalFnIn);
+    }
+  else
+    {
+    pTokenOut->eType = TokenType::kUnknown;
+    };
+  cacheCompiled.Release (pEntry);
   return (fResult);
   }
 
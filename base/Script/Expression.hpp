@@ -42,6 +42,7 @@
 #include "Containers/KVPArray.hpp"
 #include "ValueRegistry/ValueRegistry.hpp"
 #include "Script/ExpressionToken.hpp"
+#include "Script/ExpressionCache.hpp"
 
 //------------------------------------------------------------------------
 // Defines
@@ -51,6 +52,15 @@
 // Class Definitions
 //------------------------------------------------------------------------
 
+namespace ExpressionBackend
+  {
+  enum Type
+    {
+    kInterpreter = 0,  ///< Walk the compiled token list
+    kBytecode    = 1   ///< Run the compiled ExpressionProgram, if the list could be converted
+    };
+  };
+
 #ifdef MOVED
 namespace TokenType
   {
@@ -246,6 +256,9 @@ class Expression
   {
   private:
     static TList<ExpressionFn*>   listFn;
+    static UINT32                 uFnGeneration;  ///< Bumped whenever listFn changes
+    static thread_local ExpressionCache  cacheCompiled;  ///< One per thread, since the cache isn't locked
+    static ExpressionBackend::Type  eBackend;
 
   public:
 
@@ -261,6 +274,11 @@ class Expression
 
     static VOID             UnregisterAllFunctions (VOID);
 
+    static UINT32           GetFunctionGeneration  (VOID)      {return (uFnGeneration);};
+
+    static ExpressionFn *   FindFunction     (RStr &                  strNameIn,
+                                              TList<ExpressionFn*> *  plistLocalFnIn);
+
     static VOID             CallFunction     (const char *            szNameIn,
                                               Token *                 ptokParamsIn,
                                               ValueRegistry *         pRegistryIn,
@@ -297,6 +315,16 @@ class Expression
                                               KVPArray *              pEnvVarsIn     = NULL,
                                               TList<ExpressionFn*> *  plistLocalFnIn = NULL);
 
+                            /** @brief  The compiled program cache used by Execute (const char *).  Each thread
+                                        has its own, so settings and stats only apply to the calling thread.
+                                @return The calling thread's cache.
+                            */
+    static ExpressionCache &  Cache          (VOID)    {return (cacheCompiled);};
+
+    static VOID             SetBackend       (ExpressionBackend::Type  eBackendIn)  {eBackend = eBackendIn;};
+
+    static ExpressionBackend::Type  GetBackend  (VOID)                             {return (eBackend);};
+
     static VOID             DebugTokenList   (TList<Token*> *  plistTokensIn);
 
     static VOID             DebugTokenLinkedList (Token*  plistIn); // this is for parameter lists
@@ -0,0 +1,231 @@
+/* -----------------------------------------------------------------
+                          Expression Cache
+
+     This module implements a bounded, least-recently-used cache of
+   compiled expressions, keyed by the expression text.  It lets
+   Expression::Execute skip tokenizing and compiling strings that are
+   run over and over.
+
+   ----------------------------------------------------------------- */
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Sys/Types.hpp"
+#include "Debug.hpp"
+ASSERTFILE (__FILE__)
+
+#include "Script/ExpressionCache.hpp"
+#include "Script/Expression.hpp"
+#include "Script/ExpressionProgram.hpp"
+
+//-----------------------------------------------------------------------------
+//  ExpressionCacheEntry
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+ExpressionCacheEntry::~ExpressionCacheEntry ()
+  {
+  delete (pProgram);
+  if (plistCompiled != NULL)
+    {
+    Expression::FreeTokenList (&plistCompiled);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionProgram *  ExpressionCacheEntry::GetProgram  (VOID)
+  {
+  if (!bProgramBuilt)
+    {
+    bProgramBuilt = TRUE;
+    pProgram      = ExpressionProgram::Build (plistCompiled);
+    };
+  return (pProgram);
+  };
+
+//-----------------------------------------------------------------------------
+//  ExpressionCache
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+ExpressionCache::ExpressionCache  (INT  iMaxEntriesIn)
+  {
+  pMostRecent   = NULL;
+  pLeastRecent  = NULL;
+  iNumEntries   = 0;
+  iMaxEntries   = iMaxEntriesIn;
+  ResetStats ();
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionCache::~ExpressionCache  ()
+  {
+  InvalidateAll ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::LinkFront  (ExpressionCacheEntry *  pEntryIn)
+  {
+  pEntryIn->pPrev = NULL;
+  pEntryIn->pNext = pMostRecent;
+  if (pMostRecent != NULL)
+    {
+    pMostRecent->pPrev = pEntryIn;
+    }
+  else
+    {
+    pLeastRecent = pEntryIn;
+    };
+  pMostRecent = pEntryIn;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::Unlink  (ExpressionCacheEntry *  pEntryIn)
+  {
+  if (pEntryIn->pPrev != NULL) {pEntryIn->pPrev->pNext = pEntryIn->pNext;} else {pMostRecent  = pEntryIn->pNext;};
+  if (pEntryIn->pNext != NULL) {pEntryIn->pNext->pPrev = pEntryIn->pPrev;} else {pLeastRecent = pEntryIn->pPrev;};
+  pEntryIn->pPrev = pEntryIn->pNext = NULL;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::Remove  (ExpressionCacheEntry *  pEntryIn)
+  {
+  hashEntries.Remove (pEntryIn->uHash, pEntryIn);
+  Unlink (pEntryIn);
+  --iNumEntries;
+
+  // entries still being executed are freed when they are released.
+  if (pEntryIn->iRefCount > 0)
+    {
+    pEntryIn->bInvalid = TRUE;
+    }
+  else
+    {
+    delete (pEntryIn);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::Trim  (VOID)
+  {
+  while ((iNumEntries > iMaxEntries) && (pLeastRecent != NULL))
+    {
+    Remove (pLeastRecent);
+    ++iNumEvictions;
+    };
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionCacheEntry *  ExpressionCache::Acquire  (const char *  szSourceIn)
+  {
+  HASH_T  uHash = CalcHashValue (szSourceIn);
+
+  for (INT  iSlot = hashEntries.FindFirst (uHash); iSlot != -1; iSlot = hashEntries.FindNext (uHash, iSlot))
+    {
+    ExpressionCacheEntry *  pEntry = hashEntries.GetAt (iSlot);
+    if (pEntry->strSource.Equals (szSourceIn))
+      {
+      ++iNumHits;
+      if (pEntry != pMostRecent)
+        {
+        Unlink (pEntry);
+        LinkFront (pEntry);
+        };
+      ++pEntry->iRefCount;
+      return (pEntry);
+      };
+    };
+
+  ++iNumMisses;
+
+  ExpressionCacheEntry *  pEntry = new ExpressionCacheEntry;
+  pEntry->strSource.Set (szSourceIn);
+  pEntry->uHash         = uHash;
+  pEntry->plistCompiled = Expression::Compile (szSourceIn);
+  pEntry->iRefCount     = 1;
+
+  if (iMaxEntries <= 0)
+    {
+    // caching is disabled.  The entry is freed as soon as it is released.
+    pEntry->bInvalid = TRUE;
+    return (pEntry);
+    };
+
+  hashEntries.Insert (uHash, pEntry);
+  LinkFront (pEntry);
+  ++iNumEntries;
+  Trim ();
+  return (pEntry);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::Release  (ExpressionCacheEntry *  pEntryIn)
+  {
+  ASSERT (pEntryIn->iRefCount > 0);
+  --pEntryIn->iRefCount;
+  if ((pEntryIn->iRefCount == 0) && pEntryIn->bInvalid)
+    {
+    delete (pEntryIn);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  ExpressionCache::Invalidate  (const char *  szSourceIn)
+  {
+  HASH_T  uHash = CalcHashValue (szSourceIn);
+
+  for (INT  iSlot = hashEntries.FindFirst (uHash); iSlot != -1; iSlot = hashEntries.FindNext (uHash, iSlot))
+    {
+    ExpressionCacheEntry *  pEntry = hashEntries.GetAt (iSlot);
+    if (pEntry->strSource.Equals (szSourceIn))
+      {
+      Remove (pEntry);
+      return (TRUE);
+      };
+    };
+  return (FALSE);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::InvalidateAll  (VOID)
+  {
+  while (pMostRecent != NULL)
+    {
+    Remove (pMostRecent);
+    };
+  hashEntries.Clear ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ExpressionCache::SetMaxEntries  (INT  iMaxEntriesIn)
+  {
+  iMaxEntries = iMaxEntriesIn;
+  Trim ();
+  };
+
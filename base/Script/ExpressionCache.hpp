@@ -0,0 +1,172 @@
+/* -----------------------------------------------------------------
+                          Expression Cache
+
+     This module implements a bounded, least-recently-used cache of
+   compiled expressions, keyed by the expression text.  It lets
+   Expression::Execute skip tokenizing and compiling strings that are
+   run over and over.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef EXPRESSIONCACHE_HPP
+#define EXPRESSIONCACHE_HPP
+
+#include "Sys/Types.hpp"
+#include "Containers/TList.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Util/RStr.hpp"
+#include "Script/ExpressionToken.hpp"
+
+//------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+// Class Definitions
+//------------------------------------------------------------------------
+
+class ExpressionProgram;
+
+//------------------------------------------------------------------------------
+class ExpressionCacheEntry
+  {
+  public:
+    RStr                     strSource;      ///< Expression text the program was compiled from
+    HASH_T                   uHash;          ///< Hash of strSource
+    TList<Token*> *          plistCompiled;  ///< Compiled program.  NULL if compilation failed.
+    ExpressionProgram *      pProgram;       ///< Bytecode version of plistCompiled, built on first use
+    BOOL                     bProgramBuilt;  ///< pProgram has been attempted.  It stays NULL if unsupported.
+    INT                      iRefCount;      ///< Number of Execute calls currently running this program
+    BOOL                     bInvalid;       ///< Removed from the cache while in use.  Freed on last Release.
+    ExpressionCacheEntry *   pPrev;          ///< Next more recently used entry
+    ExpressionCacheEntry *   pNext;          ///< Next less recently used entry
+
+  public:
+
+                 ExpressionCacheEntry  ()   {uHash = 0; plistCompiled = NULL; pProgram = NULL; bProgramBuilt = FALSE;
+                                             iRefCount = 0; bInvalid = FALSE; pPrev = pNext = NULL;};
+
+                 ~ExpressionCacheEntry ();
+
+                                    /** @brief  Return the bytecode program for this entry, building it on first call.
+                                        @return The program, or NULL if the expression can't be run as bytecode.
+                                    */
+    ExpressionProgram *  GetProgram (VOID);
+  };
+
+//------------------------------------------------------------------------------
+// NOTE:  A cache isn't locked, and entries must only be run by the thread that
+//  acquired them.  Expression keeps a separate cache for each thread.
+
+class ExpressionCache
+  {
+  public:
+    static const INT  kDefaultMaxEntries = 256;
+
+  private:
+    THashIndex<ExpressionCacheEntry*>  hashEntries;
+
+    ExpressionCacheEntry *   pMostRecent;
+    ExpressionCacheEntry *   pLeastRecent;
+    INT                      iNumEntries;
+    INT                      iMaxEntries;
+
+    INT                      iNumHits;
+    INT                      iNumMisses;
+    INT                      iNumEvictions;
+
+  private:
+
+    // Not copyable.
+                 ExpressionCache    (const ExpressionCache &  cacheIn);
+    ExpressionCache &  operator=    (const ExpressionCache &  cacheIn);
+
+    VOID         LinkFront          (ExpressionCacheEntry *  pEntryIn);
+
+    VOID         Unlink             (ExpressionCacheEntry *  pEntryIn);
+
+    VOID         Remove             (ExpressionCacheEntry *  pEntryIn);
+
+    VOID         Trim               (VOID);
+
+  public:
+
+                 ExpressionCache    (INT  iMaxEntriesIn = kDefaultMaxEntries);
+
+                 ~ExpressionCache   ();
+
+                                    /** @brief  Find the compiled program for the given text, compiling and
+                                                caching it on a miss.  The entry is pinned until Release is
+                                                called, so it stays valid even if it is evicted or
+                                                invalidated by a nested Execute.
+                                        @param  szSourceIn The expression text.
+                                        @return The pinned entry.  Its plistCompiled may be NULL if the text failed to compile.
+                                    */
+    ExpressionCacheEntry *  Acquire (const char *  szSourceIn);
+
+                                    /** @brief  Unpin an entry returned by Acquire.
+                                        @param  pEntryIn The entry to release.
+                                        @return None
+                                    */
+    VOID         Release            (ExpressionCacheEntry *  pEntryIn);
+
+                                    /** @brief  Drop the cached program for the given text, if any.
+                                        @param  szSourceIn The expression text.
+                                        @return True if an entry was removed.
+                                    */
+    BOOL         Invalidate         (const char *  szSourceIn);
+
+                                    /** @brief  Drop every cached program.
+                                        @return None
+                                    */
+    VOID         InvalidateAll      (VOID);
+
+                                    /** @brief  Set the number of programs kept.  Zero disables caching.
+                                        @param  iMaxEntriesIn The new limit.
+                                        @return None
+                                    */
+    VOID         SetMaxEntries      (INT  iMaxEntriesIn);
+
+    INT          GetMaxEntries      (VOID) const   {return (iMaxEntries);};
+
+    INT          Size               (VOID) const   {return (iNumEntries);};
+
+    INT          GetHits            (VOID) const   {return (iNumHits);};
+
+    INT          GetMisses          (VOID) const   {return (iNumMisses);};
+
+    INT          GetEvictions       (VOID) const   {return (iNumEvictions);};
+
+    VOID         ResetStats         (VOID)         {iNumHits = iNumMisses = iNumEvictions = 0;};
+  };
+
+#endif // EXPRESSIONCACHE_HPP
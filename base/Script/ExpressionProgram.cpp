@@ -0,0 +1,439 @@
+/* -----------------------------------------------------------------
+                          Expression Program
+
+     This module implements a bytecode form of a compiled expression,
+   and the stack machine that runs it.  Programs are built from the
+   postfix token list produced by Expression::Compile, and give the
+   same results as Expression::Execute on that list without
+   allocating tokens as they run.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Sys/Types.hpp"
+#include "Debug.hpp"
+ASSERTFILE (__FILE__)
+
+#include "Script/ExpressionProgram.hpp"
+#include "Script/Expression.hpp"
+
+//-----------------------------------------------------------------------------
+//  ExpressionProgram
+//-----------------------------------------------------------------------------
+
+thread_local Token  ExpressionProgram::atokStack [ExpressionProgram::kStackSize];
+thread_local INT    ExpressionProgram::iStackTop = 0;
+
+//-----------------------------------------------------------------------------
+ExpressionProgram::ExpressionProgram  ()
+  {
+  aInstr       = NULL;
+  iNumInstr    = 0;
+  atokConst    = NULL;
+  iNumConst    = 0;
+  aFnSlots     = NULL;
+  iNumFnSlots  = 0;
+  iMaxDepth    = 0;
+  iFinalCount  = 0;
+  bEndsWithEnd = FALSE;
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionProgram::~ExpressionProgram  ()
+  {
+  delete [] aInstr;
+  delete [] atokConst;
+  delete [] aFnSlots;
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionProgram *  ExpressionProgram::Build  (TList<Token*> *  plistCompiledIn)
+  {
+  if (plistCompiledIn == NULL) return (NULL);
+
+  // instruction operands are 16 bit
+  INT  iNumTokens = plistCompiledIn->Size ();
+  if (iNumTokens > 0xffff) return (NULL);
+
+  ExpressionProgram *  pProgram = new ExpressionProgram;
+  pProgram->aInstr    = new ExpressionInstr  [iNumTokens];
+  pProgram->atokConst = new Token            [iNumTokens];
+  pProgram->aFnSlots  = new ExpressionFnSlot [iNumTokens];
+
+  // Simulate the interpreter's value stack, tracking how many slots each
+  //  value (or parameter list) takes up.
+  INT *    aiValueCount = new INT [iNumTokens + 1];
+  INT      iNumValues   = 0;
+  INT      iDepth       = 0;
+  BOOL     bSupported   = TRUE;
+  Token *  pToken       = NULL;
+
+  for (TListItr<Token*>  itrCurr = plistCompiledIn->First (); itrCurr.IsValid (); ++itrCurr)
+    {
+    pToken = (*itrCurr);
+
+    ExpressionInstr &  instr = pProgram->aInstr [pProgram->iNumInstr];
+    instr.uOp       = BytecodeOp::kPush;
+    instr.uOperator = UINT8 (pToken->eType);
+    instr.uIndex    = 0;
+    instr.uCountL   = 0;
+    instr.uCountR   = 0;
+
+    if ((pToken->IsType (TokenType::kInt)) ||
+        (pToken->IsType (TokenType::kFloat)) ||
+        (pToken->IsType (TokenType::kVariable)) ||
+        (pToken->IsType (TokenType::kString)))
+      {
+      instr.uIndex = UINT16 (pProgram->iNumConst);
+      pProgram->atokConst [pProgram->iNumConst++] = *pToken;
+      aiValueCount [iNumValues++] = 1;
+      ++iDepth;
+      ++pProgram->iNumInstr;
+      }
+    else if (pToken->bIsOperator)
+      {
+      // The interpreter substitutes NULL for missing operands.  Only the
+      //  unary minus case is well defined, so anything else is left to it.
+      if (iNumValues == 0)
+        {
+        bSupported = FALSE;
+        break;
+        };
+
+      if (pToken->bIsUnary)
+        {
+        instr.uOp     = BytecodeOp::kUnary;
+        instr.uCountL = UINT16 (aiValueCount [iNumValues - 1]);
+        ++pProgram->iNumInstr;
+        }
+      else
+        {
+        INT  iCountR = aiValueCount [--iNumValues];
+
+        if (iNumValues == 0)
+          {
+          if (!pToken->IsType (TokenType::kOpMinus))
+            {
+            bSupported = FALSE;
+            break;
+            };
+          instr.uOp     = BytecodeOp::kNegate;
+          instr.uCountR = UINT16 (iCountR);
+          aiValueCount [iNumValues++] = iCountR;
+          ++pProgram->iNumInstr;
+          }
+        else if (pToken->IsType (TokenType::kOpList))
+          {
+          // list values are already next to each other on the stack.
+          aiValueCount [iNumValues - 1] += iCountR;
+          }
+        else
+          {
+          instr.uOp     = BytecodeOp::kBinary;
+          instr.uCountL = UINT16 (aiValueCount [iNumValues - 1]);
+          instr.uCountR = UINT16 (iCountR);
+          iDepth -= iCountR;
+          ++pProgram->iNumInstr;
+          };
+        };
+      }
+    else if (pToken->IsType (TokenType::kExpressionEnd))
+      {
+      if (iNumValues == 0)
+        {
+        bSupported = FALSE;
+        break;
+        };
+      instr.uOp     = BytecodeOp::kEnd;
+      instr.uCountR = UINT16 (aiValueCount [--iNumValues]);
+      iDepth -= instr.uCountR;
+      ++pProgram->iNumInstr;
+      }
+    else if (pToken->IsType (TokenType::kFunction))
+      {
+      ExpressionFnSlot &  slot = pProgram->aFnSlots [pProgram->iNumFnSlots];
+      slot.strName.Set (pToken->strRaw);
+      slot.strName.CalcHash ();
+      slot.pfnCached   = NULL;
+      slot.uGeneration = 0;
+
+      instr.uOp     = BytecodeOp::kCall;
+      instr.uIndex  = UINT16 (pProgram->iNumFnSlots++);
+      instr.uCountR = UINT16 ((iNumValues > 0) ? aiValueCount [--iNumValues] : 0);
+      iDepth -= instr.uCountR;
+      aiValueCount [iNumValues++] = 1;
+      ++iDepth;
+      ++pProgram->iNumInstr;
+      }
+    else if (pToken->IsType (TokenType::kReturn))
+      {
+      instr.uOp     = BytecodeOp::kReturn;
+      instr.uCountR = UINT16 ((iNumValues > 0) ? aiValueCount [--iNumValues] : 0);
+      instr.uCountL = UINT16 ((iNumValues > 0) ? aiValueCount [iNumValues - 1] : 0);
+      ++pProgram->iNumInstr;
+      // nothing after a return is ever run.
+      break;
+      };
+    // any other token types are skipped by the interpreter as well.
+
+    pProgram->iMaxDepth = RMax (pProgram->iMaxDepth, iDepth);
+    };
+
+  pProgram->iFinalCount  = (iNumValues > 0) ? aiValueCount [iNumValues - 1] : 0;
+  pProgram->bEndsWithEnd = (pToken != NULL) && pToken->IsType (TokenType::kExpressionEnd);
+  delete [] aiValueCount;
+
+  if (!bSupported)
+    {
+    delete (pProgram);
+    return (NULL);
+    };
+  return (pProgram);
+  };
+
+//-----------------------------------------------------------------------------
+ExpressionFn *  ExpressionProgram::ResolveFunction  (ExpressionFnSlot &      slotIn,
+                                                     TList<ExpressionFn*> *  plistLocalFnIn)
+  {
+  // Local functions override global functions, and may differ between calls.
+  if (plistLocalFnIn != NULL)
+    {
+    for (TListItr<ExpressionFn*>  itrCurr = plistLocalFnIn->First (); itrCurr.IsValid (); ++itrCurr)
+      {
+      if ((*itrCurr)->CanHandleFunction (slotIn.strName))
+        {
+        return (*itrCurr);
+        };
+      };
+    };
+
+  // The global function is cached until the function list changes.  It is
+  //  still asked to confirm, since CanHandleFunction may set up state for OnCall.
+  if ((slotIn.pfnCached != NULL) &&
+      (slotIn.uGeneration == Expression::GetFunctionGeneration ()) &&
+      (slotIn.pfnCached->CanHandleFunction (slotIn.strName)))
+    {
+    return (slotIn.pfnCached);
+    };
+
+  slotIn.pfnCached   = Expression::FindFunction (slotIn.strName, NULL);
+  slotIn.uGeneration = Expression::GetFunctionGeneration ();
+  return (slotIn.pfnCached);
+  };
+
+//-----------------------------------------------------------------------------
+static VOID  ReleaseListTails  (Token *  atokIn,
+                                INT      iCountIn)
+  {
+  // A slot's pNext is only set when a function returned a list.  The slot
+  //  owns the rest of that list until it is popped.
+  for (INT  iSlot = 0; iSlot < iCountIn; ++iSlot)
+    {
+    if (atokIn [iSlot].pNext != NULL)
+      {
+      delete (atokIn [iSlot].pNext);
+      atokIn [iSlot].pNext = NULL;
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+static Token *  ListTail  (Token *  ptokIn)
+  {
+  while (ptokIn->pNext != NULL)
+    {
+    ptokIn = ptokIn->pNext;
+    };
+  return (ptokIn);
+  };
+
+//-----------------------------------------------------------------------------
+FLOAT  ExpressionProgram::Execute  (ValueRegistry *         pRegistryIn,
+                                    Token *                 pTokenOut,
+                                    BOOL *                  pbReturned,
+                                    KVPArray *              pEnvVarsIn,
+                                    TList<ExpressionFn*> *  plistLocalFnIn)
+  {
+  ASSERT (CanExecute ());
+
+  // Reserve this program's slots, so functions that run expressions of their
+  //  own use the stack above them.
+  INT      iBase     = iStackTop;
+  Token *  atokValue = &atokStack [iBase];
+  INT      iNumSlots = 0;
+  FLOAT    fResult   = 0.0f;
+  BOOL     bReadTop  = !bEndsWithEnd;
+  INT      iTopCount = iFinalCount;
+
+  iStackTop = iBase + iMaxDepth;
+
+  if (pTokenOut != NULL)
+    {
+    pTokenOut->eType = TokenType::kUnknown;
+    };
+  if (pbReturned != NULL)
+    {
+    *pbReturned = FALSE;
+    };
+
+  for (INT  iInstr = 0; iInstr < iNumInstr; ++iInstr)
+    {
+    const ExpressionInstr &  instr = aInstr [iInstr];
+
+    switch (instr.uOp)
+      {
+      case BytecodeOp::kPush:
+        atokValue [iNumSlots++] = atokConst [instr.uIndex];
+        break;
+
+      case BytecodeOp::kUnary:
+        Token::ApplyOperator (TokenType::Type (instr.uOperator),
+                              &atokValue [iNumSlots - instr.uCountL],
+                              NULL,
+                              pRegistryIn, pEnvVarsIn);
+        break;
+
+      case BytecodeOp::kBinary:
+        Token::ApplyOperator (TokenType::Type (instr.uOperator),
+                              &atokValue [iNumSlots - instr.uCountR - instr.uCountL],
+                              &atokValue [iNumSlots - instr.uCountR],
+                              pRegistryIn, pEnvVarsIn);
+        ReleaseListTails (&atokValue [iNumSlots - instr.uCountR], instr.uCountR);
+        iNumSlots -= instr.uCountR;
+        break;
+
+      case BytecodeOp::kNegate:
+        Token::ApplyOperator (TokenType::kOpMinus,
+                              NULL,
+                              &atokValue [iNumSlots - instr.uCountR],
+                              pRegistryIn, pEnvVarsIn);
+        break;
+
+      case BytecodeOp::kCall:
+        {
+        Token *  ptokParams = NULL;
+        Token    tokResult;
+
+        if (instr.uCountR > 0)
+          {
+          // functions expect their parameters as a linked list.  A parameter
+          //  that is a list returned by another function brings its tail along.
+          ptokParams = &atokValue [iNumSlots - instr.uCountR];
+          for (INT  iParam = 0; iParam < instr.uCountR - 1; ++iParam)
+            {
+            ListTail (&ptokParams [iParam])->pNext = &ptokParams [iParam + 1];
+            };
+          };
+
+        ExpressionFn *  pfnCall = ResolveFunction (aFnSlots [instr.uIndex], plistLocalFnIn);
+        if (pfnCall != NULL)
+          {
+          pfnCall->OnCall (ptokParams, pRegistryIn, &tokResult);
+          }
+        else
+          {
+          DBG_ERROR ("Unable to find Function : %s", aFnSlots [instr.uIndex].strName.AsChar ());
+          };
+
+        for (INT  iParam = 0; iParam < instr.uCountR - 1; ++iParam)
+          {
+          Token *  ptokTail = &ptokParams [iParam];
+          while (ptokTail->pNext != &ptokParams [iParam + 1])
+            {
+            ptokTail = ptokTail->pNext;
+            };
+          ptokTail->pNext = NULL;
+          };
+        ReleaseListTails (ptokParams, instr.uCountR);
+        iNumSlots -= instr.uCountR;
+
+        // Token::operator= drops pNext, so move a returned list over by hand.
+        Token &  tokSlot = atokValue [iNumSlots++];
+        tokSlot          = tokResult;
+        tokSlot.pNext    = tokResult.pNext;
+        tokResult.pNext  = NULL;
+        };
+        break;
+
+      case BytecodeOp::kEnd:
+        {
+        Token &  tokTop = atokValue [iNumSlots - instr.uCountR];
+        fResult = tokTop.AsFloat (pRegistryIn, pEnvVarsIn);
+        if (pTokenOut != NULL)
+          {
+          *pTokenOut = tokTop;
+          };
+        ReleaseListTails (&tokTop, instr.uCountR);
+        iNumSlots -= instr.uCountR;
+        };
+        break;
+
+      case BytecodeOp::kReturn:
+        if (pbReturned != NULL)
+          {
+          *pbReturned = TRUE;
+          };
+        if (instr.uCountR == 0)
+          {
+          fResult = 0.0f;
+          }
+        else
+          {
+          Token &  tokTop = atokValue [iNumSlots - instr.uCountR];
+          fResult = tokTop.AsFloat (pRegistryIn, pEnvVarsIn);
+          if (pTokenOut != NULL)
+            {
+            *pTokenOut = tokTop;
+            };
+          ReleaseListTails (&tokTop, instr.uCountR);
+          iNumSlots -= instr.uCountR;
+          };
+        // like the interpreter, whatever is left on the stack becomes the result.
+        bReadTop  = TRUE;
+        iTopCount = instr.uCountL;
+        iInstr    = iNumInstr;
+        break;
+      };
+    };
+
+  // catch the case where the expression didn't end in a semicolon (end expression token)
+  if (bReadTop && (iTopCount > 0))
+    {
+    Token &  tokTop = atokValue [iNumSlots - iTopCount];
+    fResult = tokTop.AsFloat (pRegistryIn, pEnvVarsIn);
+    if (pTokenOut != NULL) {*pTokenOut = tokTop;};
+    };
+
+  ReleaseListTails (atokValue, iNumSlots);
+  iStackTop = iBase;
+  return (fResult);
+  };
+
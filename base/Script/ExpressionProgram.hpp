@@ -0,0 +1,163 @@
+/* -----------------------------------------------------------------
+                          Expression Program
+
+     This module implements a bytecode form of a compiled expression,
+   and the stack machine that runs it.  Programs are built from the
+   postfix token list produced by Expression::Compile, and give the
+   same results as Expression::Execute on that list without
+   allocating tokens as they run.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef EXPRESSIONPROGRAM_HPP
+#define EXPRESSIONPROGRAM_HPP
+
+#include "Sys/Types.hpp"
+#include "Containers/TList.hpp"
+#include "Containers/KVPArray.hpp"
+#include "ValueRegistry/ValueRegistry.hpp"
+#include "Script/ExpressionToken.hpp"
+
+class ExpressionFn;
+
+//------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+// Class Definitions
+//------------------------------------------------------------------------
+
+namespace BytecodeOp
+  {
+  enum Type
+    {
+    kPush      = 0,  ///< Copy constant uIndex onto the stack
+    kUnary     = 1,  ///< Apply uOperator to the top value
+    kBinary    = 2,  ///< Apply uOperator to the top two values, leaving the result in the left one
+    kNegate    = 3,  ///< Minus with no left operand
+    kCall      = 4,  ///< Call function slot uIndex with the top uCountR values as parameters
+    kEnd       = 5,  ///< End of statement.  Pop the top value into the result.
+    kReturn    = 6   ///< Pop the top value into the result and stop.
+    };
+  };
+
+//------------------------------------------------------------------------------
+class ExpressionInstr
+  {
+  public:
+    UINT8                    uOp;        ///< BytecodeOp::Type
+    UINT8                    uOperator;  ///< TokenType of the operator for kUnary, kBinary, and kNegate
+    UINT16                   uIndex;     ///< Constant index for kPush, function slot for kCall
+    UINT16                   uCountL;    ///< Stack slots used by the left operand.  For kReturn, the slots in the value left on top.
+    UINT16                   uCountR;    ///< Stack slots used by the right operand, call parameters, or result value
+  };
+
+//------------------------------------------------------------------------------
+class ExpressionFnSlot
+  {
+  public:
+    RStr                     strName;       ///< Function name, with its hash calculated
+    ExpressionFn *           pfnCached;     ///< Global function that handled the last call
+    UINT32                   uGeneration;   ///< Expression::GetFunctionGeneration () when pfnCached was found
+  };
+
+//------------------------------------------------------------------------------
+class ExpressionProgram
+  {
+  public:
+    static const INT  kStackSize = 256;  ///< Value slots shared by the programs running on one thread
+
+  private:
+    // Values are parameter lists when they span more than one slot.  List
+    //  operators only join neighboring values, so their slots stay next to
+    //  each other on the stack and are linked together just for function calls.
+    //  Each thread has its own stack, so programs can run on worker threads.
+
+    static thread_local Token  atokStack [kStackSize];
+    static thread_local INT    iStackTop;   ///< First slot not used by a running program on this thread
+
+    ExpressionInstr *        aInstr;
+    INT                      iNumInstr;
+    Token *                  atokConst;
+    INT                      iNumConst;
+    ExpressionFnSlot *       aFnSlots;
+    INT                      iNumFnSlots;
+    INT                      iMaxDepth;      ///< Most stack slots needed at once
+    INT                      iFinalCount;    ///< Slots in the top value when the program finishes
+    BOOL                     bEndsWithEnd;   ///< Last token was an expression end
+
+  private:
+
+                 ExpressionProgram  ();
+
+    // Not copyable.
+                 ExpressionProgram  (const ExpressionProgram &  progIn);
+    ExpressionProgram &  operator=  (const ExpressionProgram &  progIn);
+
+    ExpressionFn *  ResolveFunction (ExpressionFnSlot &       slotIn,
+                                     TList<ExpressionFn*> *   plistLocalFnIn);
+
+  public:
+
+                 ~ExpressionProgram ();
+
+                                    /** @brief  Convert a list from Expression::Compile into bytecode.
+                                        @param  plistCompiledIn The compiled postfix token list.
+                                        @return A new program, or NULL if the list uses a construct the
+                                                bytecode can't reproduce exactly (such as a missing operand).
+                                                Callers should fall back to Expression::Execute on the list.
+                                    */
+    static ExpressionProgram *  Build (TList<Token*> *  plistCompiledIn);
+
+                                    /** @brief  Check that there is room on the shared stack to run this program.
+                                        @return True if Execute may be called.
+                                    */
+    BOOL         CanExecute         (VOID) const  {return (iStackTop + iMaxDepth <= kStackSize);};
+
+                                    /** @brief  Run the program.  Parameters match Expression::Execute.
+                                        @return The result as a float.
+                                    */
+    FLOAT        Execute            (ValueRegistry *         pRegistryIn,
+                                     Token *                 pTokenOut      = NULL,
+                                     BOOL *                  pbReturned     = NULL,
+                                     KVPArray *              pEnvVarsIn     = NULL,
+                                     TList<ExpressionFn*> *  plistLocalFnIn = NULL);
+
+    INT          NumInstructions    (VOID) const  {return (iNumInstr);};
+
+    INT          NumConstants       (VOID) const  {return (iNumConst);};
+
+    INT          MaxDepth           (VOID) const  {return (iMaxDepth);};
+  };
+
+#endif // EXPRESSIONPROGRAM_HPP
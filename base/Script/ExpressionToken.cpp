@@ -44,7 +44,6 @@ ASSERTFILE (__FILE__)
 
 #include "Util/RStrParser.hpp"
 #include "Script/Expression.hpp"
-#include "Util/RegEx.hpp"
 
 // NOTE:  Based off of http://en.wikipedia.org/wiki/Shunting-yard_algorithm
 
@@ -53,20 +52,26 @@ ASSERTFILE (__FILE__)
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+static BOOL  StartsWithNoCase  (const char *  szTextIn,
+                                INT           iTextLengthIn,
+                                const char *  szPrefixIn)
+  {
+  INT  iIndex = 0;
+  for (; szPrefixIn [iIndex] != '\0'; ++iIndex)
+    {
+    if ((iIndex >= iTextLengthIn) || (tolower ((UCHAR) szTextIn [iIndex]) != szPrefixIn [iIndex]))
+      {
+      return (FALSE);
+      };
+    };
+  return (TRUE);
+  };
+
 //-----------------------------------------------------------------------------
 Token::Token  (const char *   szTextIn,
                INT            iTextLengthIn)
   {
-  static RegEx  rexFloat      (REX_FLOAT);
-  static RegEx  rexInt        (REX_INT);
-  static RegEx  rexIdentifier (REX_IDENTIFIER);
-  static RegEx  rexTrue       (REX_TRUE);
-  static RegEx  rexFalse      (REX_FALSE);
-  static RegEx  rexDoubleString (REX_DOUBLE_STRING);
-  static RegEx  rexSingleString (REX_SINGLE_STRING);
-
-
-
   // Operator Predecence (higher numbers handled first)
   // 0: ( ) ;
   // 1: , = += -= *= /=
@@ -266,16 +271,22 @@ Token::Token  (const char *   szTextIn,
   // identifiers, strings, contstants, and other non-reserved keyword stuff
   else
     {
-    RStrParser  parserText;
-    parserText.AppendChars (szTextIn, iTextLengthIn);
+    INT  iNumDigits = 0;
+    while ((iNumDigits < iTextLengthIn) && isdigit ((UCHAR) szTextIn [iNumDigits]))
+      {
+      ++iNumDigits;
+      };
 
-    if (rexFloat.HasMatch (parserText.AsChar ()))
+    if ((iNumDigits > 0) &&
+        (iNumDigits + 1 < iTextLengthIn) &&
+        (szTextIn [iNumDigits] == '.') &&
+        isdigit ((UCHAR) szTextIn [iNumDigits + 1]))
       {
       // Floating point number
       eType = TokenType::kFloat;
       Set ((FLOAT) atof(szTextIn));
       }
-    else if (rexInt.HasMatch (parserText.AsChar ()))
+    else if (iNumDigits > 0)
       {
       // Integer number
       eType = TokenType::kInt;
@@ -286,33 +297,27 @@ Token::Token  (const char *   szTextIn,
       // "return" keyword
       eType = TokenType::kReturn;
       }
-    else if (rexTrue.HasMatch (parserText.AsChar ()))
+    else if (StartsWithNoCase (szTextIn, iTextLengthIn, "true"))
       {
       eType = TokenType::kInt;
       Set (1);
       }
-    else if (rexFalse.HasMatch (parserText.AsChar ()))
+    else if (StartsWithNoCase (szTextIn, iTextLengthIn, "false"))
       {
       eType = TokenType::kInt;
       Set (0);
       }
-    else if (rexIdentifier.HasMatch (parserText.AsChar ()))
+    else if ((iTextLengthIn > 0) && (CharClassTable () [(UCHAR) szTextIn [0]] == CharClass::kWord))
       {
       eType = TokenType::kIdentifier;
       }
-    else if (rexDoubleString.HasMatch (parserText.AsChar ()))
+    else if ((iTextLengthIn > 1) &&
+             ((szTextIn [0] == '"') || (szTextIn [0] == '\'')) &&
+             (memchr (szTextIn + 1, szTextIn [0], iTextLengthIn - 1) != NULL))
       {
-      // strip the double quotes
-
-      parserText.GetQuoteString (&strRaw);
-
-      eType = TokenType::kString;
-      }
-    else if (rexSingleString.HasMatch (parserText.AsChar ()))
-      {
-      // strip the single quotes
-
-      // works with both single and double quotes
+      // strip the quotes.  This works with both single and double quotes.
+      RStrParser  parserText;
+      parserText.AppendChars (szTextIn, iTextLengthIn);
       parserText.GetQuoteString (&strRaw);
 
       eType = TokenType::kString;
@@ -324,6 +329,50 @@ Token::Token  (const char *   szTextIn,
     };
   };
 
+//-----------------------------------------------------------------------------
+const UINT8 *  Token::CharClassTable  (VOID)
+  {
+  static UINT8  auClass [256];
+  static BOOL   bInitialized = FALSE;
+
+  if (!bInitialized)
+    {
+    memset (auClass, CharClass::kOther, sizeof (auClass));
+
+    for (INT  iChar = 'a'; iChar <= 'z'; ++iChar) {auClass [iChar] = CharClass::kWord;};
+    for (INT  iChar = 'A'; iChar <= 'Z'; ++iChar) {auClass [iChar] = CharClass::kWord;};
+    for (INT  iChar = '0'; iChar <= '9'; ++iChar) {auClass [iChar] = CharClass::kWord;};
+    for (const char *  pszChar = "_.${}";       *pszChar != '\0'; ++pszChar) {auClass [(UCHAR) *pszChar] = CharClass::kWord;};
+    for (const char *  pszChar = " \t\r\n\f\v";  *pszChar != '\0'; ++pszChar) {auClass [(UCHAR) *pszChar] = CharClass::kSpace;};
+    for (const char *  pszChar = "+-*/%=<>!&|,();"; *pszChar != '\0'; ++pszChar) {auClass [(UCHAR) *pszChar] = CharClass::kOperator;};
+    auClass [(UCHAR) '"']  = CharClass::kQuote;
+    auClass [(UCHAR) '\''] = CharClass::kQuote;
+    bInitialized = TRUE;
+    };
+  return (auClass);
+  };
+
+//-----------------------------------------------------------------------------
+INT  Token::OperatorLength  (const char *   szTextIn,
+                             const char *   szEndIn)
+  {
+  // two character operators must be checked before their one character prefixes.
+  static const char *  aszDoubleOps [] = {"==", "!=", "<=", ">=", "+=", "-=", "*=", "/=", "%=", "++", "--", "||", "&&"};
+
+  if (szTextIn + 1 < szEndIn)
+    {
+    for (UINT  uOp = 0; uOp < sizeof (aszDoubleOps) / sizeof (const char *); ++uOp)
+      {
+      if ((szTextIn [0] == aszDoubleOps [uOp][0]) && (szTextIn [1] == aszDoubleOps [uOp][1]))
+        {
+        return (2);
+        };
+      };
+    };
+  // '!', '&', and '|' are only valid as part of a two character operator.
+  return ((strchr ("+-*/%=<>,();", szTextIn [0]) != NULL) ? 1 : 0);
+  };
+
 //-----------------------------------------------------------------------------
 Token *  Token::MakeStringToken  (const char *   szTextIn,
                                   INT            iTextLengthIn)
@@ -666,22 +715,40 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
   // Note:  Pointers to the L and R operands are given to this routine.
   //        The result is placed in the L operand.  The R operand is deleted if needed.
 
+  if (!ApplyOperator (eType, ptokOperandL, ptokOperandR, pRegistryIn, pEnvVarsIn))
+    {
+    delete (ptokOperandR);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  Token::ApplyOperator  (TokenType::Type  eOperatorIn,
+                             Token *          ptokOperandL,
+                             Token *          ptokOperandR,
+                             ValueRegistry *  pRegistryIn,
+                             KVPArray *       pEnvVarsIn)
+  {
+  // Note:  The result is placed in the L operand.  Neither operand is freed.
+  //        Returns TRUE if the R operand is still in use (it was appended to
+  //        the L operand's list, or it holds the result of a unary minus), and
+  //        FALSE if the caller may discard it.
+
   // special case unary operators
   if (ptokOperandL == NULL)
     {
-    if (this->eType == TokenType::kOpMinus)
+    if (eOperatorIn == TokenType::kOpMinus)
       {
       if (ptokOperandR != NULL)
         {
         if (ptokOperandR->IsInt (pRegistryIn, pEnvVarsIn))
           {
           ptokOperandR->Set (- ptokOperandR->AsInt (pRegistryIn, pEnvVarsIn));
-          return;
+          return (TRUE);
           };
         if (ptokOperandR->IsFloat (pRegistryIn, pEnvVarsIn))
           {
           ptokOperandR->Set (- ptokOperandR->AsFloat (pRegistryIn, pEnvVarsIn));
-          return;
+          return (TRUE);
           };
         };
       };
@@ -710,7 +777,7 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
     FLOAT  fValueL = (ptokOperandL == NULL) ? 0.0f : ptokOperandL->AsFloat (pRegistryIn, pEnvVarsIn);
     FLOAT  fValueR = (ptokOperandR == NULL) ? 0.0f : ptokOperandR->AsFloat (pRegistryIn, pEnvVarsIn);
 
-    switch (this->eType)
+    switch (eOperatorIn)
       {
       case TokenType::kOpInc:             ptokOperandL->Set (fValueL + 1.0f); break;
       case TokenType::kOpDec:             ptokOperandL->Set (fValueL - 1.0f); break;
@@ -742,7 +809,7 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
                                           break;
       case TokenType::kOpLogicalOr:       ptokOperandL->eType = TokenType::kFloat; ptokOperandL->Set ((!FLT_APPROX_EQUAL (fValueL, 0.0f) || !FLT_APPROX_EQUAL (fValueR, 0.0f)) ? 1.0f : 0.0f); break;
 
-      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return; // Return so we don't deallocate ptokOperandR
+      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return (TRUE); // ptokOperandR is now part of the list
       default:                            ptokOperandL->Set (0.0f); break;
       };
     }
@@ -751,7 +818,7 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
     INT  iValueL = (ptokOperandL == NULL) ? 0 : ptokOperandL->AsInt (pRegistryIn, pEnvVarsIn);
     INT  iValueR = (ptokOperandR == NULL) ? 0 : ptokOperandR->AsInt (pRegistryIn, pEnvVarsIn);
 
-    switch (this->eType)
+    switch (eOperatorIn)
       {
       case TokenType::kOpInc:             ptokOperandL->Set (iValueL + 1); break;
       case TokenType::kOpDec:             ptokOperandL->Set (iValueL - 1); break;
@@ -783,14 +850,14 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
                                           break;
       case TokenType::kOpLogicalOr:       ptokOperandL->eType = TokenType::kInt; ptokOperandL->Set ((iValueL || iValueR) ? 1 : 0); break;
 
-      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return; // Return so we don't deallocate ptokOperandR
+      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return (TRUE); // ptokOperandR is now part of the list
       default:                            ptokOperandL->Set (0); break;
       };
     }
 
   else if (bStringMath)
     {
-    switch (this->eType)
+    switch (eOperatorIn)
       {
       case TokenType::kOpPlus:            {
                                           RStr strOut (ptokOperandL->AsString (pRegistryIn, pEnvVarsIn));
@@ -820,13 +887,13 @@ VOID  Token::Evaluate  (Token *          ptokOperandL,
                                           ptokOperandL->Set (strOut.AsChar (), pRegistryIn, pEnvVarsIn);
                                           break;
                                           };
-      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return; // Return so we don't deallocate ptokOperandR
+      case TokenType::kOpList:            ptokOperandL->ArrayAppend (ptokOperandR); return (TRUE); // ptokOperandR is now part of the list
       default:                            ptokOperandL->Set (""); break;
       };
 
 
     };
-  delete (ptokOperandR);
+  return (FALSE);
   };
 
 //-----------------------------------------------------------------------------
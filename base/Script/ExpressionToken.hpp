@@ -102,16 +102,18 @@ namespace AssociativityType
     };
   };
 
-// NOTE: Probably move these to const strings.
-// NOTE:  I don't currently handle non-capturing groups!
-#define REX_FLOAT      "^[0-9]+\\.[0-9]+"
-#define REX_INT        "^[0-9]+"
-//#define REX_IDENTIFIER "^[a-zA-Z_]?[a-zA-Z0-9_\\.]*"
-#define REX_TRUE "^[Tt][Rr][Uu][Ee]"
-#define REX_FALSE "^[Ff][Aa][Ll][Ss][Ee]"
-#define REX_IDENTIFIER "^[a-zA-Z_\\${]?[a-zA-Z0-9\\${}_\\.]*"
-#define REX_DOUBLE_STRING     "^\"[^\"]*\""
-#define REX_SINGLE_STRING     "^\'[^\']*\'"
+// Character classes used by Expression::Tokenize
+namespace CharClass
+  {
+  enum Type
+    {
+    kOther    = 0,  ///< Not part of any token.  Skipped.
+    kSpace    = 1,  ///< Whitespace between tokens
+    kWord     = 2,  ///< Numbers, identifiers, and variable references: [a-zA-Z0-9_.${}]
+    kQuote    = 3,  ///< Start of a single or double quoted string
+    kOperator = 4   ///< First character of an operator, parenthesis, comma, or semicolon
+    };
+  };
 
 //-----------------------------------------------------------------------------
 class Token
@@ -185,6 +187,12 @@ class Token
                                       ValueRegistry *  pRegistryIn,
                                       KVPArray *       pEnvVarsIn  = NULL);
 
+    static BOOL    ApplyOperator     (TokenType::Type  eOperatorIn,
+                                      Token *          ptokOperandL,
+                                      Token *          ptokOperandR,
+                                      ValueRegistry *  pRegistryIn,
+                                      KVPArray *       pEnvVarsIn  = NULL);
+
     INT            ComparePrecedence (const Token &  tokOperandIn);
 
     VOID           ArrayAppend       (Token *  ptokAppendIn);
@@ -199,6 +207,19 @@ class Token
     static Token * MakeStringToken   (const char *   szTextIn,
                                       INT            iTextLengthIn);
 
+                                     /** @brief  Table mapping each character to its CharClass::Type.
+                                         @return Pointer to 256 entries, indexed by unsigned char.
+                                     */
+    static const UINT8 *  CharClassTable  (VOID);
+
+                                     /** @brief  Measure the operator at the start of the text.
+                                         @param  szTextIn Start of the operator.
+                                         @param  szEndIn End of the text.
+                                         @return Length of the operator (1 or 2), or 0 if the text doesn't start with one.
+                                     */
+    static INT     OperatorLength    (const char *   szTextIn,
+                                      const char *   szEndIn);
+
   };
 
 
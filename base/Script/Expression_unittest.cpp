@@ -5,6 +5,12 @@ ASSERTFILE (__FILE__);
 
 #include "ValueRegistry/ValueRegistrySimple.hpp"
 #include "Script/Expression.hpp"
+#include "Script/ExpressionCache.hpp"
+#include "Script/ExpressionProgram.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/WorkerPool.hpp"
+#include "Util/RegEx.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 
@@ -486,4 +492,599 @@ TEST (Expression, Booleans)
   Expression::FreeTokenList (&pCompiled);
   };
 
+//------------------------------------------------------------------------------
+TEST (Expression, CompiledCache)
+  {
+  ExpressionCache  cache (2);
+  ValueRegistrySimple  registry;
+
+  ExpressionCacheEntry *  pEntryA = cache.Acquire ("1 + 2");
+  ASSERT_TRUE (pEntryA->plistCompiled != NULL);
+  ASSERT_EQ (3.0f, Expression::Execute (pEntryA->plistCompiled, &registry));
+  cache.Release (pEntryA);
+  ASSERT_EQ (0, cache.GetHits ());
+  ASSERT_EQ (1, cache.GetMisses ());
+
+  // same text returns the same program
+  ExpressionCacheEntry *  pEntryB = cache.Acquire ("1 + 2");
+  ASSERT_EQ (pEntryA, pEntryB);
+  cache.Release (pEntryB);
+  ASSERT_EQ (1, cache.GetHits ());
+
+  // least recently used entry is evicted past the limit
+  cache.Release (cache.Acquire ("3 * 4"));
+  cache.Release (cache.Acquire ("1 + 2"));
+  cache.Release (cache.Acquire ("5 - 6"));
+  ASSERT_EQ (2, cache.Size ());
+  ASSERT_EQ (1, cache.GetEvictions ());
+  ASSERT_FALSE (cache.Invalidate ("3 * 4"));
+  ASSERT_TRUE  (cache.Invalidate ("1 + 2"));
+  ASSERT_EQ (1, cache.Size ());
+
+  // entries invalidated while pinned stay usable until released
+  ExpressionCacheEntry *  pPinned = cache.Acquire ("5 - 6");
+  cache.InvalidateAll ();
+  ASSERT_EQ (0, cache.Size ());
+  ASSERT_EQ (-1.0f, Expression::Execute (pPinned->plistCompiled, &registry));
+  cache.Release (pPinned);
+
+  // a limit of zero disables caching
+  cache.SetMaxEntries (0);
+  cache.ResetStats ();
+  cache.Release (cache.Acquire ("1 + 2"));
+  cache.Release (cache.Acquire ("1 + 2"));
+  ASSERT_EQ (0, cache.Size ());
+  ASSERT_EQ (0, cache.GetHits ());
+  ASSERT_EQ (2, cache.GetMisses ());
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, ExecuteUsesCache)
+  {
+  ValueRegistrySimple  registry;
+  registry.SetInt ("counter", 0);
+
+  Expression::Cache ().InvalidateAll ();
+  Expression::Cache ().ResetStats ();
+
+  for (INT  iIndex = 0; iIndex < 5; ++iIndex)
+    {
+    Expression::Execute ("counter += 2;", &registry);
+    };
+  ASSERT_EQ (10, registry.GetInt ("counter"));
+  ASSERT_EQ (1, Expression::Cache ().GetMisses ());
+  ASSERT_EQ (4, Expression::Cache ().GetHits ());
+
+  Token  tokResult;
+  Expression::Execute ("\"abc\"", &registry, &tokResult);
+  ASSERT_STREQ ("abc", tokResult.AsString (&registry));
+  Expression::Execute ("\"abc\"", &registry, &tokResult);
+  ASSERT_STREQ ("abc", tokResult.AsString (&registry));
+  ASSERT_EQ (2, Expression::Cache ().GetMisses ());
+
+  ASSERT_TRUE (Expression::Cache ().Invalidate ("counter += 2;"));
+  Expression::Execute ("counter += 2;", &registry);
+  ASSERT_EQ (12, registry.GetInt ("counter"));
+  ASSERT_EQ (3, Expression::Cache ().GetMisses ());
+  };
+
+//------------------------------------------------------------------------------
+class ExpressionTest_CacheJob
+  {
+  public:
+    INT   iNumWrong;
+    INT   iNumMisses;
+
+    static VOID  Run  (VOID *  pContextIn)
+      {
+      ExpressionTest_CacheJob *  pJob = static_cast<ExpressionTest_CacheJob *>(pContextIn);
+
+      Expression::Cache ().ResetStats ();
+      for (INT  iRun = 0; iRun < 500; ++iRun)
+        {
+        if (Expression::Execute ("Max (2, 3) * 4 + Min (1, 5)") != 13.0f)
+          {
+          ++pJob->iNumWrong;
+          };
+        };
+      pJob->iNumMisses = Expression::Cache ().GetMisses ();
+      };
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, CacheOnWorkerThreads)
+  {
+  // Each thread compiles and caches its own programs.
+  const INT                iNumJobs = 8;
+  ExpressionTest_CacheJob  aJobs [iNumJobs];
+
+  Expression::Cache ().InvalidateAll ();
+  Expression::Cache ().ResetStats ();
+
+  WorkerPool  pool (4);
+  for (INT  iJob = 0; iJob < iNumJobs; ++iJob)
+    {
+    aJobs [iJob].iNumWrong  = 0;
+    aJobs [iJob].iNumMisses = -1;
+    pool.Submit (ExpressionTest_CacheJob::Run, &aJobs [iJob]);
+    };
+  pool.Wait ();
+
+  for (INT  iJob = 0; iJob < iNumJobs; ++iJob)
+    {
+    EXPECT_EQ (0, aJobs [iJob].iNumWrong);
+    EXPECT_LE (aJobs [iJob].iNumMisses, 1);
+    };
+  // the worker threads didn't touch this thread's cache
+  ASSERT_EQ (0, Expression::Cache ().Size ());
+  ASSERT_EQ (0, Expression::Cache ().GetMisses ());
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, CompiledCacheBenchmark)
+  {
+  // Compares running the same expression text with and without the
+  //  compiled-expression cache.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const char *  szExpression = "(counter + 3) * 2 >= 10 && counter != 7";
+  const INT     iNumRuns     = 2000;
+  ValueRegistrySimple  registry;
+  StopWatch     watch;
+
+  registry.SetInt ("counter", 4);
+
+  INT  iSavedMax = Expression::Cache ().GetMaxEntries ();
+
+  Expression::Cache ().SetMaxEntries (0);
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    ASSERT_EQ (1.0f, Expression::Execute (szExpression, &registry));
+    };
+  watch.Stop ();
+  INT64  iUncachedUs = watch.GetElapsedUs ();
+
+  Expression::Cache ().SetMaxEntries (iSavedMax);
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    ASSERT_EQ (1.0f, Expression::Execute (szExpression, &registry));
+    };
+  watch.Stop ();
+  INT64  iCachedUs = watch.GetElapsedUs ();
+
+  BenchmarkPrintf ("Expression::Execute uncached %8.2f us/call  cached %8.2f us/call  speedup %.1fx\n",
+                   DOUBLE (iUncachedUs) / DOUBLE (iNumRuns),
+                   DOUBLE (iCachedUs) / DOUBLE (iNumRuns),
+                   DOUBLE (iUncachedUs) / DOUBLE (iCachedUs > 0 ? iCachedUs : 1));
+  };
+
+//------------------------------------------------------------------------------
+static VOID  SetupBackendRegistry (ValueRegistrySimple &  registryIn)
+  {
+  registryIn.SetFloat  ("four",    4.0f);
+  registryIn.SetInt    ("five",    5);
+  registryIn.SetFloat  ("myvar",   4.0f);
+  registryIn.SetInt    ("counter", 2);
+  registryIn.SetString ("mystr",   "Hello");
+  registryIn.SetString ("hello",   "Hello");
+  registryIn.SetString ("world",   "World");
+  registryIn.SetFloat  ("replaced", 0.0f);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, BytecodeMatchesInterpreter)
+  {
+  const char *  aszCorpus [] =
+    {
+    "1 + 2 - 3 + 4", "1 + (2 - 3) * 4", "four", "1 + (2 - 3) * four",
+    "5", "5;", "four;", "5; four", "four; 5",
+    "5 == 5", "4 != 5", "4 < 5", "5 > 4", "4 <= 5", "5 >= 4", "5 <= 5.0", "5 >= 5.0", "5 == 5.0",
+    "1 && 0", "0 || 1", "5 > 4 && 2 < 3", "5 < 4 || 2 > 3", "five == 5 && four == 4", "(five == 5) && (four == 4)",
+    "myvar = 5; myvar;", "myvar = 3 + 3; myvar;", "myvar = 4; myvar += 3; myvar;", "myvar = 4; myvar -= 3; myvar;",
+    "myvar = 4; myvar *= 2; myvar;", "myvar = 4; myvar /= 2; myvar;", "counter %= 2; counter", "7 % 3", "7.5 % 2",
+    "mystr = \"World\"; mystr;", "mystr = \"Hello\"; mystr += \" World\"; mystr;",
+    "mystr = hello + \" \" + world; mystr;", "hello == \"Hello\"", "hello != world",
+    "Min (3,4);", "myvar = Min (5, 6); myvar;", "myvar = Lerp (3, 10, 0.3); myvar;", "Eval ('1+1')",
+    "Max (Min (1, 2), Min (4, 3)) + 1", "1 + Min (2, 3) * 2",
+    "-5", "-four", "-2.5 + 1", "counter++; counter", "++counter", "counter--",
+    "true", "False;", "newvar = 3; newvar * 2", "newstr = \"abc\"; newstr",
+    "$myIdentifier = 2.0f; myIdentifier;", "$myIdentifier = 4.0f; replaced;",
+    "return (four + 1); 6", "counter = 1; return counter; counter = 9",
+    "", ";", "(1", "1 +", "+ 1",
+    };
+  KVPArray  envVars;
+  envVars.SetAt ("myIdentifier", "replaced");
+
+  const char *  aszCheckVars [] = {"four", "five", "myvar", "counter", "mystr", "replaced", "myIdentifier", "newvar", "newstr"};
+  INT           iNumBuilt = 0;
+
+  for (UINT  uExpr = 0; uExpr < sizeof (aszCorpus) / sizeof (const char *); ++uExpr)
+    {
+    ValueRegistrySimple  registryInterp;
+    ValueRegistrySimple  registryVM;
+    Token                tokInterp;
+    Token                tokVM;
+    BOOL                 bReturnedInterp = FALSE;
+    BOOL                 bReturnedVM     = FALSE;
+
+    SetupBackendRegistry (registryInterp);
+    SetupBackendRegistry (registryVM);
+
+    TList<Token*> *  pCompiled = Expression::Compile (aszCorpus [uExpr]);
+    if (pCompiled == NULL) continue;
+
+    ExpressionProgram *  pProgram = ExpressionProgram::Build (pCompiled);
+    if (pProgram == NULL)
+      {
+      Expression::FreeTokenList (&pCompiled);
+      continue;
+      };
+    ++iNumBuilt;
+
+    FLOAT  fInterp = Expression::Execute (pCompiled, &registryInterp, &tokInterp, &bReturnedInterp, &envVars);
+    FLOAT  fVM     = pProgram->Execute (&registryVM, &tokVM, &bReturnedVM, &envVars);
+
+    EXPECT_EQ (fInterp, fVM) << aszCorpus [uExpr];
+    EXPECT_EQ (bReturnedInterp, bReturnedVM) << aszCorpus [uExpr];
+    EXPECT_EQ (tokInterp.eType, tokVM.eType) << aszCorpus [uExpr];
+    EXPECT_STREQ (tokInterp.strRaw.AsChar (), tokVM.strRaw.AsChar ()) << aszCorpus [uExpr];
+    EXPECT_EQ (tokInterp.AsFloat (&registryInterp), tokVM.AsFloat (&registryVM)) << aszCorpus [uExpr];
+
+    for (UINT  uVar = 0; uVar < sizeof (aszCheckVars) / sizeof (const char *); ++uVar)
+      {
+      EXPECT_EQ (registryInterp.HasKey (aszCheckVars [uVar]), registryVM.HasKey (aszCheckVars [uVar])) << aszCorpus [uExpr];
+      EXPECT_EQ (registryInterp.GetFloat (aszCheckVars [uVar]), registryVM.GetFloat (aszCheckVars [uVar])) << aszCorpus [uExpr];
+      EXPECT_STREQ (registryInterp.GetString (aszCheckVars [uVar]), registryVM.GetString (aszCheckVars [uVar])) << aszCorpus [uExpr];
+      };
+
+    delete (pProgram);
+    Expression::FreeTokenList (&pCompiled);
+    };
+  // only malformed expressions should be left to the interpreter
+  EXPECT_GE (iNumBuilt, 60);
+
+  // both backends through the string interface
+  ValueRegistrySimple  registry;
+  SetupBackendRegistry (registry);
+  Expression::SetBackend (ExpressionBackend::kInterpreter);
+  FLOAT  fInterp = Expression::Execute ("myvar = Lerp (0, 10, 0.5); myvar * four", &registry);
+  Expression::SetBackend (ExpressionBackend::kBytecode);
+  FLOAT  fVM     = Expression::Execute ("myvar = Lerp (0, 10, 0.5); myvar * four", &registry);
+  Expression::SetBackend (ExpressionBackend::kInterpreter);
+  ASSERT_EQ (fInterp, fVM);
+  ASSERT_TRUE (FLT_APPROX_EQUAL (20.0f, fVM));
+  };
+
+//------------------------------------------------------------------------------
+static VOID  ExpressionTest_Pair  (Token *          ptokParamsIn,
+                                   ValueRegistry *  pRegistryIn,
+                                   Token *          ptokResultOut)
+  {
+  // Pair (x) returns the list (x, x + 5)
+  INT  iValue = (ptokParamsIn != NULL) ? ptokParamsIn->AsInt (pRegistryIn) : 0;
 
+  ptokResultOut->eType = TokenType::kInt;
+  ptokResultOut->Set (iValue, pRegistryIn);
+
+  Token *  ptokSecond = new Token ();
+  ptokSecond->eType = TokenType::kInt;
+  ptokSecond->Set (iValue + 5, pRegistryIn);
+  ptokResultOut->ArrayAppend (ptokSecond);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, BytecodeListResults)
+  {
+  // A function that returns a list passes the whole list on to the function
+  //  it is a parameter of, on both backends.
+  const char *  aszCorpus [] =
+    {
+    "Min (Pair (3))",
+    "Max (Pair (3))",
+    "Min (Pair (3), 1)",
+    "Max (1, Pair (3))",
+    "Max (Pair (3)) + Min (Pair (4))",
+    "Max (Pair (Min (Pair (2))))",
+    "Pair (3) + 2",
+    "Pair (3)",
+    "myvar = Max (Pair (3)); myvar",
+    "return Min (Pair (3))",
+    };
+  TList<ExpressionFn*>  listLocalFn;
+  ExpressionFn          fnPair ("Pair", &ExpressionTest_Pair);
+  listLocalFn.PushBack (&fnPair);
+
+  for (UINT  uExpr = 0; uExpr < sizeof (aszCorpus) / sizeof (const char *); ++uExpr)
+    {
+    ValueRegistrySimple  registryInterp;
+    ValueRegistrySimple  registryVM;
+    Token                tokInterp;
+    Token                tokVM;
+
+    TList<Token*> *  pCompiled = Expression::Compile (aszCorpus [uExpr]);
+    ASSERT_TRUE (pCompiled != NULL) << aszCorpus [uExpr];
+    ExpressionProgram *  pProgram = ExpressionProgram::Build (pCompiled);
+    ASSERT_TRUE (pProgram != NULL) << aszCorpus [uExpr];
+
+    FLOAT  fInterp = Expression::Execute (pCompiled, &registryInterp, &tokInterp, NULL, NULL, &listLocalFn);
+    FLOAT  fVM     = pProgram->Execute (&registryVM, &tokVM, NULL, NULL, &listLocalFn);
+
+    EXPECT_EQ (fInterp, fVM) << aszCorpus [uExpr];
+    EXPECT_EQ (tokInterp.eType, tokVM.eType) << aszCorpus [uExpr];
+    EXPECT_EQ (registryInterp.GetInt ("myvar"), registryVM.GetInt ("myvar")) << aszCorpus [uExpr];
+
+    delete (pProgram);
+    Expression::FreeTokenList (&pCompiled);
+    };
+
+  ASSERT_EQ (Expression::Execute ("Max (Pair (3)) + Min (Pair (4))", NULL, NULL, NULL, &listLocalFn), 12.0f);
+  ASSERT_EQ (Expression::Execute ("Max (Pair (Min (Pair (2))))",     NULL, NULL, NULL, &listLocalFn), 7.0f);
+  listLocalFn.Empty ();
+  };
+
+//------------------------------------------------------------------------------
+class ExpressionTest_ProgramJob
+  {
+  public:
+    ExpressionProgram *  pProgram;
+    INT                  iNumRuns;
+    INT                  iNumWrong;
+
+    static VOID  Run  (VOID *  pContextIn)
+      {
+      ExpressionTest_ProgramJob *  pJob = static_cast<ExpressionTest_ProgramJob *>(pContextIn);
+      ValueRegistrySimple          registry;
+
+      for (INT  iRun = 0; iRun < pJob->iNumRuns; ++iRun)
+        {
+        if (pJob->pProgram->Execute (&registry, NULL, NULL, NULL, NULL) != 23.0f)
+          {
+          ++pJob->iNumWrong;
+          };
+        };
+      };
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, BytecodeOnWorkerThreads)
+  {
+  // Programs running at the same time on different threads each use their
+  //  own value stack.
+  const INT  iNumJobs = 8;
+  ExpressionTest_ProgramJob  aJobs [iNumJobs];
+  TList<Token*> *            apCompiled [iNumJobs];
+
+  for (INT  iJob = 0; iJob < iNumJobs; ++iJob)
+    {
+    apCompiled [iJob] = Expression::Compile ("Max (Min (4, 9) * 5, 2 + 3) + Min (Max (1, 3), 7) * (1 + 0)");
+    ASSERT_TRUE (apCompiled [iJob] != NULL);
+    aJobs [iJob].pProgram  = ExpressionProgram::Build (apCompiled [iJob]);
+    aJobs [iJob].iNumRuns  = 2000;
+    aJobs [iJob].iNumWrong = 0;
+    ASSERT_TRUE (aJobs [iJob].pProgram != NULL);
+    };
+
+  WorkerPool  pool (4);
+  for (INT  iJob = 0; iJob < iNumJobs; ++iJob)
+    {
+    pool.Submit (ExpressionTest_ProgramJob::Run, &aJobs [iJob]);
+    };
+  pool.Wait ();
+
+  for (INT  iJob = 0; iJob < iNumJobs; ++iJob)
+    {
+    EXPECT_EQ (0, aJobs [iJob].iNumWrong);
+    delete (aJobs [iJob].pProgram);
+    Expression::FreeTokenList (&apCompiled [iJob]);
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, BytecodeBenchmark)
+  {
+  // Compares the token list interpreter against the bytecode machine on
+  //  the same compiled expressions.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const char *  aszCorpus [] =
+    {
+    "(counter + 3) * 2 >= 10 && counter != 7",
+    "myvar = Min (counter, 3) + 1.5; myvar * 2",
+    "1 + (2 - 3) * four",
+    "mystr = hello + \" \" + world; mystr",
+    };
+  const INT     iNumCorpus = sizeof (aszCorpus) / sizeof (const char *);
+  const INT     iNumRuns   = 20000;
+  ValueRegistrySimple  registry;
+  StopWatch     watch;
+
+  SetupBackendRegistry (registry);
+
+  TList<Token*> *      apCompiled [iNumCorpus];
+  ExpressionProgram *  apProgram  [iNumCorpus];
+  for (INT  iExpr = 0; iExpr < iNumCorpus; ++iExpr)
+    {
+    apCompiled [iExpr] = Expression::Compile (aszCorpus [iExpr]);
+    apProgram  [iExpr] = ExpressionProgram::Build (apCompiled [iExpr]);
+    ASSERT_TRUE (apProgram [iExpr] != NULL);
+    };
+
+  DOUBLE  dInterpSum = 0.0;
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    dInterpSum += Expression::Execute (apCompiled [iRun % iNumCorpus], &registry);
+    };
+  watch.Stop ();
+  INT64  iInterpUs = watch.GetElapsedUs ();
+
+  DOUBLE  dVMSum = 0.0;
+  watch.Start ();
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    dVMSum += apProgram [iRun % iNumCorpus]->Execute (&registry);
+    };
+  watch.Stop ();
+  INT64  iVMUs = watch.GetElapsedUs ();
+
+  BenchmarkPrintf ("Expression interpreter %8.3f us/run  bytecode %8.3f us/run  speedup %.1fx\n",
+                   DOUBLE (iInterpUs) / DOUBLE (iNumRuns),
+                   DOUBLE (iVMUs) / DOUBLE (iNumRuns),
+                   DOUBLE (iInterpUs) / DOUBLE (iVMUs > 0 ? iVMUs : 1));
+  ASSERT_EQ (dInterpSum, dVMSum);
+
+  for (INT  iExpr = 0; iExpr < iNumCorpus; ++iExpr)
+    {
+    delete (apProgram [iExpr]);
+    Expression::FreeTokenList (&apCompiled [iExpr]);
+    };
+  };
+
+//------------------------------------------------------------------------------
+static const char *  aszTokenizeCorpus [] =
+  {
+  // Expression tests
+  "1 + 2 - 3 + 4", "1 + (2 - 3) * 4", "four", "1 + (2 - 3) * four", "5; four", "four; 5",
+  "5 == 5", "4 != 5", "4 < 5", "5 > 4", "4 <= 5", "5 >= 4", "5 == 5.0", "4 != 5.0", "5 >= 5.0",
+  "1 && 1", "1 || 0", "5 > 4 && 2 < 3", "5 < 4 || 2 > 3", "(five == 5) && (four == 4)",
+  "myvar = 5; myvar;", "myvar = 4; myvar += 3; myvar;", "myvar = 4; myvar -= 3; myvar;",
+  "myvar = 4; myvar *= 2; myvar;", "myvar = 4; myvar /= 2; myvar;", "counter %= 2; counter++; --counter",
+  "mystr = \"World\"; mystr;", "mystr = \"Hello\"; mystr += \" World\"; mystr;",
+  "mystr = hello + \" \" + world; mystr;", "Min (3,4);", "myvar = Lerp (3, 10, 0.3); myvar;",
+  "Eval ('1+1')", "myIdentifier = true;", "$myIdentifier = true;", "${myIdentifier} = true;",
+  "${myIdentifier}.Visible = true;", "myIdentifier = 1.0f; myIdentifier;", "True; False; trueish",
+  "return (four + 1); 6", "a=-1", "x--y", "---", "12.5.3 + 1e5 - .5", "'it' + \"s\"",
+  // Ink tests
+  "myVar = 1 + 2", "myVar = 1 + 2;  myVar += 3;", "test_var = 1", "test_var", "myFn()", "myString",
+  "visits > 2 && seen != 1", "score >= 10 || (lives == 0 && bonus != 1)", "Window.Main.Visible = 1",
+  };
+
+//------------------------------------------------------------------------------
+static TList<Token*> *  TokenizeWithRegEx (const char *  szScriptIn)
+  {
+  // The RegEx based tokenizer that Expression::Tokenize replaced.  Kept here
+  //  as a reference for well formed expressions, and as a benchmark baseline.
+  RegEx  rexTokens ("[ ]*(==|\\!=|<=|>=|<|>|=|\\+=|\\-=|\\*=|/=|%=|,|\\+\\+|\\-\\-|\\-|\\|\\||%|&&|\\+|\\*|/|\\(|\\)|[0-9]+(\\.[0-9]+)?|[a-zA-Z_\\$]?[a-zA-Z0-9\\${}_\\.]*|;|\"[^\"]*\"|'[^']*')[ ]*");
+
+  TList<Token*> *  pListOut      = new TList<Token*>;
+  const char *     pszCurr       = szScriptIn;
+  const char *     pszEnd        = pszCurr + strlen (szScriptIn);
+  const char *     pszMatchStart = NULL;
+  INT              iMatchLength  = 0;
+
+  while (pszCurr < pszEnd)
+    {
+    rexTokens.Match (pszCurr, pszEnd - pszCurr, 0, &pszMatchStart, iMatchLength);
+    if (iMatchLength != 0)
+      {
+      pszCurr += iMatchLength;
+
+      while ((pszMatchStart[0] == ' ') && (iMatchLength > 0)) {++pszMatchStart; --iMatchLength;};
+      while ((pszMatchStart[iMatchLength - 1] == ' ') && (iMatchLength > 0)) {--iMatchLength;};
+
+      if (iMatchLength != 0)
+        {
+        pListOut->PushBack (new Token (pszMatchStart, iMatchLength));
+        };
+      }
+    else
+      {
+      ++pszCurr;
+      };
+    };
+  return (pListOut);
+  };
+
+//------------------------------------------------------------------------------
+static RStr  TokenListToString (TList<Token*> *  plistIn)
+  {
+  RStr  strOut;
+  RStr  strToken;
+  for (TListItr<Token*>  itrCurr = plistIn->First (); itrCurr.IsValid (); ++itrCurr)
+    {
+    strToken.Format ("<%s:%d>", (*itrCurr)->strRaw.AsChar (), (*itrCurr)->eType);
+    strOut += strToken;
+    };
+  return (strOut);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, Tokenizer)
+  {
+  // the scanner splits well formed text the same way the RegEx tokenizer did.
+  for (UINT  uExpr = 0; uExpr < sizeof (aszTokenizeCorpus) / sizeof (const char *); ++uExpr)
+    {
+    TList<Token*> *  plistScanned = Expression::Tokenize (aszTokenizeCorpus [uExpr]);
+    TList<Token*> *  plistRegEx   = TokenizeWithRegEx (aszTokenizeCorpus [uExpr]);
+
+    EXPECT_STREQ (TokenListToString (plistRegEx).AsChar (), TokenListToString (plistScanned).AsChar ()) << aszTokenizeCorpus [uExpr];
+
+    Expression::FreeTokenList (&plistScanned);
+    Expression::FreeTokenList (&plistRegEx);
+    };
+
+  // classification
+  TList<Token*> *  plistTokens = Expression::Tokenize ("12 1.5 12.5.3 5. 1e5 .5 return returns TRUE falsey \"a b\" 'c' ${x}.y");
+  ASSERT_STREQ ("<12:2><1.5:1><12.5.3:1><5.:2><1e5:2><.5:4><return:32><returns:4><TRUE:2><falsey:2><a b:3><c:3><${x}.y:4>",
+                TokenListToString (plistTokens).AsChar ());
+  Expression::FreeTokenList (&plistTokens);
+
+  // tabs and line ends are whitespace, and stray characters are skipped
+  plistTokens = Expression::Tokenize ("x = 1;\r\n\ty = 2 # 3;\n!z \"open");
+  ASSERT_STREQ ("<x:4><=:23><1:2><;:7><y:4><=:23><2:2><3:2><;:7><z:4><open:4>",
+                TokenListToString (plistTokens).AsChar ());
+  Expression::FreeTokenList (&plistTokens);
+
+  // operators
+  plistTokens = Expression::Tokenize ("a+++b!=c&&d||e%=f--");
+  ASSERT_STREQ ("<a:4><++:11><+:13><b:4><!=:18><c:4><&&:28><d:4><||:29><e:4><%=:31><f:4><--:12>",
+                TokenListToString (plistTokens).AsChar ());
+  Expression::FreeTokenList (&plistTokens);
+  };
+
+//------------------------------------------------------------------------------
+TEST (Expression, TokenizerBenchmark)
+  {
+  // Compares the character class scanner against the RegEx tokenizer it
+  //  replaced, over the expression and Ink test corpus.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT   iNumCorpus = sizeof (aszTokenizeCorpus) / sizeof (const char *);
+  const INT   iNumPasses = 20;
+  INT         iNumTokens = 0;
+  StopWatch   watch;
+
+  watch.Start ();
+  for (INT  iPass = 0; iPass < iNumPasses; ++iPass)
+    {
+    for (INT  iExpr = 0; iExpr < iNumCorpus; ++iExpr)
+      {
+      TList<Token*> *  plistTokens = TokenizeWithRegEx (aszTokenizeCorpus [iExpr]);
+      Expression::FreeTokenList (&plistTokens);
+      };
+    };
+  watch.Stop ();
+  INT64  iRegExUs = watch.GetElapsedUs ();
+
+  watch.Start ();
+  for (INT  iPass = 0; iPass < iNumPasses; ++iPass)
+    {
+    for (INT  iExpr = 0; iExpr < iNumCorpus; ++iExpr)
+      {
+      TList<Token*> *  plistTokens = Expression::Tokenize (aszTokenizeCorpus [iExpr]);
+      iNumTokens += plistTokens->Size ();
+      Expression::FreeTokenList (&plistTokens);
+      };
+    };
+  watch.Stop ();
+  INT64  iScanUs = watch.GetElapsedUs ();
+
+  BenchmarkPrintf ("Expression::Tokenize regex %8.3f us/expr  scanner %8.3f us/expr (%.1f ns/token)  speedup %.1fx\n",
+                   DOUBLE (iRegExUs) / DOUBLE (iNumPasses * iNumCorpus),
+                   DOUBLE (iScanUs) / DOUBLE (iNumPasses * iNumCorpus),
+                   DOUBLE (iScanUs) * 1000.0 / DOUBLE (iNumTokens > 0 ? iNumTokens : 1),
+                   DOUBLE (iRegExUs) / DOUBLE (iScanUs > 0 ? iScanUs : 1));
+  ASSERT_GT (iNumTokens, 0);
+  };
@@ -0,0 +1,574 @@
+/* -----------------------------------------------------------------
+                             Ink Baker
+
+     This module converts Ink script text into a pre-parsed binary
+   form, and builds an InkScript back from that form without any
+   text parsing or expression compiling.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Script/InkBaker.hpp"
+#include "Script/InkParser.hpp"
+#include "Sys/FilePath.hpp"
+
+//-----------------------------------------------------------------------------
+//  InkBaker
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+InkBaker::InkBaker  ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+InkBaker::~InkBaker ()
+  {
+  };
+
+//-----------------------------------------------------------------------------
+UINT32  InkBaker::InternString  (const char *  szIn)
+  {
+  HASH_T  uHash = CalcHashValue (szIn);
+
+  for (INT  iSlot = indexStrings.FindFirst (uHash); iSlot != -1; iSlot = indexStrings.FindNext (uHash, iSlot))
+    {
+    INT  iIndex = indexStrings.GetAt (iSlot);
+    if (astrStrings [iIndex] == szIn)
+      {
+      return (UINT32 (iIndex));
+      };
+    };
+
+  INT  iIndex = astrStrings.Length ();
+  astrStrings.Append (RStr (szIn));
+  indexStrings.Insert (uHash, iIndex);
+  return (UINT32 (iIndex));
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  InkBaker::IsBaked  (const RStrParser &  parserIn)
+  {
+  if (parserIn.Length () < 4) return (FALSE);
+
+  const unsigned char *  pbyData = (const unsigned char *) parserIn.AsChar ();
+  return (MAKE_FOUR_CODE (pbyData) == MAKE_FOUR_CODE ("INKB"));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::BakeBuffer  (const char *  szScriptIn,
+                                RStrParser &  parserBakedOut)
+  {
+  InkParser    parser;
+  InkScript *  pScript = parser.Parse (szScriptIn);
+
+  EStatus  status = BakeScript (pScript, parserBakedOut);
+
+  pScript->FreeElementList ();
+  delete (pScript);
+  return (status);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::BakeFile  (const char *  szScriptFileIn,
+                              const char *  szBakedFileOut)
+  {
+  if (! FilePath::FileExists (szScriptFileIn))
+    {
+    return (EStatus::Failure (RStr("File does not exist: ") + szScriptFileIn));
+    };
+
+  RStrParser  parserText;
+  EStatus     status = parserText.ReadFromFile (szScriptFileIn);
+  if (status != EStatus::kSuccess)
+    {
+    return (status);
+    };
+
+  RStrParser  parserBaked;
+  status = BakeBuffer (parserText.AsChar (), parserBaked);
+  if (status != EStatus::kSuccess)
+    {
+    return (status);
+    };
+  return (parserBaked.WriteToFile (szBakedFileOut));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::BakeScript  (InkScript *   pScriptIn,
+                                RStrParser &  parserBakedOut)
+  {
+  if (pScriptIn == NULL)
+    {
+    return (EStatus::Failure ("InkBaker: No script to bake."));
+    };
+
+  astrStrings.Clear ();
+  indexStrings.Clear ();
+
+  // elements and tables are written first, since that is where the strings are interned.
+  RStrParser  parserBody;
+  parserBody.SetGrowIncrement (kBakeGrowIncrement);
+
+  parserBody.SetU4_LEnd (MAKE_FOUR_CODE("LABL"));
+  INT  iBlockLocation = parserBody.GetCursorStart ();
+  parserBody.SetU4_LEnd (0);
+  BakeTable (pScriptIn->tableLabels, parserBody);
+  INT  iBlockEnd = parserBody.GetCursorStart ();
+  parserBody.SetCursorStart (iBlockLocation);
+  parserBody.SetU4_LEnd (iBlockEnd - iBlockLocation - sizeof (INT32));
+  parserBody.SetCursorStart (iBlockEnd);
+
+  parserBody.SetU4_LEnd (MAKE_FOUR_CODE("FUNC"));
+  iBlockLocation = parserBody.GetCursorStart ();
+  parserBody.SetU4_LEnd (0);
+  BakeTable (pScriptIn->tableFunctions, parserBody);
+  iBlockEnd = parserBody.GetCursorStart ();
+  parserBody.SetCursorStart (iBlockLocation);
+  parserBody.SetU4_LEnd (iBlockEnd - iBlockLocation - sizeof (INT32));
+  parserBody.SetCursorStart (iBlockEnd);
+
+  parserBody.SetU4_LEnd (MAKE_FOUR_CODE("ELEM"));
+  iBlockLocation = parserBody.GetCursorStart ();
+  parserBody.SetU4_LEnd (0);
+  parserBody.SetU4_LEnd (pScriptIn->GetNumElements ());
+  for (INT  iIndex = 0; iIndex < pScriptIn->GetNumElements (); ++iIndex)
+    {
+    BakeChain (pScriptIn->GetElem (iIndex), parserBody);
+    };
+  iBlockEnd = parserBody.GetCursorStart ();
+  parserBody.SetCursorStart (iBlockLocation);
+  parserBody.SetU4_LEnd (iBlockEnd - iBlockLocation - sizeof (INT32));
+  parserBody.SetCursorStart (iBlockEnd);
+
+  // the payload is the string table followed by the body.  It is checksummed as a whole.
+  RStrParser  parserPayload;
+  parserPayload.SetGrowIncrement (kBakeGrowIncrement);
+
+  parserPayload.SetU4_LEnd (MAKE_FOUR_CODE("STRT"));
+  iBlockLocation = parserPayload.GetCursorStart ();
+  parserPayload.SetU4_LEnd (0);
+  parserPayload.SetU4_LEnd (astrStrings.Length ());
+  for (INT  iIndex = 0; iIndex < astrStrings.Length (); ++iIndex)
+    {
+    RStr &  strCurr = astrStrings [iIndex];
+    parserPayload.SetU4_LEnd (strCurr.Length ());
+    parserPayload.SetData    ((const unsigned char *) strCurr.AsChar (), strCurr.Length ());
+    };
+  iBlockEnd = parserPayload.GetCursorStart ();
+  parserPayload.SetCursorStart (iBlockLocation);
+  parserPayload.SetU4_LEnd (iBlockEnd - iBlockLocation - sizeof (INT32));
+  parserPayload.SetCursorStart (iBlockEnd);
+  parserPayload.SetData ((const unsigned char *) parserBody.AsChar (), parserBody.Length ());
+
+  parserBakedOut.SetGrowIncrement (kBakeGrowIncrement);
+  parserBakedOut.SetU4_LEnd (MAKE_FOUR_CODE("INKB"));
+  parserBakedOut.SetU4_LEnd (2 * sizeof (UINT32) + parserPayload.Length ());
+  parserBakedOut.SetU4_LEnd (kVersion);
+  parserBakedOut.SetU4_LEnd (CalcHashValue (parserPayload.AsChar (), parserPayload.Length ()));
+  parserBakedOut.SetData    ((const unsigned char *) parserPayload.AsChar (), parserPayload.Length ());
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkBaker::BakeTable  (InkLabelTable &  tableIn,
+                            RStrParser &     parserOut)
+  {
+  parserOut.SetU4_LEnd (tableIn.Size ());
+  for (INT  iSlot = 0; iSlot < tableIn.Size (); ++iSlot)
+    {
+    parserOut.SetU4_LEnd (InternString (tableIn.NameAt (iSlot)));
+    parserOut.SetU4_LEnd (tableIn.ValueAt (iSlot));
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkBaker::BakeChain  (InkElem *     pelemIn,
+                            RStrParser &  parserOut)
+  {
+  UINT32  uNumElems = 0;
+  for (InkElem *  pelemCurr = pelemIn; pelemCurr != NULL; pelemCurr = pelemCurr->GetNext ())
+    {
+    ++uNumElems;
+    };
+
+  parserOut.SetU4_LEnd (uNumElems);
+  for (InkElem *  pelemCurr = pelemIn; pelemCurr != NULL; pelemCurr = pelemCurr->GetNext ())
+    {
+    BakeElem (pelemCurr, parserOut);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkBaker::BakeElem  (InkElem *     pelemIn,
+                           RStrParser &  parserOut)
+  {
+  parserOut.SetU1_LEnd (pelemIn->GetType ());
+  parserOut.SetU4_LEnd (pelemIn->GetGatherLevel ());
+
+  switch (pelemIn->GetType ())
+    {
+    case InkElemType::kParagraph:
+      parserOut.SetU4_LEnd (InternString (dynamic_cast<InkParagraph*>(pelemIn)->GetRawText ().AsChar ()));
+      break;
+
+    case InkElemType::kKnot:
+      parserOut.SetU4_LEnd (InternString (dynamic_cast<InkKnot*>(pelemIn)->GetLabel ()));
+      break;
+
+    case InkElemType::kStitch:
+      parserOut.SetU4_LEnd (InternString (dynamic_cast<InkStitch*>(pelemIn)->GetLabel ()));
+      break;
+
+    case InkElemType::kDivert:
+      parserOut.SetU4_LEnd (InternString (dynamic_cast<InkDivert*>(pelemIn)->GetLabel ()));
+      break;
+
+    case InkElemType::kVariable:
+      parserOut.SetU4_LEnd (InternString (dynamic_cast<InkVariable*>(pelemIn)->GetName ()));
+      break;
+
+    case InkElemType::kList:
+      parserOut.SetU1_LEnd (dynamic_cast<InkList*>(pelemIn)->GetListType ());
+      break;
+
+    case InkElemType::kChoice:
+      parserOut.SetU4_LEnd (pelemIn->GetChoiceLevel ());
+      break;
+
+    case InkElemType::kExpression:
+      {
+      TList<Token*> *  plistCompiled = dynamic_cast<InkExpression*>(pelemIn)->GetCompiled ();
+
+      parserOut.SetU4_LEnd ((plistCompiled == NULL) ? 0 : plistCompiled->Size ());
+      if (plistCompiled == NULL) break;
+
+      for (TListItr<Token*>  itrToken = plistCompiled->First (); itrToken.IsValid (); ++itrToken)
+        {
+        Token *  ptokCurr = *itrToken;
+
+        parserOut.SetU1_LEnd (ptokCurr->eType);
+        parserOut.SetU1_LEnd ((ptokCurr->bIsOperator ? 0x01 : 0x00) | (ptokCurr->bIsUnary ? 0x02 : 0x00));
+        parserOut.SetU1_LEnd (ptokCurr->iPrecedence);
+        parserOut.SetU1_LEnd (ptokCurr->eAssociativity);
+        if ((ptokCurr->eType == TokenType::kInt) || (ptokCurr->eType == TokenType::kFloat))
+          {
+          parserOut.SetU4_LEnd (ptokCurr->iValue);
+          parserOut.SetF4_LEnd (ptokCurr->fValue);
+          };
+        parserOut.SetU4_LEnd (InternString (ptokCurr->strRaw.AsChar ()));
+        };
+      };
+      break;
+
+    default:
+      break;
+    };
+
+  parserOut.SetU4_LEnd (pelemIn->GetNumChildren ());
+  for (InkElem *  pelemChild = pelemIn->GetFirstChild (); pelemChild != NULL; pelemChild = pelemChild->GetSibling ())
+    {
+    BakeChain (pelemChild, parserOut);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::ReadBuffer  (RStrParser &   parserBakedIn,
+                                InkScript * *  ppScriptOut)
+  {
+  *ppScriptOut = NULL;
+
+  if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("INKB"))
+    {
+    return (EStatus::Failure ("InkBaker: Buffer is not a baked script."));
+    };
+  UINT32  uSize = parserBakedIn.GetU4_LEnd ();
+  if ((uSize < 2 * sizeof (UINT32)) || (uSize > UINT32 (parserBakedIn.Length () - parserBakedIn.GetCursorStart ())))
+    {
+    return (EStatus::Failure ("InkBaker: Baked script is truncated."));
+    };
+  UINT32  uVersion = parserBakedIn.GetU4_LEnd ();
+  if (uVersion != kVersion)
+    {
+    return (EStatus::Failure ("InkBaker: Baked script is version %d.  Expected version %d.", uVersion, kVersion));
+    };
+  HASH_T  uChecksum    = parserBakedIn.GetU4_LEnd ();
+  UINT32  uPayloadSize = uSize - 2 * sizeof (UINT32);
+  if (CalcHashValue (parserBakedIn.GetCursorStartPtr (), uPayloadSize) != uChecksum)
+    {
+    return (EStatus::Failure ("InkBaker: Baked script checksum does not match."));
+    };
+
+  // string table
+  if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("STRT"))
+    {
+    return (EStatus::Failure ("InkBaker: Missing string table."));
+    };
+  parserBakedIn.GetU4_LEnd ();
+  UINT32  uNumStrings = parserBakedIn.GetU4_LEnd ();
+
+  RStrArray  astrTable;
+  astrTable.SetMinLength (uNumStrings);
+  for (UINT32  uIndex = 0; uIndex < uNumStrings; ++uIndex)
+    {
+    UINT32  uLength = parserBakedIn.GetU4_LEnd ();
+    parserBakedIn.GetData (&astrTable [uIndex], uLength);
+    };
+
+  InkScript *  pScript = new InkScript ();
+  EStatus      status;
+
+  if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("LABL"))
+    {
+    status = EStatus::Failure ("InkBaker: Missing label table.");
+    }
+  else
+    {
+    parserBakedIn.GetU4_LEnd ();
+    status = ReadTable (parserBakedIn, astrTable, pScript->tableLabels);
+    };
+
+  if (status == EStatus::kSuccess)
+    {
+    if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("FUNC"))
+      {
+      status = EStatus::Failure ("InkBaker: Missing function table.");
+      }
+    else
+      {
+      parserBakedIn.GetU4_LEnd ();
+      status = ReadTable (parserBakedIn, astrTable, pScript->tableFunctions);
+      };
+    };
+
+  if (status == EStatus::kSuccess)
+    {
+    if (parserBakedIn.GetU4_LEnd () != MAKE_FOUR_CODE("ELEM"))
+      {
+      status = EStatus::Failure ("InkBaker: Missing element block.");
+      }
+    else
+      {
+      parserBakedIn.GetU4_LEnd ();
+      UINT32  uNumElems = parserBakedIn.GetU4_LEnd ();
+      for (UINT32  uIndex = 0; uIndex < uNumElems; ++uIndex)
+        {
+        InkElem *  pelemNew = NULL;
+        status = ReadChain (parserBakedIn, astrTable, &pelemNew);
+        if (status != EStatus::kSuccess) break;
+        if (pelemNew == NULL)
+          {
+          status = EStatus::Failure ("InkBaker: Element %d is empty.", uIndex);
+          break;
+          };
+        pScript->listElem.Append (pelemNew);
+        };
+      };
+    };
+
+  if (status != EStatus::kSuccess)
+    {
+    pScript->FreeElementList ();
+    delete (pScript);
+    return (status);
+    };
+
+  pScript->Link ();
+  *ppScriptOut = pScript;
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::ReadTable  (RStrParser &     parserIn,
+                               RStrArray &      astrTableIn,
+                               InkLabelTable &  tableOut)
+  {
+  UINT32  uNumEntries = parserIn.GetU4_LEnd ();
+  for (UINT32  uIndex = 0; uIndex < uNumEntries; ++uIndex)
+    {
+    UINT32  uName  = parserIn.GetU4_LEnd ();
+    INT     iValue = INT32 (parserIn.GetU4_LEnd ());
+    if (uName >= UINT32 (astrTableIn.Length ()))
+      {
+      return (EStatus::Failure ("InkBaker: Table entry %d has a bad name index.", uIndex));
+      };
+    tableOut.Set (astrTableIn [uName].AsChar (), iValue);
+    };
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::ReadChain  (RStrParser &   parserIn,
+                               RStrArray &    astrTableIn,
+                               InkElem * *    ppelemOut)
+  {
+  *ppelemOut = NULL;
+
+  InkElem *  pelemLast  = NULL;
+  UINT32     uNumElems  = parserIn.GetU4_LEnd ();
+  for (UINT32  uIndex = 0; uIndex < uNumElems; ++uIndex)
+    {
+    InkElem *  pelemNew = NULL;
+    EStatus    status   = ReadElem (parserIn, astrTableIn, &pelemNew);
+    if (status != EStatus::kSuccess)
+      {
+      // deleting the first element deletes the rest of the chain.
+      delete (*ppelemOut);
+      *ppelemOut = NULL;
+      return (status);
+      };
+
+    if (pelemLast == NULL)
+      {
+      *ppelemOut = pelemNew;
+      }
+    else
+      {
+      pelemLast->AppendElem (pelemNew);
+      };
+    pelemLast = pelemNew;
+    };
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  InkBaker::ReadElem  (RStrParser &   parserIn,
+                              RStrArray &    astrTableIn,
+                              InkElem * *    ppelemOut)
+  {
+  *ppelemOut = NULL;
+
+  UINT32  uType        = parserIn.GetU1_LEnd ();
+  INT     iGatherLevel = INT32 (parserIn.GetU4_LEnd ());
+  UINT32  uNumStrings  = UINT32 (astrTableIn.Length ());
+
+  InkElem *  pelemNew = NULL;
+  switch (uType)
+    {
+    case InkElemType::kParagraph:
+    case InkElemType::kKnot:
+    case InkElemType::kStitch:
+    case InkElemType::kDivert:
+    case InkElemType::kVariable:
+      {
+      UINT32  uString = parserIn.GetU4_LEnd ();
+      if (uString >= uNumStrings)
+        {
+        return (EStatus::Failure ("InkBaker: Element has a bad string index."));
+        };
+      RStr &  strValue = astrTableIn [uString];
+
+      switch (uType)
+        {
+        case InkElemType::kParagraph: pelemNew = new InkParagraph (strValue.AsChar (), strValue.Length ()); break;
+        case InkElemType::kKnot:      pelemNew = new InkKnot      (strValue.AsChar ()); break;
+        case InkElemType::kStitch:    pelemNew = new InkStitch    (strValue.AsChar ()); break;
+        case InkElemType::kDivert:    pelemNew = new InkDivert    (strValue.AsChar ()); break;
+        default:                      pelemNew = new InkVariable  (strValue.AsChar ()); break;
+        };
+      };
+      break;
+
+    case InkElemType::kList:
+      pelemNew = new InkList ((InkListType::Type) parserIn.GetU1_LEnd ());
+      break;
+
+    case InkElemType::kChoice:
+      {
+      InkChoice *  pChoice = new InkChoice ();
+      pChoice->SetChoiceLevel (INT32 (parserIn.GetU4_LEnd ()));
+      pelemNew = pChoice;
+      };
+      break;
+
+    case InkElemType::kExpression:
+      {
+      TList<Token*> *  plistCompiled = new TList<Token*>;
+      UINT32           uNumTokens    = parserIn.GetU4_LEnd ();
+
+      for (UINT32  uIndex = 0; uIndex < uNumTokens; ++uIndex)
+        {
+        Token *  ptokNew = new Token;
+        plistCompiled->PushBack (ptokNew);
+
+        ptokNew->eType          = (TokenType::Type) parserIn.GetU1_LEnd ();
+        UINT32  uFlags          = parserIn.GetU1_LEnd ();
+        ptokNew->bIsOperator    = ((uFlags & 0x01) != 0);
+        ptokNew->bIsUnary       = ((uFlags & 0x02) != 0);
+        ptokNew->iPrecedence    = parserIn.GetU1_LEnd ();
+        ptokNew->eAssociativity = (AssociativityType::Type) parserIn.GetU1_LEnd ();
+        if ((ptokNew->eType == TokenType::kInt) || (ptokNew->eType == TokenType::kFloat))
+          {
+          ptokNew->iValue = INT32 (parserIn.GetU4_LEnd ());
+          ptokNew->fValue = parserIn.GetF4_LEnd ();
+          };
+
+        UINT32  uString = parserIn.GetU4_LEnd ();
+        if (uString >= uNumStrings)
+          {
+          Expression::FreeTokenList (&plistCompiled);
+          return (EStatus::Failure ("InkBaker: Expression token has a bad string index."));
+          };
+        ptokNew->strRaw = astrTableIn [uString];
+        };
+      pelemNew = new InkExpression (plistCompiled);
+      };
+      break;
+
+    default:
+      return (EStatus::Failure ("InkBaker: Unknown element type %d.", uType));
+    };
+
+  pelemNew->SetGatherLevel (iGatherLevel);
+
+  UINT32  uNumChildren = parserIn.GetU4_LEnd ();
+  for (UINT32  uIndex = 0; uIndex < uNumChildren; ++uIndex)
+    {
+    InkElem *  pelemChild = NULL;
+    EStatus    status     = ReadChain (parserIn, astrTableIn, &pelemChild);
+    if ((status == EStatus::kSuccess) && (pelemChild == NULL))
+      {
+      status = EStatus::Failure ("InkBaker: Element has an empty child.");
+      };
+    if (status != EStatus::kSuccess)
+      {
+      delete (pelemNew);
+      return (status);
+      };
+    pelemNew->AddChild (pelemChild);
+    };
+
+  *ppelemOut = pelemNew;
+  return (EStatus::kSuccess);
+  };
@@ -0,0 +1,169 @@
+/* -----------------------------------------------------------------
+                             Ink Baker
+
+     This module converts Ink script text into a pre-parsed binary
+   form, and builds an InkScript back from that form without any
+   text parsing or expression compiling.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef INKBAKER_HPP
+#define INKBAKER_HPP
+
+#include "Sys/Types.hpp"
+#include "Util/RStr.hpp"
+#include "Util/RStrParser.hpp"
+#include "Containers/RStrArray.hpp"
+#include "Containers/THashIndex.hpp"
+#include "Script/InkScript.hpp"
+
+/**
+  Baked script layout.  All values are little endian, and blocks follow the
+  IFF style used by SceneBaker (four code, then byte size).
+
+    INKB  size
+      version
+      checksum      (CalcHashValue of everything after this field)
+      STRT  size
+        count
+        (length, chars) per string
+      LABL  size
+        count
+        (name string index, element index) per label
+      FUNC  size
+        count
+        (name string index, element index) per function
+      ELEM  size
+        count
+        one chain per element in InkScript::listElem
+
+    chain:    element count, then each element along the pNext links
+    element:  type (1 byte), gather level, type data, child count, then one
+              chain per child along the pSibling links
+
+    type data:
+      Paragraph, Knot, Stitch, Divert, Variable:  string index
+      List:        list type (1 byte)
+      Choice:      choice level
+      Expression:  token count, then per token of the compiled list:
+                     type (1 byte), flags (1 byte), precedence (1 byte),
+                     associativity (1 byte), int and float value (only
+                     for kInt and kFloat tokens), raw text string index
+
+  Diverts are stored by label and resolved again by InkScript::Link on load,
+  which is a single pass over the hashed label table.
+  */
+
+//-----------------------------------------------------------------------------
+class InkBaker
+  {
+  public:
+    static const UINT32  kVersion           = 2;
+    static const UINT32  kBakeGrowIncrement = 16 * 1024;  ///< buffer growth step while baking
+
+  private:
+    RStrArray          astrStrings;   ///< Interned strings.
+    THashIndex<INT>    indexStrings;  ///< Hash of each interned string to its index in astrStrings.
+
+  private:
+
+    UINT32   InternString           (const char *    szIn);
+
+    VOID     BakeTable              (InkLabelTable &  tableIn,
+                                     RStrParser &     parserOut);
+
+    VOID     BakeChain              (InkElem *       pelemIn,
+                                     RStrParser &    parserOut);
+
+    VOID     BakeElem               (InkElem *       pelemIn,
+                                     RStrParser &    parserOut);
+
+    EStatus  ReadTable              (RStrParser &     parserIn,
+                                     RStrArray &      astrTableIn,
+                                     InkLabelTable &  tableOut);
+
+    EStatus  ReadChain              (RStrParser &    parserIn,
+                                     RStrArray &     astrTableIn,
+                                     InkElem * *     ppelemOut);
+
+    EStatus  ReadElem               (RStrParser &    parserIn,
+                                     RStrArray &     astrTableIn,
+                                     InkElem * *     ppelemOut);
+
+  public:
+
+             InkBaker               ();
+
+             ~InkBaker              ();
+
+                                    /** @brief  Query whether a buffer holds a baked script, by its four code.
+                                        @param  parserIn The buffer.  Checked from the start, not the cursor.
+                                        @return True if the buffer starts like a baked script.
+                                    */
+    static BOOL  IsBaked            (const RStrParser &  parserIn);
+
+                                    /** @brief  Parse script text and bake it.
+                                        @param  szScriptIn The Ink script text.
+                                        @param  parserBakedOut Receives the baked script.
+                                        @return Success or failure.
+                                    */
+    EStatus  BakeBuffer             (const char *    szScriptIn,
+                                     RStrParser &    parserBakedOut);
+
+                                    /** @brief  Bake a parsed script.
+                                        @param  pScriptIn The script, as returned by InkParser::Parse.
+                                        @param  parserBakedOut Receives the baked script.
+                                        @return Success or failure.
+                                    */
+    EStatus  BakeScript             (InkScript *     pScriptIn,
+                                     RStrParser &    parserBakedOut);
+
+                                    /** @brief  Convert an .ink file to a baked file.  This is the path for build tools.
+                                        @param  szScriptFileIn The Ink script text file.
+                                        @param  szBakedFileOut The file to write the baked script to.
+                                        @return Success or failure.
+                                    */
+    EStatus  BakeFile               (const char *    szScriptFileIn,
+                                     const char *    szBakedFileOut);
+
+                                    /** @brief  Build a script from a baked buffer.  The checksum is verified before
+                                                anything is read.
+                                        @param  parserBakedIn The baked script.  Reading starts at the cursor.
+                                        @param  ppScriptOut Receives a new script, or NULL on failure.
+                                        @return Success or failure.
+                                    */
+    EStatus  ReadBuffer             (RStrParser &    parserBakedIn,
+                                     InkScript * *   ppScriptOut);
+  };
+
+#endif // INKBAKER_HPP
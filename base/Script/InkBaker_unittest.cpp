@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Script/InkScript.hpp"
+#include "Script/InkParser.hpp"
+#include "Script/InkExecute.hpp"
+#include "Script/InkBaker.hpp"
+#include "Script/InkScriptManager.hpp"
+#include "ValueRegistry/ValueRegistrySimple.hpp"
+#include "Sys/FilePath.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
+
+// NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
+
+static const char *  szInkBakerTestScript = R"""(
+-> knot_one
+=== function addOne ===
+~ counter = counter + 1
+Added
+~ return
+=== knot_one ===
+~ counter = 1 + 2
+Count {counter} and {One|Two}
+~ addOne()
+Count {counter} and {&Red|Green}
+-> stitch_b
+= stitch_a
+Never shown
+= stitch_b
+* Choice [One]is one.
+* Choice Two[] is chosen.
+Line after Choice Two
+-> knot_two
+=== knot_two ===
+Line Four {!Once|Twice}
+)""";
+
+//------------------------------------------------------------------------------
+static VOID  InkBakerTest_Run  (InkScript *       pScriptIn,
+                                ValueRegistry *   pRegistryIn,
+                                RStr &            strOut)
+  {
+  // run to the end, taking the first choice each time, and record everything shown.
+  InkExecute  exec;
+  exec.SetRegistry (pRegistryIn);
+  exec.SetScript (pScriptIn);
+
+  for (INT  iStep = 0; iStep < 100; ++iStep)
+    {
+    if (!exec.CanContinue ())
+      {
+      if (exec.GetNumChoices () == 0) break;
+
+      strOut.AppendFormat ("[%s]\n", exec.GetChoiceText (0));
+      exec.ChooseChoiceIndex (0);
+      };
+    strOut.AppendFormat ("%s\n", exec.Continue ());
+    };
+  };
+
+//------------------------------------------------------------------------------
+TEST (InkBaker, RoundTrip)
+  {
+  InkParser    parser;
+  InkBaker     baker;
+  RStrParser   parserBaked;
+
+  InkScript *  pTextScript  = parser.Parse (szInkBakerTestScript);
+  InkScript *  pBakedScript = NULL;
+
+  ASSERT_TRUE (baker.BakeScript (pTextScript, parserBaked) == EStatus::kSuccess);
+  ASSERT_TRUE (InkBaker::IsBaked (parserBaked));
+  parserBaked.ResetCursor ();
+  ASSERT_TRUE (baker.ReadBuffer (parserBaked, &pBakedScript) == EStatus::kSuccess);
+  ASSERT_TRUE (pBakedScript != NULL);
+
+  ASSERT_EQ (pTextScript->GetNumElements (),               pBakedScript->GetNumElements ());
+  ASSERT_EQ (pTextScript->GetLabelIndex ("knot_two"),      pBakedScript->GetLabelIndex ("knot_two"));
+  ASSERT_EQ (pTextScript->GetLabelIndex ("knot_one.stitch_b"), pBakedScript->GetLabelIndex ("knot_one.stitch_b"));
+  ASSERT_EQ (pTextScript->GetFunctionIndex ("addOne"),     pBakedScript->GetFunctionIndex ("addOne"));
+
+  // both forms must run the same way, including lists, expressions, and function calls.
+  ValueRegistrySimple  registryText;
+  ValueRegistrySimple  registryBaked;
+  RStr                 strTextOut;
+  RStr                 strBakedOut;
+
+  InkBakerTest_Run (pTextScript,  &registryText,  strTextOut);
+  InkBakerTest_Run (pBakedScript, &registryBaked, strBakedOut);
+
+  ASSERT_TRUE  (strTextOut.Find ("Line Four") != -1);
+  ASSERT_STREQ (strTextOut.AsChar (), strBakedOut.AsChar ());
+  ASSERT_EQ    (registryText.GetInt ("counter"),           registryBaked.GetInt ("counter"));
+  ASSERT_EQ    (registryText.GetInt ("knot_one.stitch_b"), registryBaked.GetInt ("knot_one.stitch_b"));
+  ASSERT_EQ    (registryBaked.GetInt ("knot_one.stitch_a"), 0);
+
+  pTextScript->FreeElementList ();
+  pBakedScript->FreeElementList ();
+  delete (pTextScript);
+  delete (pBakedScript);
+  };
+
+//------------------------------------------------------------------------------
+TEST (InkBaker, Corrupt)
+  {
+  InkBaker     baker;
+  RStrParser   parserBaked;
+  InkScript *  pScript = NULL;
+
+  ASSERT_TRUE (baker.BakeBuffer (szInkBakerTestScript, parserBaked) == EStatus::kSuccess);
+
+  // text isn't baked
+  RStrParser  parserText (szInkBakerTestScript);
+  ASSERT_FALSE (InkBaker::IsBaked (parserText));
+  ASSERT_FALSE (baker.ReadBuffer (parserText, &pScript) == EStatus::kSuccess);
+  ASSERT_TRUE  (pScript == NULL);
+
+  // a changed byte fails the checksum
+  RStrParser  parserDamaged (parserBaked);
+  parserDamaged.SetCursorStart (parserDamaged.Length () - 6);
+  parserDamaged.SetU1_LEnd (parserDamaged.GetAt (parserDamaged.Length () - 6) ^ 0x5a);
+  parserDamaged.ResetCursor ();
+  ASSERT_FALSE (baker.ReadBuffer (parserDamaged, &pScript) == EStatus::kSuccess);
+  ASSERT_TRUE  (pScript == NULL);
+
+  // a truncated buffer is caught before the checksum is calculated
+  RStrParser  parserTruncated (parserBaked);
+  parserTruncated.TruncateRight (parserTruncated.Length () - 20);
+  parserTruncated.ResetCursor ();
+  ASSERT_FALSE (baker.ReadBuffer (parserTruncated, &pScript) == EStatus::kSuccess);
+  ASSERT_TRUE  (pScript == NULL);
+
+  // the undamaged buffer still loads
+  parserBaked.ResetCursor ();
+  ASSERT_TRUE (baker.ReadBuffer (parserBaked, &pScript) == EStatus::kSuccess);
+  pScript->FreeElementList ();
+  delete (pScript);
+  };
+
+//------------------------------------------------------------------------------
+TEST (InkBaker, BakeFileAndManager)
+  {
+  // tool path:  .ink file in, baked file out.
+  RStrParser  parserText (szInkBakerTestScript);
+  RStr        strInkPath   (FilePath::ExpandPathURI ("file://UnitTestInkBaker.ink"));
+  RStr        strBakedPath (FilePath::ExpandPathURI ("file://UnitTestInkBaker.inkb"));
+
+  ASSERT_TRUE (parserText.WriteToFile (strInkPath.AsChar ()) == EStatus::kSuccess);
+
+  InkBaker  baker;
+  ASSERT_TRUE  (baker.BakeFile (strInkPath.AsChar (), strBakedPath.AsChar ()) == EStatus::kSuccess);
+  ASSERT_FALSE (baker.BakeFile ("UnitTestInkBakerMissing.ink", strBakedPath.AsChar ()) == EStatus::kSuccess);
+
+  RStrParser  parserBaked;
+  ASSERT_TRUE (parserBaked.ReadFromFile (strBakedPath.AsChar ()) == EStatus::kSuccess);
+  ASSERT_TRUE (InkBaker::IsBaked (parserBaked));
+
+  remove (strInkPath.AsChar ());
+  remove (strBakedPath.AsChar ());
+
+  // the manager loads baked buffers directly, and runs their Activate function.
+  ValueRegistrySimple  registry;
+  ContentDepot         depot;
+  RStr                 strBaked (parserBaked);
+
+  depot.AddAsset ("BakedScript", "ink", "default", "mem://BakedScript.inkb", &strBaked);
+  depot.SetEnvironment ("dev");
+  depot.Refresh (TRUE);
+
+  InkScriptManager *  pManager = new InkScriptManager (&depot, &registry);
+  RStrArray           arrayScripts;
+
+  pManager->LoadScript ("BakedScript");
+  pManager->GetScriptList (arrayScripts);
+  ASSERT_EQ (arrayScripts.Length (), 1);
+
+  pManager->RunFunctionToEnd ("BakedScript", "addOne");
+  ASSERT_EQ (registry.GetInt ("counter"), 1);
+
+  delete (pManager);
+  };
+
+//------------------------------------------------------------------------------
+TEST (InkBaker, LoadBenchmark)
+  {
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT  iNumKnots = 400;
+  const INT  iNumRuns  = 3;
+
+  RStrParser  parserText;
+  for (INT  iKnot = 0; iKnot < iNumKnots; ++iKnot)
+    {
+    parserText.AppendFormat ("=== knot_%d ===\n" \
+                             "~ visits_%d = visits_%d + %d * 2\n" \
+                             "Line one of knot %d, {red|green|blue} and {visits_%d}.\n" \
+                             "= detail\n" \
+                             "{counter > %d:More|Less} text for the detail of knot %d.\n" \
+                             "* Ask about [it]the thing in knot %d.\n" \
+                             "* Leave[] now.\n" \
+                             "-> knot_%d\n",
+                             iKnot, iKnot, iKnot, iKnot, iKnot, iKnot, iKnot, iKnot, iKnot, (iKnot + 1) % iNumKnots);
+    };
+
+  InkBaker    baker;
+  RStrParser  parserBaked;
+  ASSERT_TRUE (baker.BakeBuffer (parserText.AsChar (), parserBaked) == EStatus::kSuccess);
+
+  INT64  iTextUs  = 0;
+  INT64  iBakedUs = 0;
+  for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+    {
+    InkParser  parser;
+    INT64      iStartUs = StopWatch::GetTimeUs ();
+    InkScript *  pTextScript = parser.Parse (parserText.AsChar ());
+    iTextUs += StopWatch::GetTimeUs () - iStartUs;
+
+    InkScript *  pBakedScript = NULL;
+    parserBaked.ResetCursor ();
+    iStartUs = StopWatch::GetTimeUs ();
+    ASSERT_TRUE (baker.ReadBuffer (parserBaked, &pBakedScript) == EStatus::kSuccess);
+    iBakedUs += StopWatch::GetTimeUs () - iStartUs;
+
+    ASSERT_EQ (pTextScript->GetNumElements (), pBakedScript->GetNumElements ());
+
+    pTextScript->FreeElementList ();
+    pBakedScript->FreeElementList ();
+    delete (pTextScript);
+    delete (pBakedScript);
+    };
+
+  BenchmarkPrintf ("Ink script load, %d knots:  text %9.3f ms (%d bytes)  baked %9.3f ms (%d bytes)  speedup %.1fx\n",
+                   iNumKnots,
+                   DOUBLE (iTextUs)  / DOUBLE (1000 * iNumRuns), parserText.Length (),
+                   DOUBLE (iBakedUs) / DOUBLE (1000 * iNumRuns), parserBaked.Length (),
+                   DOUBLE (iTextUs) / DOUBLE (RMax (INT64 (1), iBakedUs)));
+  };
@@ -132,6 +132,11 @@ VOID  InkExecute::SetScript  (InkScript *  pScriptIn)
 
   pScript = pScriptIn;
   fnRouter.pScript = pScript;
+  context.pScript  = pScript;
+  if (pScript != NULL)
+    {
+    pScript->LoadVisitCounts (pRegistry);
+    };
   Restart ();
   };
 
@@ -161,6 +166,10 @@ VOID  InkExecute::SetRegistry  (ValueRegistry *  pRegistryIn)
   {
   pRegistry = pRegistryIn;
   InkElem::SetRegistry (pRegistryIn);
+  if (pScript != NULL)
+    {
+    pScript->LoadVisitCounts (pRegistry);
+    };
   };
 
 //-----------------------------------------------------------------------------
@@ -382,6 +391,12 @@ const char *  InkExecute::Continue  (BOOL  bReturnOnKnot)
   strTextOut.StripTrailingChar ('\n');
   strTextOut.TranslateEscapedChars ();
 
+  // keep the registry's visit counts current between calls
+  if (pScript != NULL)
+    {
+    pScript->SyncVisitCounts (InkElem::GetRegistry ());
+    };
+
   //OPT_DBG_INFO ("Continue returns at curr elem %d :%s", iCurrElem, strTextOut.AsChar ());
   return (strTextOut.AsChar ());
   };
@@ -446,11 +461,7 @@ BOOL  FnInkScript::CanHandleFunction (RStr &  strNameIn)
     return (FALSE);
     };
 
-  iOffset = -1;
-  if (pScript->kvpFunctions.HasKey (strNameIn.AsChar()))
-    {
-    iOffset = pScript->kvpFunctions[strNameIn.AsChar()];
-    };
+  iOffset = pScript->GetFunctionIndex (strNameIn.AsChar());
 
   return (iOffset != -1);
   };
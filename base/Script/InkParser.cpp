@@ -142,6 +142,9 @@ InkScript *  InkParser::Parse  (const char *  szScriptIn)
     delete (pparserCurr);
     } while (listScriptStack.Size () > 0);
 
+  // resolve diverts and visit counters now that every label is known.
+  pScript->Link ();
+
   //OPT_DBG_INFO ("\n\nScript Disassmbly\n");
   //pScript->DebugPrint ();
 
@@ -255,7 +258,7 @@ VOID InkParser::ParseKnot (RStrParser &  parserLineIn,
     strTag = parserLineIn.GetWord ();
     strTag.StripTrailingChar ('=');
 
-    pScriptIn->kvpFunctions [strTag.AsChar()] = pScriptIn->listElem.Length ();
+    pScriptIn->tableFunctions.Set (strTag.AsChar(), pScriptIn->listElem.Length ());
 
     // NOTE: Remove this function register call once everything works.
     //Expression::RegisterFunction (new FnInkScript (strTag.AsChar (), pScriptIn, pScriptIn->listElem.Length ()));
@@ -266,7 +269,7 @@ VOID InkParser::ParseKnot (RStrParser &  parserLineIn,
 
   InkKnot *  pNew = new InkKnot (strTag.AsChar ());
   pScriptIn->AddElem (pNew, ppelemStartOut);
-  pScriptIn->kvpLabels [strTag.AsChar()] = pScriptIn->listElem.Length (); // Storing what will be its eventual position.
+  pScriptIn->tableLabels.Set (strTag.AsChar(), pScriptIn->listElem.Length ()); // Storing what will be its eventual position.
 
   *ppPrevKnotOut = pNew;
   };
@@ -296,7 +299,7 @@ VOID InkParser::ParseStitch (RStrParser &  parserLineIn,
 
   InkStitch *  pNew = new InkStitch (strFullTag.AsChar ());
   pScriptIn->AddElem (pNew, ppelemStartOut);
-  pScriptIn->kvpLabels [strFullTag.AsChar()] = pScriptIn->listElem.Length (); // Storing what will be its eventual position.
+  pScriptIn->tableLabels.Set (strFullTag.AsChar(), pScriptIn->listElem.Length ()); // Storing what will be its eventual position.
   };
 
 //-----------------------------------------------------------------------------
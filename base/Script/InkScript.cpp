@@ -48,11 +48,56 @@ ASSERTFILE (__FILE__);
 #define DBG_INKSCRIPT 0
 //#define DBG_INKSCRIPT 1
 
-TKVP<INT> *      InkElem::pkvpLabels = NULL;
 ValueRegistry *  InkElem::pRegistry = NULL;
 
 //=============================================================================
 
+//-----------------------------------------------------------------------------
+VOID  InkLabelTable::Clear (VOID)
+  {
+  astrNames.Clear ();
+  aiValues.Clear ();
+  indexNames.Clear ();
+  };
+
+//-----------------------------------------------------------------------------
+INT  InkLabelTable::Set (const char *  szNameIn,
+                         INT           iValueIn)
+  {
+  INT  iSlot = FindSlot (szNameIn);
+  if (iSlot == -1)
+    {
+    iSlot = aiValues.Length ();
+    astrNames.Append (szNameIn);
+    aiValues.Append (iValueIn);
+    indexNames.Insert (CalcHashValue (szNameIn), iSlot);
+    }
+  else
+    {
+    aiValues [iSlot] = iValueIn;
+    };
+  return (iSlot);
+  };
+
+//-----------------------------------------------------------------------------
+INT  InkLabelTable::FindSlot (const char *  szNameIn)
+  {
+  if (szNameIn == NULL) return (-1);
+
+  HASH_T  uHash = CalcHashValue (szNameIn);
+  for (INT  iIndex = indexNames.FindFirst (uHash); iIndex != -1; iIndex = indexNames.FindNext (uHash, iIndex))
+    {
+    INT  iSlot = indexNames.GetAt (iIndex);
+    if (astrNames [iSlot].Equals (szNameIn))
+      {
+      return (iSlot);
+      };
+    };
+  return (-1);
+  };
+
+//=============================================================================
+
 //-----------------------------------------------------------------------------
 InkElem::InkElem  ()
   {
@@ -99,6 +144,46 @@ VOID  InkElem::Init (VOID)
   iGatherLevel = -1;
   };
 
+//-----------------------------------------------------------------------------
+VOID  InkElem::Link  (InkScript *  pScriptIn,
+                      InkKnot *    pKnotIn)
+  {
+  // Chains can be long, so walk them in a loop and only recurse into children.
+  for (InkElem *  pElem = this; pElem != NULL; pElem = pElem->pNext)
+    {
+    pElem->LinkSelf (pScriptIn, pKnotIn);
+    for (InkElem *  pChild = pElem->pChildren; pChild != NULL; pChild = pChild->pSibling)
+      {
+      pChild->Link (pScriptIn, pKnotIn);
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkElem::CountVisit  (InkContext *   pContextIn,
+                            INT            iVisitSlotIn,
+                            const RStr &   strLabelIn)
+  {
+  if ((pContextIn != NULL) && (pContextIn->pScript != NULL) && (iVisitSlotIn != -1))
+    {
+    pContextIn->pScript->CountVisit (iVisitSlotIn);
+    }
+  else if (pRegistry != NULL)
+    {
+    // not linked, or evaluated outside of an InkExecute.  Count in the registry directly.
+    pRegistry->SetInt (strLabelIn.AsChar (), pRegistry->GetInt (strLabelIn.AsChar ()) + 1);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkElem::SyncVisits  (InkContext *  pContextIn)
+  {
+  if ((pContextIn != NULL) && (pContextIn->pScript != NULL))
+    {
+    pContextIn->pScript->SyncVisitCounts (pRegistry);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 VOID  InkElem::AddChild  (InkElem *  pelemIn)
   {
@@ -311,6 +396,8 @@ BOOL  InkExpression::Eval (InkContext *  pContextIn)
 
   TList<ExpressionFn*> *  plistLocalFn = (pContextIn == NULL) ? NULL : pContextIn->plistLocalFn;
 
+  // the expression may read visit counts from the registry
+  SyncVisits (pContextIn);
   Expression::Execute (pCompiled, pRegistry, &tokResult, &bReturned, NULL, plistLocalFn);
 
   //DBG_INFO ("InkExpression::Eval Done.  Returned token type : %s", tokResult.GetTypeString());
@@ -320,29 +407,55 @@ BOOL  InkExpression::Eval (InkContext *  pContextIn)
 //=============================================================================
 
 //-----------------------------------------------------------------------------
-INT  InkDivert::GetNextIndex (INT &      iCurrIndexIn,
-                              InkElem *  pCurrKnotIn)
+VOID  InkKnot::LinkSelf  (InkScript *  pScriptIn,
+                          InkKnot *    pKnotIn)
   {
-  if (strLabel.Equals ("END")) return (-1);
+  iVisitSlot = pScriptIn->AddVisitCounter (strLabel.AsChar ());
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkStitch::LinkSelf  (InkScript *  pScriptIn,
+                            InkKnot *    pKnotIn)
+  {
+  iVisitSlot = pScriptIn->AddVisitCounter (strLabel.AsChar ());
+  };
+
+//=============================================================================
 
-  if (pkvpLabels->HasKey (strLabel.AsChar()))
+//-----------------------------------------------------------------------------
+VOID  InkDivert::LinkSelf  (InkScript *  pScriptIn,
+                            InkKnot *    pKnotIn)
+  {
+  // Labels are looked up the same way execution used to: as a full label
+  //  first, then as a stitch of the knot the divert is in.
+  if (strLabel.Equals ("END"))
     {
-    // knot
-    return ((*pkvpLabels) [strLabel.AsChar()]);
+    iTarget = -1;
     }
-  else if (pCurrKnotIn != NULL)
+  else
     {
-  // divert
-    RStr  strFullTag (dynamic_cast<InkKnot*>(pCurrKnotIn)->GetLabel ());
-    strFullTag.AppendChar ('.');
-    strFullTag.AppendString (strLabel);
+    iTarget = pScriptIn->tableLabels.Find (strLabel.AsChar ());
+    if ((iTarget == -1) && (pKnotIn != NULL))
+      {
+      RStr  strFullTag (pKnotIn->GetLabel ());
+      strFullTag.AppendChar ('.');
+      strFullTag.AppendString (strLabel);
 
-    if (pkvpLabels->HasKey (strFullTag.AsChar()))
+      iTarget = pScriptIn->tableLabels.Find (strFullTag.AsChar ());
+      };
+    if (iTarget == -1)
       {
-      // knot
-      return ((*pkvpLabels) [strFullTag.AsChar()]);
+      iTarget = kUnresolved;
       };
     };
+  };
+
+//-----------------------------------------------------------------------------
+INT  InkDivert::GetNextIndex (INT &      iCurrIndexIn,
+                              InkElem *  pCurrKnotIn)
+  {
+  if (iTarget != kUnresolved) return (iTarget);
+
   // couldn't find it!  Error!
   DBG_ERROR ("InkDivert: Unable to find label %s", strLabel.AsChar());
   return (InkElem::GetNextIndex (iCurrIndexIn, pCurrKnotIn));
@@ -446,7 +559,6 @@ INT InkChoice::GetNextIndex (INT &        iCurrIndexIn,
 InkScript::InkScript  ()
   {
   Init ();
-  InkElem::SetLabels (&kvpLabels);
   };
 
 //-----------------------------------------------------------------------------
@@ -464,16 +576,87 @@ VOID  InkScript::Init  (VOID)
 //-----------------------------------------------------------------------------
 INT  InkScript::GetFunctionIndex   (const char *  szFunctionNameIn)
   {
-  if (!kvpFunctions.HasKey(szFunctionNameIn)) return (-1);
-  return (kvpFunctions.Find (szFunctionNameIn));
+  return (tableFunctions.Find (szFunctionNameIn));
   };
 
 //-----------------------------------------------------------------------------
 INT  InkScript::GetLabelIndex   (const char *  szLabelIn)
   {
   if (szLabelIn == NULL) return (0);  // if null, start at the first element
-  if (!kvpLabels.HasKey(szLabelIn)) return (-1);
-  return (kvpLabels.Find (szLabelIn));
+  return (tableLabels.Find (szLabelIn));
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkScript::Link  (VOID)
+  {
+  InkKnot *  pKnot = NULL;
+
+  INT  iNumElements = listElem.Length ();
+  for (INT  iIndex = 0; iIndex < iNumElements; ++iIndex)
+    {
+    // track the enclosing knot for relative diverts, the same as InkExecute::Continue does.
+    if (listElem [iIndex]->IsType (InkElemType::kKnot))
+      {
+      pKnot = dynamic_cast<InkKnot*>(listElem [iIndex]);
+      };
+    listElem [iIndex]->Link (this, pKnot);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+INT  InkScript::AddVisitCounter  (const char *  szLabelIn)
+  {
+  INT  iSlot = tableVisits.FindSlot (szLabelIn);
+  if (iSlot == -1)
+    {
+    iSlot = tableVisits.Set (szLabelIn, 0);
+    aiVisitsSynced.Append (0);
+    };
+  return (iSlot);
+  };
+
+//-----------------------------------------------------------------------------
+INT  InkScript::GetVisitCount  (const char *  szLabelIn)
+  {
+  INT  iSlot = tableVisits.FindSlot (szLabelIn);
+  return ((iSlot == -1) ? 0 : tableVisits.ValueAt (iSlot));
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkScript::SyncVisitCounts  (ValueRegistry *  pRegistryIn)
+  {
+  if (pRegistryIn == NULL) return;
+
+  INT  iNumDirty = aiVisitsDirty.Length ();
+  for (INT  iIndex = 0; iIndex < iNumDirty; ++iIndex)
+    {
+    INT           iSlot  = aiVisitsDirty [iIndex];
+    const char *  szName = tableVisits.NameAt (iSlot);
+
+    // Add the visits rather than setting the count, since other scripts may
+    //  count visits to a label with the same name, such as START.
+    pRegistryIn->SetInt (szName, pRegistryIn->GetInt (szName) + tableVisits.ValueAt (iSlot) - aiVisitsSynced [iSlot]);
+    aiVisitsSynced [iSlot] = tableVisits.ValueAt (iSlot);
+    };
+  aiVisitsDirty.SetLength (0);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  InkScript::LoadVisitCounts  (ValueRegistry *  pRegistryIn)
+  {
+  if (pRegistryIn == NULL) return;
+
+  // don't lose counts that haven't been written yet
+  SyncVisitCounts (pRegistryIn);
+
+  INT  iNumVisits = tableVisits.Size ();
+  for (INT  iSlot = 0; iSlot < iNumVisits; ++iSlot)
+    {
+    INT  iCount = pRegistryIn->GetInt (tableVisits.NameAt (iSlot));
+
+    tableVisits.ValueRef (iSlot) = iCount;
+    aiVisitsSynced [iSlot]       = iCount;
+    };
   };
 
 //-----------------------------------------------------------------------------
@@ -517,17 +700,7 @@ VOID  InkScript::DebugPrint (VOID)
     };
   };
 
-  /*
-//-----------------------------------------------------------------------------
-INT  InkScript::GetLabelStart      (const char *  szLabelIn);
-
-    TKVP<INT>               kvpLabels;           /// named jump targets.  Indexes into listElem. - model
-
-
-
-      return ((*pkvpLabels) [strFullTag.AsChar()]);
 
-*/
 
 
 
@@ -47,6 +47,7 @@
 #include "Containers/IntArray.hpp"
 #include "ValueRegistry/ValueRegistry.hpp"
 #include "Sys/TKeyValuePair.hpp"
+#include "Containers/THashIndex.hpp"
 #include "Script/Expression.hpp"
 
 //------------------------------------------------------------------------
@@ -58,6 +59,8 @@
 // Forward Declarations
 //------------------------------------------------------------------------
 
+class InkScript;
+class InkKnot;
 
 // NOTE:  The Ink format scripts are parsed into a list of InkElem instances.
 //         Each instance can be parsed to generate some text or perform
@@ -75,6 +78,12 @@
 //         It should help that the graph does not have to be dynamically altered
 //         once it is generated.
 
+//        Once a script is parsed, InkScript::Link resolves every divert to
+//         an element index and gives every knot and stitch a visit counter
+//         slot, so execution never looks a label up by name.  Visit counts
+//         are kept in the script and written to the registry when an
+//         expression might read them, and at the end of each Continue.
+
 //------------------------------------------------------------------------
 // Class Definitions
 //------------------------------------------------------------------------
@@ -116,6 +125,56 @@ class InkContext  // Data related to the current line of execution
   {
   public:
     TList<ExpressionFn*> *  plistLocalFn;
+    InkScript *             pScript;       // script being executed.  Holds the visit counts.
+
+  public:
+                            InkContext  ()   {plistLocalFn = NULL; pScript = NULL;};
+  };
+
+//-----------------------------------------------------------------------------
+/// Names mapped to integers, such as labels to element indexes.  A name keeps
+///  the slot it was given when first set, so callers can resolve a name once
+///  and use the slot from then on.
+class InkLabelTable
+  {
+  private:
+    RStrArray          astrNames;
+    IntArray           aiValues;
+    THashIndex<INT>    indexNames;   ///< Name hash -> slot
+
+  public:
+
+    VOID           Clear          (VOID);
+
+                   /** @brief  Set the value for a name, adding the name if needed.
+                       @param  szNameIn The name.
+                       @param  iValueIn The value.
+                       @return The slot holding the name.
+                   */
+    INT            Set            (const char *  szNameIn,
+                                   INT           iValueIn);
+
+                   /** @brief  Find the slot holding a name.
+                       @param  szNameIn The name.
+                       @return The slot, or -1 if the name isn't in the table.
+                   */
+    INT            FindSlot       (const char *  szNameIn);
+
+                   /** @brief  Find the value for a name.
+                       @param  szNameIn The name.
+                       @return The value, or -1 if the name isn't in the table.
+                   */
+    INT            Find           (const char *  szNameIn)   {INT  iSlot = FindSlot (szNameIn); return ((iSlot == -1) ? -1 : aiValues [iSlot]);};
+
+    BOOL           HasKey         (const char *  szNameIn)   {return (FindSlot (szNameIn) != -1);};
+
+    INT            Size           (VOID) const               {return (aiValues.Length ());};
+
+    const char *   NameAt         (INT  iSlotIn)             {return (astrNames [iSlotIn].AsChar ());};
+
+    INT            ValueAt        (INT  iSlotIn) const       {return (aiValues [iSlotIn]);};
+
+    INT &          ValueRef       (INT  iSlotIn)             {return (aiValues [iSlotIn]);};
   };
 
 
@@ -132,9 +191,14 @@ class InkElem
 
   protected:
 
-    static TKVP<INT> *      pkvpLabels;
     static ValueRegistry *  pRegistry;
 
+    static VOID     CountVisit      (InkContext *   pContextIn,
+                                     INT            iVisitSlotIn,
+                                     const RStr &   strLabelIn);
+
+    static VOID     SyncVisits      (InkContext *   pContextIn);
+
   public:
 
                     InkElem         ();
@@ -147,6 +211,8 @@ class InkElem
 
     BOOL            IsType          (InkElemType::Type  eTypeIn)   {return (eType == eTypeIn);};
 
+    InkElemType::Type  GetType      (VOID)                         {return (eType);};
+
     VOID            AddChild        (InkElem *  pelemIn);
 
     VOID            AppendElem      (InkElem *  pelemIn);
@@ -183,10 +249,28 @@ class InkElem
     virtual INT     GetNextIndex    (INT &        iCurrIndexIn,
                                      InkElem *    pCurrKnotIn = NULL);
 
-    static VOID     SetLabels       (TKVP<INT> *  pkvpLabelsIn)    {pkvpLabels = pkvpLabelsIn;};
+                    /** @brief  Resolve names to indexes once parsing is done.  Walks the rest of the chain
+                                in a loop, calling LinkSelf on each element and recursing into its children.
+                        @param  pScriptIn The script this element belongs to.
+                        @param  pKnotIn The knot this element is in, or NULL.
+                        @return None
+                    */
+    VOID            Link            (InkScript *  pScriptIn,
+                                     InkKnot *    pKnotIn);
+
+                    /** @brief  Resolve this element's own names.  Called by Link, and overridden by
+                                elements that refer to labels.
+                        @param  pScriptIn The script this element belongs to.
+                        @param  pKnotIn The knot this element is in, or NULL.
+                        @return None
+                    */
+    virtual VOID    LinkSelf        (InkScript *  pScriptIn,
+                                     InkKnot *    pKnotIn)   {};
 
     static VOID     SetRegistry     (ValueRegistry * pRegistryIn)  {pRegistry = pRegistryIn;};
 
+    static ValueRegistry *  GetRegistry  (VOID)                    {return (pRegistry);};
+
     const char *    GetTypeName     (VOID);
 
   };
@@ -214,6 +298,8 @@ class InkParagraph : public InkElem
 
     VOID    GetText       (InkContext *  pContextIn,
                            RStr &       strOut)       override;
+
+    const RStr &  GetRawText  (VOID) const                       {return (strText);};
   };
 
 //-----------------------------------------------------------------------------
@@ -221,20 +307,25 @@ class InkKnot : public InkElem
   {
   private:
     RStr                    strLabel;
+    INT                     iVisitSlot;   // visit counter in the script, set by Link
 
   public:
 
-                 InkKnot         () {};
+                 InkKnot         () {iVisitSlot = -1;};
 
     explicit     InkKnot         (const char *  szLabelIn) : InkElem (InkElemType::kKnot)
                                                          {
                                                          strLabel.SetHash (szLabelIn);
                                                          SetGatherLevel (0);
+                                                         iVisitSlot = -1;
                                                          };
 
                  ~InkKnot        ()                      {};
 
-    BOOL         Eval            (InkContext *  pContextIn) override {pRegistry->SetInt (strLabel.AsChar (), pRegistry->GetInt (strLabel.AsChar ()) + 1); return (FALSE);};
+    BOOL         Eval            (InkContext *  pContextIn) override {CountVisit (pContextIn, iVisitSlot, strLabel); return (FALSE);};
+
+    VOID         LinkSelf        (InkScript *   pScriptIn,
+                                  InkKnot *     pKnotIn)    override;
 
     const char * GetLabel        (VOID)                              {return (strLabel.AsChar ());};
   };
@@ -244,20 +335,25 @@ class InkStitch : public InkElem
   {
   private:
     RStr                    strLabel;
+    INT                     iVisitSlot;   // visit counter in the script, set by Link
 
   public:
 
-                 InkStitch       () {};
+                 InkStitch       () {iVisitSlot = -1;};
 
     explicit     InkStitch       (const char *  szLabelIn) : InkElem (InkElemType::kStitch)
                                                          {
                                                          strLabel.SetHash (szLabelIn);
                                                          SetGatherLevel (0);
+                                                         iVisitSlot = -1;
                                                          };
 
                  ~InkStitch      ()                      {};
 
-    BOOL         Eval            (InkContext *  pContextIn) override {pRegistry->SetInt (strLabel.AsChar (), pRegistry->GetInt (strLabel.AsChar ()) + 1); return (FALSE);};
+    BOOL         Eval            (InkContext *  pContextIn) override {CountVisit (pContextIn, iVisitSlot, strLabel); return (FALSE);};
+
+    VOID         LinkSelf        (InkScript *   pScriptIn,
+                                  InkKnot *     pKnotIn)    override;
 
     const char * GetLabel        (VOID)                              {return (strLabel.AsChar ());};
   };
@@ -267,17 +363,26 @@ class InkDivert : public InkElem
   {
   private:
     RStr                    strLabel;
+    INT                     iTarget;      // element index to go to, -1 for END, or kUnresolved
 
   public:
+    static const INT  kUnresolved = -2;
 
-                 InkDivert    () {};
+  public:
 
-    explicit     InkDivert    (const char *  szLabelIn) : InkElem (InkElemType::kDivert)  {strLabel.SetHash (szLabelIn);};
+                 InkDivert    () {iTarget = kUnresolved;};
+
+    explicit     InkDivert    (const char *  szLabelIn) : InkElem (InkElemType::kDivert)  {strLabel.SetHash (szLabelIn); iTarget = kUnresolved;};
 
                  ~InkDivert   ()                         {};
 
     BOOL         Eval         (InkContext *  pContextIn) override {return (FALSE);};
 
+    VOID         LinkSelf     (InkScript *   pScriptIn,
+                               InkKnot *     pKnotIn)    override;
+
+    INT          GetTarget    (VOID)                              {return (iTarget);};
+
     const char * GetLabel     (VOID)                              {return (strLabel.AsChar ());};
 
     INT          GetNextIndex (INT &      iCurrIndexIn,
@@ -301,6 +406,8 @@ class InkList : public InkElem
 
     VOID     SetListType   (InkListType::Type  eTypeIn)           {eListType = eTypeIn;};
 
+    InkListType::Type  GetListType  (VOID) const                 {return (eListType);};
+
     BOOL     Eval          (InkContext *  pContextIn)    override {++iCount; return (FALSE);};
 
     BOOL     HasText       (VOID)                        override {return (TRUE);};
@@ -326,6 +433,9 @@ class InkExpression : public InkElem
                                   INT           iScriptLengthIn) : InkElem (InkElemType::kExpression)
                                                            {pCompiled = Expression::Compile (szScriptIn, iScriptLengthIn);};
 
+    explicit     InkExpression   (TList<Token*> *  pCompiledIn) : InkElem (InkElemType::kExpression)
+                                                           {pCompiled = pCompiledIn;};  // takes ownership of the list
+
                  ~InkExpression  ()                        {Expression::FreeTokenList (&pCompiled);};
 
     BOOL         Eval            (InkContext *  pContextIn) override;//                    {tokResult.eType = TokenType::kUnknown; Expression::Execute (pCompiled, pRegistry, &tokResult);};
@@ -336,6 +446,8 @@ class InkExpression : public InkElem
                                   RStr &        strOut)     override {if (tokResult.eType == TokenType::kString) strOut.AppendString(tokResult.strRaw);};
 
     Token *      GetResult       (VOID)                              {return (&tokResult);};
+
+    TList<Token*> *  GetCompiled (VOID)                              {return (pCompiled);};
   };
 
 //-----------------------------------------------------------------------------
@@ -351,12 +463,14 @@ class InkVariable : public InkElem
 
                  ~InkVariable    ()                        {};
 
+    const char * GetName         (VOID)                              {return (strName.AsChar ());};
+
     BOOL         Eval            (InkContext *  pContextIn) override {return (FALSE);};
 
     BOOL         HasText         (VOID)                     override {return TRUE;};
 
     VOID         GetText         (InkContext *  pContextIn,
-                                  RStr &        strOut)     override {if (pRegistry != NULL) {pRegistry->GetString (strName.AsChar (), strOut);};};
+                                  RStr &        strOut)     override {if (pRegistry != NULL) {SyncVisits (pContextIn); pRegistry->GetString (strName.AsChar (), strOut);};};
   };
 
 //-----------------------------------------------------------------------------
@@ -405,8 +519,11 @@ class InkScript
   public:
     RStr                    strName;             /// unique name identifying this script
     TArray<InkElem*>        listElem;            /// parsed version of the text script - model
-    TKVP<INT>               kvpLabels;           /// named jump targets.  Indexes into listElem. - model
-    TKVP<INT>               kvpFunctions;        /// named jump targets.  Indexes into listElem. - model
+    InkLabelTable           tableLabels;         /// named jump targets.  Indexes into listElem. - model
+    InkLabelTable           tableFunctions;      /// named jump targets.  Indexes into listElem. - model
+    InkLabelTable           tableVisits;         /// knot and stitch labels to visit counts - execute
+    IntArray                aiVisitsSynced;      /// count in tableVisits last written to the registry - execute
+    IntArray                aiVisitsDirty;       /// tableVisits slots changed since the last sync - execute
     RStrParser              parserFullScript;    /// raw script text - parsing
     TList<RStrParser*>      listScriptStack;     /// stack of scripts to parse, for implementing INCLUDE - parsing
 
@@ -431,6 +548,42 @@ class InkScript
 
     INT           GetLabelIndex      (const char *  szLabelIn);
 
+                  /** @brief  Resolve diverts and assign visit counter slots.  Called once parsing is done.
+                      @return None
+                  */
+    VOID          Link               (VOID);
+
+                  /** @brief  Get the visit counter slot for a knot or stitch label, adding one if needed.
+                      @param  szLabelIn The full label.
+                      @return The slot.
+                  */
+    INT           AddVisitCounter    (const char *  szLabelIn);
+
+    VOID          CountVisit         (INT  iSlotIn)   {
+                                                      INT &  iCount = tableVisits.ValueRef (iSlotIn);
+                                                      if (iCount == aiVisitsSynced [iSlotIn]) {aiVisitsDirty.Append (iSlotIn);};
+                                                      ++iCount;
+                                                      };
+
+                  /** @brief  Return how many times a knot or stitch has been visited.
+                      @param  szLabelIn The full label.
+                      @return The count.
+                  */
+    INT           GetVisitCount      (const char *  szLabelIn);
+
+                  /** @brief  Write the visit counts that changed since the last sync to the registry.
+                      @param  pRegistryIn The registry.  Nothing is written if NULL.
+                      @return None
+                  */
+    VOID          SyncVisitCounts    (ValueRegistry *  pRegistryIn);
+
+                  /** @brief  Sync, then read every visit count from the registry.  Needed if the counts in the
+                              registry were changed from outside the script, such as by loading a save.
+                      @param  pRegistryIn The registry.  Nothing is read if NULL.
+                      @return None
+                  */
+    VOID          LoadVisitCounts    (ValueRegistry *  pRegistryIn);
+
     VOID          AddElem            (InkElem *     pNew,
                                       InkElem * *   ppFirst);
 
@@ -40,6 +40,7 @@
 ASSERTFILE (__FILE__);
 
 #include "Script/InkParser.hpp"
+#include "Script/InkBaker.hpp"
 #include "Script/InkScriptManager.hpp"
 
 
@@ -239,9 +240,28 @@ VOID InkScriptManager::OnScriptBufferLoad (const char *        pszNameIn,
   {
   // Upon receiving the buffer from the content depot, we need to create and
   //  parse the script, store it, and call any Activate()
-  InkParser  parser;
+  InkScript *  pScript = NULL;
 
-  InkScript *  pScript = parser.Parse (parserDataIn.AsChar ());
+  if (InkBaker::IsBaked (parserDataIn))
+    {
+    // pre-parsed script from InkBaker.  Read from a copy, since reading moves the cursor.
+    RStrParser  parserBaked (parserDataIn);
+    parserBaked.ResetCursor ();
+    InkBaker    baker;
+
+    EStatus  status = baker.ReadBuffer (parserBaked, &pScript);
+    if (status != EStatus::kSuccess)
+      {
+      DBG_ERROR ("InkScriptManager: Unable to load baked script %s : %s", pszNameIn, status.GetDescription ());
+      return;
+      };
+    }
+  else
+    {
+    InkParser  parser;
+
+    pScript = parser.Parse (parserDataIn.AsChar ());
+    };
 
   listScripts.PushBack (pScript);
   pScript->strName.Set (pszNameIn, TRUE);
@@ -312,6 +312,53 @@ TEST (InkScript, End)
 
   };
 
+//------------------------------------------------------------------------------
+TEST (InkScript, VisitCounts)
+  {
+  ValueRegistrySimple  registry;
+  InkExecute           exec;
+  exec.SetRegistry (&registry);
+
+  // Test: relative stitch divert, and visits written to the registry
+  exec.Parse ("=== knot_one ===\nLine One\n-> stitch_b\n= stitch_a\nWrong\n= stitch_b\nLine Two\n-> knot_one.stitch_a\n");
+
+  ASSERT_STREQ (exec.Continue (), "Line One");
+  ASSERT_EQ    (registry.GetInt ("knot_one"), 1);
+  ASSERT_STREQ (exec.Continue (), "Line Two");
+  ASSERT_EQ    (registry.GetInt ("knot_one.stitch_b"), 1);
+  ASSERT_EQ    (registry.GetInt ("knot_one.stitch_a"), 0);
+  ASSERT_STREQ (exec.Continue (), "Wrong");
+  ASSERT_EQ    (registry.GetInt ("knot_one.stitch_a"), 1);
+  ASSERT_EQ    (exec.GetScript()->GetVisitCount ("knot_one.stitch_a"), 1);
+
+  // Test: expressions see visits made earlier in the same Continue
+  exec.Parse ("=== knot_one ===\n~ seen = knot_one\nSeen {seen}\n");
+  ASSERT_STREQ (exec.Continue (), "Seen 2");
+
+  // Test: counts changed in the registry are picked up on reload
+  InkScript *  pScript = exec.GetScript ();
+  ASSERT_EQ    (pScript->GetFunctionIndex ("missing"), -1);
+  ASSERT_EQ    (pScript->GetLabelIndex ("knot_one"), 1);
+  registry.SetInt ("knot_one", 10);
+  pScript->LoadVisitCounts (&registry);
+  ASSERT_EQ    (pScript->GetVisitCount ("knot_one"), 10);
+
+  // Test: a long chain is linked all the way to its end without recursing per element
+  InkDivert *  pChain = new InkDivert ("knot_one");
+  InkElem *    pLast  = pChain;
+  for (INT  iIndex = 0; iIndex < 100000; ++iIndex)
+    {
+    pLast->AppendElem (new InkDivert ("END"));
+    pLast = pLast->GetNext ();
+    };
+  pLast->AppendElem (new InkDivert ("knot_one"));
+  pChain->Link (pScript, NULL);
+  ASSERT_EQ    (pChain->GetTarget (), 1);
+  ASSERT_EQ    (dynamic_cast<InkDivert*>(pChain->GetNext ())->GetTarget (), -1);
+  ASSERT_EQ    (dynamic_cast<InkDivert*>(pLast->GetNext ())->GetTarget (), 1);
+  delete (pChain);
+  };
+
 //------------------------------------------------------------------------------
 TEST (InkScript, Tags)
   {
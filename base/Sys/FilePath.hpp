@@ -190,6 +190,12 @@ class FilePath
 
     static UINT   GetFileSize    (const char *  pszPathIn);
 
+                                 /** @brief Query when a file on disk was last modified.
+                                     @param pszPathIn Path to the file.
+                                     @return Modification time in nanoseconds since the epoch, or 0 if the file can't be read.  Resolution depends on the platform.
+                                 */
+    static INT64  GetFileModTime (const char *  pszPathIn);
+
     static VOID   MakeDir        (const char *  pszPathIn);
 
     static const char *  GetCwd  (VOID);
@@ -340,6 +340,22 @@ UINT  FilePath::GetFileSize  (const char *  pszPathIn)
   return (ulFileSize);
   };
 
+//------------------------------------------------------------------------------
+INT64  FilePath::GetFileModTime  (const char *  pszPathIn)
+  {
+  // packaged assets have no modification time, so only local storage is checked.
+  if (strncmp (pszPathIn, URI_PREFIX_FILE, URI_PREFIX_FILE_LENGTH) != 0) return (0);
+
+  RStr  strFullPath = filePath_localStoragePath;
+  strFullPath += DIRECTORY_SEPARATOR_STR;
+  strFullPath += &pszPathIn[URI_PREFIX_FILE_LENGTH];
+
+  struct stat  statInfo;
+  if (stat (strFullPath.AsChar (), &statInfo) != 0) return (0);
+
+  return ((INT64) statInfo.st_mtime * 1000000000LL);
+  };
+
 
 
 //------------------------------------------------------------------------------
@@ -303,6 +303,19 @@ UINT  FilePath::GetFileSize  (const char *  pszPathIn)
   return (ulFileSize);
   };
 
+//------------------------------------------------------------------------------
+INT64  FilePath::GetFileModTime  (const char *  pszPathIn)
+  {
+  struct stat  statInfo;
+
+  RStr  strFullPath;
+  if (FPLinuxExpandFilename (pszPathIn, strFullPath) != EStatus::kSuccess) return (0);
+
+  if (stat (strFullPath.AsChar (), &statInfo) != 0) return (0);
+
+  return ((INT64) statInfo.st_mtim.tv_sec * 1000000000LL + (INT64) statInfo.st_mtim.tv_nsec);
+  };
+
 
 //------------------------------------------------------------------------------
 VOID FilePath::MakeDir (const char *  pszPathIn)
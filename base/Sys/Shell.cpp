@@ -11,6 +11,8 @@ ASSERTFILE (__FILE__);
 
 #include "Sys/Shell.hpp"
 #include "Sys/Timer.hpp"
+#include "Util/ChangeBatch.hpp"
+#include "Composite/World.hpp"
 #include "Gfx/GLUtil.hpp"
 //#include "RGlobal.hpp"
 
@@ -291,6 +293,16 @@ EStatus Shell::StaticGameLoop   (UINT32  uMillisecondDeltaIn)
   // called once per 1/target_fps seconds by the GameLoopTimer
   sigOnFixedUpdate (uMillisecondDeltaIn);
 
+  // deliver the value changes batched during this update, once per changed value.
+  ChangeBatch::Flush ();
+
+  // solve the world matrices of everything that moved during this update.
+  World *  pWorld = World::ExistingInstance ();
+  if (pWorld != NULL)
+    {
+    pWorld->UpdateTransforms ();
+    };
+
   //if (pshellSingleton != NULL)
   //  {
   //  return (pshellSingleton->GameLoop (uMillisecondDeltaIn));
@@ -107,6 +107,19 @@ VOID  TimeTracker::UpdateNetworkTime (VOID)
   };
 
 
+//------------------------------------------------------------------------------
+//  Stop Watch
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+INT64  StopWatch::GetTimeUs (VOID)
+  {
+  struct timespec  tsNow;
+  clock_gettime (CLOCK_MONOTONIC, &tsNow);
+  return (INT64 (tsNow.tv_sec) * INT64 (1000000) + INT64 (tsNow.tv_nsec / 1000));
+  };
+
+
 //------------------------------------------------------------------------------
 //  TimerBase
 //------------------------------------------------------------------------------
@@ -88,6 +88,32 @@ class TimeTracker
 
   };
 
+//------------------------------------------------------------------------------
+class StopWatch
+  {
+  // Microsecond wall-clock timer used for profiling and benchmarks.
+
+  private:
+
+    INT64         iStartUs;
+    INT64         iElapsedUs;
+
+  public:
+                          StopWatch            ()      {iStartUs = 0; iElapsedUs = 0;};
+
+                          ~StopWatch           ()      {};
+
+    static INT64          GetTimeUs            (VOID);
+
+    VOID                  Start                (VOID)  {iStartUs = GetTimeUs ();};
+
+    INT64                 Stop                 (VOID)  {iElapsedUs = GetTimeUs () - iStartUs; return (iElapsedUs);};
+
+    INT64                 GetElapsedUs         (VOID)  {return (iElapsedUs);};
+
+    DOUBLE                GetElapsedMs         (VOID)  {return (DOUBLE (iElapsedUs) / 1000.0);};
+  };
+
 //------------------------------------------------------------------------------
 class TimerBase
   {
@@ -0,0 +1,63 @@
+/* -----------------------------------------------------------------
+                            Unit Test Main
+
+     Helpers shared by the unit tests and provided by main_unittest.cpp.
+   Timing loops only run when the test binary is run with --benchmarks,
+   so the default run stays a quick, quiet correctness pass.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef UNITTESTMAIN_HPP
+#define UNITTESTMAIN_HPP
+
+#include "Sys/Types.hpp"
+
+/**
+  @addtogroup base
+  @{
+*/
+
+                  /** @brief  True if the test binary was run with --benchmarks.  Benchmark tests return
+                              early, and mixed tests skip their timing loops, when this is false.
+                      @return True if timing loops should run and print their results.
+                  */
+BOOL  UnitTestBenchmarks  (VOID);
+
+                  /** @brief  printf a benchmark result, but only when run with --benchmarks.
+                      @param  szFormatIn printf style format string.
+                      @return None
+                  */
+VOID  BenchmarkPrintf     (const char *  szFormatIn, ...);
+
+/** @} */ // end of base group
+
+#endif // UNITTESTMAIN_HPP
@@ -0,0 +1,145 @@
+/* -----------------------------------------------------------------
+                            Worker Pool
+
+     This module runs jobs on a fixed set of background threads.
+   Jobs are plain function pointers with a context pointer, and the
+   caller waits for the whole batch to finish.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Sys/WorkerPool.hpp"
+
+//-----------------------------------------------------------------------------
+//  WorkerPool
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+WorkerPool::WorkerPool  (INT  iNumThreadsIn)
+  {
+  iNumThreads = (iNumThreadsIn > 0) ? iNumThreadsIn : DefaultThreadCount ();
+  iQueueHead  = 0;
+  iNumRunning = 0;
+  bShutdown   = FALSE;
+
+  pThreads = new std::thread [iNumThreads];
+  for (INT  iIndex = 0; iIndex < iNumThreads; ++iIndex)
+    {
+    pThreads [iIndex] = std::thread (&WorkerPool::WorkerLoop, this);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+WorkerPool::~WorkerPool  ()
+  {
+    {
+    std::lock_guard<std::mutex>  lock (mutexQueue);
+    bShutdown = TRUE;
+    };
+  condJobReady.notify_all ();
+
+  for (INT  iIndex = 0; iIndex < iNumThreads; ++iIndex)
+    {
+    pThreads [iIndex].join ();
+    };
+  delete [] pThreads;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  WorkerPool::Submit  (JobFn   fnJobIn,
+                           VOID *  pContextIn)
+  {
+  Job  jobNew;
+  jobNew.fnJob    = fnJobIn;
+  jobNew.pContext = pContextIn;
+
+    {
+    std::lock_guard<std::mutex>  lock (mutexQueue);
+    aQueue.Append (jobNew);
+    };
+  condJobReady.notify_one ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  WorkerPool::Wait  (VOID)
+  {
+  std::unique_lock<std::mutex>  lock (mutexQueue);
+  while ((iQueueHead < aQueue.Length ()) || (iNumRunning > 0))
+    {
+    condIdle.wait (lock);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  WorkerPool::WorkerLoop  (VOID)
+  {
+  std::unique_lock<std::mutex>  lock (mutexQueue);
+
+  while (TRUE)
+    {
+    // queued jobs are finished before a shutdown is honored.
+    while ((iQueueHead >= aQueue.Length ()) && !bShutdown)
+      {
+      condJobReady.wait (lock);
+      };
+    if (iQueueHead >= aQueue.Length ()) break;
+
+    Job  jobCurr = aQueue [iQueueHead];
+    ++iQueueHead;
+    if (iQueueHead == aQueue.Length ())
+      {
+      // drained, so reuse the storage from the start.
+      aQueue.Clear ();
+      iQueueHead = 0;
+      };
+    ++iNumRunning;
+
+    lock.unlock ();
+    jobCurr.fnJob (jobCurr.pContext);
+    lock.lock ();
+
+    --iNumRunning;
+    if ((iNumRunning == 0) && (iQueueHead >= aQueue.Length ()))
+      {
+      condIdle.notify_all ();
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+INT  WorkerPool::DefaultThreadCount  (VOID)
+  {
+  INT  iNumCores = (INT) std::thread::hardware_concurrency ();
+  return ((iNumCores > 0) ? iNumCores : 1);
+  };
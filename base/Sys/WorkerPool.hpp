@@ -0,0 +1,128 @@
+/* -----------------------------------------------------------------
+                            Worker Pool
+
+     This module runs jobs on a fixed set of background threads.
+   Jobs are plain function pointers with a context pointer, and the
+   caller waits for the whole batch to finish.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Sys/Types.hpp"
+#include "Containers/TArray.hpp"
+
+/**
+  Submit () queues a job, and the first idle thread runs it.  Jobs run in
+  submission order, but may finish in any order.  Wait () blocks until every
+  job submitted so far has finished, so the usual pattern is to give each job
+  its own output slot, submit them all, Wait (), and then combine the slots
+  on the calling thread.
+
+  Jobs must not touch state shared with other jobs or the calling thread
+  without their own locking.  Most of the engine (signals, ChangeBatch,
+  the static return buffers in FilePath and RStrParser) is not thread safe.
+  */
+
+//-----------------------------------------------------------------------------
+class WorkerPool
+  {
+  public:
+    /// A unit of work.  pContextIn is the pointer passed to Submit ().
+    typedef VOID (*JobFn) (VOID *  pContextIn);
+
+  private:
+    struct Job
+      {
+      JobFn    fnJob;
+      VOID *   pContext;
+      };
+
+    std::thread *             pThreads;
+    INT                       iNumThreads;
+
+    std::mutex                mutexQueue;
+    std::condition_variable   condJobReady;  ///< Signalled when a job is queued or the pool shuts down
+    std::condition_variable   condIdle;      ///< Signalled when the last outstanding job finishes
+    TArray<Job>               aQueue;        ///< Jobs waiting to run, from iQueueHead on
+    INT                       iQueueHead;
+    INT                       iNumRunning;   ///< Jobs taken off the queue but not yet finished
+    BOOL                      bShutdown;
+
+  private:
+
+    // Not copyable.
+                             WorkerPool     (const WorkerPool &  poolIn);
+    WorkerPool &             operator=      (const WorkerPool &  poolIn);
+
+    VOID                     WorkerLoop     (VOID);
+
+  public:
+
+                             /** @brief  Constructor.  Starts the threads.
+                                 @param  iNumThreadsIn Number of threads, or zero or less for DefaultThreadCount ().
+                                 @return None
+                             */
+                             WorkerPool     (INT  iNumThreadsIn = 0);
+
+                             /** @brief  Destructor.  Finishes any queued jobs, then joins the threads.
+                                 @return None
+                             */
+                             ~WorkerPool    ();
+
+    INT                      NumThreads     (VOID) const            {return (iNumThreads);};
+
+                             /** @brief  Queue a job to run on the next idle thread.
+                                 @param  fnJobIn The function to run.
+                                 @param  pContextIn Passed to fnJobIn.
+                                 @return None
+                             */
+    VOID                     Submit         (JobFn   fnJobIn,
+                                             VOID *  pContextIn);
+
+                             /** @brief  Block until every submitted job has finished.
+                                 @return None
+                             */
+    VOID                     Wait           (VOID);
+
+                             /** @brief  Query the number of hardware threads.
+                                 @return The number of cores reported by the system, or 1 if unknown.
+                             */
+    static INT               DefaultThreadCount (VOID);
+  };
+
+#endif // WORKERPOOL_HPP
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Sys/WorkerPool.hpp"
+
+// NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
+
+
+//------------------------------------------------------------------------------
+struct SumJob
+  {
+  INT     iStart;
+  INT     iCount;
+  INT64   iSum;
+
+  static VOID  Run  (VOID *  pJobIn)  {
+                                      SumJob *  pJob = static_cast<SumJob *>(pJobIn);
+                                      pJob->iSum = 0;
+                                      for (INT  iIndex = 0; iIndex < pJob->iCount; ++iIndex)
+                                        {
+                                        pJob->iSum += pJob->iStart + iIndex;
+                                        };
+                                      };
+  };
+
+//------------------------------------------------------------------------------
+TEST (WorkerPool, Basic)
+  {
+  ASSERT_GE (WorkerPool::DefaultThreadCount (), 1);
+
+  const INT  kNumJobs = 100;
+  SumJob     aJobs [kNumJobs];
+
+  WorkerPool  pool (4);
+  ASSERT_EQ (pool.NumThreads (), 4);
+
+  // the pool can be waited on and reused for several batches.
+  for (INT  iBatch = 0; iBatch < 3; ++iBatch)
+    {
+    for (INT  iJob = 0; iJob < kNumJobs; ++iJob)
+      {
+      aJobs [iJob].iStart = iJob * 1000;
+      aJobs [iJob].iCount = 1000 + iBatch;
+      aJobs [iJob].iSum   = -1;
+      pool.Submit (SumJob::Run, &aJobs [iJob]);
+      };
+    pool.Wait ();
+
+    for (INT  iJob = 0; iJob < kNumJobs; ++iJob)
+      {
+      INT64  iFirst = iJob * 1000;
+      INT64  iLast  = iFirst + 1000 + iBatch - 1;
+      ASSERT_EQ (aJobs [iJob].iSum, (iFirst + iLast) * (1000 + iBatch) / 2);
+      };
+    };
+
+  // waiting with nothing queued returns at once.
+  pool.Wait ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (WorkerPool, DestroyFinishesQueue)
+  {
+  const INT  kNumJobs = 50;
+  SumJob     aJobs [kNumJobs];
+
+    {
+    WorkerPool  pool (2);
+    for (INT  iJob = 0; iJob < kNumJobs; ++iJob)
+      {
+      aJobs [iJob].iStart = 1;
+      aJobs [iJob].iCount = 10;
+      aJobs [iJob].iSum   = -1;
+      pool.Submit (SumJob::Run, &aJobs [iJob]);
+      };
+    };
+
+  for (INT  iJob = 0; iJob < kNumJobs; ++iJob)
+    {
+    ASSERT_EQ (aJobs [iJob].iSum, 55);
+    };
+  };
@@ -2,7 +2,30 @@
 #include "Debug.hpp"
 ASSERTFILE (__FILE__);
 #include "Script/ExpressionDefaultFn.hpp"
+#include "Sys/UnitTestMain.hpp"
+#include <stdarg.h>
+#include <string.h>
 
+static BOOL  bBenchmarks = FALSE;
+
+//-----------------------------------------------------------------------------
+BOOL  UnitTestBenchmarks  (VOID)
+  {
+  return (bBenchmarks);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  BenchmarkPrintf  (const char *  szFormatIn, ...)
+  {
+  if (! bBenchmarks) return;
+
+  va_list  vaArgs;
+  va_start (vaArgs, szFormatIn);
+  vprintf (szFormatIn, vaArgs);
+  va_end (vaArgs);
+  };
+
+//-----------------------------------------------------------------------------
 int main(int argc, char **argv)
   {
   DebugMessagesFactory::Initialize ();
@@ -12,6 +35,12 @@ int main(int argc, char **argv)
 
   testing::InitGoogleTest(&argc, argv);
 
+  // gtest removes its own flags, so anything left over is ours.
+  for (int  iArg = 1; iArg < argc; ++iArg)
+    {
+    if (strcmp (argv [iArg], "--benchmarks") == 0) {bBenchmarks = TRUE;};
+    };
+
   int result = RUN_ALL_TESTS();
 
   Expression::UnregisterAllFunctions ();
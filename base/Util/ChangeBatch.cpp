@@ -0,0 +1,176 @@
+/* -----------------------------------------------------------------
+                            Change Batch
+
+     This module optionally defers change notifications so that
+   several changes to the same value within a frame are delivered
+   to listeners once, when the batch is flushed.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__);
+
+#include "Util/ChangeBatch.hpp"
+
+const INT                            ChangeBatch::kNotPending;
+const INT                            ChangeBatch::kMaxFlushPasses;
+
+UINT32                               ChangeBatch::uBatchMask    = ChangeBatch::kNone;
+TArray<ChangeBatch::Entry>           ChangeBatch::aPending;
+std::atomic<INT64>                   ChangeBatch::iNumRaised    (0);
+std::atomic<INT64>                   ChangeBatch::iNumDeferred  (0);
+std::atomic<INT64>                   ChangeBatch::iNumDelivered (0);
+
+//-----------------------------------------------------------------------------
+//  ChangeBatch
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+VOID  ChangeBatch::SetBatching  (UINT32  uCategoryMaskIn)
+  {
+  // nothing tracks which category a pending entry came from, so turning any
+  //  category off delivers everything that is waiting.
+  BOOL  bTurningOff = ((uBatchMask & ~uCategoryMaskIn) != 0);
+
+  uBatchMask = uCategoryMaskIn;
+  if (bTurningOff)
+    {
+    Flush ();
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ChangeBatch::Defer  (VOID *     pObjectIn,
+                           INT &      iSlotInOut,
+                           DeliverFn  fnDeliverIn,
+                           BOOL       bUpdatingIn)
+  {
+  iNumDeferred.fetch_add (1, std::memory_order_relaxed);
+
+  // the slot is only trusted if it still points back at this object, since
+  //  objects that are copied carry their slot along with them.
+  if ((iSlotInOut >= 0) && (iSlotInOut < aPending.Length ()) && (aPending [iSlotInOut].pObject == pObjectIn))
+    {
+    aPending [iSlotInOut].bUpdating = (aPending [iSlotInOut].bUpdating && bUpdatingIn);
+    return;
+    };
+
+  Entry  entryNew;
+  entryNew.pObject   = pObjectIn;
+  entryNew.fnDeliver = fnDeliverIn;
+  entryNew.bUpdating = bUpdatingIn;
+  entryNew.piSlot    = &iSlotInOut;
+
+  iSlotInOut = aPending.Length ();
+  aPending.Append (entryNew);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ChangeBatch::Cancel  (VOID *  pObjectIn,
+                            INT &   iSlotInOut)
+  {
+  if ((iSlotInOut >= 0) && (iSlotInOut < aPending.Length ()) && (aPending [iSlotInOut].pObject == pObjectIn))
+    {
+    aPending [iSlotInOut].pObject = NULL;
+    };
+  iSlotInOut = kNotPending;
+  };
+
+//-----------------------------------------------------------------------------
+INT  ChangeBatch::Flush  (VOID)
+  {
+  INT  iNumFlushed = 0;
+  INT  iStart      = 0;
+
+  // listeners may raise more changes, which are appended past the entries of
+  //  the current pass and delivered by the next one.
+  for (INT  iPass = 0; iPass < kMaxFlushPasses; ++iPass)
+    {
+    INT  iEnd = aPending.Length ();
+    if (iStart == iEnd) break;
+
+    for (INT  iIndex = iStart; iIndex < iEnd; ++iIndex)
+      {
+      // copy the entry, since delivering can grow and reallocate the array.
+      Entry  entryCurr = aPending [iIndex];
+      if (entryCurr.pObject == NULL) continue;
+
+      aPending [iIndex].pObject = NULL;
+      *entryCurr.piSlot = kNotPending;
+      ++iNumFlushed;
+      entryCurr.fnDeliver (entryCurr.pObject, entryCurr.bUpdating);
+      };
+    iStart = iEnd;
+    };
+
+  // anything raised during the last pass waits for the next flush.
+  INT  iNumLeft = aPending.Length () - iStart;
+  if (iNumLeft > 0)
+    {
+    DBG_WARNING ("ChangeBatch::Flush () - %d changes still pending after %d passes.  Listeners may be changing each other in a loop.", iNumLeft, kMaxFlushPasses);
+    };
+  for (INT  iIndex = 0; iIndex < iNumLeft; ++iIndex)
+    {
+    aPending [iIndex] = aPending [iStart + iIndex];
+    if (aPending [iIndex].pObject != NULL)
+      {
+      *aPending [iIndex].piSlot = iIndex;
+      };
+    };
+  aPending.SetLength (iNumLeft);
+
+  iNumDelivered.fetch_add (iNumFlushed, std::memory_order_relaxed);
+  return (iNumFlushed);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ChangeBatch::GetStats  (Stats &  statsOut)
+  {
+  statsOut.iNumRaised    = iNumRaised;
+  statsOut.iNumDeferred  = iNumDeferred;
+  statsOut.iNumDelivered = iNumDelivered;
+
+  statsOut.iNumPending = 0;
+  for (INT  iIndex = 0; iIndex < aPending.Length (); ++iIndex)
+    {
+    if (aPending [iIndex].pObject != NULL) {++statsOut.iNumPending;};
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ChangeBatch::ResetStats  (VOID)
+  {
+  iNumRaised    = 0;
+  iNumDeferred  = 0;
+  iNumDelivered = 0;
+  };
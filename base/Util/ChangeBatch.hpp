@@ -0,0 +1,181 @@
+/* -----------------------------------------------------------------
+                            Change Batch
+
+     This module optionally defers change notifications so that
+   several changes to the same value within a frame are delivered
+   to listeners once, when the batch is flushed.
+
+   ----------------------------------------------------------------- */
+
+// contact:  mduffor@gmail.com
+
+
+
+
+// Modified BSD License:
+//
+// Copyright (c) 2017, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+
+#ifndef CHANGEBATCH_HPP
+#define CHANGEBATCH_HPP
+
+#include <atomic>
+
+#include "Sys/Types.hpp"
+#include "Containers/TArray.hpp"
+
+/**
+  Objects that raise change notifications call Raise () instead of firing
+  their signal directly.  When batching is off for the object's category,
+  Raise () delivers at once.  When it is on, the object is added to the
+  pending list (once, however many times it changes) and delivered by the
+  next Flush ().  Shell::StaticGameLoop flushes once per logic update.
+
+  Each object keeps an INT holding its slot in the pending list, so repeat
+  changes are coalesced without a search, and a deleted object can take
+  itself out of the list with Cancel ().
+
+  Listeners that run during Flush () may raise more changes.  Those are
+  delivered by the same Flush (), for up to kMaxFlushPasses rounds; anything
+  left after that waits for the next Flush ().
+
+  Batching and Flush () belong to the main thread.  Objects that only live on
+  a worker thread may still Raise () while batching is off, so the counters
+  are atomic.  They are only statistics, so they are counted relaxed to keep
+  barriers off the set path.
+  */
+
+//-----------------------------------------------------------------------------
+class ChangeBatch
+  {
+  public:
+    /// Categories of notification that can be batched.  Pass a mask of these to SetBatching.
+    enum ECategory {kNone       = 0x00,
+                    kValueElem  = 0x01,   ///< ValueElem::sigOnChanged
+                    kAttr       = 0x02,   ///< Attr::sigOnChanged
+                    kAll        = 0x03};
+
+    static const INT   kNotPending     = -1;
+    static const INT   kMaxFlushPasses = 8;
+
+    /// Delivers a notification.  bUpdatingIn is only TRUE if every coalesced change was an updating one.
+    typedef VOID (*DeliverFn) (VOID *  pObjectIn,
+                               BOOL    bUpdatingIn);
+
+    struct Stats
+      {
+      INT64  iNumRaised;     ///< Changes reported through Raise ()
+      INT64  iNumDeferred;   ///< Raised changes that were queued rather than delivered at once
+      INT64  iNumDelivered;  ///< Notifications actually sent to listeners
+      INT    iNumPending;    ///< Objects waiting for the next Flush ()
+      };
+
+  private:
+    struct Entry
+      {
+      VOID *     pObject;     ///< NULL once cancelled
+      DeliverFn  fnDeliver;
+      BOOL       bUpdating;
+      INT *      piSlot;      ///< The object's pending slot, reset when delivered
+      };
+
+    static UINT32          uBatchMask;
+    static TArray<Entry>   aPending;
+    static std::atomic<INT64>  iNumRaised;
+    static std::atomic<INT64>  iNumDeferred;
+    static std::atomic<INT64>  iNumDelivered;
+
+  public:
+
+                           /** @brief  Choose which categories of notification are deferred until Flush ().
+                                       Categories that are turned off are flushed right away.
+                               @param  uCategoryMaskIn Mask of ECategory values.
+                               @return None
+                           */
+    static VOID            SetBatching    (UINT32  uCategoryMaskIn);
+
+                           /** @brief  Query which categories of notification are deferred.
+                               @return Mask of ECategory values.
+                           */
+    static UINT32          Batching       (VOID)                       {return (uBatchMask);};
+
+                           /** @brief  Report that an object changed.  Delivers now, or queues the object if its
+                                       category is batched and it isn't queued already.
+                               @param  eCategoryIn The kind of object that changed.
+                               @param  pObjectIn The object that changed.  Passed back to fnDeliverIn.
+                               @param  iSlotInOut The object's pending slot.  Initialize it to kNotPending.
+                               @param  fnDeliverIn Fires the object's change signal.
+                               @param  bUpdatingIn Passed to fnDeliverIn.
+                               @return None
+                           */
+    static VOID            Raise          (ECategory  eCategoryIn,
+                                           VOID *     pObjectIn,
+                                           INT &      iSlotInOut,
+                                           DeliverFn  fnDeliverIn,
+                                           BOOL       bUpdatingIn)    {
+                                                                      iNumRaised.fetch_add (1, std::memory_order_relaxed);
+                                                                      if ((uBatchMask & eCategoryIn) == 0)
+                                                                        {
+                                                                        iNumDelivered.fetch_add (1, std::memory_order_relaxed);
+                                                                        fnDeliverIn (pObjectIn, bUpdatingIn);
+                                                                        return;
+                                                                        };
+                                                                      Defer (pObjectIn, iSlotInOut, fnDeliverIn, bUpdatingIn);
+                                                                      };
+
+                           /** @brief  Take an object out of the pending list without notifying.  Call from the
+                                       destructor of any object that uses Raise.
+                               @param  pObjectIn The object being deleted.
+                               @param  iSlotInOut The object's pending slot.
+                               @return None
+                           */
+    static VOID            Cancel         (VOID *  pObjectIn,
+                                           INT &   iSlotInOut);
+
+                           /** @brief  Deliver all pending notifications.
+                               @return Number of notifications delivered.
+                           */
+    static INT             Flush          (VOID);
+
+                           /** @brief  Get the notification counters.
+                               @param  statsOut Receives the counters.
+                               @return None
+                           */
+    static VOID            GetStats       (Stats &  statsOut);
+
+                           /** @brief  Zero the raised, deferred and delivered counters.
+                               @return None
+                           */
+    static VOID            ResetStats     (VOID);
+
+  private:
+
+    static VOID            Defer          (VOID *     pObjectIn,
+                                           INT &      iSlotInOut,
+                                           DeliverFn  fnDeliverIn,
+                                           BOOL       bUpdatingIn);
+  };
+
+#endif // CHANGEBATCH_HPP
@@ -362,6 +362,12 @@ public:
                                  */
     HASH_T        GetHash        (VOID)          {return (uHash);};
 
+                                 /** @brief Store a hash that was calculated earlier, such as one saved alongside the string, instead of calling CalcHash.
+                                     @param uHashIn The value CalcHash would return for the current contents of the string.
+                                     @return None
+                                 */
+    VOID          SetHashValue   (HASH_T  uHashIn)  {uHash = uHashIn;};
+
                                  /** @brief Compares the hash value of two strings.  It is up to the caller that CalcHash has been called on each string before this call.
                                      @param strCompareIn The string whose hash value we will compare against.
                                      @return True if the hash values match, false if not.  No other checks are made, so as to keep this call fast.
@@ -701,6 +701,531 @@ VOID  RegExDeque::DebugPrint  (VOID)
 
 
 
+//------------------------------------------------------------------------
+// RegExDfa
+//------------------------------------------------------------------------
+
+// NOTE:  The DFA reproduces the NFA simulation in RegEx::MatchNfa exactly,
+//          including its leftmost-longest search and its handling of the
+//          end of the buffer.  The only NFA feature it can't reproduce is
+//          the per-state repeat counter, so counted repeats stay on the NFA.
+
+//------------------------------------------------------------------------
+static BOOL  MatchAgainstByte  (RegExMatch &  matchIn,
+                                INT           iMatchStateIn,
+                                INT           iContextIn,
+                                INT           iCharIn)
+  {
+  // iCharIn of -1 is the end of the buffer, where the NFA only checks MatchOnLineEnd
+  if (iCharIn < 0)
+    {
+    return (matchIn.MatchOnLineEnd ());
+    };
+
+  // build a tiny buffer so IsMatch sees the same previous character and
+  //  buffer start that it would see in the source string.
+  char  achBuffer [3];
+  achBuffer [0] = (iContextIn == RegExDfa::kContextLineStart) ? '\n' : ' ';
+  achBuffer [1] = char (iCharIn);
+  achBuffer [2] = '\0';
+
+  const char *  pchStart = (iContextIn == RegExDfa::kContextBufferStart) ? &achBuffer [1] : &achBuffer [0];
+
+  return (matchIn.IsMatch (iMatchStateIn, &achBuffer [1], pchStart, &achBuffer [2]));
+  };
+
+//------------------------------------------------------------------------
+RegExDfa::RegExDfa ()
+  {
+  bEnabled      = TRUE;
+  iMaxStates    = kDefaultMaxStates;
+  iStamp        = 0;
+  uNumOverflows = 0;
+  Reset ();
+  };
+
+//------------------------------------------------------------------------
+RegExDfa::~RegExDfa ()
+  {
+  };
+
+//------------------------------------------------------------------------
+RegExDfa::RegExDfa (const RegExDfa &  dfaIn)
+  {
+  bEnabled      = dfaIn.bEnabled;
+  iMaxStates    = dfaIn.iMaxStates;
+  iStamp        = 0;
+  uNumOverflows = 0;
+  Reset ();
+  };
+
+//------------------------------------------------------------------------
+RegExDfa &  RegExDfa::operator=  (const RegExDfa &  dfaIn)
+  {
+  bEnabled   = dfaIn.bEnabled;
+  iMaxStates = dfaIn.iMaxStates;
+  Reset ();
+  return (*this);
+  };
+
+//------------------------------------------------------------------------
+VOID  RegExDfa::Reset  (VOID)
+  {
+  bPrepared     = FALSE;
+  bUsable       = FALSE;
+  bTrackContext = FALSE;
+  iNumClasses   = 0;
+  iNumStates    = 0;
+  aiInfo.Clear ();
+  aiKernels.Clear ();
+  aiTransitions.Clear ();
+  for (INT  iContext = 0; iContext < kNumContexts; ++iContext)
+    {
+    aiStartState [iContext] = -1;
+    };
+  };
+
+//------------------------------------------------------------------------
+VOID  RegExDfa::FlushStates  (VOID)
+  {
+  iNumStates = 0;
+  aiInfo.Clear ();
+  aiKernels.Clear ();
+  aiTransitions.Clear ();
+  for (INT  iContext = 0; iContext < kNumContexts; ++iContext)
+    {
+    aiStartState [iContext] = -1;
+    };
+
+  // state zero is the dead state.  It has an empty kernel and loops to itself without accepting.
+  aiInfo.Append (0);  // kInfoKernelStart
+  aiInfo.Append (0);  // kInfoKernelCount
+  aiInfo.Append (kContextOther);
+  aiInfo.Append (0);  // kInfoHash
+  aiInfo.Append (0);  // kInfoEndAccept
+  for (INT  iClass = 0; iClass < iNumClasses; ++iClass)
+    {
+    aiTransitions.Append (0);
+    };
+  iNumStates = 1;
+  };
+
+//------------------------------------------------------------------------
+BOOL  RegExDfa::IsSupported  (RegExMatch &  matchIn)
+  {
+  switch (matchIn.eMatchType)
+    {
+    case RegExMatch::kRepeat:
+         // The NFA counts visits to a repeat state across all threads, which a DFA
+         //  can't model.  Only unbounded repeats with no minimum ignore that count.
+         return ((matchIn.GetMatchMin () <= 0) && (matchIn.GetMatchMax () == -1));
+
+    case RegExMatch::kWordBoundary:
+    case RegExMatch::kWordInside:
+    case RegExMatch::kWordBegin:
+    case RegExMatch::kWordEnd:
+         // these look at the previous character, even at the start of the buffer.
+         return (FALSE);
+
+    default:
+         break;
+    };
+  return (TRUE);
+  };
+
+//------------------------------------------------------------------------
+BOOL  RegExDfa::Prepare  (TArray<RegExMatch> &  arrayStatesIn)
+  {
+  if (bPrepared)
+    {
+    return (bUsable);
+    };
+  bPrepared     = TRUE;
+  bUsable       = FALSE;
+  bTrackContext = FALSE;
+
+  INT  iNumNfaStates = arrayStatesIn.Length ();
+  if (iNumNfaStates == 0)
+    {
+    return (FALSE);
+    };
+
+  aiVisited.SetLength  (iNumNfaStates);
+  aiInKernel.SetLength (iNumNfaStates);
+
+  // walk the reachable states, making sure each one can be run as a DFA,
+  //  and collect the states that test characters.
+  IntArray  aiTestStates;
+
+  ++iStamp;
+  aiStack.Clear ();
+  aiStack.Append (arrayStatesIn [0].GetNextOne ());
+  while (aiStack.Length () > 0)
+    {
+    INT  iIndex = aiStack [aiStack.Length () - 1];
+    aiStack.SetLength (aiStack.Length () - 1);
+
+    if ((iIndex < 0) || (iIndex >= iNumNfaStates))
+      {
+      return (FALSE);
+      };
+    if ((iIndex == 0) || (aiVisited [iIndex] == iStamp))
+      {
+      continue;
+      };
+    aiVisited [iIndex] = iStamp;
+
+    RegExMatch &  matchCurr = arrayStatesIn [iIndex];
+    if (! IsSupported (matchCurr))
+      {
+      return (FALSE);
+      };
+    if ((matchCurr.eMatchType == RegExMatch::kLineStart) ||
+        (matchCurr.eMatchType == RegExMatch::kBufferStart))
+      {
+      bTrackContext = TRUE;
+      };
+
+    aiStack.Append (matchCurr.GetNextOne ());
+    if (matchCurr.IsOr () || matchCurr.IsRepeat ())
+      {
+      aiStack.Append (matchCurr.GetNextTwo ());
+      }
+    else if (! matchCurr.IsNull ())
+      {
+      aiTestStates.Append (iIndex);
+      };
+    };
+
+  // Group the input bytes into classes.  Two bytes share a class if every
+  //  testing state gives the same result for both.  With context tracking the
+  //  newline also gets its own class, since it changes the context.
+  INT       iNumTests = aiTestStates.Length ();
+  INT       iRowSize  = iNumTests + 1;
+  IntArray  aiRows    (256 * iRowSize);
+
+  for (INT  iByte = 0; iByte < 256; ++iByte)
+    {
+    INT32 *  piRow = aiRows.GetRawArray () + iByte * iRowSize;
+    for (INT  iTest = 0; iTest < iNumTests; ++iTest)
+      {
+      INT  iMatchState = aiTestStates [iTest];
+      piRow [iTest] = MatchAgainstByte (arrayStatesIn [iMatchState], iMatchState, kContextOther, iByte);
+      };
+    piRow [iNumTests] = bTrackContext && (iByte == '\n');
+    };
+
+  iNumClasses = 0;
+  for (INT  iByte = 0; iByte < 256; ++iByte)
+    {
+    const INT32 *  piRow   = aiRows.GetRawArray () + iByte * iRowSize;
+    INT            iClass  = 0;
+    for (; iClass < iNumClasses; ++iClass)
+      {
+      const INT32 *  piRep = aiRows.GetRawArray () + auClassRep [iClass] * iRowSize;
+      if (memcmp (piRow, piRep, sizeof (INT32) * iRowSize) == 0)
+        {
+        break;
+        };
+      };
+    if (iClass == iNumClasses)
+      {
+      auClassRep [iNumClasses++] = UINT8 (iByte);
+      };
+    auClassOf [iByte] = UINT8 (iClass);
+    };
+
+  FlushStates ();
+  bUsable = TRUE;
+  return (TRUE);
+  };
+
+//------------------------------------------------------------------------
+BOOL  RegExDfa::Closure  (TArray<RegExMatch> &  arrayStatesIn,
+                          const INT32 *         piKernelIn,
+                          INT                   iKernelCountIn,
+                          INT                   iContextIn,
+                          INT                   iCharIn,
+                          BOOL &                bAcceptOut)
+  {
+  // Follow every transition that doesn't consume a character, starting from the
+  //  kernel, with iCharIn as the current character.  States that consume the
+  //  character are collected into aiNextKernel.  Reaching state zero means a
+  //  match ends at the current position.
+
+  ++iStamp;
+  bAcceptOut = FALSE;
+  aiStack.Clear ();
+  aiNextKernel.Clear ();
+
+  for (INT  iIndex = iKernelCountIn - 1; iIndex >= 0; --iIndex)
+    {
+    aiStack.Append (piKernelIn [iIndex]);
+    };
+
+  while (aiStack.Length () > 0)
+    {
+    INT  iMatchState = aiStack [aiStack.Length () - 1];
+    aiStack.SetLength (aiStack.Length () - 1);
+
+    if (iMatchState == 0)
+      {
+      bAcceptOut = TRUE;
+      continue;
+      };
+    if (aiVisited [iMatchState] == iStamp)
+      {
+      continue;
+      };
+    aiVisited [iMatchState] = iStamp;
+
+    RegExMatch &  matchCurr = arrayStatesIn [iMatchState];
+
+    if (matchCurr.IsNull ())
+      {
+      aiStack.Append (matchCurr.GetNextOne ());
+      }
+    else if (matchCurr.IsOr () || matchCurr.IsRepeat ())
+      {
+      aiStack.Append (matchCurr.GetNextTwo ());
+      aiStack.Append (matchCurr.GetNextOne ());
+      }
+    else if (MatchAgainstByte (matchCurr, iMatchState, iContextIn, iCharIn))
+      {
+      if (matchCurr.IncOnMatch ())
+        {
+        INT  iNext = matchCurr.GetNextOne ();
+        if (aiInKernel [iNext] != iStamp)
+          {
+          aiInKernel [iNext] = iStamp;
+          aiNextKernel.Append (iNext);
+          };
+        }
+      else
+        {
+        aiStack.Append (matchCurr.GetNextOne ());
+        };
+      };
+    };
+
+  // sort the kernel so equal sets compare equal
+  INT32 *  piNext  = aiNextKernel.GetRawArray ();
+  INT      iCount  = aiNextKernel.Length ();
+  for (INT  iIndex = 1; iIndex < iCount; ++iIndex)
+    {
+    INT32  iValue = piNext [iIndex];
+    INT    iSlot  = iIndex;
+    for (; (iSlot > 0) && (piNext [iSlot - 1] > iValue); --iSlot)
+      {
+      piNext [iSlot] = piNext [iSlot - 1];
+      };
+    piNext [iSlot] = iValue;
+    };
+  return (bAcceptOut);
+  };
+
+//------------------------------------------------------------------------
+INT  RegExDfa::FindOrAddState  (TArray<RegExMatch> &  arrayStatesIn,
+                                INT                   iContextIn)
+  {
+  // returns the DFA state for the kernel in aiNextKernel, or -1 if the cache is full.
+
+  INT  iCount = aiNextKernel.Length ();
+  if (iCount == 0)
+    {
+    return (0);
+    };
+  if (! bTrackContext)
+    {
+    iContextIn = kContextOther;
+    };
+
+  const INT32 *  piKernel = aiNextKernel.GetRawArray ();
+  UINT32         uHash    = 2166136261u ^ UINT32 (iContextIn);
+  for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+    {
+    uHash = (uHash ^ UINT32 (piKernel [iIndex])) * 16777619u;
+    };
+
+  const INT32 *  piInfo = aiInfo.GetRawArray ();
+  for (INT  iState = 1; iState < iNumStates; ++iState)
+    {
+    const INT32 *  piState = piInfo + iState * kInfoStride;
+    if ((piState [kInfoHash]        == INT32 (uHash)) &&
+        (piState [kInfoKernelCount] == iCount) &&
+        (piState [kInfoContext]     == iContextIn) &&
+        (memcmp (aiKernels.GetRawArray () + piState [kInfoKernelStart], piKernel, sizeof (INT32) * iCount) == 0))
+      {
+      return (iState);
+      };
+    };
+
+  if (iNumStates >= iMaxStates)
+    {
+    return (-1);
+    };
+
+  INT  iKernelStart = aiKernels.Length ();
+  for (INT  iIndex = 0; iIndex < iCount; ++iIndex)
+    {
+    aiKernels.Append (aiNextKernel [iIndex]);
+    };
+
+  BOOL  bEndAccept;
+  Closure (arrayStatesIn, aiKernels.GetRawArray () + iKernelStart, iCount, iContextIn, -1, bEndAccept);
+
+  aiInfo.Append (iKernelStart);
+  aiInfo.Append (iCount);
+  aiInfo.Append (iContextIn);
+  aiInfo.Append (INT32 (uHash));
+  aiInfo.Append (bEndAccept ? 1 : 0);
+  for (INT  iClass = 0; iClass < iNumClasses; ++iClass)
+    {
+    aiTransitions.Append (-1);
+    };
+  return (iNumStates++);
+  };
+
+//------------------------------------------------------------------------
+INT  RegExDfa::StartState  (TArray<RegExMatch> &  arrayStatesIn,
+                            INT                   iContextIn)
+  {
+  if (! bTrackContext)
+    {
+    iContextIn = kContextOther;
+    };
+  if (aiStartState [iContextIn] < 0)
+    {
+    aiNextKernel.Clear ();
+    aiNextKernel.Append (arrayStatesIn [0].GetNextOne ());
+    aiStartState [iContextIn] = FindOrAddState (arrayStatesIn, iContextIn);
+    };
+  return (aiStartState [iContextIn]);
+  };
+
+//------------------------------------------------------------------------
+INT  RegExDfa::BuildTransition  (TArray<RegExMatch> &  arrayStatesIn,
+                                 INT                   iStateIn,
+                                 INT                   iClassIn)
+  {
+  const INT32 *  piState = aiInfo.GetRawArray () + iStateIn * kInfoStride;
+  INT            iChar   = auClassRep [iClassIn];
+  INT            iNextContext = ((iChar == '\n') && bTrackContext) ? kContextLineStart : kContextOther;
+  BOOL           bAccept;
+
+  Closure (arrayStatesIn,
+           aiKernels.GetRawArray () + piState [kInfoKernelStart],
+           piState [kInfoKernelCount],
+           piState [kInfoContext],
+           iChar,
+           bAccept);
+
+  INT  iNext = FindOrAddState (arrayStatesIn, iNextContext);
+  if (iNext < 0)
+    {
+    return (-1);
+    };
+
+  INT  iTransition = (iNext << 1) | (bAccept ? 1 : 0);
+  aiTransitions [iStateIn * iNumClasses + iClassIn] = iTransition;
+  return (iTransition);
+  };
+
+//------------------------------------------------------------------------
+BOOL  RegExDfa::Search  (TArray<RegExMatch> &  arrayStatesIn,
+                         const char *          szSourceIn,
+                         INT32                 iSourceLengthIn,
+                         INT32                 iSearchStartIn,
+                         const char * *        szMatchStartOut,
+                         INT32 &               iMatchSizeOut)
+  {
+  *szMatchStartOut = NULL;
+  iMatchSizeOut    = 0;
+
+  if ((iSearchStartIn < 0) || (! Prepare (arrayStatesIn)))
+    {
+    return (FALSE);
+    };
+
+  const UINT8 *  pSource = (const UINT8 *) szSourceIn;
+  INT32          iMax    = iSourceLengthIn;
+
+  // Like the NFA, try each start position in turn and keep the longest match
+  //  from the first one that succeeds.  Every start position before that one
+  //  failed, so if a later start reaches a position in a DFA state that a
+  //  failed start already had there, it can't find anything further either.
+  if (iSearchStartIn <= iMax)
+    {
+    aiSeenAt.SetLength (iMax + 1);
+    memset (aiSeenAt.GetRawArray () + iSearchStartIn, 0xff, sizeof (INT32) * (iMax + 1 - iSearchStartIn));
+    };
+
+  for (INT32  iStartMatch = iSearchStartIn; iStartMatch <= iMax; ++iStartMatch)
+    {
+    INT  iContext = kContextOther;
+    if      (iStartMatch == 0)                    {iContext = kContextBufferStart;}
+    else if (pSource [iStartMatch - 1] == '\n')   {iContext = kContextLineStart;};
+
+    INT  iState = StartState (arrayStatesIn, iContext);
+    if (iState < 0)
+      {
+      ++uNumOverflows;
+      FlushStates ();
+      return (FALSE);
+      };
+
+    INT32 *  piSeenAt         = aiSeenAt.GetRawArray ();
+    INT32    iLongestMatchPos = -1;
+    INT32    iPos             = iStartMatch;
+
+    while (iState != 0)
+      {
+      if (piSeenAt [iPos] == iState)
+        {
+        break;
+        };
+      piSeenAt [iPos] = iState;
+
+      if (iPos == iMax)
+        {
+        if (aiInfo [iState * kInfoStride + kInfoEndAccept])
+          {
+          iLongestMatchPos = iPos;
+          };
+        break;
+        };
+
+      INT  iTransition = aiTransitions.GetRawArray () [iState * iNumClasses + auClassOf [pSource [iPos]]];
+      if (iTransition < 0)
+        {
+        iTransition = BuildTransition (arrayStatesIn, iState, auClassOf [pSource [iPos]]);
+        if (iTransition < 0)
+          {
+          ++uNumOverflows;
+          FlushStates ();
+          return (FALSE);
+          };
+        };
+
+      if (iTransition & 1)
+        {
+        iLongestMatchPos = iPos;
+        };
+      iState = iTransition >> 1;
+      ++iPos;
+      };
+
+    if (iLongestMatchPos > 0)
+      {
+      *szMatchStartOut = &szSourceIn [iStartMatch];
+      iMatchSizeOut    = iLongestMatchPos - iStartMatch;
+      break;
+      };
+    };
+  return (TRUE);
+  };
+
+
 //------------------------------------------------------------------------
 // RegEx
 //------------------------------------------------------------------------
@@ -814,6 +1339,25 @@ VOID  RegEx::Match  (const char *    szSourceIn,
                      INT32 &         iMatchSizeOut,
                      RStrArray *     pstraSubstringsOut)
   {
+  // The DFA can't track sub-strings, so searches that want them always run the NFA.
+  if ((pstraSubstringsOut == NULL) &&
+      (strPattern.Length () > 0) &&
+      dfa.IsEnabled () &&
+      dfa.Search (arrayStates, szSourceIn, iSourceLengthIn, iSearchStartIn, szMatchStartOut, iMatchSizeOut))
+    {
+    return;
+    };
+
+  MatchNfa (szSourceIn, iSourceLengthIn, iSearchStartIn, szMatchStartOut, iMatchSizeOut);
+  };
+
+//------------------------------------------------------------------------
+VOID  RegEx::MatchNfa  (const char *    szSourceIn,
+                        INT32           iSourceLengthIn,
+                        INT32           iSearchStartIn,
+                        const char * *  szMatchStartOut,
+                        INT32 &         iMatchSizeOut)
+  {
   INT32         iStartMatch   = 0;
   INT32         iMaxMatch     = iSourceLengthIn;
   *szMatchStartOut = NULL;
@@ -1098,6 +1642,7 @@ EStatus  RegEx::ParseRegEx (const RStr &  strExprIn)
     DBG_INFO ("RegEx::ParseRegEx");
   #endif
   arrayStates.Clear ();
+  dfa.Reset ();
 
   iState = 1;
   iPatternPos = 0;
@@ -1132,6 +1677,7 @@ EStatus  RegEx::ParseGlob  (const RStr &  strExprIn)
     DBG_INFO ("RegEx::ParseGlob");
   #endif
   arrayStates.Clear ();
+  dfa.Reset ();
 
   iState = 1;
   iPatternPos = 0;
@@ -267,6 +267,148 @@ class RegExDeque
   };
 
 
+//------------------------------------------------------------------------
+class RegExDfa
+  {
+  // Lazily built DFA over the NFA states of a RegEx.  Each DFA state is the
+  //  set of NFA states waiting on the next character (the "kernel"), plus
+  //  the line context needed by ^ and \` anchors.  Transitions are only
+  //  computed the first time they are taken, and the number of cached
+  //  states is bounded.  Input bytes that every NFA state treats the same
+  //  share a byte class, so each state only needs one transition per class.
+
+  public:
+
+    static const INT  kDefaultMaxStates = 128;
+
+    enum EContext {kContextOther       = 0,
+                   kContextLineStart   = 1,
+                   kContextBufferStart = 2,
+                   kNumContexts        = 3};
+
+  private:
+
+    enum EInfo    {kInfoKernelStart = 0,
+                   kInfoKernelCount = 1,
+                   kInfoContext     = 2,
+                   kInfoHash        = 3,
+                   kInfoEndAccept   = 4,
+                   kInfoStride      = 5};
+
+    BOOL           bEnabled;       ///< If false, RegEx always uses the NFA
+    BOOL           bPrepared;      ///< True once the states have been checked and byte classes built
+    BOOL           bUsable;        ///< True if the pattern can be run as a DFA
+    BOOL           bTrackContext;  ///< True if the pattern contains line or buffer start anchors
+    INT            iMaxStates;     ///< Cache limit.  The DFA gives up on the current search when it is reached.
+
+    INT            iNumClasses;
+    UINT8          auClassOf [256];     ///< Byte class of each input byte
+    UINT8          auClassRep [256];    ///< A representative byte for each class
+
+    INT            iNumStates;
+    IntArray       aiInfo;         ///< kInfoStride entries per DFA state
+    IntArray       aiKernels;      ///< Sorted NFA state indices, pooled for all DFA states
+    IntArray       aiTransitions;  ///< iNumClasses entries per state.  -1 if not built, else (next << 1) | accept
+    INT            aiStartState [kNumContexts];
+
+    // scratch space
+    IntArray       aiVisited;
+    IntArray       aiInKernel;
+    IntArray       aiStack;
+    IntArray       aiNextKernel;
+    IntArray       aiSeenAt;       ///< DFA state reached at each input position by an earlier, failed start position
+    INT            iStamp;
+
+    UINT32         uNumOverflows;
+
+  private:
+
+    BOOL           Prepare        (TArray<RegExMatch> &  arrayStatesIn);
+
+    VOID           FlushStates    (VOID);
+
+    BOOL           IsSupported    (RegExMatch &  matchIn);
+
+    BOOL           Closure        (TArray<RegExMatch> &  arrayStatesIn,
+                                   const INT32 *         piKernelIn,
+                                   INT                   iKernelCountIn,
+                                   INT                   iContextIn,
+                                   INT                   iCharIn,
+                                   BOOL &                bAcceptOut);
+
+    INT            FindOrAddState (TArray<RegExMatch> &  arrayStatesIn,
+                                   INT                   iContextIn);
+
+    INT            StartState     (TArray<RegExMatch> &  arrayStatesIn,
+                                   INT                   iContextIn);
+
+    INT            BuildTransition (TArray<RegExMatch> &  arrayStatesIn,
+                                    INT                   iStateIn,
+                                    INT                   iClassIn);
+
+  public:
+
+                   RegExDfa       ();
+
+                   ~RegExDfa      ();
+
+                                  /** @brief  Copies only the settings.  The cache is rebuilt on first use.
+                                      @param  dfaIn The DFA whose settings are copied.
+                                  */
+                   RegExDfa       (const RegExDfa &  dfaIn);
+
+    RegExDfa &     operator=      (const RegExDfa &  dfaIn);
+
+                                  /** @brief  Discard all cached states.  Call whenever the NFA states change.
+                                      @return None
+                                  */
+    VOID           Reset          (VOID);
+
+                                  /** @brief  Leftmost-longest search, with the same results as RegEx::Match.
+                                      @param  arrayStatesIn The NFA states of the owning RegEx.
+                                      @param  szSourceIn The buffer to search.
+                                      @param  iSourceLengthIn Number of bytes in the buffer.
+                                      @param  iSearchStartIn Offset to start searching from.
+                                      @param  szMatchStartOut Returns the start of the match, or NULL.
+                                      @param  iMatchSizeOut Returns the length of the match.
+                                      @return True if the search completed.  False if the pattern can't be run
+                                              as a DFA or the state cache overflowed, in which case the caller
+                                              must run the NFA instead.
+                                  */
+    BOOL           Search         (TArray<RegExMatch> &  arrayStatesIn,
+                                   const char *          szSourceIn,
+                                   INT32                 iSourceLengthIn,
+                                   INT32                 iSearchStartIn,
+                                   const char * *        szMatchStartOut,
+                                   INT32 &               iMatchSizeOut);
+
+    VOID           Enable         (BOOL  bEnableIn)           {bEnabled = bEnableIn;};
+
+    BOOL           IsEnabled      (VOID) const                {return (bEnabled);};
+
+                                  /** @brief  Set the maximum number of cached DFA states.
+                                      @param  iMaxStatesIn The new limit.
+                                      @return None
+                                  */
+    VOID           SetMaxStates   (INT  iMaxStatesIn)         {iMaxStates = iMaxStatesIn; Reset ();};
+
+    INT            GetMaxStates   (VOID) const                {return (iMaxStates);};
+
+    INT            NumStates      (VOID) const                {return (iNumStates);};
+
+    INT            NumClasses     (VOID) const                {return (iNumClasses);};
+
+                                  /** @brief  Query whether the current pattern can run as a DFA.  Patterns with
+                                              counted repeats ('+' or {n,m}) or word boundary assertions can't.
+                                      @param  arrayStatesIn The NFA states of the owning RegEx.
+                                      @return True if Search will be used for this pattern.
+                                  */
+    BOOL           IsUsable       (TArray<RegExMatch> &  arrayStatesIn)   {return (Prepare (arrayStatesIn));};
+
+    UINT32         NumOverflows   (VOID) const                {return (uNumOverflows);};
+  };
+
+
 //------------------------------------------------------------------------
 class RegEx
   {
@@ -278,6 +420,7 @@ class RegEx
   public:
     TArray<RegExMatch> arrayStates;
     RegExDeque         deque;
+    RegExDfa           dfa;
 
     RStr               strPattern;
     UINT32             iPatternPos;
@@ -309,6 +452,12 @@ class RegEx
 
     INT   RegExListItem     (INT   iListStartState);
 
+    VOID  MatchNfa          (const char *    szSourceIn,
+                             INT32           iSourceLengthIn,
+                             INT32           iSearchStartIn,
+                             const char * *  szMatchStartOut,
+                             INT32 &         iMatchSizeOut);
+
   public:
 
 
@@ -354,6 +503,14 @@ class RegEx
 
     VOID     Debug      (VOID);
 
+                        /** @brief  Turn the DFA engine on or off.  When off, every search runs the NFA.
+                            @param  bEnableIn True to use the DFA when the pattern allows it.
+                            @return None
+                        */
+    VOID     EnableDfa  (BOOL  bEnableIn)       {dfa.Enable (bEnableIn);};
+
+    RegExDfa &  Dfa     (VOID)                  {return (dfa);};
+
     const RStr &  Pattern    (VOID) const       {return (strPattern);};
 
 
@@ -5,6 +5,8 @@
 ASSERTFILE (__FILE__);
 
 #include "Util/RegEx.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 // NOTE: Tests drawn from https://hg.python.org/cpython/file/178075fbff3a/Lib/test/re_tests.py
@@ -129,3 +131,166 @@ rex.Set ("[ ]*");
 
 */
   };
+
+//------------------------------------------------------------------------------
+static VOID  CompareEngines  (RegEx &       rexIn,
+                              const char *  szSourceIn,
+                              INT32         iSearchStartIn)
+  {
+  const char *  pszDfaStart;
+  const char *  pszNfaStart;
+  INT32         iDfaSize;
+  INT32         iNfaSize;
+  INT32         iLength = INT32 (strlen (szSourceIn));
+
+  rexIn.EnableDfa (TRUE);
+  rexIn.Match (szSourceIn, iLength, iSearchStartIn, &pszDfaStart, iDfaSize);
+  rexIn.EnableDfa (FALSE);
+  rexIn.Match (szSourceIn, iLength, iSearchStartIn, &pszNfaStart, iNfaSize);
+  rexIn.EnableDfa (TRUE);
+
+  EXPECT_EQ (pszNfaStart, pszDfaStart) << "pattern \"" << rexIn.Pattern ().AsChar () << "\" source \"" << szSourceIn << "\"";
+  EXPECT_EQ (iNfaSize,    iDfaSize)    << "pattern \"" << rexIn.Pattern ().AsChar () << "\" source \"" << szSourceIn << "\"";
+  };
+
+//------------------------------------------------------------------------------
+TEST (RegEx, DfaMatchesNfa)
+  {
+  const char *  aszRegEx [] =
+    {
+    "abc", "ab*c", "ab*bc", "ab?bc", "ab?c", "^abc$", "^abc", "abc$", "a.c", "a.*c",
+    "a[bc]d", "a[b-d]e", "a[b-d]", "a[-b]", "(a)", "((a))", "(a)b(c)", "(a|b)*",
+    "[^ab]*", "a|b|c|d|e", "(a|b|c|d|e)f", "abcd*efg", "ab*", "(ab|cd)e",
+    "[abhgefdc]ij", "^(ab|cd)e", "[ ]*", "[ ]*([0-9]*(\\.[0-9]*)?|;)[ ]*",
+    "[[:alpha:]_][[:alnum:]_]*", "^/?[[:alpha:]]:", "x*", "^$", "$", "^",
+    "[^\n]*$", "^[a-z]*\n", "\\w\\w", "\\`ab", "b\\'", ".*json",
+    };
+  const char *  aszGlob [] =
+    {
+    "*", "*.json", "config_*.json", "a?c", "*a*b*", "?", "*\\*", "data/*/x.*",
+    };
+  const char *  aszSource [] =
+    {
+    "", "abc", "xabcy", "ababc", "abbbbc", "ac", "abcc", "aabc", "axyzc", "axyzd",
+    "abd", "ace", "a-", "aabbabc", "cde", "ef", "abcde", "hij", "a bc", " 123.45 ",
+    " 4", "line one\nabc\nline three", "\nabc\n", "C:/Windows", "/d:", "_ident9 x",
+    "config_base.json", "data/levels/x.json", "README.md", "a*b", "xyz\n",
+    "settings.json.bak", "aaaa*bbbb*",
+    };
+  const INT  iNumRegEx  = sizeof (aszRegEx)  / sizeof (const char *);
+  const INT  iNumGlob   = sizeof (aszGlob)   / sizeof (const char *);
+  const INT  iNumSource = sizeof (aszSource) / sizeof (const char *);
+
+  RegEx  rex;
+  for (INT  iPattern = 0; iPattern < iNumRegEx + iNumGlob; ++iPattern)
+    {
+    if (iPattern < iNumRegEx)
+      {
+      rex.Set (aszRegEx [iPattern]);
+      }
+    else
+      {
+      rex.Set (aszGlob [iPattern - iNumRegEx], RegEx::kGlob);
+      };
+    for (INT  iSource = 0; iSource < iNumSource; ++iSource)
+      {
+      CompareEngines (rex, aszSource [iSource], 0);
+      CompareEngines (rex, aszSource [iSource], 1);
+      };
+    };
+
+  // counted repeats and word boundaries stay on the NFA
+  rex.Set ("*.json", RegEx::kGlob);   ASSERT_TRUE  (rex.Dfa ().IsUsable (rex.arrayStates));
+  rex.Set ("^[a-z]*$");               ASSERT_TRUE  (rex.Dfa ().IsUsable (rex.arrayStates));
+  rex.Set ("ab+c");                   ASSERT_FALSE (rex.Dfa ().IsUsable (rex.arrayStates));
+  rex.Set ("a{2,3}");                 ASSERT_FALSE (rex.Dfa ().IsUsable (rex.arrayStates));
+  rex.Set ("\\bword");                ASSERT_FALSE (rex.Dfa ().IsUsable (rex.arrayStates));
+  rex.Set ("ab+c"); ASSERT_STREQ (rex.Match ("xabbc").AsChar (), "abbc");
+
+  // a glob needs very few byte classes
+  rex.Set ("*.json", RegEx::kGlob);
+  ASSERT_TRUE (rex.HasMatch ("level.json"));
+  ASSERT_EQ (6, rex.Dfa ().NumClasses ());
+  };
+
+//------------------------------------------------------------------------------
+TEST (RegEx, DfaCacheOverflow)
+  {
+  // With a tiny state cache the DFA gives up and the NFA produces the result.
+  RegEx  rex ("(ab|cd|ef)*g");
+
+  rex.Dfa ().SetMaxStates (2);
+  ASSERT_STREQ (rex.Match ("xxabcdefabg").AsChar (), "abcdefabg");
+  ASSERT_GT    (rex.Dfa ().NumOverflows (), 0u);
+  ASSERT_LE    (rex.Dfa ().NumStates (), 2);
+  ASSERT_FALSE (rex.HasMatch ("abcdef"));
+
+  rex.Dfa ().SetMaxStates (RegExDfa::kDefaultMaxStates);
+  UINT32  uOverflows = rex.Dfa ().NumOverflows ();
+  ASSERT_STREQ (rex.Match ("xxabcdefabg").AsChar (), "abcdefabg");
+  ASSERT_EQ    (uOverflows, rex.Dfa ().NumOverflows ());
+  };
+
+//------------------------------------------------------------------------------
+TEST (RegEx, DfaBenchmark)
+  {
+  // Compares the NFA simulation and the lazy DFA on long inputs, for both a
+  //  glob that fails to match and a regular expression found near the end.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  RStr  strLong;
+  for (INT  iIndex = 0; iIndex < 50; ++iIndex)
+    {
+    strLong.AppendChars ("assets/levels/level_", 20);
+    strLong.AppendChar  (char ('a' + (iIndex % 26)));
+    strLong.AppendChar  ('/');
+    };
+  RStr  strFound (strLong);
+  strFound.AppendString ("config_final.json");
+
+  struct
+    {
+    const char *     szPattern;
+    RegEx::EParser   eParser;
+    const RStr *     pstrSource;
+    BOOL             bExpected;
+    } aCases [] =
+    {
+    {"*.json",                RegEx::kGlob,  &strLong,  FALSE},
+    {"config_[a-z]*\\.json",  RegEx::kRegEx, &strFound, TRUE},
+    };
+  const INT  iNumCases = sizeof (aCases) / sizeof (aCases [0]);
+  const INT  iNumRuns  = 3;
+  StopWatch  watch;
+
+  for (INT  iCase = 0; iCase < iNumCases; ++iCase)
+    {
+    RegEx  rex (aCases [iCase].szPattern, aCases [iCase].eParser);
+    const char *  szSource = aCases [iCase].pstrSource->AsChar ();
+
+    rex.EnableDfa (FALSE);
+    watch.Start ();
+    for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+      {
+      ASSERT_EQ (aCases [iCase].bExpected, rex.HasMatch (szSource));
+      };
+    watch.Stop ();
+    INT64  iNfaUs = watch.GetElapsedUs ();
+
+    rex.EnableDfa (TRUE);
+    watch.Start ();
+    for (INT  iRun = 0; iRun < iNumRuns; ++iRun)
+      {
+      ASSERT_EQ (aCases [iCase].bExpected, rex.HasMatch (szSource));
+      };
+    watch.Stop ();
+    INT64  iDfaUs = watch.GetElapsedUs ();
+
+    BenchmarkPrintf ("RegEx \"%s\" on %d chars  NFA %10.1f us/call  DFA %8.1f us/call  speedup %.1fx\n",
+                     aCases [iCase].szPattern,
+                     aCases [iCase].pstrSource->Length (),
+                     DOUBLE (iNfaUs) / DOUBLE (iNumRuns),
+                     DOUBLE (iDfaUs) / DOUBLE (iNumRuns),
+                     DOUBLE (iNfaUs) / DOUBLE (iDfaUs > 0 ? iDfaUs : 1));
+    };
+  };
@@ -43,6 +43,9 @@ ASSERTFILE (__FILE__)
 #include "Util/CalcHash.hpp"
 #include "Util/ParseTools.hpp"
 #include "Sys/FilePath.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/WorkerPool.hpp"
+#include "Util/ChangeBatch.hpp"
 #include "ConfigDeck.hpp"
 
 
@@ -53,6 +56,35 @@ ASSERTFILE (__FILE__)
 
 ConfigDeck *   ConfigDeck::pInstance = NULL;
 
+const INT      ConfigDeck::kMaxResolvePasses = 8;
+
+//-----------------------------------------------------------------------------
+static VOID  InsertUnique (THashIndex<ConfigLayer*> &  indexIn,
+                           HASH_T                      uKeyIn,
+                           ConfigLayer *               pLayerIn)
+  {
+  for (INT  iSlot = indexIn.FindFirst (uKeyIn); iSlot != -1; iSlot = indexIn.FindNext (uKeyIn, iSlot))
+    {
+    if (indexIn.GetAt (iSlot) == pLayerIn) return;
+    };
+  indexIn.Insert (uKeyIn, pLayerIn);
+  };
+
+//-----------------------------------------------------------------------------
+static BOOL  ValuesMatch (ValueElem &  elemAIn,
+                          ValueElem &  elemBIn)
+  {
+  if (! elemAIn.IsType (elemBIn.GetType ())) return (FALSE);
+
+  RStrParser  parserA;
+  RStrParser  parserB;
+
+  elemAIn.ToParser (parserA);
+  elemBIn.ToParser (parserB);
+  return ((parserA.Length () == parserB.Length ()) &&
+          (memcmp (parserA.AsChar (), parserB.AsChar (), parserA.Length ()) == 0));
+  };
+
 
 //-----------------------------------------------------------------------------
 VOID ConfigDeck::Init (VOID)
@@ -67,14 +99,30 @@ VOID ConfigDeck::Init (VOID)
 ConfigDeck::ConfigDeck (ValueRegistry *  pRegIn)
   {
   pReg = (pRegIn != NULL) ? pRegIn : ValueRegistry::Root();
+  pRegResolved = NULL;
+  iParseThreads = 1;
+  memset (&statsLastResolve, 0, sizeof (statsLastResolve));
   };
 
 
 //-----------------------------------------------------------------------------
-EStatus ConfigDeck::Deserialize (RStrParser &  parserJsonIn,
-                                 const char *  szSourceIn)
+EStatus ConfigDeck::Deserialize (RStrParser &             parserJsonIn,
+                                 const char *             szSourceIn,
+                                 TArray<ConfigLayer*> *   papLayersOut)
   {
+  TArray<ConfigLayer*>  apLayersParsed;
+
+  // layers parsed before any error are still added, as they always have been.
+  EStatus  status = ParseLayers (parserJsonIn, szSourceIn, apLayersParsed);
+  AdoptLayers (apLayersParsed, papLayersOut);
+  return (status);
+  };
 
+//-----------------------------------------------------------------------------
+EStatus ConfigDeck::ParseLayers (RStrParser &             parserJsonIn,
+                                 const char *             szSourceIn,
+                                 TArray<ConfigLayer*> &   apLayersOut)
+  {
   parserJsonIn.SetSkipComments (RStrParser::kCStyle);
   parserJsonIn.SkipWhitespace ();
 
@@ -86,15 +134,15 @@ EStatus ConfigDeck::Deserialize (RStrParser &  parserJsonIn,
     // step through  list
     while (parserJsonIn.PeekChar () != ']')
       {
-      // find layer and update if it exists, else create it
-
-      ConfigLayer *   pLayer = listLayers.PushBack (new ConfigLayer ());
+      ConfigLayer *   pLayer = new ConfigLayer ();
 
       EStatus  status;
       if ((status = pLayer->Deserialize (parserJsonIn, szSourceIn)) == EStatus::kFailure)
         {
+        delete (pLayer);
         return (status);
         };
+      apLayersOut.Append (pLayer);
 
       // check for next
       if (! ParseTools::SkipChar (parserJsonIn, ','))  {break;};
@@ -104,13 +152,29 @@ EStatus ConfigDeck::Deserialize (RStrParser &  parserJsonIn,
     if (! ParseTools::SkipChar (parserJsonIn, ']'))  {return (EStatus::kFailure);};
 
     } else {
-      ConfigLayer *   pLayer = listLayers.PushBack (new ConfigLayer ());
-      return (pLayer->Deserialize (parserJsonIn, szSourceIn));
+      ConfigLayer *   pLayer = new ConfigLayer ();
+      EStatus  status = pLayer->Deserialize (parserJsonIn, szSourceIn);
+      apLayersOut.Append (pLayer);
+      return (status);
     };
 
   return (EStatus::kSuccess);
   };
 
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::AdoptLayers (TArray<ConfigLayer*> &   apLayersIn,
+                              TArray<ConfigLayer*> *   papLayersOut)
+  {
+  // each new layer takes the place of any existing layer with the same name.
+  for (INT  iIndex = 0; iIndex < apLayersIn.Length (); ++iIndex)
+    {
+    ConfigLayer *  pLayer = listLayers.PushBack (apLayersIn [iIndex]);
+
+    ReplaceLayer (pLayer);
+    if (papLayersOut != NULL) {papLayersOut->Append (pLayer);};
+    };
+  };
+
 
 //-----------------------------------------------------------------------------
 ConfigLayer *  ConfigDeck::FindLayerByName (const char *  szNameIn)
@@ -143,6 +207,7 @@ ConfigLayer *  ConfigDeck::FindOrCreateLayer (const char *  szNameIn,
     if (pLayer != NULL)
       {
       pLayer->SetOrder (iOrderIn);
+      MarkLayerDirty (pLayer);
       };
     };
   return (pLayer);
@@ -166,6 +231,55 @@ VOID  ConfigDeck::DeleteAllLayers (VOID)
     delete (*itrCurr);
     };
   listLayers.Empty();
+
+  indexContributors.Clear ();
+  indexDependents.Clear ();
+  apUntrackedDeps.Clear ();
+  apDirtyLayers.Clear ();
+  auDirtyKeys.Clear ();
+  auChangedKeys.Clear ();
+  pRegResolved = NULL;
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigDeck::DeleteLayer (ConfigLayer *  pLayerIn)
+  {
+  if (pLayerIn == NULL) return;
+
+  // the keys this layer merged need to be recomputed from the remaining layers.
+  for (INT  iIndex = 0; iIndex < pLayerIn->auResolvedKeys.Length (); ++iIndex)
+    {
+    auDirtyKeys.Append (pLayerIn->auResolvedKeys [iIndex]);
+    };
+  UntrackLayer (pLayerIn);
+
+  for (INT  iIndex = apDirtyLayers.Length () - 1; iIndex >= 0; --iIndex)
+    {
+    if (apDirtyLayers [iIndex] == pLayerIn) {apDirtyLayers.Remove (iIndex, 1);};
+    };
+  listLayers.Delete (pLayerIn);
+  delete (pLayerIn);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigDeck::ReplaceLayer (ConfigLayer *  pLayerIn)
+  {
+  if (pLayerIn->GetBaseSegment () != NULL)
+    {
+    HASH_T   uNameHash = HASH (pLayerIn->GetName ());
+
+    TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
+    while (itrCurr.IsValid ())
+      {
+      ConfigLayer *  pLayerCurr = *itrCurr;
+      ++itrCurr;
+      if ((pLayerCurr != pLayerIn) && pLayerCurr->NameEquals (uNameHash, pLayerIn->GetName ()))
+        {
+        DeleteLayer (pLayerCurr);
+        };
+      };
+    };
+  MarkLayerDirty (pLayerIn);
   };
 
 
@@ -199,27 +313,44 @@ EStatus  ConfigDeck::ReadBuffer (const char *  szNameIn,
       status.SetDescription (strOut.AsChar ());
       return (status);
       }
-    ResolveStack (pReg, TRUE);
+    // the first load does a full reset, and later loads only touch the keys
+    //  the new layers affect.
+    ResolveChanges (pReg);
     };
   return (EStatus::kSuccess);
   };
 
 //-----------------------------------------------------------------------------
-EStatus  ConfigDeck::ReadFile (const char *  szFilenameIn)
+VOID  ConfigDeck::ParseFileJob::Run (VOID *  pJobIn)
+  {
+  // runs on a worker thread, so it may only touch its own job.
+  ParseFileJob *  pJob = static_cast<ParseFileJob *>(pJobIn);
+  RStrParser      parserFile;
+
+  if ((pJob->status = parserFile.ReadFromFile (pJob->strPath.AsChar ())) == EStatus::kSuccess)
+    {
+    pJob->status = ParseLayers (parserFile, pJob->strSource.AsChar (), pJob->apLayers);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ConfigDeck::ReadFile (const char *             szFilenameIn,
+                              TArray<ConfigLayer*> *   papLayersOut)
   {
   EStatus      status;
   RStrParser   parserFile;
 
   if ((status = parserFile.ReadFromFile (szFilenameIn)) == EStatus::kSuccess)
     {
-    return (Deserialize (parserFile, FilePath::GetFilenameNoExtFromPath (szFilenameIn)));
+    return (Deserialize (parserFile, FilePath::GetFilenameNoExtFromPath (szFilenameIn), papLayersOut));
     };
   return (status);
   };
 
 //-----------------------------------------------------------------------------
 VOID  ConfigDeck::ReadDirectory (const char *  szRelativePathIn,
-                                 const char *  szGlobMatchIn)
+                                 const char *  szGlobMatchIn,
+                                 const char *  szSnapshotIn)
   {
   // NOTE: This will read the files in a directory on disk, but not from
   //  a resource directory.
@@ -227,21 +358,303 @@ VOID  ConfigDeck::ReadDirectory (const char *  szRelativePathIn,
   RegEx       rexSearch    (szGlobMatchIn, RegEx::EParser::kGlob);
   RegEx       rexSearchTwo ("");
   RStr        strExpandedPath (FilePath::ExpandPathURI (szRelativePathIn));
+  RStrArray   arrayDirs;
   RStrArray   arrayAllPaths;
+  FilePath    filePath;
+  RStr        strSnapshot ((szSnapshotIn != NULL) ? szSnapshotIn : GetSnapshotPath (szRelativePathIn, szGlobMatchIn));
+
+  // without a trailing separator, the listing treats the last part of the
+  //  path as a file spec and searches the parent directory instead.
+  if ((! strExpandedPath.IsEmpty ()) &&
+      (strExpandedPath.GetAt (strExpandedPath.Length () - 1) != DIRECTORY_SEPARATOR))
+    {
+    strExpandedPath += DIRECTORY_SEPARATOR_STR;
+    };
 
   FilePath::DirTreeSearch  (strExpandedPath.AsChar (),
                             rexSearch, rexSearchTwo,
-                            arrayAllPaths);
+                            arrayDirs);
 
-  INT  iNumPaths = arrayAllPaths.Length();
-  for (INT  iIndex = 0; iIndex < iNumPaths; ++iIndex)
+  // DirTreeSearch finds the directories holding matches, so list the
+  //  matching files in each.
+  for (INT  iDir = 0; iDir < arrayDirs.Length (); ++iDir)
     {
-    // TODO : test
-    printf ("Found Path %s", arrayAllPaths[iIndex].AsChar ());
-    ReadFile (arrayAllPaths[iIndex].AsChar ());
+    RStr       strFileSpec (FilePath::Combine (arrayDirs [iDir].AsChar (), szGlobMatchIn));
+    RStrArray  arrayFiles = filePath.lsf (strFileSpec.AsChar (), TRUE);
+
+    for (INT  iFile = 0; iFile < arrayFiles.Length (); ++iFile)
+      {
+      arrayAllPaths.Append (arrayFiles [iFile]);
+      };
+    };
+
+  if ((! strSnapshot.IsEmpty ()) &&
+      (ReadSnapshot (strSnapshot.AsChar (), arrayAllPaths) == EStatus::kSuccess))
+    {
+    return;
+    };
+
+  TArray<ConfigLayer*>  apLayersRead;
+
+  ReadFiles (arrayAllPaths, &apLayersRead);
+
+  if (! strSnapshot.IsEmpty ())
+    {
+    WriteSnapshot (strSnapshot.AsChar (), arrayAllPaths, apLayersRead);
     };
   }
 
+//-----------------------------------------------------------------------------
+EStatus  ConfigDeck::ReadFiles (RStrArray &              arrayPathsIn,
+                                TArray<ConfigLayer*> *   papLayersOut)
+  {
+  INT      iNumPaths   = arrayPathsIn.Length ();
+  INT      iNumThreads = (iParseThreads > 0) ? iParseThreads : WorkerPool::DefaultThreadCount ();
+  EStatus  statusOut   = EStatus::kSuccess;
+
+  // batched ValueElem notifications are queued in a shared list, so parsing
+  //  has to stay on this thread while they are on.
+  if ((ChangeBatch::Batching () & ChangeBatch::kValueElem) != 0) {iNumThreads = 1;};
+
+  iNumThreads = RMin (iNumThreads, iNumPaths);
+
+  if (iNumThreads <= 1)
+    {
+    for (INT  iIndex = 0; iIndex < iNumPaths; ++iIndex)
+      {
+      EStatus  status = ReadFile (arrayPathsIn [iIndex].AsChar (), papLayersOut);
+      if (status.IsFailure () && statusOut.IsSuccess ()) {statusOut = status;};
+      };
+    return (statusOut);
+    };
+
+  // each file is read and parsed into its own job on the pool.  The layers
+  //  only join the deck once every job is done, in file order, so the stack
+  //  comes out the same as a serial read.
+  ParseFileJob *  pJobs = new ParseFileJob [iNumPaths];
+  WorkerPool      poolParse (iNumThreads);
+
+  for (INT  iIndex = 0; iIndex < iNumPaths; ++iIndex)
+    {
+    pJobs [iIndex].strPath   = arrayPathsIn [iIndex];
+    pJobs [iIndex].strSource = FilePath::GetFilenameNoExtFromPath (arrayPathsIn [iIndex].AsChar ());
+    poolParse.Submit (ParseFileJob::Run, &pJobs [iIndex]);
+    };
+  poolParse.Wait ();
+
+  for (INT  iIndex = 0; iIndex < iNumPaths; ++iIndex)
+    {
+    AdoptLayers (pJobs [iIndex].apLayers, papLayersOut);
+    if (pJobs [iIndex].status.IsFailure ())
+      {
+      DBG_ERROR ("ConfigDeck - Failed to load \"%s\": %s", pJobs [iIndex].strPath.AsChar (), pJobs [iIndex].status.GetDescription ());
+      if (statusOut.IsSuccess ()) {statusOut = pJobs [iIndex].status;};
+      };
+    };
+  delete [] pJobs;
+  return (statusOut);
+  };
+
+/*
+  Snapshot layout.  All values are big endian, matching ValueElem::ToParser.
+
+    CFGS
+    version
+    source count
+    per source file:
+      path (length, chars)
+      size
+      modification time (U8)
+      hash of the file contents
+    payload size
+    payload hash
+    payload:
+      layer count
+      per layer, ConfigSubset::ToBinary of the base subset (segments nested)
+
+  A snapshot is current if every source file is in the same order and has the
+  same size.  A file whose time changed but whose contents hash the same is
+  still current, and the snapshot is rewritten with the new time.
+*/
+
+//-----------------------------------------------------------------------------
+EStatus  ConfigDeck::WriteSnapshot (const char *             szFileIn,
+                                    RStrArray &              arraySourcesIn,
+                                    TArray<ConfigLayer*> &   apLayersIn)
+  {
+  RStrParser  parserOut;
+  RStrParser  parserPayload;
+  RStrParser  parserSource;
+
+  parserOut.SetGrowIncrement (16 * 1024);
+  parserPayload.SetGrowIncrement (16 * 1024);
+
+  parserOut.SetU4_BEnd (MAKE_FOUR_CODE ("CFGS"));
+  parserOut.SetU4_BEnd (kSnapshotVersion);
+
+  INT  iNumSources = arraySourcesIn.Length ();
+  parserOut.SetU4_BEnd (iNumSources);
+  for (INT  iIndex = 0; iIndex < iNumSources; ++iIndex)
+    {
+    const char *  szSource = arraySourcesIn [iIndex].AsChar ();
+
+    if (parserSource.ReadFromFile (szSource) != EStatus::kSuccess)
+      {
+      return (EStatus::Failure ("ConfigDeck::WriteSnapshot - unable to read source file"));
+      };
+    parserOut.SetU4_BEnd (arraySourcesIn [iIndex].Length ());
+    parserOut.SetData    (arraySourcesIn [iIndex].AsUChar (), arraySourcesIn [iIndex].Length ());
+    parserOut.SetU4_BEnd (parserSource.Length ());
+    parserOut.SetU8_BEnd (UINT64 (FilePath::GetFileModTime (szSource)));
+    parserOut.SetU4_BEnd (CalcHashValue (parserSource.AsChar (), parserSource.Length ()));
+    };
+
+  // Layers replaced by a later file in the same read are no longer in the
+  //  deck, so walk the deck to keep only live layers, in stack order.
+  TArray<ConfigLayer*>  apLive;
+  for (TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
+        itrCurr.IsValid ();
+        ++itrCurr)
+    {
+    for (INT  iIndex = 0; iIndex < apLayersIn.Length (); ++iIndex)
+      {
+      if ((apLayersIn [iIndex] == *itrCurr) && ((*itrCurr)->GetBaseSegment () != NULL))
+        {
+        apLive.Append (*itrCurr);
+        break;
+        };
+      };
+    };
+
+  parserPayload.SetU4_BEnd (apLive.Length ());
+  for (INT  iIndex = 0; iIndex < apLive.Length (); ++iIndex)
+    {
+    apLive [iIndex]->ToBinary (parserPayload);
+    };
+
+  parserOut.SetU4_BEnd (parserPayload.Length ());
+  parserOut.SetU4_BEnd (CalcHashValue (parserPayload.AsChar (), parserPayload.Length ()));
+  parserOut.SetData    (parserPayload.AsUChar (), parserPayload.Length ());
+
+  return (parserOut.WriteToFile (szFileIn));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ConfigDeck::ReadSnapshot (const char *  szFileIn,
+                                   RStrArray &   arraySourcesIn)
+  {
+  RStrParser  parserIn;
+  RStr        strPath;
+  BOOL        bRewrite = FALSE;
+
+  // the whole snapshot is brought in with a single read.
+  if ((! FilePath::FileExists (szFileIn)) ||
+      (parserIn.ReadFromFile (szFileIn) != EStatus::kSuccess) ||
+      (parserIn.Length () < 12))
+    {
+    return (EStatus::kFailure);
+    };
+
+  if ((parserIn.GetU4_BEnd () != MAKE_FOUR_CODE ("CFGS")) ||
+      (parserIn.GetU4_BEnd () != kSnapshotVersion))
+    {
+    return (EStatus::kFailure);
+    };
+
+  INT  iNumSources = parserIn.GetU4_BEnd ();
+  if (iNumSources != arraySourcesIn.Length ()) return (EStatus::kFailure);
+
+  for (INT  iIndex = 0; iIndex < iNumSources; ++iIndex)
+    {
+    strPath.Empty ();
+    INT  iPathLength = parserIn.GetU4_BEnd ();
+    parserIn.GetData (&strPath, iPathLength);
+
+    UINT32  uSize     = parserIn.GetU4_BEnd ();
+    INT64   iModTime  = INT64 (parserIn.GetU8_BEnd ());
+    HASH_T  uHash     = parserIn.GetU4_BEnd ();
+
+    const char *  szSource = arraySourcesIn [iIndex].AsChar ();
+
+    if ((! strPath.Equals (szSource)) ||
+        (uSize != FilePath::GetFileSize (szSource)))
+      {
+      return (EStatus::kFailure);
+      };
+
+    if (iModTime != FilePath::GetFileModTime (szSource))
+      {
+      // touched, but possibly not changed.
+      RStrParser  parserSource;
+      if ((parserSource.ReadFromFile (szSource) != EStatus::kSuccess) ||
+          (CalcHashValue (parserSource.AsChar (), parserSource.Length ()) != uHash))
+        {
+        return (EStatus::kFailure);
+        };
+      bRewrite = TRUE;
+      };
+    };
+
+  UINT32  uPayloadSize = parserIn.GetU4_BEnd ();
+  HASH_T  uPayloadHash = parserIn.GetU4_BEnd ();
+  INT     iPayloadPos  = parserIn.GetCursorStart ();
+
+  if ((iPayloadPos + INT (uPayloadSize) != INT (parserIn.Length ())) ||
+      (CalcHashValue (parserIn.GetCursorStartPtr (), uPayloadSize) != uPayloadHash))
+    {
+    return (EStatus::kFailure);
+    };
+
+  // build the layers aside, so a failure leaves the deck untouched.
+  TArray<ConfigLayer*>  apLayers;
+  INT                   iNumLayers = parserIn.GetU4_BEnd ();
+  EStatus               status     = EStatus::kSuccess;
+
+  for (INT  iIndex = 0; iIndex < iNumLayers; ++iIndex)
+    {
+    ConfigLayer *  pLayer = new ConfigLayer ();
+    apLayers.Append (pLayer);
+    if ((status = pLayer->FromBinary (parserIn)) == EStatus::kFailure)
+      {
+      break;
+      };
+    };
+
+  if (status == EStatus::kFailure)
+    {
+    for (INT  iIndex = 0; iIndex < apLayers.Length (); ++iIndex)
+      {
+      delete (apLayers [iIndex]);
+      };
+    return (status);
+    };
+
+  for (INT  iIndex = 0; iIndex < apLayers.Length (); ++iIndex)
+    {
+    listLayers.PushBack (apLayers [iIndex]);
+    ReplaceLayer (apLayers [iIndex]);
+    };
+
+  if (bRewrite)
+    {
+    WriteSnapshot (szFileIn, arraySourcesIn, apLayers);
+    };
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+const char *  ConfigDeck::GetSnapshotPath (const char *  szRelativePathIn,
+                                           const char *  szGlobMatchIn)
+  {
+  static RStr  strPathOut;
+  RStr         strName;
+
+  // one snapshot per directory and glob pair.
+  strName.Format ("snapshot_%08x.cfgs", CalcHashValue (szGlobMatchIn, 0, CalcHashValue (szRelativePathIn)));
+  strPathOut = FilePath::Combine (GetConfigCachePath (), strName.AsChar ());
+  return (strPathOut.AsChar ());
+  };
+
 //-----------------------------------------------------------------------------
 INT ConfigDeck::CompareLayerOrders (ConfigLayer*  pAIn,
                                     ConfigLayer*  pBIn)
@@ -254,7 +667,12 @@ INT ConfigDeck::CompareLayerOrders (ConfigLayer*  pAIn,
 VOID ConfigDeck::ResolveStack (ValueRegistry *  pRegIn,
                                BOOL             bFullResetIn)
   {
-  ValueRegistry *  pRegFinal = (pRegIn != NULL) ? pRegIn : pReg;
+  ValueRegistry *  pRegFinal   = (pRegIn != NULL) ? pRegIn : pReg;
+  INT64            iStartUs    = StopWatch::GetTimeUs ();
+  UINT32           uExprStart  = ConfigSubset::uNumExpressionsRun;
+
+  memset (&statsLastResolve, 0, sizeof (statsLastResolve));
+  statsLastResolve.bFullResolve = TRUE;
 
   if (bFullResetIn)
     {
@@ -263,35 +681,361 @@ VOID ConfigDeck::ResolveStack (ValueRegistry *  pRegIn,
 
   listLayers.Sort (&CompareLayerOrders);
 
-  for (TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
-        itrCurr.IsValid ();
-        ++itrCurr)
+  // rebuild the key tracking from scratch, since any layer may have changed.
+  indexContributors.Clear ();
+  indexDependents.Clear ();
+  apUntrackedDeps.Clear ();
+
+  INT  iRank = 0;
+  for (INT  iPhase = 0; iPhase < 2; ++iPhase)
     {
-    if ((*itrCurr)->IsExpressionDriven () == FALSE)
+    // Phase 0 merges the fixed layers, and phase 1 the expression driven
+    //  layers so they can read the values the fixed layers set.
+    BOOL  bExpressionPhase = (iPhase == 1);
+
+    for (TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
+          itrCurr.IsValid ();
+          ++itrCurr)
       {
-      if ((*itrCurr)->IsActive (*pRegFinal))
+      ConfigLayer *  pLayer = *itrCurr;
+
+      if (pLayer->IsExpressionDriven () != bExpressionPhase) continue;
+
+      TrackLayer (pLayer);
+      pLayer->iResolveRank    = iRank++;
+      pLayer->bResolvedActive = pLayer->IsActive (*pRegFinal);
+      pLayer->psetResolved    = NULL;
+      pLayer->auResolvedKeys.Clear ();
+      ++statsLastResolve.iLayersEvaluated;
+
+      if (pLayer->bResolvedActive)
         {
-        //DBG_INFO ("ConfigDeck::ResolveStack Phase 1 Merging layer %s\n", (*itrCurr)->GetName());
-        (*itrCurr)->MergeInto (*pRegFinal);
+        //DBG_INFO ("ConfigDeck::ResolveStack Phase %d Merging layer %s\n", iPhase + 1, pLayer->GetName());
+        pLayer->psetResolved = pLayer->GetActiveSegment (*pRegFinal);
+        pLayer->MergeInto (*pRegFinal, pLayer->psetResolved);
+        pLayer->GetMergedKeys (pLayer->psetResolved, pLayer->auResolvedKeys);
+        ++statsLastResolve.iLayersMerged;
+        statsLastResolve.iKeysResolved += pLayer->auResolvedKeys.Length ();
         };
       };
     };
 
-  for (TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
-        itrCurr.IsValid ();
-        ++itrCurr)
+  apDirtyLayers.Clear ();
+  auDirtyKeys.Clear ();
+  auChangedKeys.Clear ();
+  pRegResolved = pRegFinal;
+
+  statsLastResolve.iKeysChanged    = statsLastResolve.iKeysResolved;
+  statsLastResolve.iExpressionsRun = INT (ConfigSubset::uNumExpressionsRun - uExprStart);
+  statsLastResolve.iTimeUs         = StopWatch::GetTimeUs () - iStartUs;
+
+  sigOnResolveStack();
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::ResolveChanges (ValueRegistry *  pRegIn)
+  {
+  ValueRegistry *  pRegFinal = (pRegIn != NULL) ? pRegIn : pReg;
+
+  if (pRegFinal != pRegResolved)
+    {
+    ResolveStack (pRegFinal, TRUE);
+    return;
+    };
+
+  INT64   iStartUs    = StopWatch::GetTimeUs ();
+  UINT32  uExprStart  = ConfigSubset::uNumExpressionsRun;
+
+  memset (&statsLastResolve, 0, sizeof (statsLastResolve));
+
+  listLayers.Sort (&CompareLayerOrders);
+  RankLayers ();
+
+  // Each pass re-evaluates the layers that were edited or that read a changed
+  //  key, then recomputes the keys whose contributions changed.  Keys that end
+  //  up with new values may in turn flip other expressions, so repeat until
+  //  nothing changes.
+
+  static INT  iStampCounter = 0;
+
+  for (INT  iPass = 0; iPass < kMaxResolvePasses; ++iPass)
     {
-    if ((*itrCurr)->IsExpressionDriven ())
+    INT  iStamp = ++iStampCounter;
+
+    for (INT  iIndex = 0; iIndex < apDirtyLayers.Length (); ++iIndex)
+      {
+      apDirtyLayers [iIndex]->iResolveStamp = iStamp;
+      EvaluateLayer (apDirtyLayers [iIndex], *pRegFinal, TRUE);
+      };
+    apDirtyLayers.Clear ();
+
+    for (INT  iIndex = 0; iIndex < auChangedKeys.Length (); ++iIndex)
+      {
+      HASH_T  uKey = auChangedKeys [iIndex];
+      for (INT  iSlot = indexDependents.FindFirst (uKey); iSlot != -1; iSlot = indexDependents.FindNext (uKey, iSlot))
+        {
+        ConfigLayer *  pLayer = indexDependents.GetAt (iSlot);
+        if (pLayer->iResolveStamp != iStamp)
+          {
+          pLayer->iResolveStamp = iStamp;
+          EvaluateLayer (pLayer, *pRegFinal, FALSE);
+          };
+        };
+      };
+    if (auChangedKeys.Length () > 0)
       {
-      if ((*itrCurr)->IsActive (*pRegFinal))
+      for (INT  iIndex = 0; iIndex < apUntrackedDeps.Length (); ++iIndex)
         {
-        //DBG_INFO ("ConfigDeck::ResolveStack Phase 2 Merging layer %s\n", (*itrCurr)->GetName());
-        (*itrCurr)->MergeInto (*pRegFinal);
+        ConfigLayer *  pLayer = apUntrackedDeps [iIndex];
+        if (pLayer->iResolveStamp != iStamp)
+          {
+          pLayer->iResolveStamp = iStamp;
+          EvaluateLayer (pLayer, *pRegFinal, FALSE);
+          };
         };
       };
+    auChangedKeys.Clear ();
+
+    if (auDirtyKeys.Length () == 0) break;
+
+    // a key can be queued more than once, so skip repeats.
+    THashIndex<INT>  indexDone;
+    for (INT  iIndex = 0; iIndex < auDirtyKeys.Length (); ++iIndex)
+      {
+      HASH_T  uKey = auDirtyKeys [iIndex];
+      if (indexDone.FindFirst (uKey) != -1) continue;
+      indexDone.Insert (uKey, iIndex);
+
+      ++statsLastResolve.iKeysResolved;
+      if (ResolveKey (uKey, *pRegFinal))
+        {
+        ++statsLastResolve.iKeysChanged;
+        auChangedKeys.Append (uKey);
+        };
+      };
+    auDirtyKeys.Clear ();
+
+    if (auChangedKeys.Length () == 0) break;
     };
 
-  sigOnResolveStack();
+  statsLastResolve.iExpressionsRun = INT (ConfigSubset::uNumExpressionsRun - uExprStart);
+  statsLastResolve.iTimeUs         = StopWatch::GetTimeUs () - iStartUs;
+
+  if (statsLastResolve.iKeysChanged > 0)
+    {
+    sigOnResolveStack();
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::MarkLayerDirty (ConfigLayer *  pLayerIn)
+  {
+  if (pLayerIn == NULL) return;
+
+  UntrackLayer (pLayerIn);
+  TrackLayer (pLayerIn);
+
+  for (INT  iIndex = 0; iIndex < apDirtyLayers.Length (); ++iIndex)
+    {
+    if (apDirtyLayers [iIndex] == pLayerIn) return;
+    };
+  apDirtyLayers.Append (pLayerIn);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::RankLayers (VOID)
+  {
+  // assign the same merge order that ResolveStack uses.
+  INT  iRank = 0;
+  for (INT  iPhase = 0; iPhase < 2; ++iPhase)
+    {
+    for (TListItr<ConfigLayer*>  itrCurr = listLayers.First ();
+          itrCurr.IsValid ();
+          ++itrCurr)
+      {
+      if ((*itrCurr)->IsExpressionDriven () == (iPhase == 1))
+        {
+        (*itrCurr)->iResolveRank = iRank++;
+        };
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::TrackLayer (ConfigLayer *  pLayerIn)
+  {
+  TArray<HASH_T>  auKeys;
+
+  pLayerIn->GetKeys (auKeys);
+  for (INT  iIndex = 0; iIndex < auKeys.Length (); ++iIndex)
+    {
+    InsertUnique (indexContributors, auKeys [iIndex], pLayerIn);
+    };
+
+  if (pLayerIn->IsExpressionDriven ())
+    {
+    auKeys.Clear ();
+    if (! pLayerIn->GetDependencies (auKeys))
+      {
+      apUntrackedDeps.Append (pLayerIn);
+      };
+    for (INT  iIndex = 0; iIndex < auKeys.Length (); ++iIndex)
+      {
+      InsertUnique (indexDependents, auKeys [iIndex], pLayerIn);
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::UntrackLayer (ConfigLayer *  pLayerIn)
+  {
+  indexContributors.RemoveValue (pLayerIn);
+  indexDependents.RemoveValue (pLayerIn);
+  for (INT  iIndex = apUntrackedDeps.Length () - 1; iIndex >= 0; --iIndex)
+    {
+    if (apUntrackedDeps [iIndex] == pLayerIn) {apUntrackedDeps.Remove (iIndex, 1);};
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::EvaluateLayer (ConfigLayer *     pLayerIn,
+                                ValueRegistry &   regIn,
+                                BOOL              bForceIn)
+  {
+  // Re-check which subsets of a layer are active.  If that changed, or the
+  //  layer was edited (bForceIn), queue both the keys it used to set and the
+  //  keys it sets now for recomputation.
+
+  BOOL            bActive    = pLayerIn->IsActive (regIn);
+  ConfigSubset *  psetActive = bActive ? pLayerIn->GetActiveSegment (regIn) : NULL;
+
+  ++statsLastResolve.iLayersEvaluated;
+
+  if ((! bForceIn) &&
+      (bActive    == pLayerIn->bResolvedActive) &&
+      (psetActive == pLayerIn->psetResolved))
+    {
+    return;
+    };
+  ++statsLastResolve.iLayersMerged;
+
+  for (INT  iIndex = 0; iIndex < pLayerIn->auResolvedKeys.Length (); ++iIndex)
+    {
+    auDirtyKeys.Append (pLayerIn->auResolvedKeys [iIndex]);
+    };
+
+  pLayerIn->bResolvedActive = bActive;
+  pLayerIn->psetResolved    = psetActive;
+  pLayerIn->auResolvedKeys.Clear ();
+  if (bActive)
+    {
+    pLayerIn->GetMergedKeys (psetActive, pLayerIn->auResolvedKeys);
+    };
+
+  for (INT  iIndex = 0; iIndex < pLayerIn->auResolvedKeys.Length (); ++iIndex)
+    {
+    auDirtyKeys.Append (pLayerIn->auResolvedKeys [iIndex]);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL ConfigDeck::ResolveKey (HASH_T           uKeyIn,
+                             ValueRegistry &  regIn)
+  {
+  // Rebuild the key the way a full reset ResolveStack would, by overlaying
+  //  every active contribution in merge order into an empty scratch registry.
+  //  Then only touch the real element if the result differs, so listeners
+  //  don't see changes for values that stayed the same.
+
+  TArray<ConfigLayer*>  apContrib;
+
+  for (INT  iSlot = indexContributors.FindFirst (uKeyIn); iSlot != -1; iSlot = indexContributors.FindNext (uKeyIn, iSlot))
+    {
+    ConfigLayer *  pLayer = indexContributors.GetAt (iSlot);
+    if (! pLayer->bResolvedActive) continue;
+
+    // insertion sort by merge rank.  There are rarely more than a few.
+    INT  iInsert = apContrib.Length ();
+    while ((iInsert > 0) && (apContrib [iInsert - 1]->iResolveRank > pLayer->iResolveRank))
+      {
+      --iInsert;
+      };
+    apContrib.Insert (iInsert, 1);
+    apContrib [iInsert] = pLayer;
+    };
+
+  regScratch.Clear ();
+  for (INT  iIndex = 0; iIndex < apContrib.Length (); ++iIndex)
+    {
+    ConfigLayer *   pLayer   = apContrib [iIndex];
+    ConfigSubset *  apsetMerge [2] = {pLayer->GetBaseSegment (), pLayer->psetResolved};
+
+    for (INT  iSet = 0; iSet < 2; ++iSet)
+      {
+      if (apsetMerge [iSet] == NULL) continue;
+
+      ValueElem *  pElem = apsetMerge [iSet]->regVariables.Find (uKeyIn);
+      if (pElem != NULL)
+        {
+        regScratch.OverlayElem (pElem, pLayer->GetOrder ());
+        };
+      };
+    };
+
+  ValueElem *  pElemResolved = regScratch.Find (uKeyIn);
+  ValueElem *  pElemExisting = regIn.Find (uKeyIn);
+
+  if (pElemResolved == NULL)
+    {
+    // no active layer sets this key anymore.
+    if (pElemExisting == NULL) return (FALSE);
+    regIn.DeleteElem (pElemExisting);
+    return (TRUE);
+    };
+
+  if (pElemExisting == NULL)
+    {
+    regIn.SetClone (pElemResolved);
+    return (TRUE);
+    };
+
+  if (ValuesMatch (*pElemExisting, *pElemResolved))
+    {
+    return (FALSE);
+    };
+
+  if (pElemExisting->IsType (pElemResolved->GetType ()))
+    {
+    // sets merge into their current contents, so empty them first.
+    if (pElemExisting->IsUniqueSet ())
+      {
+      pElemExisting->ClearArray ();
+      };
+    pElemExisting->SetByType (*pElemResolved);
+    pElemExisting->SetOrder (pElemResolved->GetOrder ());
+    }
+  else
+    {
+    // same replacement as ValueRegistry::OverlayElem uses for type changes.
+    pElemExisting->ZeroName ();
+    ValueElem *  pElemNew = regIn.SetClone (pElemResolved);
+    regIn.SwapIndexes (*pElemExisting, *pElemNew);
+    regIn.DeleteElem (pElemExisting);
+    };
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ConfigDeck::DebugPrintResolveStats (VOID)
+  {
+  printf ("ConfigDeck %s resolve: %d layers evaluated, %d merged, %d expressions, %d keys resolved, %d changed, %lld us\n",
+          statsLastResolve.bFullResolve ? "full" : "incremental",
+          statsLastResolve.iLayersEvaluated,
+          statsLastResolve.iLayersMerged,
+          statsLastResolve.iExpressionsRun,
+          statsLastResolve.iKeysResolved,
+          statsLastResolve.iKeysChanged,
+          (long long) statsLastResolve.iTimeUs);
   };
 
 //-----------------------------------------------------------------------------
@@ -40,8 +40,11 @@
 
 #include "Sys/Types.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/TArray.hpp"
+#include "Containers/THashIndex.hpp"
 #include "Util/RStr.hpp"
 #include "Util/RStrParser.hpp"
+#include "Containers/RStrArray.hpp"
 #include "Util/Signal.h"
 #include "ValueRegistry/ConfigLayer.hpp"
 
@@ -58,8 +61,48 @@ using namespace Gallant;
 //-----------------------------------------------------------------------------
 class ConfigDeck
   {
+  public:
+
+    /// Work done by the last ResolveStack or ResolveChanges call.
+    struct ResolveStats
+      {
+      BOOL    bFullResolve;       ///< True if every layer was re-merged
+      INT     iLayersEvaluated;   ///< Layers whose IsActive was evaluated
+      INT     iLayersMerged;      ///< Layers merged (full) or whose contribution changed (incremental)
+      INT     iExpressionsRun;    ///< Prereq/enabled expressions executed
+      INT     iKeysResolved;      ///< Keys written (full) or recomputed (incremental)
+      INT     iKeysChanged;       ///< Keys whose registry value changed
+      INT64   iTimeUs;            ///< Wall clock time of the resolve
+      };
+
+    static const INT      kMaxResolvePasses;   ///< Limit on ResolveChanges cascades through expression dependencies
+
+    static const UINT32   kSnapshotVersion = 1;
+
   protected:
 
+    /// One file read and parsed on a worker thread by ReadFiles.
+    struct ParseFileJob
+      {
+      RStr                   strPath;
+      RStr                   strSource;   ///< File name without extension, looked up before the job runs
+      TArray<ConfigLayer*>   apLayers;    ///< Layers parsed from the file, not yet in the deck
+      EStatus                status;
+
+      static VOID            Run          (VOID *  pJobIn);
+      };
+
+    INT                       iParseThreads;       ///< Threads ReadFiles parses on.  1 parses on the calling thread, 0 uses one per core.
+    THashIndex<ConfigLayer*>  indexContributors;   ///< Key hash -> layers that set the key in their base or any segment
+    THashIndex<ConfigLayer*>  indexDependents;     ///< Key hash -> expression driven layers that read the key
+    TArray<ConfigLayer*>      apUntrackedDeps;     ///< Expression driven layers whose dependencies can't be known ahead of time
+    TArray<ConfigLayer*>      apDirtyLayers;       ///< Layers added or edited since the last resolve
+    TArray<HASH_T>            auDirtyKeys;         ///< Keys that need to be recomputed on the next ResolveChanges
+    TArray<HASH_T>            auChangedKeys;       ///< Registry keys whose values changed since the last resolve
+    ValueRegistry *           pRegResolved;        ///< Registry the resolve state was built for, or NULL if a full resolve is needed
+    ValueRegistrySimple       regScratch;          ///< Working space for recomputing single keys
+    ResolveStats              statsLastResolve;
+
   public:
 
     TList<ConfigLayer*>   listLayers;
@@ -80,8 +123,20 @@ class ConfigDeck
 
     static VOID          Init               (VOID);
 
-    EStatus              Deserialize        (RStrParser &  parserJsonIn,
-                                             const char *  szSourceIn = NULL);
+    EStatus              Deserialize        (RStrParser &             parserJsonIn,
+                                             const char *             szSourceIn   = NULL,
+                                             TArray<ConfigLayer*> *   papLayersOut = NULL);
+
+                         /** @brief  Parse one layer or an array of layers without adding them to any deck.  Safe to
+                                     call from a worker thread.
+                             @param  parserJsonIn The JSON to parse.
+                             @param  szSourceIn Name of the source the layers came from.
+                             @param  apLayersOut Receives the new layers, which the caller owns.
+                             @return Success or failure.  Layers parsed before a failure are still returned.
+                         */
+    static EStatus       ParseLayers        (RStrParser &             parserJsonIn,
+                                             const char *             szSourceIn,
+                                             TArray<ConfigLayer*> &   apLayersOut);
 
     ConfigLayer *        FindLayerByName    (const char *  szNameIn);
 
@@ -100,9 +155,62 @@ class ConfigDeck
                                              const char *  szTypeIn,
                                              RStrParser &  parserIn);
 
-    EStatus              ReadFile           (const char *  szFileIn);
-
+    EStatus              ReadFile           (const char *             szFileIn,
+                                             TArray<ConfigLayer*> *   papLayersOut = NULL);
+
+                         /** @brief  Read a list of config files.  With more than one parse thread, the files are read
+                                     and parsed on a worker pool, and the layers are added in list order once all
+                                     are done, so the result matches a serial read.
+                             @param  arrayPathsIn The files to read, in stack order.
+                             @param  papLayersOut If not NULL, receives the layers added.
+                             @return Success, or the first failure.  Files that fail don't stop the others.
+                         */
+    EStatus              ReadFiles          (RStrArray &              arrayPathsIn,
+                                             TArray<ConfigLayer*> *   papLayersOut = NULL);
+
+                         /** @brief  Set how many threads ReadFiles and ReadDirectory parse on.  Parsing stays on
+                                     the calling thread while ChangeBatch is batching kValueElem.
+                             @param  iNumThreadsIn 1 to parse on the calling thread (the default), 0 for one per core.
+                             @return None
+                         */
+    VOID                 SetParseThreads    (INT  iNumThreadsIn)  {iParseThreads = iNumThreadsIn;};
+
+    INT                  GetParseThreads    (VOID)                {return (iParseThreads);};
+
+                         /** @brief  Read every matching config file in a directory.  If a snapshot of the same files
+                                     is still current it is loaded instead of parsing the JSON, otherwise the JSON
+                                     is parsed and a new snapshot written.
+                             @param  szRelativePathIn Directory to search.
+                             @param  szGlobMatchIn Glob the file names must match.
+                             @param  szSnapshotIn Snapshot file to use.  NULL picks one under GetConfigCachePath, and
+                                     an empty string disables snapshots.
+                             @return None
+                         */
     VOID                 ReadDirectory      (const char *  szRelativePathIn,
+                                             const char *  szGlobMatchIn,
+                                             const char *  szSnapshotIn = NULL);
+
+                         /** @brief  Write layers to a binary snapshot, along with the size, time and hash of their source files.
+                             @param  szFileIn The snapshot file to write.
+                             @param  arraySourcesIn The files the layers were read from.
+                             @param  apLayersIn The layers to store, in stack order.
+                             @return Success or failure.
+                         */
+    EStatus              WriteSnapshot      (const char *             szFileIn,
+                                             RStrArray &              arraySourcesIn,
+                                             TArray<ConfigLayer*> &   apLayersIn);
+
+                         /** @brief  Load the layers from a snapshot if it was written from the given source files and
+                                     they haven't changed since.
+                             @param  szFileIn The snapshot file to read.
+                             @param  arraySourcesIn The files the snapshot should have been built from.
+                             @return Success, or failure if the snapshot is missing, stale, or damaged.  Nothing
+                                     is added to the deck on failure.
+                         */
+    EStatus              ReadSnapshot       (const char *  szFileIn,
+                                             RStrArray &   arraySourcesIn);
+
+    static const char *  GetSnapshotPath    (const char *  szRelativePathIn,
                                              const char *  szGlobMatchIn);
 
     static INT           CompareLayerOrders (ConfigLayer*  pAIn,
@@ -111,12 +219,64 @@ class ConfigDeck
     VOID                 ResolveStack       (ValueRegistry *  pRegIn,
                                              BOOL             bFullResetIn);
 
+                         /** @brief  Re-resolve only the keys affected by layers marked dirty and registry keys marked
+                                     changed since the last resolve.  Falls back to a full ResolveStack if pRegIn
+                                     hasn't been resolved yet.
+                             @param  pRegIn The registry to resolve into, or NULL for pReg.
+                             @return None
+                         */
+    VOID                 ResolveChanges     (ValueRegistry *  pRegIn = NULL);
+
+                         /** @brief  Note that a layer was added or its contents edited, so ResolveChanges re-merges it.
+                             @param  pLayerIn The layer.
+                             @return None
+                         */
+    VOID                 MarkLayerDirty     (ConfigLayer *  pLayerIn);
+
+                         /** @brief  Note that a registry value changed, so ResolveChanges re-evaluates the expression
+                                     driven layers that read it.
+                             @param  szNameIn Name of the registry key.
+                             @return None
+                         */
+    VOID                 MarkKeyChanged     (const char *  szNameIn)    {MarkKeyChanged (CalcHashValue (szNameIn));};
+
+    VOID                 MarkKeyChanged     (HASH_T  uNameHashIn)       {auChangedKeys.Append (uNameHashIn);};
+
+                         /** @brief  Remove a layer from the stack and delete it.  Its keys are recomputed on the next ResolveChanges.
+                             @param  pLayerIn The layer to delete.
+                             @return None
+                         */
+    VOID                 DeleteLayer        (ConfigLayer *  pLayerIn);
+
+    const ResolveStats & GetResolveStats    (VOID)                      {return (statsLastResolve);};
+
+    VOID                 DebugPrintResolveStats (VOID);
+
     static const char *  GetConfigSavePath  ();
 
     static const char *  GetConfigCachePath ();
 
     static const char *  GetConfigPath      (const char *  szSubdirectory);
 
+  protected:
+
+    VOID                 ReplaceLayer       (ConfigLayer *  pLayerIn);
+
+    VOID                 AdoptLayers        (TArray<ConfigLayer*> &   apLayersIn,
+                                             TArray<ConfigLayer*> *   papLayersOut);
+
+    VOID                 RankLayers         (VOID);
+
+    VOID                 TrackLayer         (ConfigLayer *  pLayerIn);
+
+    VOID                 UntrackLayer       (ConfigLayer *  pLayerIn);
+
+    VOID                 EvaluateLayer      (ConfigLayer *     pLayerIn,
+                                             ValueRegistry &   regIn,
+                                             BOOL              bForceIn);
+
+    BOOL                 ResolveKey         (HASH_T           uKeyIn,
+                                             ValueRegistry &  regIn);
 
   };
 
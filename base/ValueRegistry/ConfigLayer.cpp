@@ -95,6 +95,22 @@ EStatus  ConfigLayer::Deserialize  (RStrParser &  parserIn,
   return (status);
   };
 
+//-----------------------------------------------------------------------------
+VOID  ConfigLayer::ToBinary  (RStrParser &  parserOut)
+  {
+  if (pBase == NULL) return;
+  pBase->ToBinary (parserOut);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ConfigLayer::FromBinary  (RStrParser &  parserIn)
+  {
+  RemoveAllSegments();
+  RemoveBaseSegment();
+  pBase = new ConfigSubset ();
+  return (pBase->FromBinary (parserIn));
+  };
+
 //-----------------------------------------------------------------------------
 VOID  ConfigLayer::ToJSON (RStrParser &  parserOut,
                            const char *  strSectionIndent,
@@ -180,11 +196,51 @@ VOID  ConfigLayer::RemoveAllSegments  (VOID)
 //-----------------------------------------------------------------------------
 VOID  ConfigLayer::MergeInto          (ValueRegistry &  regTargetIn)
   {
+  MergeInto (regTargetIn, GetActiveSegment (regTargetIn));
+  };
 
+//-----------------------------------------------------------------------------
+VOID  ConfigLayer::MergeInto          (ValueRegistry &  regTargetIn,
+                                       ConfigSubset *   psetActiveIn)
+  {
   ConfigSubset *  psetBase   = GetBaseSegment();
-  ConfigSubset *  psetActive = GetActiveSegment(regTargetIn);
   INT             iOrder     = GetOrder();
 
-  if (psetBase != NULL)   psetBase->MergeInto   (regTargetIn, iOrder);
-  if (psetActive != NULL) psetActive->MergeInto (regTargetIn, iOrder);
+  if (psetBase != NULL)     psetBase->MergeInto     (regTargetIn, iOrder);
+  if (psetActiveIn != NULL) psetActiveIn->MergeInto (regTargetIn, iOrder);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigLayer::GetKeys  (TArray<HASH_T> &  auKeysOut)
+  {
+  if (pBase == NULL) return;
+  pBase->GetKeys (auKeysOut);
+  for (TListItr<ConfigSubset*>  itrCurr = pBase->listSegments.First ();
+       itrCurr.IsValid ();
+       ++itrCurr)
+    {
+    (*itrCurr)->GetKeys (auKeysOut);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigLayer::GetMergedKeys  (ConfigSubset *     psetActiveIn,
+                                   TArray<HASH_T> &   auKeysOut)
+  {
+  if (pBase != NULL)        pBase->GetKeys        (auKeysOut);
+  if (psetActiveIn != NULL) psetActiveIn->GetKeys (auKeysOut);
+  };
+
+//-----------------------------------------------------------------------------
+BOOL  ConfigLayer::GetDependencies  (TArray<HASH_T> &  auKeysOut)
+  {
+  if (pBase == NULL) return (TRUE);
+  BOOL  bAllKnown = pBase->GetDependencies (auKeysOut);
+  for (TListItr<ConfigSubset*>  itrCurr = pBase->listSegments.First ();
+       itrCurr.IsValid ();
+       ++itrCurr)
+    {
+    if (! (*itrCurr)->GetDependencies (auKeysOut)) {bAllKnown = FALSE;};
+    };
+  return (bAllKnown);
   };
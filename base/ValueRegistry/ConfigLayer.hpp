@@ -65,10 +65,19 @@ class ConfigLayer
 
     //BOOL    bClearOnReset;
 
+    // State from the last ConfigDeck resolve, used to re-resolve incrementally.
+    BOOL                  bResolvedActive;     ///< IsActive result
+    ConfigSubset *        psetResolved;        ///< Active segment that was merged, or NULL
+    INT                   iResolveRank;        ///< Position of the layer in the merge order
+    INT                   iResolveStamp;       ///< Last ResolveChanges pass that evaluated this layer
+    TArray<HASH_T>        auResolvedKeys;      ///< Keys merged into the registry
+
   public:
 
                           ConfigLayer       ()                    {//bClearOnReset = FALSE;
-                                                                   pBase = NULL;};
+                                                                   pBase = NULL;
+                                                                   bResolvedActive = FALSE; psetResolved = NULL;
+                                                                   iResolveRank = 0; iResolveStamp = 0;};
 
     virtual               ~ConfigLayer      ()                    {RemoveBaseSegment(); Clear();};
 
@@ -109,6 +118,33 @@ class ConfigLayer
 
     VOID                  MergeInto          (ValueRegistry &  regTargetIn);
 
+    VOID                  MergeInto          (ValueRegistry &  regTargetIn,
+                                              ConfigSubset *   psetActiveIn);
+
+                          /** @brief  Append the keys set by the base or any segment.  Keys may repeat.
+                              @param  auKeysOut Array the key hashes are appended to.
+                              @return None
+                          */
+    VOID                  GetKeys            (TArray<HASH_T> &  auKeysOut);
+
+                          /** @brief  Append the keys MergeInto would set with the given active segment.
+                              @param  psetActiveIn The active segment, or NULL.
+                              @param  auKeysOut Array the key hashes are appended to.
+                              @return None
+                          */
+    VOID                  GetMergedKeys      (ConfigSubset *     psetActiveIn,
+                                              TArray<HASH_T> &   auKeysOut);
+
+                          /** @brief  Append the registry keys read by the base and segment expressions.
+                              @param  auKeysOut Array the key hashes are appended to.
+                              @return False if some keys can't be known ahead of time.
+                          */
+    BOOL                  GetDependencies    (TArray<HASH_T> &  auKeysOut);
+
+    VOID                  ToBinary           (RStrParser &  parserOut);
+
+    EStatus               FromBinary         (RStrParser &  parserIn);
+
   };
 
 
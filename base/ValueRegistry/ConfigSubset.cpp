@@ -46,6 +46,26 @@ ASSERTFILE (__FILE__)
 #include "Util/ParseTools.hpp"
 
 
+UINT32  ConfigSubset::uNumExpressionsRun = 0;
+
+//-----------------------------------------------------------------------------
+static VOID  SetBinaryString (RStrParser &  parserOut,
+                              const RStr &  strIn)
+  {
+  parserOut.SetU4_BEnd (strIn.Length ());
+  parserOut.SetData    (strIn.AsUChar (), strIn.Length ());
+  };
+
+//-----------------------------------------------------------------------------
+static VOID  GetBinaryString (RStrParser &  parserIn,
+                              RStr &        strOut)
+  {
+  strOut.Empty ();
+  INT  iLength = parserIn.GetU4_BEnd ();
+  parserIn.GetData (&strOut, iLength);
+  };
+
+
 
 /*
 [
@@ -552,6 +572,7 @@ BOOL  ConfigSubset::EvaluateExpression (RStr &           strExpressionIn,
   // TODO: Set the subseg name to a variable for use in seeing if an AB test is activating it.
 
   Token  tokResult;
+  ++uNumExpressionsRun;
   Expression::Execute (strPreReq.AsChar (), &regIn, &tokResult);
 
   return (tokResult.AsInt () != 0);
@@ -571,6 +592,144 @@ BOOL  ConfigSubset::IsExpressionDriven  (VOID)
   return (TRUE);
   };
 
+//-----------------------------------------------------------------------------
+BOOL  ConfigSubset::GetDependencies  (TArray<HASH_T> &  auKeysOut)
+  {
+  // Identifiers that aren't followed by a paren are variable reads, the same
+  //  rule Expression::Compile uses.  Names built with ${} expansion can't be
+  //  known until the expression runs, and neither can the keys a function
+  //  call reads (GetInt, Eval, ...), so either makes the subset untracked.
+
+  BOOL    bAllKnown = TRUE;
+  RStr *  apstrExpressions [2] = {&strPreReq, &strEnabled};
+
+  for (INT  iExpr = 0; iExpr < 2; ++iExpr)
+    {
+    if (apstrExpressions [iExpr]->IsEmpty ()) continue;
+
+    TList<Token*> *  plistTokens = Expression::Tokenize (apstrExpressions [iExpr]->AsChar ());
+
+    for (TListItr<Token*>  itrCurr = plistTokens->First (); itrCurr.IsValid (); ++itrCurr)
+      {
+      if ((*itrCurr)->strRaw.Contains ("$"))
+        {
+        bAllKnown = FALSE;
+        }
+      else if ((*itrCurr)->IsType (TokenType::kIdentifier))
+        {
+        TListItr<Token*>  itrNext = itrCurr; ++itrNext;
+        if (itrNext.IsValid () && (*itrNext)->IsType (TokenType::kParenL))
+          {
+          bAllKnown = FALSE;
+          }
+        else
+          {
+          auKeysOut.Append (CalcHashValue ((*itrCurr)->strRaw.AsChar ()));
+          };
+        };
+      };
+    Expression::FreeTokenList (&plistTokens);
+    };
+  return (bAllKnown);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigSubset::GetKeys  (TArray<HASH_T> &  auKeysOut)
+  {
+  INT  iNumElem = regVariables.Size ();
+  for (INT  iIndex = 0; iIndex < iNumElem; ++iIndex)
+    {
+    auKeysOut.Append (regVariables.FindByIndex (iIndex)->GetNameHash ());
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ConfigSubset::ToBinary  (RStrParser &  parserOut)
+  {
+  SetBinaryString (parserOut, strName);
+  SetBinaryString (parserOut, strDesc);
+  SetBinaryString (parserOut, strEnabled);
+  SetBinaryString (parserOut, strPreReq);
+  SetBinaryString (parserOut, strPrefix);
+  parserOut.SetU4_BEnd (UINT32 (iOrder));
+
+  // variables are stored with their name hash so the registry doesn't
+  //  have to search by string while loading.
+  INT  iNumElem = regVariables.Size ();
+  parserOut.SetU4_BEnd (iNumElem);
+  for (INT  iIndex = 0; iIndex < iNumElem; ++iIndex)
+    {
+    ValueElem *  pElem = regVariables.FindByIndex (iIndex);
+
+    parserOut.SetU4_BEnd (pElem->GetType ());
+    parserOut.SetU4_BEnd (pElem->GetNameHash ());
+    SetBinaryString (parserOut, pElem->GetNameStr ());
+    SetBinaryString (parserOut, pElem->GetAltNameStr ());
+    parserOut.SetU1_BEnd (pElem->IsUniqueSet () ? 1 : 0);
+    pElem->ToParser (parserOut);
+    };
+
+  parserOut.SetU4_BEnd (listSegments.Size ());
+  for (TListItr<ConfigSubset*>  itrCurr = listSegments.First ();
+       itrCurr.IsValid ();
+       ++itrCurr)
+    {
+    (*itrCurr)->ToBinary (parserOut);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ConfigSubset::FromBinary  (RStrParser &  parserIn)
+  {
+  RStr  strElemName;
+  RStr  strElemAltName;
+
+  RemoveAll ();
+
+  GetBinaryString (parserIn, strName);
+  GetBinaryString (parserIn, strDesc);
+  GetBinaryString (parserIn, strEnabled);
+  GetBinaryString (parserIn, strPreReq);
+  GetBinaryString (parserIn, strPrefix);
+  strName.CalcHash ();
+  iOrder = INT (parserIn.GetU4_BEnd ());
+
+  INT  iNumElem = parserIn.GetU4_BEnd ();
+  for (INT  iIndex = 0; iIndex < iNumElem; ++iIndex)
+    {
+    UINT32  uType     = parserIn.GetU4_BEnd ();
+    HASH_T  uNameHash = parserIn.GetU4_BEnd ();
+
+    GetBinaryString (parserIn, strElemName);
+    GetBinaryString (parserIn, strElemAltName);
+    BOOL  bUniqueSet = (parserIn.GetU1_BEnd () == 1);
+
+    ValueElem *  pElem = regVariables.NewByType (uType, uNameHash, strElemName.AsChar (), strElemAltName.AsChar ());
+    if (pElem == NULL)
+      {
+      return (EStatus::Failure ("ConfigSubset::FromBinary - unknown value type"));
+      };
+    if (pElem->GetNameHash () != uNameHash)
+      {
+      return (EStatus::Failure ("ConfigSubset::FromBinary - name hash mismatch"));
+      };
+    pElem->MakeUniqueSet (bUniqueSet);
+    pElem->FromParser (parserIn);
+    };
+
+  INT  iNumSegments = parserIn.GetU4_BEnd ();
+  for (INT  iIndex = 0; iIndex < iNumSegments; ++iIndex)
+    {
+    ConfigSubset *  psetNew = listSegments.PushBack (new ConfigSubset ());
+    EStatus         status  = psetNew->FromBinary (parserIn);
+    if (status == EStatus::kFailure)
+      {
+      return (status);
+      };
+    };
+  return (EStatus::kSuccess);
+  };
+
 //-----------------------------------------------------------------------------
 VOID  ConfigSubset::MergeInto  (ValueRegistry &  regTargetIn,
                                 INT              iOrderIn)
@@ -40,6 +40,7 @@
 
 #include "Sys/Types.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/TArray.hpp"
 #include "Util/RStr.hpp"
 #include "Util/RStrParser.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
@@ -76,6 +77,8 @@ class ConfigSubset
 
     TList<ConfigSubset*>  listSegments;
 
+    static UINT32         uNumExpressionsRun;  ///< Count of expressions executed by EvaluateExpression, for resolve diagnostics
+
   public:
 
                   ConfigSubset        ()                   {iOrder = 0;};
@@ -109,9 +112,33 @@ class ConfigSubset
 
     BOOL          IsExpressionDriven  (VOID);
 
+                  /** @brief  Append the registry keys read by the prereq and enabled expressions.
+                      @param  auKeysOut Array the key hashes are appended to.
+                      @return False if a key can't be known ahead of time (${} expansion or a function call).
+                  */
+    BOOL          GetDependencies     (TArray<HASH_T> &  auKeysOut);
+
+                  /** @brief  Append the hash of every variable this subset sets.
+                      @param  auKeysOut Array the key hashes are appended to.
+                      @return None
+                  */
+    VOID          GetKeys             (TArray<HASH_T> &  auKeysOut);
+
     VOID          MergeInto           (ValueRegistry &  regTargetIn,
                                        INT              iOrderIn);
 
+                  /** @brief  Write the subset and its segments in the ConfigDeck snapshot format.
+                      @param  parserOut Receives the binary data.
+                      @return None
+                  */
+    VOID          ToBinary            (RStrParser &  parserOut);
+
+                  /** @brief  Read a subset and its segments written by ToBinary.
+                      @param  parserIn The binary data.  Reading starts at the cursor.
+                      @return Success, or failure if a value can't be restored.
+                  */
+    EStatus       FromBinary          (RStrParser &  parserIn);
+
   };
 
 
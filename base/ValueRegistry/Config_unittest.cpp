@@ -12,6 +12,11 @@ ASSERTFILE (__FILE__)
 #include "ValueRegistry/ConfigLayer.hpp"
 #include "ValueRegistry/ConfigSubset.hpp"
 #include "ValueRegistry/ConfigDeck.hpp"
+#include "Sys/FilePath.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/WorkerPool.hpp"
+#include "Sys/UnitTestMain.hpp"
+#include <unistd.h>
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 
@@ -274,3 +279,371 @@ TEST (ConfigLayer, Prefix)
   delete (pDeck);
   };
 
+
+//-----------------------------------------------------------------------------
+TEST (ConfigDeck, IncrementalResolve)
+  {
+  ValueRegistrySimple  registry;
+  ValueRegistrySimple  registryFull;
+
+  ConfigDeck *  pDeck = new ConfigDeck (&registry);
+
+  // a handful of plain layers, plus one layer driven by a registry value.
+  RStr   strBuffer ("[\n");
+  for (INT  iLayer = 0; iLayer < 20; ++iLayer)
+    {
+    strBuffer.AppendFormat ("{ \"name\" : \"filler_%d\", \"order\" : %d, \"variables\" : { \"int:Filler.%d\" : %d, \"int:Var.Shared\" : %d } },\n",
+                            iLayer, iLayer, iLayer, iLayer, iLayer);
+    };
+  strBuffer.AppendString (R"""(
+      {
+      "name" : "gated",
+      "prereq" : "Var.Gate == 1",
+      "order" : 5,
+      "variables" :
+        {
+        "int:Var.Gated" : 10,
+        "int:Var.Shared" : 100
+        }
+      }
+    ]
+    )""");
+
+  pDeck->ReadBuffer ("", "rcfg", strBuffer.AsChar ());
+  ASSERT_EQ (pDeck->GetLayerCount (), 21);
+  ASSERT_TRUE (pDeck->GetResolveStats ().bFullResolve);
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersEvaluated, 21);
+  ASSERT_EQ (registry.GetInt ("Var.Shared"), 19);
+  ASSERT_FALSE (registry.HasKey ("Var.Gated"));
+
+  // nothing changed, so nothing is done.
+  pDeck->ResolveChanges ();
+  ASSERT_FALSE (pDeck->GetResolveStats ().bFullResolve);
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersEvaluated, 0);
+  ASSERT_EQ (pDeck->GetResolveStats ().iKeysResolved, 0);
+
+  // flipping the gate only re-evaluates the layer that reads it.  Expression
+  //  layers merge after the fixed ones, so it wins Var.Shared.
+  registry.SetInt ("Var.Gate", 1);
+  pDeck->MarkKeyChanged ("Var.Gate");
+  pDeck->ResolveChanges ();
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersEvaluated, 1);
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersMerged, 1);
+  ASSERT_GT (pDeck->GetResolveStats ().iExpressionsRun, 0);
+  ASSERT_EQ (pDeck->GetResolveStats ().iKeysResolved, 2);
+  ASSERT_EQ (pDeck->GetResolveStats ().iKeysChanged, 2);
+  ASSERT_EQ (registry.GetInt ("Var.Gated"), 10);
+  ASSERT_EQ (registry.GetInt ("Var.Shared"), 100);
+
+  // keys that don't feed an expression don't cause any work.
+  pDeck->MarkKeyChanged ("Filler.3");
+  pDeck->ResolveChanges ();
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersEvaluated, 0);
+
+  registry.SetInt ("Var.Gate", 0);
+  pDeck->MarkKeyChanged ("Var.Gate");
+  pDeck->ResolveChanges ();
+  ASSERT_FALSE (registry.HasKey ("Var.Gated"));
+  ASSERT_EQ (registry.GetInt ("Var.Shared"), 19);
+  ASSERT_EQ (registry.GetInt ("Var.Gate"), 0);
+
+  // a live update to one layer replaces it and only touches its keys.
+  pDeck->ReadBuffer ("", "rcfg", R"""([{ "name" : "filler_7", "order" : 7, "variables" : { "int:Filler.7" : 77, "int:Filler.New" : 1 } }])""");
+  ASSERT_EQ (pDeck->GetLayerCount (), 21);
+  ASSERT_FALSE (pDeck->GetResolveStats ().bFullResolve);
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersEvaluated, 1);
+  ASSERT_EQ (pDeck->GetResolveStats ().iKeysResolved, 3);
+  ASSERT_EQ (pDeck->GetResolveStats ().iKeysChanged, 2);
+  ASSERT_EQ (registry.GetInt ("Filler.7"), 77);
+  ASSERT_EQ (registry.GetInt ("Filler.New"), 1);
+  ASSERT_EQ (registry.GetInt ("Var.Shared"), 19);
+
+  //pDeck->DebugPrintResolveStats ();
+
+  // the incremental result matches a full resolve.
+  registryFull.SetInt ("Var.Gate", 0);
+  pDeck->ResolveStack (&registryFull, FALSE);
+  ASSERT_EQ (registryFull.Size (), registry.Size ());
+  for (INT  iIndex = 0; iIndex < registryFull.Size (); ++iIndex)
+    {
+    ValueElem *  pElem = registryFull.FindByIndex (iIndex);
+    ASSERT_TRUE (registry.HasKey (pElem->GetName ()));
+    ASSERT_EQ (registry.GetInt (pElem->GetName ()), pElem->GetInt ());
+    };
+
+  delete (pDeck);
+  };
+
+//-----------------------------------------------------------------------------
+TEST (ConfigDeck, FunctionCallGate)
+  {
+  ValueRegistrySimple  registry;
+
+  ConfigDeck *  pDeck = new ConfigDeck (&registry);
+
+  // the key GetInt reads is only known when the expression runs, so the layer
+  //  is re-checked on any change instead of being missed.
+  pDeck->ReadBuffer ("", "rcfg", R"""(
+    [
+      { "name" : "base", "order" : 0, "variables" : { "int:Var.Value" : 1 } },
+      {
+      "name" : "gated",
+      "prereq" : "GetInt (\"Var.X\") == 1",
+      "order" : 1,
+      "variables" : { "int:Var.Value" : 2 }
+      }
+    ]
+    )""");
+  ASSERT_EQ (registry.GetInt ("Var.Value"), 1);
+
+  registry.SetInt ("Var.X", 1);
+  pDeck->MarkKeyChanged ("Var.X");
+  pDeck->ResolveChanges ();
+  ASSERT_EQ (pDeck->GetResolveStats ().iLayersMerged, 1);
+  ASSERT_EQ (registry.GetInt ("Var.Value"), 2);
+
+  registry.SetInt ("Var.X", 0);
+  pDeck->MarkKeyChanged ("Var.X");
+  pDeck->ResolveChanges ();
+  ASSERT_EQ (registry.GetInt ("Var.Value"), 1);
+
+  delete (pDeck);
+  };
+
+//-----------------------------------------------------------------------------
+static BOOL  RegistriesMatch (ValueRegistrySimple &  regAIn,
+                              ValueRegistrySimple &  regBIn)
+  {
+  if (regAIn.Size () != regBIn.Size ()) return (FALSE);
+  for (INT  iIndex = 0; iIndex < regAIn.Size (); ++iIndex)
+    {
+    ValueElem *  pElemA = regAIn.FindByIndex (iIndex);
+    ValueElem *  pElemB = regBIn.Find (pElemA->GetNameHash ());
+    if ((pElemB == NULL) || (! pElemB->IsType (pElemA->GetType ()))) return (FALSE);
+
+    RStrParser  parserA;
+    RStrParser  parserB;
+    pElemA->ToParser (parserA);
+    pElemB->ToParser (parserB);
+    if ((parserA.Length () != parserB.Length ()) ||
+        (memcmp (parserA.AsChar (), parserB.AsChar (), parserA.Length ()) != 0)) return (FALSE);
+    };
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+TEST (ConfigDeck, Snapshot)
+  {
+  RStr  strDir;
+  strDir.Format ("/tmp/ConfigDeckSnapshot_%d", INT (StopWatch::GetTimeUs () & 0xffffff));
+  FilePath::MakeDir (strDir.AsChar ());
+
+  RStr  strFileA     (FilePath::Combine (strDir.AsChar (), "a.json"));
+  RStr  strFileB     (FilePath::Combine (strDir.AsChar (), "b.json"));
+  RStr  strSnapshot  (FilePath::Combine (strDir.AsChar (), "snapshot.cfgs"));
+
+  // 200 layers when timing the snapshot, otherwise enough to cover the cases.
+  const INT   iNumLayers = UnitTestBenchmarks () ? 200 : 20;
+
+  RStrParser  parserA ("[\n");
+  for (INT  iLayer = 0; iLayer < iNumLayers; ++iLayer)
+    {
+    parserA.AppendFormat ("{ \"name\" : \"layer_%d\", \"order\" : %d, \"prereq\" : \"%s\",\n"
+                          "  \"variables\" : { \"int:Int.%d\" : %d, \"float:Float.%d\" : %d.5, \"string:Str.%d\" : \"value %d\",\n"
+                          "                    \"stringset:Set.Shared\" : [\"S%d\"], \"intarray:IntArray.%d\" : [1, 2, %d] },\n"
+                          "  \"segments\" : [ { \"name\" : \"SegA\", \"prereq\" : \"false\", \"variables\" : { \"int:Int.%d\" : -1 } },\n"
+                          "                   { \"name\" : \"SegB\", \"prereq\" : \"\", \"variables\" : { \"bool:Bool.%d\" : true } } ] },\n",
+                          iLayer, iLayer, (iLayer % 10 == 0) ? "Int.1 == 1" : "",
+                          iLayer, iLayer, iLayer, iLayer, iLayer, iLayer,
+                          iLayer % 5, iLayer, iLayer, iLayer, iLayer);
+    };
+  parserA.AppendString ("]\n");
+  ASSERT_EQ (parserA.WriteToFile (strFileA.AsChar ()), EStatus::kSuccess);
+
+  RStrParser  parserB (R"""([{ "name" : "layer_3", "order" : 300, "variables" : { "int:Int.3" : 33, "int:Alias.Name|Alias.Alt" : 5 } }])""");
+  ASSERT_EQ (parserB.WriteToFile (strFileB.AsChar ()), EStatus::kSuccess);
+
+  FilePath    filePath;
+  RStr        strSpec (FilePath::Combine (strDir.AsChar (), "*.json"));
+  RStrArray   arrayPaths = filePath.lsf (strSpec.AsChar (), TRUE);
+  ASSERT_EQ (arrayPaths.Length (), 2);
+
+  // parse the json, which writes the snapshot.
+  ValueRegistrySimple  regJson;
+  ConfigDeck *         pDeckJson = new ConfigDeck (&regJson);
+
+  INT64  iJsonStartUs = StopWatch::GetTimeUs ();
+  pDeckJson->ReadDirectory (strDir.AsChar (), "*.json", strSnapshot.AsChar ());
+  INT64  iJsonUs = StopWatch::GetTimeUs () - iJsonStartUs;
+
+  ASSERT_TRUE (FilePath::FileExists (strSnapshot.AsChar ()));
+  // b.json's layer_3 replaces a.json's.
+  ASSERT_EQ (pDeckJson->GetLayerCount (), iNumLayers);
+  pDeckJson->ResolveStack (&regJson, TRUE);
+  ASSERT_EQ (regJson.GetInt ("Int.3"), 33);
+
+  // load the snapshot into a fresh deck, and it should resolve the same way.
+  ValueRegistrySimple  regSnap;
+  ConfigDeck *         pDeckSnap = new ConfigDeck (&regSnap);
+
+  INT64  iSnapStartUs = StopWatch::GetTimeUs ();
+  ASSERT_EQ (pDeckSnap->ReadSnapshot (strSnapshot.AsChar (), arrayPaths), EStatus::kSuccess);
+  INT64  iSnapUs = StopWatch::GetTimeUs () - iSnapStartUs;
+
+  ASSERT_EQ (pDeckSnap->GetLayerCount (), iNumLayers);
+  pDeckSnap->ResolveStack (&regSnap, TRUE);
+  ASSERT_TRUE (RegistriesMatch (regJson, regSnap));
+  ASSERT_EQ (regSnap.GetArrayLength ("Set.Shared"), 5);
+  ASSERT_TRUE (pDeckSnap->FindLayerByName ("layer_10")->IsExpressionDriven ());
+
+  // alt names survive the snapshot and can still be looked up.
+  ValueRegistrySimple &  regJsonVars = pDeckJson->FindLayerByName ("layer_3")->GetBaseSegment ()->regVariables;
+  ValueRegistrySimple &  regSnapVars = pDeckSnap->FindLayerByName ("layer_3")->GetBaseSegment ()->regVariables;
+  ASSERT_TRUE (regJsonVars.Find ("Alias.Alt") != NULL);
+  ASSERT_TRUE (regSnapVars.Find ("Alias.Alt") != NULL);
+  ASSERT_TRUE (regSnapVars.Find ("Alias.Alt") == regSnapVars.Find ("Alias.Name"));
+  ASSERT_EQ (regSnapVars.Find ("Alias.Alt")->GetInt (), 5);
+
+  BenchmarkPrintf ("Config load, %d layers:  json %8.3f ms  snapshot %8.3f ms  speedup %.1fx\n",
+                   iNumLayers, iJsonUs / 1000.0, iSnapUs / 1000.0, (iSnapUs > 0) ? DOUBLE (iJsonUs) / DOUBLE (iSnapUs) : 0.0);
+
+  // rewriting a file with the same contents only changes its time, so the
+  //  snapshot is still used.
+  ASSERT_EQ (parserB.WriteToFile (strFileB.AsChar ()), EStatus::kSuccess);
+  ConfigDeck *  pDeckTouched = new ConfigDeck (&regSnap);
+  ASSERT_EQ (pDeckTouched->ReadSnapshot (strSnapshot.AsChar (), arrayPaths), EStatus::kSuccess);
+  ASSERT_EQ (pDeckTouched->GetLayerCount (), iNumLayers);
+
+  // changed contents make it stale, and nothing is loaded.
+  RStrParser  parserBChanged (R"""([{ "name" : "layer_3", "order" : 300, "variables" : { "int:Int.3" : 34 } }])""");
+  ASSERT_EQ (parserBChanged.WriteToFile (strFileB.AsChar ()), EStatus::kSuccess);
+  ConfigDeck *  pDeckStale = new ConfigDeck (&regSnap);
+  ASSERT_EQ (pDeckStale->ReadSnapshot (strSnapshot.AsChar (), arrayPaths), EStatus::kFailure);
+  ASSERT_EQ (pDeckStale->GetLayerCount (), 0);
+
+  // ReadDirectory falls back to the json and refreshes the snapshot.
+  pDeckStale->ReadDirectory (strDir.AsChar (), "*.json", strSnapshot.AsChar ());
+  pDeckStale->ResolveStack (&regSnap, TRUE);
+  ASSERT_EQ (regSnap.GetInt ("Int.3"), 34);
+  ConfigDeck *  pDeckFresh = new ConfigDeck (&regSnap);
+  ASSERT_EQ (pDeckFresh->ReadSnapshot (strSnapshot.AsChar (), arrayPaths), EStatus::kSuccess);
+
+  remove (strFileA.AsChar ());
+  remove (strFileB.AsChar ());
+  remove (strSnapshot.AsChar ());
+  rmdir (strDir.AsChar ());
+
+  pDeckJson->DeleteAllLayers ();
+  pDeckSnap->DeleteAllLayers ();
+  pDeckTouched->DeleteAllLayers ();
+  pDeckStale->DeleteAllLayers ();
+  pDeckFresh->DeleteAllLayers ();
+  delete (pDeckJson);
+  delete (pDeckSnap);
+  delete (pDeckTouched);
+  delete (pDeckStale);
+  delete (pDeckFresh);
+  };
+
+//-----------------------------------------------------------------------------
+TEST (ConfigDeck, ParallelRead)
+  {
+  RStr  strDir;
+  strDir.Format ("/tmp/ConfigDeckParallel_%d", INT (StopWatch::GetTimeUs () & 0xffffff));
+  FilePath::MakeDir (strDir.AsChar ());
+
+  // every file replaces the "shared" layer, so the result depends on the
+  //  files being added in order.  300 files when timing the parse.
+  const INT    kNumFiles = UnitTestBenchmarks () ? 300 : 30;
+  RStrArray    arrayFiles;
+  for (INT  iFile = 0; iFile < kNumFiles; ++iFile)
+    {
+    RStr  strName;
+    strName.Format ("layer_%03d.json", iFile);
+    RStr  strFile (FilePath::Combine (strDir.AsChar (), strName.AsChar ()));
+
+    RStrParser  parserFile ("[\n");
+    for (INT  iLayer = 0; iLayer < 8; ++iLayer)
+      {
+      parserFile.AppendFormat ("{ \"name\" : \"file_%d_%d\", \"order\" : %d, \"prereq\" : \"%s\",\n"
+                               "  \"variables\" : { \"int:Int.%d.%d\" : %d, \"float:Float.%d\" : %d.5, \"string:Str.%d\" : \"value %d\",\n"
+                               "                    \"intarray:IntArray.%d\" : [1, 2, %d] },\n"
+                               "  \"segments\" : [ { \"name\" : \"SegA\", \"prereq\" : \"false\", \"variables\" : { \"int:Int.Seg\" : -1 } } ] },\n",
+                               iFile, iLayer, iFile, (iLayer == 0) ? "Int.0.1 == 1" : "",
+                               iFile, iLayer, iLayer, iFile, iLayer, iFile, iLayer, iFile, iLayer);
+      };
+    parserFile.AppendFormat ("{ \"name\" : \"shared\", \"order\" : 1000, \"variables\" : { \"int:Int.Shared\" : %d } }\n]\n", iFile);
+    ASSERT_EQ (parserFile.WriteToFile (strFile.AsChar ()), EStatus::kSuccess);
+    arrayFiles.Append (strFile);
+    };
+
+  ValueRegistrySimple  regSerial;
+  ConfigDeck *         pDeckSerial = new ConfigDeck (&regSerial);
+
+  INT64  iSerialStartUs = StopWatch::GetTimeUs ();
+  pDeckSerial->ReadDirectory (strDir.AsChar (), "*.json", "");
+  INT64  iSerialUs = StopWatch::GetTimeUs () - iSerialStartUs;
+
+  ValueRegistrySimple  regParallel;
+  ConfigDeck *         pDeckParallel = new ConfigDeck (&regParallel);
+  // use the pool even on a single core machine, so the merge is exercised.
+  INT                  iNumThreads = RMax (WorkerPool::DefaultThreadCount (), 4);
+  pDeckParallel->SetParseThreads (iNumThreads);
+
+  INT64  iParallelStartUs = StopWatch::GetTimeUs ();
+  pDeckParallel->ReadDirectory (strDir.AsChar (), "*.json", "");
+  INT64  iParallelUs = StopWatch::GetTimeUs () - iParallelStartUs;
+
+  // same layers, in the same stack order.
+  ASSERT_EQ (pDeckSerial->GetLayerCount (), kNumFiles * 8 + 1);
+  ASSERT_EQ (pDeckParallel->GetLayerCount (), pDeckSerial->GetLayerCount ());
+  TListItr<ConfigLayer*>  itrSerial   = pDeckSerial->listLayers.First ();
+  TListItr<ConfigLayer*>  itrParallel = pDeckParallel->listLayers.First ();
+  for (; itrSerial.IsValid (); ++itrSerial, ++itrParallel)
+    {
+    ASSERT_TRUE (itrParallel.IsValid ());
+    ASSERT_STREQ ((*itrSerial)->GetName (), (*itrParallel)->GetName ());
+    };
+
+  pDeckSerial->ResolveStack (&regSerial, TRUE);
+  pDeckParallel->ResolveStack (&regParallel, TRUE);
+  // the shared layer comes from whichever file the directory listing gave last.
+  FilePath    filePath;
+  RStr        strSpec (FilePath::Combine (strDir.AsChar (), "*.json"));
+  RStrArray   arrayListed = filePath.lsf (strSpec.AsChar (), TRUE);
+  RStr        strLast (FilePath::GetFilenameNoExtFromPath (arrayListed [arrayListed.Length () - 1].AsChar ()));
+  ASSERT_EQ (regParallel.GetInt ("Int.Shared"), atoi (strLast.AsChar () + strlen ("layer_")));
+  ASSERT_TRUE (RegistriesMatch (regSerial, regParallel));
+
+  // a file that fails to parse doesn't keep the others from loading.
+  RStrParser  parserBad ("[ { \"name\" : \"bad\", \"variables\" : { \"nosuchtype:Bad\" : 1 } } ]");
+  RStr        strBad (FilePath::Combine (strDir.AsChar (), "bad.json"));
+  ASSERT_EQ (parserBad.WriteToFile (strBad.AsChar ()), EStatus::kSuccess);
+  RStrArray   arrayWithBad;
+  arrayWithBad.Append (arrayFiles [0]);
+  arrayWithBad.Append (strBad);
+  arrayWithBad.Append (arrayFiles [1]);
+
+  ConfigDeck *  pDeckBad = new ConfigDeck (&regParallel);
+  pDeckBad->SetParseThreads (3);
+  ASSERT_EQ (pDeckBad->ReadFiles (arrayWithBad), EStatus::kFailure);
+  ASSERT_EQ (pDeckBad->GetLayerCount (), 8 + 8 + 1);
+
+  BenchmarkPrintf ("Config load, %d files, %d threads on %d cores:  serial %8.3f ms  parallel %8.3f ms  speedup %.1fx\n",
+                   kNumFiles, iNumThreads, WorkerPool::DefaultThreadCount (), iSerialUs / 1000.0, iParallelUs / 1000.0,
+                   (iParallelUs > 0) ? DOUBLE (iSerialUs) / DOUBLE (iParallelUs) : 0.0);
+
+  for (INT  iFile = 0; iFile < arrayFiles.Length (); ++iFile)
+    {
+    remove (arrayFiles [iFile].AsChar ());
+    };
+  remove (strBad.AsChar ());
+  rmdir (strDir.AsChar ());
+
+  pDeckSerial->DeleteAllLayers ();
+  pDeckParallel->DeleteAllLayers ();
+  pDeckBad->DeleteAllLayers ();
+  delete (pDeckSerial);
+  delete (pDeckParallel);
+  delete (pDeckBad);
+  };
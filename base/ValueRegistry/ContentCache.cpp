@@ -0,0 +1,442 @@
+/* -----------------------------------------------------------------
+                            Content Cache
+
+     This module keeps downloaded content on disk between runs, along
+   with the validators needed to ask the server whether it changed.
+
+   ----------------------------------------------------------------- */
+
+// Authors:  Michael T. Duffy  (mduffor@gmail.com)
+
+// Modified BSD License:
+//
+// Copyright (c) 2021, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Sys/Types.hpp"
+
+#include "Debug.hpp"
+ASSERTFILE (__FILE__)
+
+#include <stdio.h>
+
+#include "ValueRegistry/ContentCache.hpp"
+#include "Sys/FilePath.hpp"
+
+
+/*
+  Index layout.  All values are big endian, matching the config snapshot.
+
+    CCIX
+    version
+    payload size
+    payload hash
+    payload:
+      entry count
+      per entry:
+        tag (length, chars)
+        uri (length, chars)
+        etag (length, chars)
+        last modified (length, chars)
+        content hash
+        content size
+        last used
+
+  Blobs are stored beside the index as <hash>_<size>.blob.
+*/
+
+//-----------------------------------------------------------------------------
+static VOID  WriteString (RStrParser &  parserIn,
+                          const RStr &  strIn)
+  {
+  parserIn.SetU4_BEnd (strIn.Length ());
+  parserIn.SetData    (strIn.AsUChar (), strIn.Length ());
+  };
+
+//-----------------------------------------------------------------------------
+static VOID  ReadString (RStrParser &  parserIn,
+                         RStr &        strOut)
+  {
+  strOut.Empty ();
+  INT  iLength = parserIn.GetU4_BEnd ();
+  parserIn.GetData (&strOut, iLength);
+  };
+
+//-----------------------------------------------------------------------------
+ContentCache::ContentCache  ()
+  {
+  iMaxBytes   = kDefaultMaxBytes;
+  iTotalBytes = 0;
+  uUseCounter = 0;
+  bIndexDirty = FALSE;
+  };
+
+//-----------------------------------------------------------------------------
+ContentCache::~ContentCache  ()
+  {
+  Clear ();
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::Clear  (VOID)
+  {
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    delete (apEntries [iIndex]);
+    };
+  apEntries.Clear ();
+  iTotalBytes = 0;
+  uUseCounter = 0;
+  bIndexDirty = FALSE;
+  };
+
+//-----------------------------------------------------------------------------
+const char *  ContentCache::GetDefaultPath  (VOID)
+  {
+  static RStr  strExpandedPath;
+
+  strExpandedPath = FilePath::ExpandPathURI ("file://content_cache");
+  return (strExpandedPath.AsChar ());
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::GetBlobPath  (HASH_T  uHashIn,
+                                  UINT32  uSizeIn,
+                                  RStr &  strPathOut)
+  {
+  RStr  strName;
+
+  strName.Format ("%08x_%08x.blob", uHashIn, uSizeIn);
+  strPathOut = FilePath::Combine (strDirectory.AsChar (), strName.AsChar ());
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::GetIndexPath  (RStr &  strPathOut)
+  {
+  strPathOut = FilePath::Combine (strDirectory.AsChar (), "index.ccix");
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ContentCache::Open  (const char *  szDirectoryIn,
+                              INT64         iMaxBytesIn)
+  {
+  Clear ();
+
+  strDirectory = (szDirectoryIn != NULL) ? szDirectoryIn : GetDefaultPath ();
+  iMaxBytes    = iMaxBytesIn;
+
+  FilePath::MakeDir (strDirectory.AsChar ());
+  if (! FilePath::DirExists (strDirectory.AsChar ()))
+    {
+    EStatus  status = EStatus::Failure ("ContentCache::Open - unable to create \"%s\"", strDirectory.AsChar ());
+    strDirectory.Empty ();
+    return (status);
+    };
+
+  RStr        strIndexPath;
+  RStrParser  parserIn;
+
+  GetIndexPath (strIndexPath);
+
+  // the whole index is brought in with a single read.  Anything wrong with
+  //  it just means starting over with an empty cache.
+  if ((FilePath::FileExists (strIndexPath.AsChar ())) &&
+      (parserIn.ReadFromFile (strIndexPath.AsChar ()) == EStatus::kSuccess) &&
+      (parserIn.Length () >= 16) &&
+      (parserIn.GetU4_BEnd () == MAKE_FOUR_CODE ("CCIX")) &&
+      (parserIn.GetU4_BEnd () == kIndexVersion))
+    {
+    UINT32  uPayloadSize = parserIn.GetU4_BEnd ();
+    HASH_T  uPayloadHash = parserIn.GetU4_BEnd ();
+
+    if ((parserIn.GetCursorStart () + INT (uPayloadSize) == INT (parserIn.Length ())) &&
+        (CalcHashValue (parserIn.GetCursorStartPtr (), uPayloadSize) == uPayloadHash))
+      {
+      INT  iNumEntries = parserIn.GetU4_BEnd ();
+      for (INT  iIndex = 0; iIndex < iNumEntries; ++iIndex)
+        {
+        Entry *  pEntry = new Entry;
+
+        ReadString (parserIn, pEntry->strTag);
+        ReadString (parserIn, pEntry->strUri);
+        ReadString (parserIn, pEntry->strETag);
+        ReadString (parserIn, pEntry->strLastModified);
+        pEntry->uContentHash = parserIn.GetU4_BEnd ();
+        pEntry->uContentSize = parserIn.GetU4_BEnd ();
+        pEntry->uLastUsed    = parserIn.GetU4_BEnd ();
+
+        if (CountBlobUsers (pEntry->uContentHash, pEntry->uContentSize) == 0)
+          {
+          iTotalBytes += pEntry->uContentSize;
+          };
+        uUseCounter = RMax (uUseCounter, pEntry->uLastUsed);
+        apEntries.Append (pEntry);
+        };
+      };
+    };
+
+  DeleteOrphans ();
+
+  // the bound may be lower than the one the cache was filled under.
+  Evict (iMaxBytes, NULL);
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::DeleteOrphans  (VOID)
+  {
+  FilePath   filePath;
+  RStr       strFileSpec (FilePath::Combine (strDirectory.AsChar (), "*.blob"));
+  RStrArray  arrayFiles = filePath.lsf (strFileSpec.AsChar (), TRUE);
+  RStrArray  arrayKnown;
+  RStr       strBlobPath;
+
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    GetBlobPath (apEntries [iIndex]->uContentHash, apEntries [iIndex]->uContentSize, strBlobPath);
+    arrayKnown.Append (strBlobPath);
+    };
+
+  for (INT  iFile = 0; iFile < arrayFiles.Length (); ++iFile)
+    {
+    if (arrayKnown.Find (arrayFiles [iFile].AsChar ()) == -1)
+      {
+      remove (arrayFiles [iFile].AsChar ());
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ContentCache::Save  (VOID)
+  {
+  if (! IsOpen ())  return (EStatus::Failure ("ContentCache::Save - cache is not open"));
+  if (! bIndexDirty) return (EStatus::kSuccess);
+
+  RStrParser  parserOut;
+  RStrParser  parserPayload;
+  RStr        strIndexPath;
+
+  parserPayload.SetU4_BEnd (apEntries.Length ());
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    Entry *  pEntry = apEntries [iIndex];
+
+    WriteString (parserPayload, pEntry->strTag);
+    WriteString (parserPayload, pEntry->strUri);
+    WriteString (parserPayload, pEntry->strETag);
+    WriteString (parserPayload, pEntry->strLastModified);
+    parserPayload.SetU4_BEnd (pEntry->uContentHash);
+    parserPayload.SetU4_BEnd (pEntry->uContentSize);
+    parserPayload.SetU4_BEnd (pEntry->uLastUsed);
+    };
+
+  parserOut.SetU4_BEnd (MAKE_FOUR_CODE ("CCIX"));
+  parserOut.SetU4_BEnd (kIndexVersion);
+  parserOut.SetU4_BEnd (parserPayload.Length ());
+  parserOut.SetU4_BEnd (CalcHashValue (parserPayload.AsChar (), parserPayload.Length ()));
+  parserOut.SetData    (parserPayload.AsUChar (), parserPayload.Length ());
+
+  GetIndexPath (strIndexPath);
+  EStatus  status = parserOut.WriteToFile (strIndexPath.AsChar ());
+  if (status == EStatus::kSuccess)
+    {
+    bIndexDirty = FALSE;
+    };
+  return (status);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::SetMaxBytes  (INT64  iMaxBytesIn)
+  {
+  iMaxBytes = iMaxBytesIn;
+  Evict (iMaxBytes, NULL);
+  };
+
+//-----------------------------------------------------------------------------
+ContentCache::Entry *  ContentCache::Find  (const char *  szTagIn,
+                                            const char *  szUriIn)
+  {
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    Entry *  pEntry = apEntries [iIndex];
+    if (pEntry->strTag.Equals (szTagIn) && pEntry->strUri.Equals (szUriIn))
+      {
+      return (pEntry);
+      };
+    };
+  return (NULL);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  ContentCache::Read  (Entry *       pEntryIn,
+                              RStrParser &  parserDataOut)
+  {
+  RStr  strBlobPath;
+
+  GetBlobPath (pEntryIn->uContentHash, pEntryIn->uContentSize, strBlobPath);
+
+  if ((! FilePath::FileExists (strBlobPath.AsChar ())) ||
+      (parserDataOut.ReadFromFile (strBlobPath.AsChar ()) != EStatus::kSuccess) ||
+      (parserDataOut.Length () != pEntryIn->uContentSize) ||
+      (CalcHashValue (parserDataOut.AsChar (), parserDataOut.Length ()) != pEntryIn->uContentHash))
+    {
+    EStatus  status = EStatus::Failure ("ContentCache::Read - cached data for \"%s\" is missing or damaged", pEntryIn->strTag.AsChar ());
+    parserDataOut.Empty ();
+    Remove (pEntryIn);
+    return (status);
+    };
+
+  parserDataOut.ResetCursor ();
+  pEntryIn->uLastUsed = ++uUseCounter;
+  bIndexDirty = TRUE;
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+ContentCache::Entry *  ContentCache::Store  (const char *  szTagIn,
+                                             const char *  szUriIn,
+                                             const char *  szETagIn,
+                                             const char *  szLastModifiedIn,
+                                             RStrParser &  parserDataIn)
+  {
+  if (! IsOpen ()) return (NULL);
+
+  Entry *  pOld = Find (szTagIn, szUriIn);
+  if (pOld != NULL)
+    {
+    Remove (pOld);
+    };
+
+  if (INT64 (parserDataIn.Length ()) > iMaxBytes) return (NULL);
+
+  HASH_T  uHash = CalcHashValue (parserDataIn.AsChar (), parserDataIn.Length ());
+  UINT32  uSize = parserDataIn.Length ();
+
+  if (CountBlobUsers (uHash, uSize) == 0)
+    {
+    RStr  strBlobPath;
+
+    GetBlobPath (uHash, uSize, strBlobPath);
+    if (parserDataIn.WriteToFile (strBlobPath.AsChar ()) != EStatus::kSuccess)
+      {
+      DBG_WARNING ("ContentCache::Store - unable to write \"%s\"", strBlobPath.AsChar ());
+      return (NULL);
+      };
+    iTotalBytes += uSize;
+    };
+
+  Entry *  pEntry = new Entry;
+
+  pEntry->strTag          = szTagIn;
+  pEntry->strUri          = szUriIn;
+  pEntry->strETag         = (szETagIn != NULL) ? szETagIn : "";
+  pEntry->strLastModified = (szLastModifiedIn != NULL) ? szLastModifiedIn : "";
+  pEntry->uContentHash    = uHash;
+  pEntry->uContentSize    = uSize;
+  pEntry->uLastUsed       = ++uUseCounter;
+  apEntries.Append (pEntry);
+  bIndexDirty = TRUE;
+
+  Evict (iMaxBytes, pEntry);
+  return (pEntry);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::Remove  (Entry *  pEntryIn)
+  {
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    if (apEntries [iIndex] == pEntryIn)
+      {
+      DeleteEntry (iIndex);
+      return;
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::RemoveAll  (VOID)
+  {
+  while (apEntries.Length () > 0)
+    {
+    DeleteEntry (apEntries.Length () - 1);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+INT  ContentCache::CountBlobUsers  (HASH_T  uHashIn,
+                                    UINT32  uSizeIn)
+  {
+  INT  iCount = 0;
+  for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+    {
+    if ((apEntries [iIndex]->uContentHash == uHashIn) &&
+        (apEntries [iIndex]->uContentSize == uSizeIn))
+      {
+      ++iCount;
+      };
+    };
+  return (iCount);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::DeleteEntry  (INT  iIndexIn)
+  {
+  Entry *  pEntry = apEntries [iIndexIn];
+
+  apEntries.Remove (iIndexIn);
+  bIndexDirty = TRUE;
+
+  if (CountBlobUsers (pEntry->uContentHash, pEntry->uContentSize) == 0)
+    {
+    RStr  strBlobPath;
+
+    GetBlobPath (pEntry->uContentHash, pEntry->uContentSize, strBlobPath);
+    remove (strBlobPath.AsChar ());
+    iTotalBytes -= pEntry->uContentSize;
+    };
+  delete (pEntry);
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ContentCache::Evict  (INT64    iTargetBytesIn,
+                            Entry *  pKeepIn)
+  {
+  while (iTotalBytes > iTargetBytesIn)
+    {
+    INT  iOldest = -1;
+    for (INT  iIndex = 0; iIndex < apEntries.Length (); ++iIndex)
+      {
+      if (apEntries [iIndex] == pKeepIn) continue;
+      if ((iOldest == -1) || (apEntries [iIndex]->uLastUsed < apEntries [iOldest]->uLastUsed))
+        {
+        iOldest = iIndex;
+        };
+      };
+    if (iOldest == -1) break;
+
+    DeleteEntry (iOldest);
+    };
+  };
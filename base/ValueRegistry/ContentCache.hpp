@@ -0,0 +1,198 @@
+/* -----------------------------------------------------------------
+                            Content Cache
+
+     This module keeps downloaded content on disk between runs, along
+   with the validators needed to ask the server whether it changed.
+
+   ----------------------------------------------------------------- */
+
+// Authors:  Michael T. Duffy  (mduffor@gmail.com)
+
+// Modified BSD License:
+//
+// Copyright (c) 2021, Michael T. Duffy II.  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+// Redistributions of source code must retain the above copyright notice,
+//  this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CONTENTCACHE_HPP
+#define CONTENTCACHE_HPP
+
+#include "Sys/Types.hpp"
+#include "Containers/TArray.hpp"
+#include "Util/RStr.hpp"
+#include "Util/RStrParser.hpp"
+#include "Util/CalcHash.hpp"
+
+//------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------
+// Class Definitions
+//------------------------------------------------------------------------
+
+// NOTE:  Entries are keyed by asset tag and the expanded URI they were
+//  fetched from, so each environment gets its own entry.  The data itself
+//  is stored in blob files named after its hash and size, so entries with
+//  the same contents share one file.  The index is only written by Save,
+//  so a blob the index doesn't know about is left over from a run that
+//  didn't save, and Open deletes it.
+//
+//  The cache is not thread safe.  ContentDepot only uses it from the thread
+//  that calls StartFetch and UpdateFetch.
+
+//-----------------------------------------------------------------------------
+class ContentCache
+  {
+  public:
+    static const UINT32   kIndexVersion   = 1;
+    static const INT64    kDefaultMaxBytes = 64 * 1024 * 1024;
+
+    struct Entry
+      {
+      RStr      strTag;
+      RStr      strUri;
+      RStr      strETag;          ///< ETag header of the response, if any
+      RStr      strLastModified;  ///< Last-Modified header of the response, if any
+      HASH_T    uContentHash;
+      UINT32    uContentSize;
+      UINT32    uLastUsed;        ///< Use stamp of the last Store or Read.  Lowest is evicted first.
+      };
+
+  protected:
+
+    RStr                strDirectory;
+    INT64               iMaxBytes;
+    INT64               iTotalBytes;      ///< Size of the blob files, counting shared blobs once
+    UINT32              uUseCounter;
+    BOOL                bIndexDirty;
+    TArray<Entry*>      apEntries;
+
+  protected:
+
+    VOID               GetBlobPath     (HASH_T        uHashIn,
+                                        UINT32        uSizeIn,
+                                        RStr &        strPathOut);
+
+    VOID               GetIndexPath    (RStr &        strPathOut);
+
+    INT                CountBlobUsers  (HASH_T        uHashIn,
+                                        UINT32        uSizeIn);
+
+    VOID               DeleteEntry     (INT           iIndexIn);
+
+    VOID               DeleteOrphans   (VOID);
+
+    VOID               Evict           (INT64         iTargetBytesIn,
+                                        Entry *       pKeepIn);
+
+  public:
+
+                       ContentCache    ();
+
+                       ~ContentCache   ();
+
+                       /** @brief  Load the index from a cache directory, creating the directory if needed.
+                                   A missing or corrupt index leaves the cache empty.
+                           @param  szDirectoryIn Directory to keep the cache in.  NULL uses GetDefaultPath.
+                           @param  iMaxBytesIn Most bytes of content to keep.  Older entries are evicted past this.
+                           @return Failure if the directory can't be used.
+                       */
+    EStatus            Open            (const char *  szDirectoryIn = NULL,
+                                        INT64         iMaxBytesIn   = kDefaultMaxBytes);
+
+                       /** @brief  Write the index, if it changed since it was loaded or last saved.
+                           @return Success or failure.
+                       */
+    EStatus            Save            (VOID);
+
+                       /** @brief  Forget every entry without touching the files on disk.
+                           @return None
+                       */
+    VOID               Clear           (VOID);
+
+                       /** @brief  Delete every entry and its blob.
+                           @return None
+                       */
+    VOID               RemoveAll       (VOID);
+
+    BOOL               IsOpen          (VOID) const  {return (! strDirectory.IsEmpty ());};
+
+    const char *       GetDirectory    (VOID) const  {return (strDirectory.AsChar ());};
+
+    INT                Size            (VOID) const  {return (apEntries.Length ());};
+
+    INT64              TotalBytes      (VOID) const  {return (iTotalBytes);};
+
+    INT64              GetMaxBytes     (VOID) const  {return (iMaxBytes);};
+
+                       /** @brief  Change the size bound, evicting entries if the cache is now over it.
+                           @param  iMaxBytesIn Most bytes of content to keep.
+                           @return None
+                       */
+    VOID               SetMaxBytes     (INT64         iMaxBytesIn);
+
+                       /** @brief  Find the entry for an asset fetched from a URI.
+                           @param  szTagIn The asset tag.
+                           @param  szUriIn The expanded URI.
+                           @return The entry, or NULL if there isn't one.
+                       */
+    Entry *            Find            (const char *  szTagIn,
+                                        const char *  szUriIn);
+
+                       /** @brief  Read an entry's content with a single file read, and check it against the
+                                   stored size and hash.  An entry whose blob is missing or damaged is removed.
+                           @param  pEntryIn The entry.  Deleted if the read fails.
+                           @param  parserDataOut Receives the content.
+                           @return Success or failure.
+                       */
+    EStatus            Read            (Entry *       pEntryIn,
+                                        RStrParser &  parserDataOut);
+
+                       /** @brief  Store content for an asset, replacing any earlier entry for the same tag and
+                                   URI, then evict the least recently used entries until the cache fits.
+                           @param  szTagIn The asset tag.
+                           @param  szUriIn The expanded URI.
+                           @param  szETagIn ETag of the response, or NULL.
+                           @param  szLastModifiedIn Last-Modified of the response, or NULL.
+                           @param  parserDataIn The content.
+                           @return The entry, or NULL if the content couldn't be stored or is bigger than the cache.
+                       */
+    Entry *            Store           (const char *  szTagIn,
+                                        const char *  szUriIn,
+                                        const char *  szETagIn,
+                                        const char *  szLastModifiedIn,
+                                        RStrParser &  parserDataIn);
+
+                       /** @brief  Remove an entry, and delete its blob if no other entry shares it.
+                           @param  pEntryIn The entry.  Deleted.
+                           @return None
+                       */
+    VOID               Remove          (Entry *       pEntryIn);
+
+    static const char *  GetDefaultPath  (VOID);
+  };
+
+#endif // CONTENTCACHE_HPP
@@ -48,6 +48,9 @@ ASSERTFILE (__FILE__)
 #include "ValueRegistry/ConfigSubset.hpp"
 #include "Script/Expression.hpp"
 #include "Util/ParseTools.hpp"
+#include "Sys/FilePath.hpp"
+#include "Net/HTTP.hpp"
+#include "Net/URLBuilder.hpp"
 
 
 
@@ -74,14 +77,112 @@ const char *  ContentLocation::GetUri (const char *  szEnvIn)
 
 
 
+//-----------------------------------------------------------------------------
+//  FileContentFetcher
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+EStatus  FileContentFetcher::Fetch  (const char *  szUriIn,
+                                     RStrParser &  parserDataOut)
+  {
+  // RStrParser expands file:// and res:// itself, without the static buffer
+  //  FilePath::ExpandPathURI returns, so this is safe on a worker thread.
+  return (parserDataOut.ReadFromFile (szUriIn));
+  };
+
+
+//-----------------------------------------------------------------------------
+//  HttpContentFetcher
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+EStatus  HttpContentFetcher::Fetch  (const char *  szUriIn,
+                                     RStrParser &  parserDataOut)
+  {
+  ContentValidators  validatorsNone;
+  ContentValidators  validatorsOut;
+  BOOL               bNotModified;
+
+  return (FetchIfChanged (szUriIn, validatorsNone, parserDataOut, validatorsOut, bNotModified));
+  };
+
+//-----------------------------------------------------------------------------
+EStatus  HttpContentFetcher::FetchIfChanged  (const char *               szUriIn,
+                                              const ContentValidators &  validatorsIn,
+                                              RStrParser &               parserDataOut,
+                                              ContentValidators &        validatorsOut,
+                                              BOOL &                     bNotModifiedOut)
+  {
+  URLBuilder  url (szUriIn);
+  HTTP        http;
+  RStr        strHeader;
+  RStr        strBody;
+
+  bNotModifiedOut = FALSE;
+
+  HTTP::HeaderConditional (validatorsIn.strETag.AsChar (), validatorsIn.strLastModified.AsChar (), strHeader);
+
+  EStatus  status = http.Connect (url);
+  if (status.IsFailure ()) return (status);
+
+  status = http.Get (strBody, strHeader.IsEmpty () ? NULL : strHeader.AsChar ());
+  http.Disconnect ();
+  if (status.IsFailure ()) return (status);
+
+  INT  iCode = http.GetResponseCode ();
+  if (iCode == 304)
+    {
+    bNotModifiedOut = TRUE;
+    return (EStatus::kSuccess);
+    };
+  if ((iCode < 200) || (iCode > 299))
+    {
+    return (EStatus::Failure ("HTTP %d for \"%s\"", iCode, szUriIn));
+    };
+
+  const char *  szETag         = http.GetResponseHeader ("ETag");
+  const char *  szLastModified = http.GetResponseHeader ("Last-Modified");
+
+  validatorsOut.strETag         = (szETag         != NULL) ? szETag         : "";
+  validatorsOut.strLastModified = (szLastModified != NULL) ? szLastModified : "";
+  parserDataOut.Set (strBody);
+  return (EStatus::kSuccess);
+  };
+
+
+//-----------------------------------------------------------------------------
+//  ContentDepot
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 ContentDepot::ContentDepot  ()
   {
+  bLinksDirty       = TRUE;
+  pFetchPool        = NULL;
+  iFetchOutstanding = 0;
+  iFetchRunning     = 0;
+  statusFetch       = EStatus::kSuccess;
+  pCache            = NULL;
+
+  RegisterFetcher ("file://", &fetcherFile);
+  RegisterFetcher ("res://",  &fetcherFile);
+  RegisterFetcher ("http://", &fetcherHttp);
   };
 
 //-----------------------------------------------------------------------------
 ContentDepot::~ContentDepot  ()
   {
+  if (pFetchPool != NULL)
+    {
+    // let the running jobs finish, but don't deliver them.
+    delete (pFetchPool);
+    pFetchPool = NULL;
+    for (INT  iIndex = 0; iIndex < apFetchDone.Length (); ++iIndex)
+      {
+      delete (apFetchDone [iIndex]);
+      };
+    apFetchDone.Clear ();
+    };
   RemoveAllAssets();
   };
 
@@ -104,6 +205,7 @@ ContentLocation * ContentDepot::AddAsset (const char *  szTagIn,
     pLoc = listContents.PushBack (new ContentLocation);
     pLoc->strTag.Set  (szTagIn, TRUE);
     pLoc->strType.Set (szTypeIn, TRUE);
+    bLinksDirty = TRUE;
     };
 
   pLoc->arrayEnvUriPairs.SetAt (szEnvIn, szUrlIn);
@@ -152,6 +254,7 @@ VOID ContentDepot::RemoveAsset (const char *  szTagIn)
       {
       delete (*itrCurr);
       listContents.Delete (itrCurr);
+      bLinksDirty = TRUE;
       return;
       };
     };
@@ -167,6 +270,7 @@ VOID ContentDepot::RemoveAllAssets (VOID)
     delete (*itrCurr);
     };
   listContents.Empty ();
+  bLinksDirty = TRUE;
   };
 
 //-----------------------------------------------------------------------------
@@ -178,6 +282,7 @@ VOID ContentDepot::AddDependency (const char *  szTagIn,
   if (pLoc == NULL) return;
 
   pLoc->astrDependencies.AppendUnique (szDepTagIn);
+  bLinksDirty = TRUE;
   };
 
 //-----------------------------------------------------------------------------
@@ -193,6 +298,7 @@ VOID ContentDepot::AddDependencies (const char *  szTagIn,
     {
     pLoc->astrDependencies.AppendUnique (arrayDepTagsIn[iIndex]);
     };
+  bLinksDirty = TRUE;
   };
 
 //-----------------------------------------------------------------------------
@@ -203,6 +309,8 @@ VOID ContentDepot::RecalcDependents (VOID)
        ++itrCurr)
     {
     (*itrCurr)->astrDependents.Clear ();
+    (*itrCurr)->apDependencies.Clear ();
+    (*itrCurr)->apDependents.Clear ();
     };
 
   for (TListItr<ContentLocation*>  itrCurr = listContents.First();
@@ -216,10 +324,16 @@ VOID ContentDepot::RecalcDependents (VOID)
 
       if (pLocDep != NULL)
         {
-        pLocDep->astrDependents.AppendUnique ((*itrCurr)->strTag);
+        if (pLocDep->astrDependents.Find ((*itrCurr)->strTag) == -1)
+          {
+          pLocDep->astrDependents.Append ((*itrCurr)->strTag);
+          pLocDep->apDependents.Append (*itrCurr);
+          };
+        (*itrCurr)->apDependencies.Append (pLocDep);
         };
       };
     };
+  bLinksDirty = FALSE;
   };
 
 //-----------------------------------------------------------------------------
@@ -229,19 +343,18 @@ BOOL ContentDepot::AreDependenciesLoaded (ContentLocation *  pLocIn)
 
   if (pLocIn == NULL) return (TRUE);
 
-  INT  iNumDep = pLocIn->astrDependencies.Length();
+  UpdateLinks ();
+
+  INT  iNumDep = pLocIn->apDependencies.Length();
   for (INT  iIndex = 0; iIndex < iNumDep; ++iIndex)
     {
-    ContentLocation *  pLocDep = FindAsset (pLocIn->astrDependencies[iIndex]);
+    ContentLocation *  pLocDep = pLocIn->apDependencies[iIndex];
 
-    if (pLocDep != NULL)
-      {
-      // if any unloaded asset is found, return that dependencies are not yet loaded.
-      if (! pLocDep->bIsLoaded) {return (FALSE);};
+    // if any unloaded asset is found, return that dependencies are not yet loaded.
+    if (! pLocDep->bIsLoaded) {return (FALSE);};
 
-      // check chained dependencies
-      if (! AreDependenciesLoaded (pLocDep)) {return (FALSE);};
-      };
+    // check chained dependencies
+    if (! AreDependenciesLoaded (pLocDep)) {return (FALSE);};
     };
   return (TRUE);
   };
@@ -252,7 +365,9 @@ VOID ContentDepot::GetRootDependants (ContentLocation *           plocIn,
   {
   // step up dependency tree to find roots.
 
-  INT  iNumDep = plocIn->astrDependents.Length();
+  UpdateLinks ();
+
+  INT  iNumDep = plocIn->apDependents.Length();
 
   if (iNumDep == 0)
     {
@@ -262,12 +377,7 @@ VOID ContentDepot::GetRootDependants (ContentLocation *           plocIn,
 
   for (INT  iIndex = 0; iIndex < iNumDep; ++iIndex)
     {
-    ContentLocation *  plocDep = FindAsset (plocIn->astrDependents[iIndex]);
-
-    if (plocDep != NULL)
-      {
-      GetRootDependants (plocDep, listOut);
-      };
+    GetRootDependants (plocIn->apDependents[iIndex], listOut);
     };
   };
 
@@ -306,12 +416,13 @@ VOID  ContentDepot::RunCallbacks (ContentLocation *  pLocIn)
 
   if (pLocIn == NULL) return;
 
+  UpdateLinks ();
+
   // run callbacks on dependencies first
-  INT  iNumDep = pLocIn->astrDependencies.Length();
+  INT  iNumDep = pLocIn->apDependencies.Length();
   for (INT  iIndex = 0; iIndex < iNumDep; ++iIndex)
     {
-    ContentLocation *  pLocDep = FindAsset (pLocIn->astrDependencies[iIndex]);
-    RunCallbacks (pLocDep);
+    RunCallbacks (pLocIn->apDependencies[iIndex]);
     };
 
   // Now you can run the callback on this location
@@ -525,6 +636,426 @@ BOOL ContentDepot::IsEverythingReturned (VOID)
 
 
 
+//-----------------------------------------------------------------------------
+VOID ContentDepot::RegisterFetcher (const char *       szSchemeIn,
+                                    ContentFetcher *   pFetcherIn)
+  {
+  INT  iIndex = astrFetchSchemes.Find (szSchemeIn);
+  if (iIndex == -1)
+    {
+    astrFetchSchemes.Append (szSchemeIn);
+    apFetchers.Append (pFetcherIn);
+    }
+  else
+    {
+    apFetchers [iIndex] = pFetcherIn;
+    };
+  };
+
+//-----------------------------------------------------------------------------
+EStatus ContentDepot::StartFetch (BOOL  bForceRefreshIn,
+                                  INT   iNumThreadsIn)
+  {
+  if (pFetchPool != NULL) {return (EStatus::Failure ("ContentDepot::StartFetch () - A fetch is already in progress"));};
+
+  if (strEnvironment.IsEmpty ())
+    {
+    DBG_WARNING ("ContentDepot::StartFetch () - Environment is not set");
+    };
+  arrayEnvVars.SetAt ("Env", strEnvironment.AsChar());
+
+  UpdateLinks ();
+
+  TListItr<ContentLocation*>  itrCurr;
+
+  iFetchOutstanding = 0;
+  iFetchRunning     = 0;
+  statusFetch       = EStatus::kSuccess;
+
+  // everything dirty takes part, and waits on its dirty dependencies.  Clean
+  //  dependencies already have their data.
+  for (itrCurr = listContents.First(); itrCurr.IsValid (); ++itrCurr)
+    {
+    ContentLocation *  pLoc = *itrCurr;
+
+    if (bForceRefreshIn) {pLoc->bIsDirty = TRUE;};
+    pLoc->iFetchState  = pLoc->bIsDirty ? kFetchWaiting : kFetchIdle;
+    pLoc->iPendingDeps = 0;
+    if (pLoc->bIsDirty)
+      {
+      pLoc->bIsReported = FALSE;
+      ++iFetchOutstanding;
+      };
+    };
+
+  for (itrCurr = listContents.First(); itrCurr.IsValid (); ++itrCurr)
+    {
+    ContentLocation *  pLoc = *itrCurr;
+
+    if (pLoc->iFetchState != kFetchWaiting) continue;
+    for (INT  iIndex = 0; iIndex < pLoc->apDependencies.Length (); ++iIndex)
+      {
+      if (pLoc->apDependencies [iIndex]->iFetchState == kFetchWaiting) {++pLoc->iPendingDeps;};
+      };
+    };
+
+  if (iFetchOutstanding == 0)
+    {
+    sigOnAllLoaded ();
+    return (EStatus::kSuccess);
+    };
+
+  pFetchPool = new WorkerPool (iNumThreadsIn);
+
+  for (itrCurr = listContents.First(); itrCurr.IsValid (); ++itrCurr)
+    {
+    if (((*itrCurr)->iFetchState == kFetchWaiting) && ((*itrCurr)->iPendingDeps == 0))
+      {
+      DispatchFetch (*itrCurr);
+      };
+    };
+  return (EStatus::kSuccess);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::ExpandUri (ContentLocation *  pLocIn,
+                              RStrParser &       parserUriOut)
+  {
+  parserUriOut.Set (pLocIn->GetUri (strEnvironment.AsChar()));
+  arrayEnvVars.ExpandVars (parserUriOut);
+  parserUriOut.ResetCursor ();
+  };
+
+//-----------------------------------------------------------------------------
+ContentFetcher *  ContentDepot::FindFetcher (const char *  szUriIn)
+  {
+  for (INT  iIndex = 0; iIndex < astrFetchSchemes.Length (); ++iIndex)
+    {
+    if (strncmp (szUriIn, astrFetchSchemes [iIndex].AsChar (), astrFetchSchemes [iIndex].Length ()) == 0)
+      {
+      return (apFetchers [iIndex]);
+      };
+    };
+  return (NULL);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::DispatchFetch (ContentLocation *  pLocIn)
+  {
+  // the URI is expanded here, since ExpandVars isn't safe to call from the workers.
+  RStrParser  parserExpandedUri;
+  ExpandUri (pLocIn, parserExpandedUri);
+
+  FetchJob *  pJob = new FetchJob;
+  pJob->pDepot       = this;
+  pJob->pLoc         = pLocIn;
+  pJob->pFetcher     = NULL;
+  pJob->strUri       = parserExpandedUri;
+  pJob->status       = EStatus::kSuccess;
+  pJob->bCacheable   = FALSE;
+  pJob->bNotModified = FALSE;
+
+  pLocIn->iFetchState = kFetchRunning;
+  ++iFetchRunning;
+
+  if (parserExpandedUri.StartsWith ("mem://"))
+    {
+    // memory buffer (already stored in Data for content location)
+    QueueFetchDone (pJob);
+    return;
+    };
+
+  pJob->pFetcher = FindFetcher (parserExpandedUri.AsChar ());
+
+  if (pJob->pFetcher == NULL)
+    {
+    pJob->status = EStatus::Failure ("ContentDepot - No fetcher for \"%s\"", parserExpandedUri.AsChar ());
+    QueueFetchDone (pJob);
+    return;
+    };
+
+  if ((pCache != NULL) && pJob->pFetcher->IsCacheable ())
+    {
+    // the cache is only touched on this thread, so the validators are copied into the job.
+    pJob->bCacheable = TRUE;
+    ContentCache::Entry *  pEntry = pCache->Find (pLocIn->strTag.AsChar (), parserExpandedUri.AsChar ());
+    if (pEntry != NULL)
+      {
+      pJob->validatorsIn.strETag         = pEntry->strETag;
+      pJob->validatorsIn.strLastModified = pEntry->strLastModified;
+      };
+    };
+  pFetchPool->Submit (FetchJob::Run, pJob);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::FetchJob::Run (VOID *  pJobIn)
+  {
+  // runs on a worker thread.
+  FetchJob *  pJob = static_cast<FetchJob *>(pJobIn);
+
+  pJob->status = pJob->pFetcher->FetchIfChanged (pJob->strUri.AsChar (), pJob->validatorsIn,
+                                                 pJob->parserData, pJob->validatorsOut, pJob->bNotModified);
+  pJob->pDepot->QueueFetchDone (pJob);
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::QueueFetchDone (FetchJob *  pJobIn)
+  {
+    {
+    std::lock_guard<std::mutex>  lock (mutexFetchDone);
+    apFetchDone.Append (pJobIn);
+    };
+  condFetchDone.notify_all ();
+  };
+
+//-----------------------------------------------------------------------------
+INT ContentDepot::UpdateFetch (VOID)
+  {
+  if (pFetchPool == NULL) return (0);
+
+  TArray<FetchJob*>  apDone;
+    {
+    std::lock_guard<std::mutex>  lock (mutexFetchDone);
+    apDone.Copy (apFetchDone);
+    apFetchDone.Clear ();
+    };
+
+  for (INT  iJob = 0; iJob < apDone.Length (); ++iJob)
+    {
+    FetchJob *          pJob = apDone [iJob];
+    ContentLocation *   pLoc = pJob->pLoc;
+
+    BOOL                bFromCache = FALSE;
+
+    --iFetchRunning;
+    if (pJob->bCacheable && (pCache != NULL))
+      {
+      if (pJob->status.IsFailure () || pJob->bNotModified)
+        {
+        bFromCache = ReadFromCache (pLoc, pJob->strUri.AsChar ());
+        if (bFromCache && pJob->status.IsFailure ())
+          {
+          DBG_WARNING ("ContentDepot - Using cached \"%s\": %s", pLoc->strTag.AsChar (), pJob->status.GetDescription ());
+          pJob->status = EStatus::kSuccess;
+          }
+        else if (!bFromCache && pJob->bNotModified)
+          {
+          // the cached copy is gone, so ask again without validators.
+          delete (pJob);
+          DispatchFetch (pLoc);
+          continue;
+          };
+        }
+      else
+        {
+        pCache->Store (pLoc->strTag.AsChar (), pJob->strUri.AsChar (),
+                       pJob->validatorsOut.strETag.AsChar (), pJob->validatorsOut.strLastModified.AsChar (),
+                       pJob->parserData);
+        };
+      };
+
+    if (pJob->status.IsFailure ())
+      {
+      FailFetch (pLoc, pJob->status);
+      }
+    else
+      {
+      if ((pJob->pFetcher != NULL) && !bFromCache) {pLoc->parserCachedData = pJob->parserData;};
+      pLoc->bIsLoaded   = TRUE;
+      pLoc->bIsDirty    = FALSE;
+      pLoc->iFetchState = kFetchDone;
+      --iFetchOutstanding;
+
+      // data LoadFromCache already reported, that the server says is still
+      //  current, isn't reported twice.
+      BOOL  bAlreadyReported = (bFromCache && pLoc->bCacheReported);
+      pLoc->bCacheReported = FALSE;
+      if (bAlreadyReported)
+        {
+        pLoc->bIsReported = TRUE;
+        }
+      else if (!pLoc->parserCachedData.IsEmpty ())
+        {
+        pLoc->parserCachedData.ResetCursor ();
+        sigOnDataLoad (pLoc->strTag.AsChar(), pLoc->strType.AsChar(), pLoc->parserCachedData);
+        pLoc->bIsReported = TRUE;
+        };
+
+      // dependents whose last dependency this was can start now.
+      for (INT  iIndex = 0; iIndex < pLoc->apDependents.Length (); ++iIndex)
+        {
+        ContentLocation *  pLocDep = pLoc->apDependents [iIndex];
+        if (pLocDep->iFetchState != kFetchWaiting) continue;
+
+        if (--pLocDep->iPendingDeps == 0)
+          {
+          DispatchFetch (pLocDep);
+          };
+        };
+      };
+    delete (pJob);
+    };
+
+  if ((iFetchOutstanding > 0) && (iFetchRunning == 0))
+    {
+    // nothing is running and nothing can start, so the rest depend on each other.
+    for (TListItr<ContentLocation*>  itrCurr = listContents.First(); itrCurr.IsValid (); ++itrCurr)
+      {
+      if ((*itrCurr)->iFetchState == kFetchWaiting)
+        {
+        FailFetch (*itrCurr, EStatus::Failure ("ContentDepot - Dependency cycle at \"%s\"", (*itrCurr)->strTag.AsChar ()));
+        };
+      };
+    };
+
+  if (iFetchOutstanding == 0)
+    {
+    FinishFetch ();
+    };
+  return (apDone.Length ());
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::FailFetch (ContentLocation *  pLocIn,
+                              EStatus            statusIn)
+  {
+  if ((pLocIn->iFetchState != kFetchWaiting) && (pLocIn->iFetchState != kFetchRunning)) return;
+
+  DBG_ERROR ("ContentDepot - Unable to fetch \"%s\": %s", pLocIn->strTag.AsChar (), statusIn.GetDescription ());
+  if (statusFetch.IsSuccess ()) {statusFetch = statusIn;};
+
+  pLocIn->iFetchState = kFetchFailed;
+  --iFetchOutstanding;
+
+  // anything waiting on this will never be able to start.
+  for (INT  iIndex = 0; iIndex < pLocIn->apDependents.Length (); ++iIndex)
+    {
+    if (pLocIn->apDependents [iIndex]->iFetchState == kFetchWaiting)
+      {
+      FailFetch (pLocIn->apDependents [iIndex], EStatus::Failure ("Dependency \"%s\" failed", pLocIn->strTag.AsChar ()));
+      };
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID ContentDepot::FinishFetch (VOID)
+  {
+  delete (pFetchPool);
+  pFetchPool = NULL;
+
+  if (pCache != NULL)
+    {
+    pCache->Save ();
+    };
+
+  if (statusFetch.IsSuccess ())
+    {
+    sigOnAllLoaded ();
+    };
+  };
+
+//-----------------------------------------------------------------------------
+BOOL ContentDepot::ReadFromCache (ContentLocation *  pLocIn,
+                                  const char *       szUriIn)
+  {
+  ContentCache::Entry *  pEntry = pCache->Find (pLocIn->strTag.AsChar (), szUriIn);
+  if (pEntry == NULL) return (FALSE);
+
+  // read aside, so a damaged entry leaves the location's data alone.
+  RStrParser  parserData;
+  if (pCache->Read (pEntry, parserData) != EStatus::kSuccess) return (FALSE);
+
+  pLocIn->parserCachedData = parserData;
+  return (TRUE);
+  };
+
+//-----------------------------------------------------------------------------
+INT ContentDepot::LoadFromCache (VOID)
+  {
+  if ((pCache == NULL) || (pFetchPool != NULL)) return (0);
+
+  arrayEnvVars.SetAt ("Env", strEnvironment.AsChar());
+  UpdateLinks ();
+
+  TArray<ContentLocation*>  apLoaded;
+  RStrParser                parserExpandedUri;
+
+  for (TListItr<ContentLocation*>  itrCurr = listContents.First(); itrCurr.IsValid (); ++itrCurr)
+    {
+    ContentLocation *  pLoc = *itrCurr;
+    if (! pLoc->bIsDirty) continue;
+
+    ExpandUri (pLoc, parserExpandedUri);
+    ContentFetcher *  pFetcher = FindFetcher (parserExpandedUri.AsChar ());
+    if ((pFetcher == NULL) || !pFetcher->IsCacheable ()) continue;
+
+    if (ReadFromCache (pLoc, parserExpandedUri.AsChar ()))
+      {
+      pLoc->bIsLoaded   = TRUE;
+      pLoc->bIsReported = FALSE;
+      apLoaded.Append (pLoc);
+      };
+    };
+  pCache->Save ();
+
+  // report in dependency order.  Anything with a dependency that isn't loaded
+  //  waits for the next fetch.
+  INT   iNumLoaded = apLoaded.Length ();
+  BOOL  bProgress  = TRUE;
+  while (bProgress)
+    {
+    bProgress = FALSE;
+    for (INT  iIndex = 0; iIndex < apLoaded.Length ();)
+      {
+      ContentLocation *  pLoc   = apLoaded [iIndex];
+      BOOL               bReady = TRUE;
+
+      for (INT  iDep = 0; iDep < pLoc->apDependencies.Length (); ++iDep)
+        {
+        if (!pLoc->apDependencies [iDep]->bIsLoaded || !pLoc->apDependencies [iDep]->bIsReported)
+          {
+          bReady = FALSE;
+          break;
+          };
+        };
+      if (! bReady)
+        {
+        ++iIndex;
+        continue;
+        };
+
+      if (!pLoc->parserCachedData.IsEmpty ())
+        {
+        sigOnDataLoad (pLoc->strTag.AsChar(), pLoc->strType.AsChar(), pLoc->parserCachedData);
+        pLoc->bCacheReported = TRUE;
+        };
+      pLoc->bIsReported = TRUE;
+      apLoaded.Remove (iIndex);
+      bProgress = TRUE;
+      };
+    };
+  return (iNumLoaded);
+  };
+
+//-----------------------------------------------------------------------------
+EStatus ContentDepot::WaitForFetch (VOID)
+  {
+  while (pFetchPool != NULL)
+    {
+    UpdateFetch ();
+    if (pFetchPool == NULL) break;
+
+    std::unique_lock<std::mutex>  lock (mutexFetchDone);
+    while (apFetchDone.Length () == 0)
+      {
+      condFetchDone.wait (lock);
+      };
+    };
+  return (statusFetch);
+  };
+
+
 //-----------------------------------------------------------------------------
 VOID ContentDepot::GetHttpHeader (const char *  szUrlIn,
                                   const char *  szTagIn)
@@ -39,13 +39,19 @@
 #ifndef CONTENTDEPOT_HPP
 #define CONTENTDEPOT_HPP
 
+#include <mutex>
+#include <condition_variable>
+
 #include "Sys/Types.hpp"
 #include "Containers/TList.hpp"
+#include "Containers/TArray.hpp"
 #include "Containers/KVPArray.hpp"
 #include "Util/RStr.hpp"
 #include "Util/RStrParser.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
 #include "Util/Signal.h"
+#include "Sys/WorkerPool.hpp"
+#include "ValueRegistry/ContentCache.hpp"
 
 
 //------------------------------------------------------------------------
@@ -58,10 +64,11 @@ using namespace Gallant;
 // Class Definitions
 //------------------------------------------------------------------------
 
-// NOTE:  If looking up dependencies by name becomes too time consuming, you
-//  will probably need to cache pointers to ContentLocation alongside the names.
-//  You can't replace the names with pointers, because the names may be defined
-//  before the associated ContentLocation is registered.
+// NOTE:  Dependencies are stored by name, because the names may be defined
+//  before the associated ContentLocation is registered.  RecalcDependents
+//  caches the matching ContentLocation pointers alongside the names, and the
+//  depot re-runs it whenever assets or dependencies have been added or removed
+//  since the last time the links were used.
 
 //-----------------------------------------------------------------------------
 class ContentLocation
@@ -73,16 +80,26 @@ class ContentLocation
     RStrArray  astrDependencies; // which items need to be loaded before this one.
     RStrArray  astrDependents;   // which items list this one as a dependency
 
+    TArray<ContentLocation*>  apDependencies;  // cached links for astrDependencies that are registered
+    TArray<ContentLocation*>  apDependents;    // cached links for astrDependents
+
     BOOL       bIsDirty;     // if data has been invaldiated and needs to be re-[down]loaded
     BOOL       bIsReported;  // if data has been passed to callback
     BOOL       bIsLoaded;  // if we have data from remote systems
+    BOOL       bCacheReported;  // if LoadFromCache passed the cached data to callback, and the next fetch only has to revalidate it
+
+    INT        iFetchState;   // ContentDepot::EFetchState during a StartFetch
+    INT        iPendingDeps;  // dependencies that still have to finish before this one is fetched
 
     RStrParser  parserCachedData;  //
 
   public:
                   ContentLocation    ()        {bIsDirty    = TRUE;
                                                 bIsReported = FALSE;
-                                                bIsLoaded = FALSE;};
+                                                bIsLoaded = FALSE;
+                                                bCacheReported = FALSE;
+                                                iFetchState = 0;
+                                                iPendingDeps = 0;};
 
     RStrParser &  GetCachedData      (const char *  szEnvIn)   {return (parserCachedData);};
 
@@ -91,11 +108,150 @@ class ContentLocation
   };
 
 
+//-----------------------------------------------------------------------------
+/// What a server told us about a response, so the next request can ask whether it changed.
+struct ContentValidators
+  {
+  RStr   strETag;
+  RStr   strLastModified;
+  };
+
+//-----------------------------------------------------------------------------
+/// Retrieves the bytes for a URI.  ContentDepot::StartFetch picks a fetcher by
+///  URI scheme and calls Fetch on a worker thread, so implementations must not
+///  touch the depot or any other shared state without their own locking.
+class ContentFetcher
+  {
+  public:
+    virtual           ~ContentFetcher  ()        {};
+
+                      /** @brief  Retrieve the data at a URI.  Runs on a worker thread.
+                          @param  szUriIn The URI, with environment variables already expanded.
+                          @param  parserDataOut Receives the data.
+                          @return Success or failure.
+                      */
+    virtual EStatus   Fetch            (const char *  szUriIn,
+                                        RStrParser &  parserDataOut) = 0;
+
+                      /** @brief  Retrieve the data at a URI, unless it still matches the copy the validators
+                                  describe.  Runs on a worker thread.  The default ignores the validators.
+                          @param  szUriIn The URI, with environment variables already expanded.
+                          @param  validatorsIn Validators of the cached copy.  Empty if there isn't one.
+                          @param  parserDataOut Receives the data, unless it hasn't changed.
+                          @param  validatorsOut Receives the validators of the new data.
+                          @param  bNotModifiedOut Set if the cached copy is still current.
+                          @return Success or failure.
+                      */
+    virtual EStatus   FetchIfChanged   (const char *               szUriIn,
+                                        const ContentValidators &  validatorsIn,
+                                        RStrParser &               parserDataOut,
+                                        ContentValidators &        validatorsOut,
+                                        BOOL &                     bNotModifiedOut)
+                                                                   {
+                                                                   bNotModifiedOut = FALSE;
+                                                                   return (Fetch (szUriIn, parserDataOut));
+                                                                   };
+
+                      /** @brief  Whether data from this fetcher should be kept in the depot's ContentCache.
+                          @return True for remote sources.  Local files are already on disk.
+                      */
+    virtual BOOL      IsCacheable      (VOID)                      {return (FALSE);};
+  };
+
+//-----------------------------------------------------------------------------
+/// Reads file:// and res:// URIs through FilePath.
+class FileContentFetcher : public ContentFetcher
+  {
+  public:
+    EStatus           Fetch            (const char *  szUriIn,
+                                        RStrParser &  parserDataOut) override;
+  };
+
+//-----------------------------------------------------------------------------
+/// Reads http:// URIs through HTTP, with a conditional GET when there are validators.
+class HttpContentFetcher : public ContentFetcher
+  {
+  public:
+    EStatus           Fetch            (const char *  szUriIn,
+                                        RStrParser &  parserDataOut) override;
+
+    EStatus           FetchIfChanged   (const char *               szUriIn,
+                                        const ContentValidators &  validatorsIn,
+                                        RStrParser &               parserDataOut,
+                                        ContentValidators &        validatorsOut,
+                                        BOOL &                     bNotModifiedOut) override;
+
+    BOOL              IsCacheable      (VOID) override             {return (TRUE);};
+  };
+
 //-----------------------------------------------------------------------------
 class ContentDepot
   {
+  public:
+    enum EFetchState {kFetchIdle    = 0,
+                      kFetchWaiting = 1,   ///< Waiting on dependencies
+                      kFetchRunning = 2,   ///< Handed to a fetcher
+                      kFetchDone    = 3,
+                      kFetchFailed  = 4};  ///< The fetch, or one of its dependencies, failed
+
+  protected:
+
+    /// One fetch in flight.  Run executes on a worker thread and only touches the job and the done queue.
+    struct FetchJob
+      {
+      ContentDepot *       pDepot;
+      ContentLocation *    pLoc;
+      ContentFetcher *     pFetcher;    ///< NULL if the data is already in the location (mem://)
+      RStr                 strUri;
+      RStrParser           parserData;
+      EStatus              status;
+      BOOL                 bCacheable;    ///< Store the result in pCache
+      ContentValidators    validatorsIn;  ///< From the cache entry, if there is one
+      ContentValidators    validatorsOut;
+      BOOL                 bNotModified;  ///< The cache entry is still current
+
+      static VOID          Run          (VOID *  pJobIn);
+      };
+
+    BOOL                       bLinksDirty;       ///< Assets or dependencies changed since RecalcDependents
+
+    RStrArray                  astrFetchSchemes;  ///< URI prefixes with a registered fetcher
+    TArray<ContentFetcher*>    apFetchers;        ///< Fetcher for each entry in astrFetchSchemes.  Not owned.
+    FileContentFetcher         fetcherFile;
+    HttpContentFetcher         fetcherHttp;
+
+    ContentCache *             pCache;            ///< Not owned.  NULL if fetched data isn't kept on disk.
+
+    WorkerPool *               pFetchPool;        ///< Non-NULL while a StartFetch is in progress
+    INT                        iFetchOutstanding; ///< Locations in the current fetch that haven't finished or failed
+    INT                        iFetchRunning;     ///< Jobs submitted but not yet handled by UpdateFetch
+    EStatus                    statusFetch;       ///< First failure of the current fetch
+
+    std::mutex                 mutexFetchDone;
+    std::condition_variable    condFetchDone;
+    TArray<FetchJob*>          apFetchDone;       ///< Finished jobs waiting for UpdateFetch.  Guarded by mutexFetchDone.
+
   protected:
 
+    VOID               UpdateLinks           (VOID)   {if (bLinksDirty) {RecalcDependents ();};};
+
+    VOID               ExpandUri             (ContentLocation *  pLocIn,
+                                              RStrParser &       parserUriOut);
+
+    ContentFetcher *   FindFetcher           (const char *       szUriIn);
+
+    BOOL               ReadFromCache         (ContentLocation *  pLocIn,
+                                              const char *       szUriIn);
+
+    VOID               DispatchFetch         (ContentLocation *  pLocIn);
+
+    VOID               QueueFetchDone        (FetchJob *  pJobIn);
+
+    VOID               FailFetch             (ContentLocation *  pLocIn,
+                                              EStatus            statusIn);
+
+    VOID               FinishFetch           (VOID);
+
   public:
     TList<ContentLocation*>  listContents;
 
@@ -190,6 +346,58 @@ class ContentDepot
 
     VOID               OnHttpFileReceived    ();
 
+                       /** @brief  Use a fetcher for URIs that start with the given scheme, in place of any
+                                   fetcher registered for it before.  file:// and res:// are registered
+                                   by default.  mem:// assets need no fetcher.
+                           @param  szSchemeIn URI prefix, such as "http://".
+                           @param  pFetcherIn The fetcher.  Not owned, and must outlive any fetch that uses it.
+                           @return None
+                       */
+    VOID               RegisterFetcher       (const char *       szSchemeIn,
+                                              ContentFetcher *   pFetcherIn);
+
+                       /** @brief  Start fetching every dirty asset on a worker pool.  An asset is fetched once all
+                                   of its dependencies have finished, so assets that don't depend on each other
+                                   are fetched at the same time.  UpdateFetch delivers the results.
+                           @param  bForceRefreshIn Mark every asset dirty first.
+                           @param  iNumThreadsIn Number of worker threads, or 0 for one per core.
+                           @return Failure if a fetch is already in progress.
+                       */
+    EStatus            StartFetch            (BOOL  bForceRefreshIn,
+                                              INT   iNumThreadsIn = 0);
+
+                       /** @brief  Handle finished fetches on the calling thread.  Fires sigOnDataLoad for each
+                                   asset, always after its dependencies, and starts any fetches this unblocks.
+                                   Fires sigOnAllLoaded when the last one finishes, unless one failed.
+                           @return Number of fetches handled.
+                       */
+    INT                UpdateFetch           (VOID);
+
+                       /** @brief  Block, calling UpdateFetch, until the current fetch is complete.
+                           @return Success, or the first fetch failure.
+                       */
+    EStatus            WaitForFetch          (VOID);
+
+    BOOL               IsFetching            (VOID)   {return (pFetchPool != NULL);};
+
+                       /** @brief  Keep fetched data in an on-disk cache.  Remote assets with an entry are
+                                   revalidated with a conditional request, read from the cache if they haven't
+                                   changed, and read from the cache if the request fails.
+                           @param  pCacheIn An open cache, or NULL to stop caching.  Not owned.
+                           @return None
+                       */
+    VOID               SetCache              (ContentCache *  pCacheIn)   {pCache = pCacheIn;};
+
+    ContentCache *     GetCache              (VOID)                       {return (pCache);};
+
+                       /** @brief  Load every dirty asset that has a cache entry straight from disk, and fire
+                                   sigOnDataLoad for each one whose dependencies are loaded too.  The assets
+                                   stay dirty, so the next StartFetch still revalidates them.  If the server
+                                   says they haven't changed, sigOnDataLoad isn't fired for them again.
+                           @return Number of assets loaded.
+                       */
+    INT                LoadFromCache         (VOID);
+
 
 
   };
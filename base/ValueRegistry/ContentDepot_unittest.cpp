@@ -10,6 +10,11 @@ ASSERTFILE (__FILE__)
 #include "ValueRegistry/ValueRegistry.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
 #include "ValueRegistry/ContentDepot.hpp"
+#include "Sys/FilePath.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
+#include <atomic>
+#include <unistd.h>
 
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
@@ -292,3 +297,442 @@ TEST (ContentDepot, Memory)
 
 
 // TODO: Test Memory Assets
+
+
+//------------------------------------------------------------------------------
+/// Stands in for an HTTP server.  Each page takes iDelayUs to arrive.
+class LocalHttpFetcher : public ContentFetcher
+  {
+  public:
+    RStrArray          astrUrls;
+    RStrArray          astrBodies;
+    INT                iDelayUs;
+
+    std::atomic<INT>   iNumActive;
+    std::atomic<INT>   iMaxActive;
+
+  public:
+                       LocalHttpFetcher  ()     {iDelayUs = 0; iNumActive = 0; iMaxActive = 0;};
+
+    VOID               AddPage           (const char *  szUrlIn,
+                                          const char *  szBodyIn)  {astrUrls.Append (szUrlIn); astrBodies.Append (szBodyIn);};
+
+    EStatus            Fetch             (const char *  szUriIn,
+                                          RStrParser &  parserDataOut) override
+                                                   {
+                                                   INT  iActive = ++iNumActive;
+                                                   INT  iMax    = iMaxActive;
+                                                   while ((iActive > iMax) && !iMaxActive.compare_exchange_weak (iMax, iActive)) {};
+
+                                                   usleep (iDelayUs);
+                                                   --iNumActive;
+
+                                                   INT  iIndex = astrUrls.Find (szUriIn);
+                                                   if (iIndex == -1) {return (EStatus::Failure ("404 %s", szUriIn));};
+                                                   parserDataOut.Set (astrBodies [iIndex]);
+                                                   return (EStatus::kSuccess);
+                                                   };
+  };
+
+//------------------------------------------------------------------------------
+class FetchRecorder
+  {
+  public:
+    RStrArray   astrLoaded;
+    INT         iNumAllLoaded;
+    INT         iLoadedAtAllLoaded;
+
+  public:
+                FetchRecorder  ()   {iNumAllLoaded = 0; iLoadedAtAllLoaded = -1;};
+
+    VOID        OnDataLoad     (const char *        szNameIn,
+                                const char *        szTypeIn,
+                                const RStrParser&   dataIn)   {astrLoaded.Append (szNameIn);};
+
+    VOID        OnAllLoaded    (VOID)                         {++iNumAllLoaded; iLoadedAtAllLoaded = astrLoaded.Length ();};
+
+    INT         IndexOf        (const char *  szNameIn)       {return (astrLoaded.Find (szNameIn));};
+  };
+
+//------------------------------------------------------------------------------
+TEST (ContentDepot, FetchScheduler)
+  {
+  // pages are slow enough to overlap.  A 20 ms delay when timing the fetch.
+  LocalHttpFetcher  fetcherHttp;
+  fetcherHttp.iDelayUs = UnitTestBenchmarks () ? 20000 : 2000;
+
+  ContentDepot   depot;
+  depot.strEnvironment = "dev";
+  depot.RegisterFetcher ("http://", &fetcherHttp);
+
+  // A needs B and C, which both need D.  E through H stand alone.
+  const char *  aszHttp [] = {"A", "B", "C", "D", "E", "F", "G", "H"};
+  for (INT  iIndex = 0; iIndex < 8; ++iIndex)
+    {
+    RStr  strUrl;
+    RStr  strBody;
+    strUrl.Format  ("http://localhost/%s.txt", aszHttp [iIndex]);
+    strBody.Format ("Body of %s", aszHttp [iIndex]);
+    fetcherHttp.AddPage (strUrl.AsChar (), strBody.AsChar ());
+    depot.AddAsset (aszHttp [iIndex], "txt", "dev", strUrl.AsChar ());
+    };
+  depot.AddDependency ("A", "B");
+  depot.AddDependency ("A", "C");
+  depot.AddDependency ("B", "D");
+  depot.AddDependency ("C", "D");
+
+  // local files and memory buffers take part in the same graph.
+  RStrParser  parserFile ("Hello File");
+  RStr        strFilePath ("file://UnitTestFetch.txt");
+  parserFile.WriteToFile (FilePath::ExpandPathURI (strFilePath.AsChar ()));
+  depot.AddAsset ("File", "txt", "dev", strFilePath.AsChar ());
+
+  RStr  strMemory ("Hello Memory");
+  depot.AddAsset ("Memory", "txt", "dev", "mem://Memory.txt", &strMemory);
+  depot.AddDependency ("Memory", "A");
+  depot.AddDependency ("Memory", "File");
+
+  FetchRecorder  recorder;
+  depot.sigOnDataLoad.Connect (&recorder, &FetchRecorder::OnDataLoad);
+  depot.sigOnAllLoaded.Connect (&recorder, &FetchRecorder::OnAllLoaded);
+
+  // one thread fetches everything in turn.
+  INT64  iSerialStartUs = StopWatch::GetTimeUs ();
+  ASSERT_EQ (depot.StartFetch (TRUE, 1), EStatus::kSuccess);
+  ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+  INT64  iSerialUs = StopWatch::GetTimeUs () - iSerialStartUs;
+
+  ASSERT_EQ (recorder.astrLoaded.Length (), 10);
+  ASSERT_EQ (fetcherHttp.iMaxActive, 1);
+
+  recorder.astrLoaded.Clear ();
+  recorder.iNumAllLoaded = 0;
+  fetcherHttp.iMaxActive = 0;
+
+  INT64  iParallelStartUs = StopWatch::GetTimeUs ();
+  ASSERT_EQ (depot.StartFetch (TRUE, 8), EStatus::kSuccess);
+  ASSERT_TRUE (depot.IsFetching ());
+  ASSERT_EQ (depot.StartFetch (TRUE, 8), EStatus::kFailure);
+  ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+  INT64  iParallelUs = StopWatch::GetTimeUs () - iParallelStartUs;
+
+  ASSERT_FALSE (depot.IsFetching ());
+  ASSERT_TRUE (depot.IsEverythingReturned ());
+  ASSERT_EQ (recorder.astrLoaded.Length (), 10);
+  ASSERT_EQ (recorder.iNumAllLoaded, 1);
+  ASSERT_EQ (recorder.iLoadedAtAllLoaded, 10);
+  ASSERT_GT (fetcherHttp.iMaxActive, 1);
+
+  // every asset is reported after the assets it depends on.
+  ASSERT_LT (recorder.IndexOf ("D"), recorder.IndexOf ("B"));
+  ASSERT_LT (recorder.IndexOf ("D"), recorder.IndexOf ("C"));
+  ASSERT_LT (recorder.IndexOf ("B"), recorder.IndexOf ("A"));
+  ASSERT_LT (recorder.IndexOf ("C"), recorder.IndexOf ("A"));
+  ASSERT_LT (recorder.IndexOf ("A"), recorder.IndexOf ("Memory"));
+  ASSERT_LT (recorder.IndexOf ("File"), recorder.IndexOf ("Memory"));
+
+  ASSERT_STREQ (depot.FindAsset ("A")->parserCachedData.AsChar (), "Body of A");
+  ASSERT_STREQ (depot.FindAsset ("File")->parserCachedData.AsChar (), "Hello File");
+  ASSERT_STREQ (depot.FindAsset ("Memory")->parserCachedData.AsChar (), "Hello Memory");
+
+  BenchmarkPrintf ("ContentDepot fetch, 8 http assets at %d ms:  serial %8.3f ms  parallel %8.3f ms  speedup %.1fx\n",
+                   fetcherHttp.iDelayUs / 1000, iSerialUs / 1000.0, iParallelUs / 1000.0,
+                   (iParallelUs > 0) ? DOUBLE (iSerialUs) / DOUBLE (iParallelUs) : 0.0);
+
+  // nothing dirty means nothing to fetch.
+  recorder.astrLoaded.Clear ();
+  recorder.iNumAllLoaded = 0;
+  ASSERT_EQ (depot.StartFetch (FALSE), EStatus::kSuccess);
+  ASSERT_FALSE (depot.IsFetching ());
+  ASSERT_EQ (recorder.astrLoaded.Length (), 0);
+  ASSERT_EQ (recorder.iNumAllLoaded, 1);
+
+  depot.sigOnDataLoad.Disconnect (&recorder, &FetchRecorder::OnDataLoad);
+  depot.sigOnAllLoaded.Disconnect (&recorder, &FetchRecorder::OnAllLoaded);
+  };
+
+//------------------------------------------------------------------------------
+TEST (ContentDepot, FetchSchedulerFailures)
+  {
+  LocalHttpFetcher  fetcherHttp;
+  fetcherHttp.AddPage ("http://localhost/ok.txt", "ok");
+
+  ContentDepot   depot;
+  depot.strEnvironment = "dev";
+  depot.RegisterFetcher ("http://", &fetcherHttp);
+
+  // Missing fails, so NeedsMissing can never start.  X and Y wait on each other.
+  depot.AddAsset ("Ok",           "txt", "dev", "http://localhost/ok.txt");
+  depot.AddAsset ("Missing",      "txt", "dev", "http://localhost/missing.txt");
+  depot.AddAsset ("NeedsMissing", "txt", "dev", "http://localhost/ok.txt");
+  depot.AddAsset ("NoScheme",     "txt", "dev", "gopher://localhost/ok.txt");
+  depot.AddAsset ("X",            "txt", "dev", "http://localhost/ok.txt");
+  depot.AddAsset ("Y",            "txt", "dev", "http://localhost/ok.txt");
+  depot.AddDependency ("NeedsMissing", "Missing");
+  depot.AddDependency ("X", "Y");
+  depot.AddDependency ("Y", "X");
+
+  FetchRecorder  recorder;
+  depot.sigOnDataLoad.Connect (&recorder, &FetchRecorder::OnDataLoad);
+  depot.sigOnAllLoaded.Connect (&recorder, &FetchRecorder::OnAllLoaded);
+
+  ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+  ASSERT_EQ (depot.WaitForFetch (), EStatus::kFailure);
+  ASSERT_FALSE (depot.IsFetching ());
+
+  ASSERT_EQ (recorder.astrLoaded.Length (), 1);
+  ASSERT_STREQ (recorder.astrLoaded [0].AsChar (), "Ok");
+  ASSERT_EQ (recorder.iNumAllLoaded, 0);
+  ASSERT_FALSE (depot.FindAsset ("NeedsMissing")->bIsLoaded);
+  ASSERT_FALSE (depot.FindAsset ("X")->bIsLoaded);
+  ASSERT_EQ (depot.FindAsset ("X")->iFetchState, ContentDepot::kFetchFailed);
+
+  depot.sigOnDataLoad.Disconnect (&recorder, &FetchRecorder::OnDataLoad);
+  depot.sigOnAllLoaded.Disconnect (&recorder, &FetchRecorder::OnAllLoaded);
+  };
+
+//------------------------------------------------------------------------------
+/// Stands in for an HTTP server that answers conditional requests.  Each page's
+///  ETag is the hash of its body, so changing the body changes the ETag.
+class RevalidatingFetcher : public ContentFetcher
+  {
+  public:
+    RStrArray          astrUrls;
+    RStrArray          astrBodies;
+    BOOL               bOffline;
+
+    std::atomic<INT>   iNumFull;
+    std::atomic<INT>   iNumNotModified;
+
+  public:
+                       RevalidatingFetcher  ()  {bOffline = FALSE; iNumFull = 0; iNumNotModified = 0;};
+
+    VOID               SetPage              (const char *  szUrlIn,
+                                             const char *  szBodyIn)  {
+                                                                      INT  iIndex = astrUrls.Find (szUrlIn);
+                                                                      if (iIndex == -1) {astrUrls.Append (szUrlIn); astrBodies.Append (szBodyIn);}
+                                                                      else              {astrBodies [iIndex] = szBodyIn;};
+                                                                      };
+
+    EStatus            Fetch                (const char *  szUriIn,
+                                             RStrParser &  parserDataOut) override
+                                                   {
+                                                   ContentValidators  validatorsNone;
+                                                   ContentValidators  validatorsOut;
+                                                   BOOL               bNotModified;
+                                                   return (FetchIfChanged (szUriIn, validatorsNone, parserDataOut, validatorsOut, bNotModified));
+                                                   };
+
+    EStatus            FetchIfChanged       (const char *               szUriIn,
+                                             const ContentValidators &  validatorsIn,
+                                             RStrParser &               parserDataOut,
+                                             ContentValidators &        validatorsOut,
+                                             BOOL &                     bNotModifiedOut) override
+                                                   {
+                                                   bNotModifiedOut = FALSE;
+                                                   if (bOffline) {return (EStatus::Failure ("Unable to connect to %s", szUriIn));};
+
+                                                   INT  iIndex = astrUrls.Find (szUriIn);
+                                                   if (iIndex == -1) {return (EStatus::Failure ("404 %s", szUriIn));};
+
+                                                   validatorsOut.strETag.Format ("\"%08x\"", CalcHashValue (astrBodies [iIndex].AsChar ()));
+                                                   if (validatorsIn.strETag == validatorsOut.strETag)
+                                                     {
+                                                     ++iNumNotModified;
+                                                     bNotModifiedOut = TRUE;
+                                                     return (EStatus::kSuccess);
+                                                     };
+                                                   ++iNumFull;
+                                                   parserDataOut.Set (astrBodies [iIndex]);
+                                                   return (EStatus::kSuccess);
+                                                   };
+
+    BOOL               IsCacheable          (VOID) override   {return (TRUE);};
+  };
+
+//------------------------------------------------------------------------------
+TEST (ContentDepot, CacheRevalidation)
+  {
+  RStr  strCacheDir (FilePath::ExpandPathURI ("file://UnitTestContentCache"));
+
+  ContentCache  cache;
+  ASSERT_EQ (cache.Open (strCacheDir.AsChar ()), EStatus::kSuccess);
+  cache.RemoveAll ();
+  cache.Save ();
+
+  RevalidatingFetcher  fetcher;
+  fetcher.SetPage ("http://localhost/dev/A.txt", "Body of A");
+  fetcher.SetPage ("http://localhost/dev/B.txt", "Body of B");
+  fetcher.SetPage ("http://localhost/prod/A.txt", "Body of prod A");
+
+  FetchRecorder  recorder;
+
+    {
+    ContentDepot   depot;
+    depot.strEnvironment = "dev";
+    depot.RegisterFetcher ("http://", &fetcher);
+    depot.SetCache (&cache);
+    depot.AddAsset ("A", "txt", "default", "http://localhost/${Env}/A.txt");
+    depot.AddAsset ("B", "txt", "default", "http://localhost/${Env}/B.txt");
+    depot.AddDependency ("B", "A");
+    depot.sigOnDataLoad.Connect (&recorder, &FetchRecorder::OnDataLoad);
+
+    // first run downloads everything and fills the cache.
+    ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+    ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+    ASSERT_EQ (fetcher.iNumFull, 2);
+    ASSERT_EQ (cache.Size (), 2);
+    ASSERT_NE (cache.Find ("A", "http://localhost/dev/A.txt"), nullptr);
+
+    // nothing changed, so both are revalidated and read back from disk.
+    ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+    ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+    ASSERT_EQ (fetcher.iNumFull, 2);
+    ASSERT_EQ (fetcher.iNumNotModified, 2);
+    ASSERT_STREQ (depot.FindAsset ("B")->parserCachedData.AsChar (), "Body of B");
+
+    // only the changed page is downloaded again.
+    fetcher.SetPage ("http://localhost/dev/A.txt", "New body of A");
+    ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+    ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+    ASSERT_EQ (fetcher.iNumFull, 3);
+    ASSERT_EQ (fetcher.iNumNotModified, 3);
+    ASSERT_STREQ (depot.FindAsset ("A")->parserCachedData.AsChar (), "New body of A");
+
+    // each environment has its own entry.
+    depot.strEnvironment = "prod";
+    ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+    ASSERT_EQ (depot.WaitForFetch (), EStatus::kFailure);
+    ASSERT_STREQ (depot.FindAsset ("A")->parserCachedData.AsChar (), "Body of prod A");
+    ASSERT_EQ (cache.Size (), 3);
+
+    // offline, the cached copies stand in for the server.
+    depot.strEnvironment = "dev";
+    fetcher.bOffline = TRUE;
+    recorder.astrLoaded.Clear ();
+    ASSERT_EQ (depot.StartFetch (TRUE, 2), EStatus::kSuccess);
+    ASSERT_EQ (depot.WaitForFetch (), EStatus::kSuccess);
+    ASSERT_EQ (recorder.astrLoaded.Length (), 2);
+    ASSERT_STREQ (depot.FindAsset ("A")->parserCachedData.AsChar (), "New body of A");
+    ASSERT_STREQ (depot.FindAsset ("B")->parserCachedData.AsChar (), "Body of B");
+
+    depot.sigOnDataLoad.Disconnect (&recorder, &FetchRecorder::OnDataLoad);
+    };
+
+  // a cold start reads the saved index and has the data before any request.
+  fetcher.iNumFull        = 0;
+  fetcher.iNumNotModified = 0;
+
+  ContentCache  cacheCold;
+  ASSERT_EQ (cacheCold.Open (strCacheDir.AsChar ()), EStatus::kSuccess);
+  ASSERT_EQ (cacheCold.Size (), 3);
+
+  ContentDepot   depotCold;
+  depotCold.strEnvironment = "dev";
+  depotCold.RegisterFetcher ("http://", &fetcher);
+  depotCold.SetCache (&cacheCold);
+  depotCold.AddAsset ("B", "txt", "default", "http://localhost/${Env}/B.txt");
+  depotCold.AddAsset ("A", "txt", "default", "http://localhost/${Env}/A.txt");
+  depotCold.AddAsset ("C", "txt", "default", "http://localhost/${Env}/C.txt");
+  depotCold.AddDependency ("B", "A");
+  depotCold.sigOnDataLoad.Connect (&recorder, &FetchRecorder::OnDataLoad);
+
+  recorder.astrLoaded.Clear ();
+  ASSERT_EQ (depotCold.LoadFromCache (), 2);
+  ASSERT_EQ (fetcher.iNumFull + fetcher.iNumNotModified, 0);
+  ASSERT_EQ (recorder.astrLoaded.Length (), 2);
+  ASSERT_LT (recorder.IndexOf ("A"), recorder.IndexOf ("B"));
+  ASSERT_STREQ (depotCold.FindAsset ("A")->parserCachedData.AsChar (), "New body of A");
+  ASSERT_FALSE (depotCold.FindAsset ("C")->bIsLoaded);
+
+  // the loaded assets are still revalidated by the next fetch, but since they
+  //  haven't changed, only the new asset is reported.
+  fetcher.bOffline = FALSE;
+  fetcher.SetPage ("http://localhost/dev/C.txt", "Body of C");
+  recorder.astrLoaded.Clear ();
+  ASSERT_EQ (depotCold.StartFetch (FALSE, 2), EStatus::kSuccess);
+  ASSERT_EQ (depotCold.WaitForFetch (), EStatus::kSuccess);
+  ASSERT_EQ (fetcher.iNumNotModified, 2);
+  ASSERT_EQ (fetcher.iNumFull, 1);
+  ASSERT_EQ (recorder.astrLoaded.Length (), 1);
+  ASSERT_EQ (recorder.IndexOf ("C"), 0);
+  ASSERT_TRUE (depotCold.FindAsset ("B")->bIsReported);
+
+  // a forced refresh reports everything again.
+  recorder.astrLoaded.Clear ();
+  ASSERT_EQ (depotCold.StartFetch (TRUE, 2), EStatus::kSuccess);
+  ASSERT_EQ (depotCold.WaitForFetch (), EStatus::kSuccess);
+  ASSERT_EQ (recorder.astrLoaded.Length (), 3);
+
+  depotCold.sigOnDataLoad.Disconnect (&recorder, &FetchRecorder::OnDataLoad);
+  cacheCold.RemoveAll ();
+  cacheCold.Save ();
+  };
+
+//------------------------------------------------------------------------------
+TEST (ContentCache, Eviction)
+  {
+  RStr  strCacheDir (FilePath::ExpandPathURI ("file://UnitTestContentCacheEvict"));
+
+  ContentCache  cache;
+  ASSERT_EQ (cache.Open (strCacheDir.AsChar (), 100), EStatus::kSuccess);
+  cache.RemoveAll ();
+
+  RStrParser  parserOne   ("0123456789012345678901234567890123456789");
+  RStrParser  parserTwo   ("abcdefghijabcdefghijabcdefghijabcdefghij");
+  RStrParser  parserThree ("ABCDEFGHIJABCDEFGHIJABCDEFGHIJABCDEFGHIJ");
+  RStrParser  parserRead;
+
+  ASSERT_NE (cache.Store ("One",   "http://localhost/1", "\"1\"", NULL, parserOne),   nullptr);
+  ASSERT_NE (cache.Store ("Two",   "http://localhost/2", "\"2\"", NULL, parserTwo),   nullptr);
+
+  // entries with the same contents share a blob.
+  ASSERT_NE (cache.Store ("Copy",  "http://localhost/c", NULL, "Wed, 21 Oct 2015 07:28:00 GMT", parserOne), nullptr);
+  ASSERT_EQ (cache.Size (), 3);
+  ASSERT_EQ (cache.TotalBytes (), 80);
+
+  // reading One makes Two the oldest, so it goes when Three doesn't fit.
+  ASSERT_EQ (cache.Read (cache.Find ("One", "http://localhost/1"), parserRead), EStatus::kSuccess);
+  ASSERT_STREQ (parserRead.AsChar (), parserOne.AsChar ());
+  ASSERT_NE (cache.Store ("Three", "http://localhost/3", NULL, NULL, parserThree), nullptr);
+  ASSERT_EQ (cache.Find ("Two", "http://localhost/2"), nullptr);
+  ASSERT_NE (cache.Find ("One", "http://localhost/1"), nullptr);
+  ASSERT_LE (cache.TotalBytes (), 100);
+
+  // too big to ever fit.
+  RStrParser  parserHuge;
+  for (INT  iIndex = 0; iIndex < 3; ++iIndex) {parserHuge.AppendString (parserTwo);};
+  ASSERT_EQ (cache.Store ("Huge", "http://localhost/h", NULL, NULL, parserHuge), nullptr);
+
+  // the index survives a reopen, and blobs it doesn't know about are removed.
+  ASSERT_EQ (cache.Save (), EStatus::kSuccess);
+  RStrParser  parserOrphan ("orphan");
+  RStr        strOrphan (FilePath::Combine (strCacheDir.AsChar (), "00000000_00000006.blob"));
+  parserOrphan.WriteToFile (strOrphan.AsChar ());
+
+  ContentCache  cacheReopen;
+  ASSERT_EQ (cacheReopen.Open (strCacheDir.AsChar (), 100), EStatus::kSuccess);
+  ASSERT_EQ (cacheReopen.Size (), 3);
+  ASSERT_EQ (cacheReopen.TotalBytes (), cache.TotalBytes ());
+  ASSERT_FALSE (FilePath::FileExists (strOrphan.AsChar ()));
+
+  ContentCache::Entry *  pCopy = cacheReopen.Find ("Copy", "http://localhost/c");
+  ASSERT_NE (pCopy, nullptr);
+  ASSERT_STREQ (pCopy->strLastModified.AsChar (), "Wed, 21 Oct 2015 07:28:00 GMT");
+
+  // a damaged blob is caught by its hash, and the entries using it are dropped.
+  RStrParser  parserDamaged ("0123456789012345678901234567890123456788");
+  RStr        strBlob;
+  strBlob.Format ("%08x_%08x.blob", pCopy->uContentHash, pCopy->uContentSize);
+  parserDamaged.WriteToFile (FilePath::Combine (strCacheDir.AsChar (), strBlob.AsChar ()));
+  ASSERT_EQ (cacheReopen.Read (pCopy, parserRead), EStatus::kFailure);
+  ASSERT_EQ (cacheReopen.Find ("Copy", "http://localhost/c"), nullptr);
+  ASSERT_EQ (cacheReopen.Read (cacheReopen.Find ("One", "http://localhost/1"), parserRead), EStatus::kFailure);
+  ASSERT_EQ (cacheReopen.Size (), 1);
+
+  // shrinking the bound evicts right away.
+  cacheReopen.SetMaxBytes (10);
+  ASSERT_EQ (cacheReopen.Size (), 0);
+  ASSERT_EQ (cacheReopen.TotalBytes (), 0);
+  cacheReopen.Save ();
+  };
@@ -182,61 +182,67 @@ VOID  ValueRegistry::Overlay  (ValueRegistry *  pregToOverlay,
     INT iNumElem = pregToOverlay->Size ();
     for (INT  iIndex = 0; iIndex < iNumElem; ++iIndex)
       {
-      ValueElem *  pElem         = pregToOverlay->FindByIndex (iIndex);
-      ValueElem *  pElemExisting = Find (pElem->GetNameHash());
-
-      if (pElemExisting != NULL)
-        {
-        //DBG_INFO ("Merging variable %s into base\n", pElemExisting->GetName());
-
-        if (pElem->IsType (pElemExisting->GetType ()))
-          {
-          // if type is same, and order is higher, set the new value and order
-          if (iOrderIn > pElemExisting->GetOrder ())
-            {
-            pElemExisting->SetByType (*pElem);
-            pElemExisting->SetOrder (pElem->GetOrder ());
-            };
-          }
-        else
-          {
-          // if type is different, lowest ordered elem determines type
-          if (pElem->GetOrder () < pElemExisting->GetOrder ())
-            {
-            // NOTE: This behavior of having the lowest ordered element setting
-            //  the type is needed in case a higher ordered element is solved first
-            //  (because it was not expression driven), but it used a predicted type
-            //  that was incorrect.  This should hopefully be an edge case, rather
-            //  than the norm, and only really a problem on initial solve either at
-            //  startup or because the dev/prod environment changed.
-            //
-            //  To change type we need to delete and recreate the element, and this
-            //  will break all OnChange/OnDelete connections.  This should be fine,
-            //  as long as the element hookups are coded so they auto-connect as needed.
-
-            // Zero out hash so Find() will ignore it, and a new elem of the same name can be created.
-            pElemExisting->ZeroName ();
-            ValueElem *  pElemNew = SetClone (pElem);
-
-            // the new item is at the end of the list.  Swap it with the existing
-            //  to-be-deleted element so that the indexing isn't messed up.
-
-            SwapIndexes (*pElemExisting, *pElemNew);
-            DeleteElem (pElemExisting);
-            }
-          }
-        }
-      else
-        {
-        //DBG_INFO ("SetClone");
-        SetClone (pElem);
-        };
+      OverlayElem (pregToOverlay->FindByIndex (iIndex), iOrderIn);
       };
 
     // preserve name lookups
 
   };
 
+//-----------------------------------------------------------------------------
+VOID  ValueRegistry::OverlayElem  (ValueElem *  pElem,
+                                   INT          iOrderIn)
+  {
+  ValueElem *  pElemExisting = Find (pElem->GetNameHash());
+
+  if (pElemExisting != NULL)
+    {
+    //DBG_INFO ("Merging variable %s into base\n", pElemExisting->GetName());
+
+    if (pElem->IsType (pElemExisting->GetType ()))
+      {
+      // if type is same, and order is higher, set the new value and order
+      if (iOrderIn > pElemExisting->GetOrder ())
+        {
+        pElemExisting->SetByType (*pElem);
+        pElemExisting->SetOrder (pElem->GetOrder ());
+        };
+      }
+    else
+      {
+      // if type is different, lowest ordered elem determines type
+      if (pElem->GetOrder () < pElemExisting->GetOrder ())
+        {
+        // NOTE: This behavior of having the lowest ordered element setting
+        //  the type is needed in case a higher ordered element is solved first
+        //  (because it was not expression driven), but it used a predicted type
+        //  that was incorrect.  This should hopefully be an edge case, rather
+        //  than the norm, and only really a problem on initial solve either at
+        //  startup or because the dev/prod environment changed.
+        //
+        //  To change type we need to delete and recreate the element, and this
+        //  will break all OnChange/OnDelete connections.  This should be fine,
+        //  as long as the element hookups are coded so they auto-connect as needed.
+
+        // Zero out hash so Find() will ignore it, and a new elem of the same name can be created.
+        pElemExisting->ZeroName ();
+        ValueElem *  pElemNew = SetClone (pElem);
+
+        // the new item is at the end of the list.  Swap it with the existing
+        //  to-be-deleted element so that the indexing isn't messed up.
+
+        SwapIndexes (*pElemExisting, *pElemNew);
+        DeleteElem (pElemExisting);
+        }
+      }
+    }
+  else
+    {
+    //DBG_INFO ("SetClone");
+    SetClone (pElem);
+    };
+  };
+
 
 //------------------------------------------------------------------------------
 const char *  ValueRegistry::ExpandVars (RStrParser &  parserIn) const
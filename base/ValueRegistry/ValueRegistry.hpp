@@ -43,6 +43,7 @@
 #include "Util/RStr.hpp"
 #include "Util/RStrParser.hpp"
 #include "Util/Signal.h"
+#include "Util/ChangeBatch.hpp"
 #include "Containers/RStrArray.hpp"
 #include "Containers/IntArray.hpp"
 #include "Containers/FloatArray.hpp"
@@ -79,6 +80,7 @@ class ValueElem
     INT     iOrder;      ///< For variable lists, gives left->right order of the variable.  For ValueRegistries set by ConfigDeck, gives the order of the layer that set this element.
     BOOL    bSave;
     BOOL    bIsUniqueSet;      ///< If true, the array type will be treated as a unique set of values.
+    INT     iPendingChange;    ///< Slot in ChangeBatch's pending list while a batched sigOnChanged is waiting.
 
     static RStr    strStringOut; // used by GetString for string conversion purposes.
                                  // since only one copy exists, it is not thread safe
@@ -106,9 +108,10 @@ class ValueElem
 
   public:
 
-                          ValueElem     ()                    {iOrder = -1; uType = 0; bIsUniqueSet = FALSE; bSave = FALSE; uNameHash = 0;};
+                          ValueElem     ()                    {iOrder = -1; uType = 0; bIsUniqueSet = FALSE; bSave = FALSE; uNameHash = 0;
+                                                               iPendingChange = ChangeBatch::kNotPending;};
 
-    virtual               ~ValueElem    ()                    {CallOnDelete (this);};
+    virtual               ~ValueElem    ()                    {ChangeBatch::Cancel (this, iPendingChange); CallOnDelete (this);};
 
     UINT32                GetType       (VOID)                {return uType;};
 
@@ -120,6 +123,10 @@ class ValueElem
 
     HASH_T                GetNameHash   (VOID)                {return uNameHash;};
 
+    const RStr &          GetAltNameStr (VOID)                {return strAltName;};
+
+    HASH_T                GetAltNameHash (VOID)               {return strAltName.GetHash ();};
+
     VOID                  ZeroName      (VOID)                {strName.Empty(); uNameHash = 0;};
 
     BOOL                  MatchesName   (const char *  szNameIn,
@@ -140,8 +147,13 @@ class ValueElem
 
     VOID                  SetNameHash   (HASH_T  uHashIn)     {uNameHash = uHashIn;};
 
+                          /// @brief  Fire sigOnChanged, or queue it for ChangeBatch::Flush if ChangeBatch is batching kValueElem.
     VOID                  CallOnChanged (ValueElem *  pelemChanged,
-                                         BOOL         bUpdating)     {sigOnChanged(this, bUpdating);};
+                                         BOOL         bUpdating)     {ChangeBatch::Raise (ChangeBatch::kValueElem, this, iPendingChange, &ValueElem::DeliverChanged, bUpdating);};
+
+                          /// @brief  Fires sigOnChanged for CallOnChanged, directly or from ChangeBatch::Flush.
+    static VOID           DeliverChanged (VOID *  pelemIn,
+                                          BOOL    bUpdating)     {ValueElem *  pelem = static_cast<ValueElem *>(pelemIn); pelem->sigOnChanged (pelem, bUpdating);};
 
     VOID                  CallOnDelete  (ValueElem *  pelemChanged)  {sigOnDelete(this);};
 
@@ -511,6 +523,11 @@ class ValueRegistry
     virtual VOID          Overlay       (ValueRegistry *  regToOverlay,
                                          INT              iOrderIn);
 
+                          /** @brief Merge a single element using the same ordering rules as Overlay.
+                          */
+    VOID                  OverlayElem   (ValueElem *  pElemIn,
+                                         INT          iOrderIn);
+
 
                           /** @brief Utility function to swap the position in storage of two elements.  Will be used to move elements to delete to the end of the list to avoid messing up indexed order.
                           */
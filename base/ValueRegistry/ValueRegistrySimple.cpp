@@ -198,17 +198,49 @@ ValueRegistrySimple::~ValueRegistrySimple ()
   ClearLocal ();
   };
 
+//-----------------------------------------------------------------------------
+VOID  ValueRegistrySimple::AddElem  (ValueElem *   pElemIn)
+  {
+  listValues.PushBack (pElemIn);
+
+  hashValues.Insert (pElemIn->GetNameHash (), pElemIn);
+  if (!pElemIn->GetAltNameStr ().IsEmpty ())
+    {
+    hashValues.Insert (pElemIn->GetAltNameHash (), pElemIn);
+    };
+  };
+
+//-----------------------------------------------------------------------------
+VOID  ValueRegistrySimple::RemoveElem  (ValueElem *   pElemIn)
+  {
+  // The element's name may have been zeroed or changed since it was indexed
+  //  (see ValueRegistry::MergeRegistry), so fall back to a full scan if the
+  //  current hash doesn't find it.
+  if (!hashValues.Remove (pElemIn->GetNameHash (), pElemIn))
+    {
+    hashValues.RemoveValue (pElemIn);
+    return;
+    };
+  if (!pElemIn->GetAltNameStr ().IsEmpty ())
+    {
+    hashValues.Remove (pElemIn->GetAltNameHash (), pElemIn);
+    };
+  };
+
 //-----------------------------------------------------------------------------
 ValueElem *  ValueRegistrySimple::Find  (const char *  szNameIn) const
   {
-  RStr   strNameIn (szNameIn);
-  strNameIn.CalcHash ();
+  if (szNameIn == NULL) szNameIn = "";
+  HASH_T  uHash = CalcHashValue (szNameIn);
 
-  for (TListItr<ValueElem*>  itrCurr = listValues.First(); itrCurr.IsValid (); ++itrCurr)
+  // entries are indexed by both name and alt name, so verify the string
+  //  to rule out hash collisions.
+  for (INT  iSlot = hashValues.FindFirst (uHash); iSlot != -1; iSlot = hashValues.FindNext (uHash, iSlot))
     {
-    if ((*itrCurr)->MatchesName (strNameIn))
+    ValueElem *  pElem = hashValues.GetAt (iSlot);
+    if (pElem->MatchesName (szNameIn, uHash))
       {
-      return (*itrCurr);
+      return (pElem);
       };
     };
   return (NULL);
@@ -217,11 +249,14 @@ ValueElem *  ValueRegistrySimple::Find  (const char *  szNameIn) const
 //-----------------------------------------------------------------------------
 ValueElem *  ValueRegistrySimple::Find  (HASH_T  uNameHashIn) const
   {
-  for (TListItr<ValueElem*>  itrCurr = listValues.First(); itrCurr.IsValid (); ++itrCurr)
+  // the index also holds alt name hashes and stale entries, so verify the
+  //  element's current name hash.
+  for (INT  iSlot = hashValues.FindFirst (uNameHashIn); iSlot != -1; iSlot = hashValues.FindNext (uNameHashIn, iSlot))
     {
-    if ((*itrCurr)->MatchesNameHash (uNameHashIn))
+    ValueElem *  pElem = hashValues.GetAt (iSlot);
+    if (pElem->MatchesNameHash (uNameHashIn))
       {
-      return (*itrCurr);
+      return (pElem);
       };
     };
   return (NULL);
@@ -1012,7 +1047,7 @@ ValueElem *  ValueRegistrySimple::NewInt  (const char *  szNameIn)
     {
     pSearch = new ValueElemInt;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1025,7 +1060,7 @@ ValueElem *  ValueRegistrySimple::NewInt  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemInt;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1038,7 +1073,7 @@ ValueElem *  ValueRegistrySimple::NewFloat  (const char *  szNameIn)
     {
     pSearch = new ValueElemFloat;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1051,7 +1086,7 @@ ValueElem *  ValueRegistrySimple::NewFloat  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemFloat;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1064,7 +1099,7 @@ ValueElem *  ValueRegistrySimple::NewDouble  (const char *  szNameIn)
     {
     pSearch = new ValueElemDouble;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1077,7 +1112,7 @@ ValueElem *  ValueRegistrySimple::NewDouble  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemDouble;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1090,7 +1125,7 @@ ValueElem *  ValueRegistrySimple::NewVec  (const char *  szNameIn)
     {
     pSearch = new ValueElemVec;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1103,7 +1138,7 @@ ValueElem *  ValueRegistrySimple::NewVec  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemVec;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1116,7 +1151,7 @@ ValueElem *  ValueRegistrySimple::NewBool  (const char *  szNameIn)
     {
     pSearch = new ValueElemBool;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1129,7 +1164,7 @@ ValueElem *  ValueRegistrySimple::NewBool  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemBool;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1142,7 +1177,7 @@ ValueElem *  ValueRegistrySimple::NewString  (const char *  szNameIn)
     {
     pSearch = new ValueElemString;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1155,7 +1190,7 @@ ValueElem *  ValueRegistrySimple::NewString  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemString;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1168,7 +1203,7 @@ ValueElem *  ValueRegistrySimple::NewBlob  (const char *  szNameIn)
     {
     pSearch = new ValueElemBlob;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1181,7 +1216,7 @@ ValueElem *  ValueRegistrySimple::NewBlob  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemBlob;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1194,7 +1229,7 @@ ValueElem *  ValueRegistrySimple::NewStringArray  (const char *  szNameIn)
     {
     pSearch = new ValueElemStringArray;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1207,7 +1242,7 @@ ValueElem *  ValueRegistrySimple::NewStringArray  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemStringArray;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1220,7 +1255,7 @@ ValueElem *  ValueRegistrySimple::NewIntArray  (const char *  szNameIn)
     {
     pSearch = new ValueElemIntArray;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1233,7 +1268,7 @@ ValueElem *  ValueRegistrySimple::NewIntArray  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemIntArray;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1246,7 +1281,7 @@ ValueElem *  ValueRegistrySimple::NewFloatArray  (const char *  szNameIn)
     {
     pSearch = new ValueElemFloatArray;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1259,7 +1294,7 @@ ValueElem *  ValueRegistrySimple::NewFloatArray  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemFloatArray;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1272,7 +1307,7 @@ ValueElem *  ValueRegistrySimple::NewDoubleArray  (const char *  szNameIn)
     {
     pSearch = new ValueElemDoubleArray;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1285,7 +1320,7 @@ ValueElem *  ValueRegistrySimple::NewDoubleArray  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemDoubleArray;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1298,7 +1333,7 @@ ValueElem *   ValueRegistrySimple::NewPtr  (const char *  szNameIn)
     {
     pSearch = new ValueElemPtr;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1311,7 +1346,7 @@ ValueElem *   ValueRegistrySimple::NewPtr  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemPtr;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1324,7 +1359,7 @@ ValueElem *   ValueRegistrySimple::NewLink  (const char *  szNameIn)
     {
     pSearch = new ValueElemLink;
     pSearch->SetName (szNameIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1337,7 +1372,7 @@ ValueElem *   ValueRegistrySimple::NewLink  (HASH_T  uNameHashIn)
     {
     pSearch = new ValueElemLink;
     pSearch->SetNameHash (uNameHashIn);
-    listValues.PushBack (pSearch);
+    AddElem (pSearch);
     };
   return (pSearch);
   };
@@ -1430,6 +1465,47 @@ ValueElem *  ValueRegistrySimple::SetClone  (ValueElem *   pelemIn)
   return (pelemNew);
   };
 
+//-----------------------------------------------------------------------------
+ValueElem *  ValueRegistrySimple::NewByType  (UINT32  uTypeIn,
+                                              HASH_T  uNameHashIn)
+  {
+  if      (uTypeIn == ValueElem::kTypeInt)          {return (NewInt         (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeFloat)        {return (NewFloat       (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeDouble)       {return (NewDouble      (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeVec)          {return (NewVec         (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeBool)         {return (NewBool        (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeString)       {return (NewString      (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeBlob)         {return (NewBlob        (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeIntArray)     {return (NewIntArray    (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeFloatArray)   {return (NewFloatArray  (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeDoubleArray)  {return (NewDoubleArray (uNameHashIn));}
+  else if (uTypeIn == ValueElem::kTypeStringArray)  {return (NewStringArray (uNameHashIn));};
+  return (NULL);
+  };
+
+//-----------------------------------------------------------------------------
+ValueElem *  ValueRegistrySimple::NewByType  (UINT32        uTypeIn,
+                                              HASH_T        uNameHashIn,
+                                              const char *  szNameIn,
+                                              const char *  szAltNameIn)
+  {
+  ValueElem *  pElem = NewByType (uTypeIn, uNameHashIn);
+  if (pElem == NULL) return (NULL);
+
+  // AddElem only saw the name hash, so the alt name is indexed here once it is set.
+  if (!pElem->GetAltNameStr ().IsEmpty ())
+    {
+    hashValues.Remove (pElem->GetAltNameHash (), pElem);
+    };
+  pElem->SetName (szNameIn);
+  if ((szAltNameIn != NULL) && (szAltNameIn [0] != '\0'))
+    {
+    pElem->SetAltName (szAltNameIn);
+    hashValues.Insert (pElem->GetAltNameHash (), pElem);
+    };
+  return (pElem);
+  };
+
 //-----------------------------------------------------------------------------
 BOOL  ValueRegistrySimple::HasKey  (const char *  szNameIn) const
   {
@@ -1570,6 +1646,7 @@ VOID  ValueRegistrySimple::ClearLocal  (VOID)
     delete (*itrCurr);
     };
   listValues.Empty ();
+  hashValues.Clear ();
   };
 
 //-----------------------------------------------------------------------------
@@ -1595,6 +1672,7 @@ VOID  ValueRegistrySimple::ClearElem  (HASH_T  uNameHashIn)
 //-----------------------------------------------------------------------------
 VOID  ValueRegistrySimple::DeleteElem  (ValueElem *   pElemIn)
   {
+  RemoveElem (pElemIn);
   listValues.Delete (pElemIn);
   };
 
@@ -1622,7 +1700,7 @@ ValueRegistry &  ValueRegistrySimple::operator= (const ValueRegistry &  regIn)
 
   for (TListItr<ValueElem*>  itrCurr = pregIn->listValues.First(); itrCurr.IsValid (); ++itrCurr)
     {
-    listValues.PushBack ((*itrCurr)->Clone());
+    AddElem ((*itrCurr)->Clone());
     };
   return (*this);
   };
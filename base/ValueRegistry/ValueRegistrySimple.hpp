@@ -42,6 +42,7 @@
 #include "Sys/Types.hpp"
 #include "Util/Signal.h"
 #include "Containers/TList.hpp"
+#include "Containers/THashIndex.hpp"
 #include "ValueRegistry/ValueRegistry.hpp"
 #include "Containers/IntArray.hpp"
 #include "Containers/FloatArray.hpp"
@@ -563,9 +564,14 @@ class ValueRegistrySimple : public ValueRegistry
   {
   private:
 
-    // NOTE:  This would be much faster lookup with a hash map or a balanced
-    //         RBTree.
-    TList<ValueElem*>  listValues;
+    TList<ValueElem*>        listValues;  ///< Elements in insertion order.  Used for FindByIndex and iteration.
+    THashIndex<ValueElem*>   hashValues;  ///< Name hash (and alt name hash) to element, for O(1) Find.
+
+  private:
+
+    VOID          AddElem              (ValueElem *   pElemIn);
+
+    VOID          RemoveElem           (ValueElem *   pElemIn);
 
   protected:
 
@@ -770,6 +776,27 @@ class ValueRegistrySimple : public ValueRegistry
     ValueElem *   NewLink              (const char *  szNameIn);
     ValueElem *   NewLink              (HASH_T        uNameHashIn);
 
+                  /** @brief  Create (or find) an element of the given type by name hash.
+                      @param  uTypeIn One of the ValueElem::kType four codes.  Pointer and link types are not created.
+                      @param  uNameHashIn Hash of the element name.
+                      @return The element, or NULL if the type is unknown.
+                  */
+    ValueElem *   NewByType            (UINT32        uTypeIn,
+                                        HASH_T        uNameHashIn);
+
+                  /** @brief  Create (or find) an element by name hash as above, then set its name and alt name,
+                              and index it under the alt name too.
+                      @param  uTypeIn One of the ValueElem::kType four codes.
+                      @param  uNameHashIn Hash of the element name.
+                      @param  szNameIn The element name, without an alt name.
+                      @param  szAltNameIn The alt name, or an empty string for none.
+                      @return The element, or NULL if the type is unknown.
+                  */
+    ValueElem *   NewByType            (UINT32        uTypeIn,
+                                        HASH_T        uNameHashIn,
+                                        const char *  szNameIn,
+                                        const char *  szAltNameIn);
+
     HASH_T        GetLink              (const char *  szNameIn)    const override;
     HASH_T        GetLink              (HASH_T        uNameHashIn) const override;
 
@@ -824,6 +851,8 @@ class ValueRegistrySimple : public ValueRegistry
 
     ValueRegistry &  operator=         (const ValueRegistry &  regIn) override;
 
+    ValueRegistrySimple &  operator=   (const ValueRegistrySimple &  regIn)  {ValueRegistrySimple::operator= ((const ValueRegistry &) regIn); return (*this);};
+
     INT           Size                 (VOID) const override;
 
     VOID          SetOrder             (const char *  szNameIn,
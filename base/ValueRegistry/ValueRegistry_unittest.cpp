@@ -9,6 +9,8 @@ ASSERTFILE (__FILE__)
 
 #include "ValueRegistry/ValueRegistry.hpp"
 #include "ValueRegistry/ValueRegistrySimple.hpp"
+#include "Sys/Timer.hpp"
+#include "Sys/UnitTestMain.hpp"
 
 
 // NOTE: https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
@@ -293,3 +295,203 @@ TEST (ValueRegistry, ExpandVars)
   ASSERT_STREQ (registry.ExpandVars (parserSource), "1/2");
   };
 
+
+//------------------------------------------------------------------------------
+TEST (ValueRegistry, HashIndex)
+  {
+  ValueRegistrySimple  registry;
+  RStr                 strName;
+  const INT            iNumKeys = 5000;
+
+  for (INT  iIndex = 0; iIndex < iNumKeys; ++iIndex)
+    {
+    strName.Format ("Config.Key.%d", iIndex);
+    registry.SetInt (strName.AsChar (), iIndex);
+    };
+  ASSERT_EQ (registry.Size (), iNumKeys);
+
+  for (INT  iIndex = 0; iIndex < iNumKeys; ++iIndex)
+    {
+    strName.Format ("Config.Key.%d", iIndex);
+    ASSERT_EQ (registry.GetInt (strName.AsChar ()), iIndex);
+    ASSERT_EQ (registry.GetInt (HASH (strName.AsChar ())), iIndex);
+    };
+
+  // index order is still insertion order
+  ASSERT_STREQ (registry.FindByIndex (0)->GetName (), "Config.Key.0");
+  ASSERT_STREQ (registry.FindByIndex (iNumKeys - 1)->GetName (), "Config.Key.4999");
+
+  registry.SetOrder ("Config.Key.42", 7);
+  ASSERT_STREQ (registry.FindByOrder (7)->GetName (), "Config.Key.42");
+
+  // delete half the keys, and make sure the rest are still found
+  for (INT  iIndex = 0; iIndex < iNumKeys; iIndex += 2)
+    {
+    strName.Format ("Config.Key.%d", iIndex);
+    registry.DeleteElem (strName.AsChar ());
+    };
+  ASSERT_EQ (registry.Size (), iNumKeys / 2);
+  ASSERT_FALSE (registry.HasKey ("Config.Key.0"));
+  ASSERT_TRUE  (registry.HasKey ("Config.Key.1"));
+  ASSERT_EQ (registry.GetInt ("Config.Key.4999"), 4999);
+  ASSERT_STREQ (registry.FindByIndex (0)->GetName (), "Config.Key.1");
+
+  // alt names
+  registry.SetInt ("Primary|Alternate", 12);
+  ASSERT_EQ (registry.GetInt ("Primary"), 12);
+  ASSERT_TRUE (registry.Find ("Alternate") != NULL);
+  ASSERT_EQ (registry.Find ("Alternate"), registry.Find ("Primary"));
+
+  // copies build their own index
+  ValueRegistrySimple  registryCopy;
+  registryCopy = registry;
+  ASSERT_EQ (registryCopy.GetInt ("Config.Key.1"), 1);
+  ASSERT_EQ (registryCopy.GetInt (HASH ("Config.Key.4999")), 4999);
+
+  registry.Clear ();
+  ASSERT_EQ (registry.Size (), 0);
+  ASSERT_FALSE (registry.HasKey ("Config.Key.1"));
+  };
+
+//------------------------------------------------------------------------------
+TEST (ValueRegistry, LookupBenchmark)
+  {
+  // Reports lookup cost against key count.  With the hash index, the cost
+  //  per lookup should stay roughly flat as the registry grows.
+  if (! UnitTestBenchmarks ()) {return;};
+
+  const INT   aiKeyCounts [] = {10, 100, 1000, 10000};
+  const INT   iNumLookups    = 200000;
+  RStr        strName;
+  StopWatch   watch;
+
+  for (UINT  uCount = 0; uCount < sizeof (aiKeyCounts) / sizeof (INT); ++uCount)
+    {
+    ValueRegistrySimple  registry;
+    HASH_T *             auHashes = new HASH_T [aiKeyCounts [uCount]];
+
+    for (INT  iIndex = 0; iIndex < aiKeyCounts [uCount]; ++iIndex)
+      {
+      strName.Format ("UI.Window.Field%d.Value", iIndex);
+      registry.SetInt (strName.AsChar (), iIndex);
+      auHashes [iIndex] = HASH (strName.AsChar ());
+      };
+
+    INT64  iSum = 0;
+    watch.Start ();
+    for (INT  iLookup = 0; iLookup < iNumLookups; ++iLookup)
+      {
+      iSum += registry.GetInt (auHashes [iLookup % aiKeyCounts [uCount]]);
+      };
+    watch.Stop ();
+
+    BenchmarkPrintf ("ValueRegistrySimple: %6d keys  %8.2f ns/lookup\n",
+                     aiKeyCounts [uCount],
+                     DOUBLE (watch.GetElapsedUs ()) * 1000.0 / DOUBLE (iNumLookups));
+    ASSERT_GT (iSum, INT64 (-1));
+    delete [] auHashes;
+    };
+  };
+
+//------------------------------------------------------------------------------
+class BatchListener
+  {
+  public:
+    INT                    iNumCalls;
+    BOOL                   bLastUpdating;
+    ValueRegistrySimple *  pRegistry;    ///< If set, OnChanged writes "echo" to test changes raised during a flush.
+
+  public:
+           BatchListener ()  {iNumCalls = 0; bLastUpdating = FALSE; pRegistry = NULL;};
+
+    VOID   OnChanged     (ValueElem *  pelemIn,
+                          BOOL         bUpdatingIn)
+                                   {
+                                   ++iNumCalls;
+                                   bLastUpdating = bUpdatingIn;
+                                   if (pRegistry != NULL) {pRegistry->SetInt ("echo", pelemIn->GetInt ());};
+                                   };
+  };
+
+//------------------------------------------------------------------------------
+TEST (ValueRegistry, BatchedChanges)
+  {
+  ValueRegistrySimple  registry;
+  BatchListener        listenerCount;
+  BatchListener        listenerEcho;
+  ChangeBatch::Stats   stats;
+
+  ValueElem *  pelemCount = registry.SetInt ("count", 0);
+  ValueElem *  pelemEcho  = registry.SetInt ("echo",  0);
+  pelemCount->sigOnChanged.Connect (&listenerCount, &BatchListener::OnChanged);
+  pelemEcho->sigOnChanged.Connect  (&listenerEcho,  &BatchListener::OnChanged);
+
+  // without batching, every set is delivered at once
+  ChangeBatch::ResetStats ();
+  registry.SetInt ("count", 1);
+  registry.SetInt ("count", 2);
+  ASSERT_EQ (2, listenerCount.iNumCalls);
+
+  // with batching, a burst of sets is delivered once at the flush
+  ChangeBatch::SetBatching (ChangeBatch::kValueElem);
+  listenerCount.iNumCalls = 0;
+  for (INT  iValue = 0; iValue < 100; ++iValue)
+    {
+    registry.SetInt ("count", iValue, TRUE);
+    };
+  registry.SetInt ("echo", 5);
+  ASSERT_EQ (0, listenerCount.iNumCalls);
+  ASSERT_EQ (0, listenerEcho.iNumCalls);
+
+  ChangeBatch::GetStats (stats);
+  ASSERT_EQ (2, stats.iNumPending);
+  ASSERT_EQ (2, ChangeBatch::Flush ());
+  ASSERT_EQ (1, listenerCount.iNumCalls);
+  ASSERT_EQ (1, listenerEcho.iNumCalls);
+  ASSERT_TRUE (listenerCount.bLastUpdating);
+  ASSERT_EQ (99, registry.GetInt ("count"));
+  ASSERT_EQ (0, ChangeBatch::Flush ());
+
+  ChangeBatch::GetStats (stats);
+  ASSERT_EQ (103, stats.iNumRaised);
+  ASSERT_EQ (101, stats.iNumDeferred);
+  ASSERT_EQ (4,   stats.iNumDelivered);
+  ASSERT_EQ (0,   stats.iNumPending);
+
+  // a single non-updating change means the listener sees a non-updating change
+  registry.SetInt ("count", 1, TRUE);
+  registry.SetInt ("count", 2, FALSE);
+  ChangeBatch::Flush ();
+  ASSERT_FALSE (listenerCount.bLastUpdating);
+
+  // changes raised by listeners during a flush are delivered by the same flush
+  listenerCount.iNumCalls = 0;
+  listenerEcho.iNumCalls  = 0;
+  listenerCount.pRegistry = &registry;
+  registry.SetInt ("count", 42);
+  ASSERT_EQ (2, ChangeBatch::Flush ());
+  ASSERT_EQ (1, listenerCount.iNumCalls);
+  ASSERT_EQ (1, listenerEcho.iNumCalls);
+  ASSERT_EQ (42, registry.GetInt ("echo"));
+  listenerCount.pRegistry = NULL;
+
+  // elements deleted while pending are dropped
+  ValueElem *  pelemTemp = new ValueElemInt;
+  pelemTemp->SetInt (1);
+  pelemTemp->SetInt (2);
+  delete pelemTemp;
+  ChangeBatch::GetStats (stats);
+  ASSERT_EQ (0, stats.iNumPending);
+  ASSERT_EQ (0, ChangeBatch::Flush ());
+
+  // turning batching off delivers whatever is waiting
+  listenerCount.iNumCalls = 0;
+  registry.SetInt ("count", 7);
+  ChangeBatch::SetBatching (ChangeBatch::kNone);
+  ASSERT_EQ (1, listenerCount.iNumCalls);
+  registry.SetInt ("count", 8);
+  ASSERT_EQ (2, listenerCount.iNumCalls);
+
+  pelemCount->sigOnChanged.Disconnect (&listenerCount, &BatchListener::OnChanged);
+  pelemEcho->sigOnChanged.Disconnect  (&listenerEcho,  &BatchListener::OnChanged);
+  };